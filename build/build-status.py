@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/src/config-store/examples/ns3-dev-config-store-save-debug', 'build/src/core/examples/ns3-dev-main-callback-debug', 'build/src/core/examples/ns3-dev-sample-simulator-debug', 'build/src/core/examples/ns3-dev-main-ptr-debug', 'build/src/core/examples/ns3-dev-main-random-variable-debug', 'build/src/core/examples/ns3-dev-main-random-variable-stream-debug', 'build/src/core/examples/ns3-dev-sample-random-variable-debug', 'build/src/core/examples/ns3-dev-sample-random-variable-stream-debug', 'build/src/core/examples/ns3-dev-command-line-example-debug', 'build/src/core/examples/ns3-dev-hash-example-debug', 'build/src/core/examples/ns3-dev-main-test-sync-debug', 'build/src/internet/examples/ns3-dev-main-simple-debug', 'build/src/mobility/examples/ns3-dev-main-grid-topology-debug', 'build/src/mobility/examples/ns3-dev-main-random-topology-debug', 'build/src/mobility/examples/ns3-dev-main-random-walk-debug', 'build/src/mobility/examples/ns3-dev-mobility-trace-example-debug', 'build/src/mobility/examples/ns3-dev-ns2-mobility-trace-debug', 'build/src/mobility/examples/ns3-dev-bonnmotion-ns2-example-debug', 'build/src/network/examples/ns3-dev-main-packet-header-debug', 'build/src/network/examples/ns3-dev-main-packet-tag-debug', 'build/src/network/examples/ns3-dev-packet-socket-apps-debug', 'build/src/propagation/examples/ns3-dev-main-propagation-loss-debug', 'build/src/propagation/examples/ns3-dev-jakes-propagation-model-example-debug', 'build/src/satellite/examples/ns3-dev-satellite-example-debug', 'build/src/satellite/examples/ns3-dev-sat-constellation-bench-debug', 'build/src/satellite/examples/ns3-dev-sat-visibility-bench-debug', 'build/src/satellite/examples/ns3-dev-sat-links-bench-debug', 'build/src/satellite/examples/ns3-dev-sat-contact-plan-bench-debug', 'build/src/stats/examples/ns3-dev-gnuplot-example-debug', 'build/src/stats/examples/ns3-dev-double-probe-example-debug', 'build/src/stats/examples/ns3-dev-time-probe-example-debug', 'build/src/stats/examples/ns3-dev-gnuplot-aggregator-example-debug', 'build/src/stats/examples/ns3-dev-gnuplot-helper-example-debug', 'build/src/stats/examples/ns3-dev-file-aggregator-example-debug', 'build/src/stats/examples/ns3-dev-file-helper-example-debug', 'build/src/wifi/examples/ns3-dev-wifi-phy-test-debug', 'build/src/wifi/examples/ns3-dev-test-interference-helper-debug', 'build/src/wifi/examples/ns3-dev-s1g-raw-ctr-bench-debug', 'build/src/wifi/examples/ns3-dev-s1g-raw-slot-bench-debug', 'build/src/wifi/examples/ns3-dev-s1g-raw-estimator-bench-debug', 'build/src/wifi/examples/ns3-dev-s1g-raw-grouping-bench-debug', 'build/src/wifi/examples/ns3-dev-yans-wifi-channel-bench-debug', 'build/src/wifi/examples/ns3-dev-s1g-phy-tables-bench-debug', 'build/src/wifi/examples/ns3-dev-wifi-remote-station-manager-bench-debug', 'build/src/wifi/examples/ns3-dev-mac-low-control-frame-bench-debug', 'build/examples/stats/ns3-dev-wifi-example-sim-debug', 'build/examples/wireless/ns3-dev-wifi-adhoc-debug', 'build/examples/wireless/ns3-dev-wifi-clear-channel-cmu-debug', 'build/examples/wireless/ns3-dev-wifi-ap-debug', 'build/examples/wireless/ns3-dev-simple-msdu-aggregation-debug', 'build/examples/wireless/ns3-dev-wifi-simple-adhoc-debug', 'build/examples/wireless/ns3-dev-wifi-simple-infra-debug', 'build/examples/wireless/ns3-dev-wifi-simple-interference-debug', 'build/examples/wireless/ns3-dev-wifi-blockack-debug', 'build/examples/wireless/ns3-dev-ofdm-validation-debug', 'build/examples/wireless/ns3-dev-ofdm-ht-validation-debug', 'build/examples/wireless/ns3-dev-ht-wifi-network-debug', 'build/examples/wireless/ns3-dev-wifi-timing-attributes-debug', 'build/examples/wireless/ns3-dev-simple-mpdu-aggregation-debug', 'build/examples/wireless/ns3-dev-simple-two-level-aggregation-debug', 'build/examples/wireless/ns3-dev-simple-ht-hidden-stations-debug', 'build/examples/tutorial/ns3-dev-hello-simulator-debug', 'build/examples/tutorial/ns3-dev-fourth-debug', 'build/scratch/ns3-dev-spider-test-debug', 'build/scratch/subdir/ns3-dev-subdir-debug', 'build/scratch/ns3-dev-s1g-mac-test-debug', 'build/scratch/ns3-dev-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'wifi-ap.py']
+
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RAW_ACCESS_GATE_H
+#define RAW_ACCESS_GATE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Whether the channel access functions of a station may contend for the
+ * medium with respect to the RAW of the current beacon.
+ *
+ * All the DcaTxop and EdcaTxopN of a StaWifiMac share one gate, so that a
+ * RAW boundary opens or closes every queue with a single call.  Each
+ * queue gets its own bit, so a queue can still be opened on its own, as
+ * the PS-Poll queue in a paged STA RAW.  Outside of any RAW every queue
+ * is allowed.
+ *
+ * The gate also schedules the RAW boundaries of the station: the start
+ * and the end of its slot, and the end of the RAW.  Each boundary is one
+ * event, which notifies the queues in the order they were added.
+ */
+class RawAccessGate : public SimpleRefCount<RawAccessGate>
+{
+public:
+  /**
+   * Create a gate with no queue
+   */
+  RawAccessGate ();
+
+  /**
+   * \param rawStart called when the queue may start a RAW backoff
+   * \param outsideRawStart called at the end of the RAW
+   * \return the index of a new queue, initially allowed
+   */
+  uint32_t AddQueue (Callback<void> rawStart, Callback<void> outsideRawStart);
+  /**
+   * \param wakeUp called at the start of the slot and at the end of the
+   *        RAW, before the queues are notified
+   */
+  void SetWakeUpCallback (Callback<void> wakeUp);
+  /**
+   * \param queue the index of a queue
+   * \param allowed whether the queue may contend for the medium
+   */
+  void SetAllowed (uint32_t queue, bool allowed);
+  /**
+   * \param allowed whether all the queues may contend for the medium
+   */
+  void SetAllAllowed (bool allowed);
+  /**
+   * \param queue the index of a queue
+   *
+   * Allow queue and no other.
+   */
+  void SetOnlyAllowed (uint32_t queue);
+  /**
+   * \param queue the index of a queue
+   * \return whether the queue may contend for the medium
+   */
+  bool IsAllowed (uint32_t queue) const;
+
+  /**
+   * Start the RAW backoff of every queue now.
+   */
+  void StartRaw (void);
+  /**
+   * \param start the delay until the start of the slot of the station
+   * \param duration the duration of the slot
+   *
+   * At the start of the slot, open every queue and start their RAW
+   * backoff; close them all at the end of the slot.  A slot still to
+   * come, from the RAW of an earlier beacon, is cancelled.
+   */
+  void ScheduleSlot (Time start, Time duration);
+  /**
+   * \param delay the delay until the end of the RAW
+   *
+   * At the end of the RAW, reopen every queue and restart its backoff.
+   */
+  void ScheduleRawEnd (Time delay);
+  /**
+   * Cancel the end of the RAW, for a beacon received before it.
+   */
+  void CancelRawEnd (void);
+  /**
+   * \return whether the end of a RAW is pending
+   */
+  bool IsRawEndPending (void) const;
+  /**
+   * Cancel the pending boundaries and forget the wake up callback.
+   */
+  void Dispose (void);
+
+private:
+  /**
+   * The notifications of a queue at the RAW boundaries
+   */
+  struct Queue
+  {
+    Callback<void> rawStart;        //!< start of a RAW backoff
+    Callback<void> outsideRawStart; //!< end of the RAW
+  };
+
+  /**
+   * \param duration the duration of the slot
+   */
+  void SlotStart (Time duration);
+  void SlotEnd (void);
+  void RawEnd (void);
+
+  std::vector<Queue> m_queues; //!< queues, in notification order
+  uint32_t m_allowed;          //!< one bit per allowed queue
+  Callback<void> m_wakeUp;     //!< called before the queues are opened
+  EventId m_slotStartEvent;    //!< start of the slot of the station
+  EventId m_slotEndEvent;      //!< end of the slot of the station
+  EventId m_rawEndEvent;       //!< end of the RAW
+};
+
+} //namespace ns3
+
+#endif /* RAW_ACCESS_GATE_H */
@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef RPS_H
+#define RPS_H
+
+#include <stdint.h>
+#include "ns3/buffer.h"
+#include "ns3/attribute.h"
+#include "ns3/attribute-helper.h"
+#include "ns3/wifi-information-element.h"
+#include "ns3/vector.h"
+
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * The IEEE 802.11 TIM Element
+ *
+ * \see attribute_Tim
+ */
+class RPS : public WifiInformationElement
+{
+public:
+    
+      class RawAssignment
+       {
+       public:
+          RawAssignment ();
+          ~RawAssignment ();
+          
+          void SetRawControl (uint8_t control);
+          //void SetRawSlot (uint16_t slot); repalce by following
+          void SetSlotFormat (uint8_t format);
+          void SetSlotCrossBoundary (uint8_t cross);
+          void SetSlotDurationCount (uint16_t count);
+          void SetSlotNum (uint16_t count);
+ 
+           
+          void SetRawStart (uint8_t start);
+          void SetRawGroup (uint32_t group);
+          void SetChannelInd (uint16_t channel);
+          void SetPRAW (uint32_t praw);
+          
+          uint8_t GetRawControl (void) const;
+          uint16_t GetRawSlot (void) ;
+          uint8_t GetSlotFormat (void) const;
+          uint8_t GetSlotCrossBoundary (void) const;
+          uint16_t GetSlotDurationCount (void) const;
+          uint16_t GetSlotNum (void) const;
+           
+           
+          uint8_t GetRawStart (void) const;
+          uint32_t GetRawGroup (void) const;
+          uint16_t GetChannelInd (void) const;
+          uint32_t GetPRAW (void) const;
+          
+          uint8_t GetSize (void) const;
+          //void Serialize (Buffer::Iterator start) const;
+          //uint8_t Deserialize (Buffer::Iterator start);
+          
+      private:
+          uint8_t m_rawcontrol;
+          uint16_t m_rawslot;
+          uint8_t m_SlotFormat;
+          uint8_t m_slotCrossBoundary;
+          uint16_t m_slotDurationCount;
+          uint16_t m_slotNum;
+           
+          uint8_t m_rawstart;
+          uint32_t m_rawgroup;
+          uint16_t m_channelind;
+          uint32_t m_prawparam;
+          
+          uint8_t raw_length; //!< length of (single) Raw Assignment
+       };
+
+      /**
+       * Read-only view of one RAW Assignment subfield inside an RPS.
+       * Fields are decoded on access from the RPS buffer, nothing is
+       * copied.  A view is only valid as long as the RPS it comes from.
+       */
+      class RawAssignmentView
+       {
+       public:
+          RawAssignmentView (const uint8_t * start);
+
+          uint8_t GetRawControl (void) const;
+          uint16_t GetRawSlot (void) const;
+          uint8_t GetSlotFormat (void) const;
+          uint8_t GetSlotCrossBoundary (void) const;
+          uint16_t GetSlotDurationCount (void) const;
+          uint16_t GetSlotNum (void) const;
+          uint32_t GetRawGroup (void) const;
+          uint8_t GetPage (void) const;
+          uint16_t GetRawStartAid (void) const;
+          uint16_t GetRawEndAid (void) const;
+
+       private:
+          const uint8_t * m_start;
+       };
+
+      /**
+       * Iterates over the RAW Assignment subfields of an RPS.
+       */
+      class Iterator
+       {
+       public:
+          Iterator (const uint8_t * pos);
+
+          RawAssignmentView operator * (void) const;
+          Iterator & operator ++ (void);
+          bool operator == (const Iterator & o) const;
+          bool operator != (const Iterator & o) const;
+
+       private:
+          const uint8_t * m_pos;
+       };
+
+  RPS ();
+  RPS (const RPS & o);
+  RPS & operator = (const RPS & o);
+  ~RPS ();
+ 
+   /**
+   * Set the Partial Virtual Bitmap.
+   *
+   * \Set the Partial Virtual Bitmap
+   */
+  void SetRawAssignment (RPS::RawAssignment raw);
+  /**
+   * Return the Partial Virtual Bitmap.
+   *
+   * \Return the Partial Virtual Bitmap
+   */
+  const uint8_t * GetRawAssignment (void) const;
+  /**
+   * \param index the index of a RAW Assignment subfield
+   * \param count the new slot duration count of that subfield
+   *
+   * Patch the slot duration count in place, in the slot format of the
+   * subfield.
+   */
+  void SetSlotDurationCount (uint8_t index, uint16_t count);
+
+  Iterator Begin (void) const;
+  Iterator End (void) const;
+  /**
+   * \return the number of RAW Assignment subfields
+   */
+  uint8_t GetNRawAssignments (void) const;
+
+
+  WifiInformationElementId ElementId () const;
+  uint8_t GetInformationFieldSize () const;
+    
+  void SerializeInformationField (Buffer::Iterator start) const;
+  uint8_t DeserializeInformationField (Buffer::Iterator start, uint8_t length);
+    
+  static const uint8_t RAW_ASSIGNMENT_SIZE = 6;
+  /** The most RAW Assignment subfields one information field can carry */
+  static const uint8_t MAX_RAW_ASSIGNMENTS = 255 / RAW_ASSIGNMENT_SIZE;
+
+  uint8_t m_length; //!< Total length of all RAW Assignments
+private:
+  uint8_t m_rps[255]; //!< RAW Assignment subfields, up to the largest information field
+};
+
+std::ostream &operator << (std::ostream &os, const RPS &rps);
+std::istream &operator >> (std::istream &is, RPS &rps);
+
+ATTRIBUTE_HELPER_HEADER (RPS);
+
+//} //namespace ns3
+
+
+    
+class RPSVector
+{
+public:
+    typedef std::vector<ns3::RPS> RPSlist;
+    RPSlist rpsset;
+    
+    uint32_t getlen();
+    void setlen(uint8_t len);
+    
+    friend std::ostream &operator << (std::ostream &os, const RPSVector &rpsv);
+    friend std::istream &operator >> (std::istream &is, RPSVector &rpsv);
+    
+private:
+    uint32_t length;
+};
+    
+std::ostream &operator << (std::ostream &os, const RPSVector &rpsv);
+std::istream &operator >> (std::istream &is, RPSVector &rpsv);
+    
+
+ATTRIBUTE_HELPER_HEADER (RPSVector);
+
+} //namespace ns3
+
+#endif /* RPS_H */
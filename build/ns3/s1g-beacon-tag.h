@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef S1G_BEACON_TAG_H
+#define S1G_BEACON_TAG_H
+
+#include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
+#include "extension-headers.h"
+#include <vector>
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup wifi
+ *
+ * An S1G beacon as the stations see it once decoded: the header and the
+ * RAW schedule carried in its RPS element, with the start of every RAW
+ * already accumulated.  One instance is shared by all the stations that
+ * receive the same beacon.
+ */
+class S1gBeaconInfo : public SimpleRefCount<S1gBeaconInfo>
+{
+public:
+  /**
+   * One RAW of the RPS element.
+   */
+  struct Raw
+  {
+    uint8_t rawType;            //!< RAW type, bits 0-2 of the RAW control
+    uint8_t page;               //!< page index of the RAW group
+    uint16_t rawStartAid;       //!< first AID of the RAW group (10 bits)
+    uint16_t rawEndAid;         //!< last AID of the RAW group (10 bits)
+    uint16_t slotDurationCount; //!< slot duration count
+    uint16_t slotNum;           //!< number of slots
+    uint64_t startUs;           //!< start of the RAW after the beacon, in microseconds
+  };
+
+  /**
+   * The slot a station is given by the beacon.
+   */
+  struct Slot
+  {
+    uint8_t rawIndex;    //!< index of the RAW in GetRaws ()
+    uint16_t slot;       //!< slot of the station in that RAW
+    uint64_t startUs;    //!< start of the slot after the beacon, in microseconds
+    uint64_t durationUs; //!< duration of the slot, in microseconds
+  };
+
+  /**
+   * \param beacon the decoded beacon header
+   */
+  S1gBeaconInfo (const S1gBeaconHeader &beacon);
+
+  /**
+   * \return the decoded beacon header
+   */
+  const S1gBeaconHeader & GetHeader (void) const;
+  /**
+   * \return the RAWs of the beacon in the order of the RPS element
+   */
+  const std::vector<Raw> & GetRaws (void) const;
+  /**
+   * \return the sum of the durations of all RAWs, in microseconds
+   */
+  uint64_t GetRawDurationUs (void) const;
+  /**
+   * \param aid the AID of a station
+   * \param slot the slot of the station, set if found
+   * \return true if a RAW of the beacon includes the station
+   *
+   * When several RAWs include the station, the last one in the RPS
+   * element gives the slot.  The lookup is a binary search over the AID
+   * ranges of the page of the station.
+   */
+  bool FindSlot (uint16_t aid, Slot &slot) const;
+
+private:
+  /**
+   * AIDs of a page, from start to the start of the next segment, whose
+   * slot is given by one RAW.
+   */
+  struct Segment
+  {
+    uint16_t start;   //!< first AID (10 bits) of the segment
+    int16_t rawIndex; //!< index of the RAW, -1 if none includes these AIDs
+  };
+
+  /**
+   * Split the AIDs of every page into segments covered by the same RAW.
+   */
+  void BuildSegments (void);
+
+  S1gBeaconHeader m_header;            //!< decoded beacon header
+  std::vector<Raw> m_raws;             //!< RAW schedule
+  uint64_t m_rawDurationUs;            //!< total duration of the RAWs
+  std::vector<Segment> m_segments[4];  //!< AID segments of every page
+};
+
+/**
+ * \ingroup wifi
+ *
+ * The S1gBeaconInfo objects of the most recent beacons of an AP, indexed
+ * by identifier modulo the table size.  An entry is reused once 256 newer
+ * beacons have been added, which is long after all the stations have
+ * received it.
+ */
+class S1gBeaconTable
+{
+public:
+  /**
+   * Create an empty table
+   */
+  S1gBeaconTable ();
+
+  /**
+   * \param info a decoded beacon
+   * \return the identifier of info in the table, never 0
+   */
+  uint32_t Add (Ptr<const S1gBeaconInfo> info);
+  /**
+   * \param id the identifier of a beacon
+   * \return the beacon, or 0 if it is no longer in the table
+   */
+  Ptr<const S1gBeaconInfo> Get (uint32_t id) const;
+  /**
+   * Forget all the beacons.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * A beacon of the table
+   */
+  struct Entry
+  {
+    uint32_t id;                   //!< identifier, 0 if none
+    Ptr<const S1gBeaconInfo> info; //!< the decoded beacon
+  };
+
+  std::vector<Entry> m_entries; //!< the table
+  uint32_t m_lastId;            //!< identifier of the last beacon added
+};
+
+/**
+ * \ingroup wifi
+ *
+ * The S1gBeaconTag lets an AP hand the beacon it has just decoded to all
+ * the stations receiving it, so that they do not deserialize the same
+ * S1G beacon header one by one.
+ *
+ * The tag only carries the S1gBeaconTable of the AP and an identifier in
+ * it, so it resolves only while the AP is alive and the beacon is still
+ * in its table; a station whose tag no longer resolves (or a beacon
+ * without the tag) falls back to removing the header from the packet.
+ */
+class S1gBeaconTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * Create a S1gBeaconTag which refers to no beacon
+   */
+  S1gBeaconTag ();
+
+  /**
+   * \param table the recent beacons of the AP
+   * \param info the decoded beacon to share
+   *
+   * Add info to table and make this tag refer to it.
+   */
+  void SetBeaconInfo (S1gBeaconTable &table, Ptr<const S1gBeaconInfo> info);
+  /**
+   * \return the decoded beacon this tag refers to, or 0 if it is no
+   *         longer in the table of the AP
+   */
+  Ptr<const S1gBeaconInfo> GetBeaconInfo (void) const;
+
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual uint32_t GetSerializedSize () const;
+  virtual void Print (std::ostream &os) const;
+
+private:
+  const S1gBeaconTable *m_table; //!< recent beacons of the AP, 0 if none
+  uint32_t m_id;                 //!< identifier of the beacon in the table, 0 if none
+};
+
+} //namespace ns3
+
+#endif /* S1G_BEACON_TAG_H */
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SAT_CONSTELLATION_H
+#define SAT_CONSTELLATION_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "satgeometry.h"
+#include "satposition.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * The orbits of a whole constellation, propagated together.
+ *
+ * The orbital elements of the satellites and terminals added are kept in
+ * contiguous arrays, one block per kind of SatPosition, so that
+ * Propagate moves them all to a time in one pass over each block,
+ * without a virtual call nor a Simulator::Now per satellite.  The
+ * positions it gives are those GetCoord of the SatPosition added gives at
+ * that time, bit for bit; a SatPosition changed after it was added is not
+ * followed.
+ */
+class SatConstellation : public Object
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatConstellation ();
+  virtual ~SatConstellation ();
+
+  /**
+   * \param position the orbit of a satellite
+   *
+   * \return the index of the satellite in the constellation
+   */
+  uint32_t Add (const PolarSatPosition &position);
+  /**
+   * \param position the orbit of a satellite
+   *
+   * \return the index of the satellite in the constellation
+   */
+  uint32_t Add (const SunSynStaPosition &position);
+  /**
+   * \param position the orbit of a satellite
+   *
+   * \return the index of the satellite in the constellation
+   */
+  uint32_t Add (const GeoSatPosition &position);
+  /**
+   * \param position a terminal on the Earth
+   *
+   * \return the index of the terminal in the constellation
+   */
+  uint32_t Add (const TermSatPosition &position);
+  /**
+   * \return the number of satellites and terminals added
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a satellite or terminal
+   *
+   * \return whether it is a terminal
+   */
+  bool IsTerminal (uint32_t i) const;
+
+  /**
+   * Move all the satellites and terminals to a time.
+   *
+   * \param time the simulation time
+   */
+  void Propagate (Time time);
+  /**
+   * \return the time of the last Propagate
+   */
+  Time GetTime (void) const;
+  /**
+   * \param i the index of a satellite or terminal
+   *
+   * \return its spherical coordinates at the time of the last Propagate
+   */
+  coordinate GetCoord (uint32_t i) const;
+  /**
+   * \param i the index of a satellite or terminal
+   *
+   * \return its Cartesian coordinates at the time of the last Propagate
+   */
+  cartesian GetCartesian (uint32_t i) const;
+  /**
+   * \param i the index of a satellite or terminal
+   * \param time a simulation time
+   *
+   * \return its spherical coordinates at that time, leaving the positions
+   * of the last Propagate alone
+   */
+  coordinate GetCoord (uint32_t i, Time time) const;
+  /**
+   * \param i the index of a satellite or terminal
+   * \param time a simulation time
+   *
+   * \return its Cartesian coordinates at that time, leaving the positions
+   * of the last Propagate alone
+   */
+  cartesian GetCartesian (uint32_t i, Time time) const;
+
+private:
+  /** The kinds of orbits, each with its own formula */
+  enum Kind
+  {
+    POLAR,
+    SUN_SYN,
+    GEO,
+    TERM,
+    N_KINDS
+  };
+
+  /** The orbital elements and the positions of the orbits of a kind */
+  struct Block
+  {
+    std::vector<double> r;
+    std::vector<double> theta0;       //!< initialCoord.theta
+    std::vector<double> phi0;         //!< initialCoord.phi
+    std::vector<double> sinInc;
+    std::vector<double> cosInc;
+    std::vector<double> period;
+    std::vector<int64_t> initial;     //!< initialTime, in time steps
+    std::vector<double> elapsed;      //!< the seconds since initialTime
+    std::vector<double> theta;
+    std::vector<double> phi;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+  };
+
+  /**
+   * \param kind the kind of the orbit
+   * \param position the orbit
+   * \param inclination its inclination, in radians
+   *
+   * \return the index of the orbit in the constellation
+   */
+  uint32_t Add (enum Kind kind, const SatPosition &position, double inclination);
+  /**
+   * Compute the elapsed times of the orbits of a block.
+   *
+   * \param block the block
+   * \param time the simulation time
+   */
+  static void SetElapsed (Block &block, Time time);
+  static void PropagatePolar (Block &block);
+  static void PropagateSunSyn (Block &block);
+  /**
+   * Propagate an orbit along the equator, of a GeoSatPosition, or of a
+   * TermSatPosition, which does not wrap the elapsed time around its
+   * period.
+   *
+   * \param block the block
+   * \param wrap whether to wrap the elapsed time around the period
+   */
+  static void PropagateEquatorial (Block &block, bool wrap);
+  static void ToCartesian (Block &block);
+
+  Block m_blocks[N_KINDS];
+  std::vector<uint8_t> m_kinds;       //!< the kind of each orbit
+  std::vector<uint32_t> m_slots;      //!< the index of each orbit in its block
+  Time m_time;
+};
+
+} // namespace ns3
+
+#endif /* SAT_CONSTELLATION_H */
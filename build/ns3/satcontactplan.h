@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SAT_CONTACT_PLAN_H
+#define SAT_CONTACT_PLAN_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "satconstellation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * The contacts of a SatConstellation over a horizon, computed ahead.
+ *
+ * The links of SatVisibility are found every Step of the horizon, and the
+ * time each link came up or went down between two steps is found by
+ * bisection on SatVisibility::AreLinked, that is on the sign of the
+ * elevation over the mask or of the grazing radius over the atmosphere,
+ * down to Tolerance.  The plan is only as fine as its Step: a contact,
+ * or a gap within a contact, which starts and ends between two steps is
+ * missed, and when a link flips more than once between two steps only
+ * one of its transitions is found.  Step must then be shorter than the
+ * shortest contact and gap of interest.
+ *
+ * Schedule then runs one event per link transition, which traces
+ * LinkChange, rather than a check of all the links at a fixed interval.
+ */
+class SatContactPlan : public Object
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatContactPlan ();
+  virtual ~SatContactPlan ();
+
+  /** The time two positions of the constellation are linked */
+  struct Contact
+  {
+    uint32_t first;     //!< the lower index
+    uint32_t second;    //!< the higher index
+    Time start;
+    Time end;           //!< the end of the horizon if the link is still up
+  };
+
+  /**
+   * \param constellation the satellites and terminals to link
+   */
+  void SetConstellation (Ptr<SatConstellation> constellation);
+  /**
+   * \return the satellites and terminals linked
+   */
+  Ptr<SatConstellation> GetConstellation (void) const;
+
+  /**
+   * Compute the contacts over a horizon.  The constellation is left
+   * propagated to its end.
+   *
+   * \param start the start of the horizon
+   * \param stop the end of the horizon
+   */
+  void Compute (Time start, Time stop);
+  /**
+   * \return the contacts, sorted by start, then by index
+   */
+  const std::vector<Contact> & GetContacts (void) const;
+  /**
+   * \return the number of link transitions within the horizon, the links
+   * up at its start included
+   */
+  uint32_t GetNTransitions (void) const;
+  /**
+   * \param i the index of a position
+   * \param j the index of another position
+   * \param time a time of the horizon
+   *
+   * \return whether i and j are linked at time
+   */
+  bool IsLinked (uint32_t i, uint32_t j, Time time) const;
+  /**
+   * Trace LinkChange at each transition of the contacts from now on, with
+   * one event at a time.
+   */
+  void Schedule (void);
+
+private:
+  virtual void DoDispose (void);
+
+  /** A link coming up or going down */
+  struct Transition
+  {
+    Time time;
+    uint32_t first;
+    uint32_t second;
+    bool up;
+  };
+
+  static bool ContactLess (const Contact &a, const Contact &b);
+  static bool TransitionLess (const Transition &a, const Transition &b);
+  /**
+   * \param i the lower index
+   * \param j the higher index
+   * \param time a time
+   *
+   * \return whether i and j are linked at time
+   */
+  bool Links (uint32_t i, uint32_t j, Time time) const;
+  /**
+   * \param i the lower index
+   * \param j the higher index
+   * \param before a time at which i and j are not in state up
+   * \param after a later time at which they are
+   * \param up whether the transition brings the link up
+   *
+   * \return the first time, within Tolerance, at which i and j are in state up
+   */
+  Time FindTransition (uint32_t i, uint32_t j, Time before, Time after, bool up) const;
+  /** Trace the next transition and schedule the one after. */
+  void Fire (void);
+
+  Ptr<SatConstellation> m_constellation;
+  double m_elevationMask;           //!< in degrees
+  Time m_step;
+  Time m_tolerance;
+  uint32_t m_threads;
+
+  std::vector<Contact> m_contacts;
+  std::vector<Transition> m_transitions;
+  uint32_t m_next;                  //!< the next transition to trace
+  EventId m_event;
+
+  TracedCallback<uint32_t, uint32_t, bool> m_linkChangeTrace;
+};
+
+} // namespace ns3
+
+#endif /* SAT_CONTACT_PLAN_H */
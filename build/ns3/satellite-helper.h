@@ -0,0 +1,14 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef SATELLITE_HELPER_H
+#define SATELLITE_HELPER_H
+
+#include "ns3/satellite.h"
+
+namespace ns3 {
+
+/* ... */
+
+}
+
+#endif /* SATELLITE_HELPER_H */
+
@@ -0,0 +1,19 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_SATELLITE
+    
+
+// Module headers:
+#include "satconstellation.h"
+#include "satcontactplan.h"
+#include "satellite-helper.h"
+#include "satellite-mobility-model.h"
+#include "satellite-propagation-model.h"
+#include "satellite.h"
+#include "satgeometry.h"
+#include "satposition.h"
+#include "satvisibility.h"
+#endif
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATELLITE_PROPAGATION_MODEL_H
+#define SATELLITE_PROPAGATION_MODEL_H
+
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * The delay of SatGeometry::propdelay over the slant range between two
+ * nodes, at the speed of light of SatGeometry.
+ */
+class SatellitePropagationDelayModel : public PropagationDelayModel
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatellitePropagationDelayModel ();
+  virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+private:
+  virtual int64_t DoAssignStreams (int64_t stream);
+};
+
+/**
+ * \ingroup satellite
+ *
+ * The free space loss of the Friis equation over the slant range between
+ * two nodes.
+ *
+ * When both nodes move with a SatelliteMobilityModel and Blockage is
+ * true, the nodes which are not linked, as SatVisibility::AreLinked
+ * tells with ElevationMask, receive nothing: -1000 dBm.
+ */
+class SatellitePropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatellitePropagationLossModel ();
+
+  /**
+   * \param frequency the carrier frequency, in Hz
+   */
+  void SetFrequency (double frequency);
+  /**
+   * \return the carrier frequency, in Hz
+   */
+  double GetFrequency (void) const;
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  double m_frequency;
+  double m_lambda;                  //!< the wavelength, in m
+  double m_systemLoss;
+  double m_elevationMask;           //!< in degrees
+  bool m_blockage;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_PROPAGATION_MODEL_H */
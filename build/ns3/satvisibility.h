@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SAT_VISIBILITY_H
+#define SAT_VISIBILITY_H
+
+#include <stdint.h>
+#include <vector>
+#include <utility>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "satgeometry.h"
+#include "satconstellation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * The links between the satellites and terminals of a SatConstellation.
+ *
+ * At each Update, two satellites are linked when each sees the other with
+ * SatGeometry::are_satellites_mutually_visible, which is the same for
+ * satellites at one altitude, and a satellite and a terminal are linked
+ * when SatGeometry::check_elevation of the satellite over the terminal,
+ * against ElevationMask, is not 0.  Terminals are not linked together.
+ *
+ * Only the pairs which may be within range are checked: the positions
+ * are sorted into latitude bands as high as the largest angle, seen from
+ * the center of the Earth, between two linked positions, and each
+ * position is checked against the positions of its band and the two
+ * next, within the longitudes of that angle.  The positions are split
+ * between Threads threads.
+ *
+ * The links which come up or go down since the previous Update are
+ * traced by LinkChange, in the order of the links.
+ */
+class SatVisibility : public Object
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatVisibility ();
+  virtual ~SatVisibility ();
+
+  /** A link between two positions of the constellation */
+  struct Link
+  {
+    uint32_t first;     //!< the lower index
+    uint32_t second;    //!< the higher index
+    double distance;    //!< in km
+  };
+
+  /** A link which came up or went down */
+  struct Change
+  {
+    uint32_t first;     //!< the lower index
+    uint32_t second;    //!< the higher index
+    bool up;
+  };
+
+  /**
+   * TracedCallback signature for link changes.
+   *
+   * \param [in] first the lower index of the link
+   * \param [in] second the higher index of the link
+   * \param [in] up whether the link came up or went down
+   */
+  typedef void (* LinkChangeCallback)(uint32_t first, uint32_t second, bool up);
+
+  /**
+   * \param a a position
+   * \param aTerminal whether a is a terminal
+   * \param b another position
+   * \param bTerminal whether b is a terminal
+   * \param elevationMask the lowest elevation of a satellite linked to a
+   * terminal, in degrees
+   *
+   * \return whether a and b are linked
+   */
+  static bool AreLinked (const cartesian &a, bool aTerminal,
+                         const cartesian &b, bool bTerminal, double elevationMask);
+
+  /**
+   * \param constellation the satellites and terminals to link
+   */
+  void SetConstellation (Ptr<SatConstellation> constellation);
+  /**
+   * \return the satellites and terminals linked
+   */
+  Ptr<SatConstellation> GetConstellation (void) const;
+
+  /**
+   * Propagate the constellation to a time and find its links.
+   *
+   * \param time the simulation time
+   */
+  void Update (Time time);
+  /**
+   * \return the links of the last Update, sorted by their indexes
+   */
+  const std::vector<Link> & GetLinks (void) const;
+  /**
+   * \return the changes of the links at the last Update, sorted by their
+   * indexes
+   */
+  const std::vector<Change> & GetChanges (void) const;
+  /**
+   * \param i the index of a position
+   * \param j the index of another position
+   *
+   * \return whether i and j were linked at the last Update
+   */
+  bool IsLinked (uint32_t i, uint32_t j) const;
+  /**
+   * \return the number of pairs checked at the last Update
+   */
+  uint64_t GetChecked (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  class Slice;
+
+  /**
+   * Find the links of the positions of a slice with the positions of
+   * higher indexes.
+   *
+   * \param slice the slice
+   */
+  void Scan (Slice *slice) const;
+  /**
+   * Check a pair of positions and add their link if they are linked.
+   *
+   * \param i the lower index
+   * \param j the higher index
+   * \param links the links to add to
+   */
+  void Check (uint32_t i, uint32_t j, std::vector<Link> &links) const;
+  /**
+   * Sort the positions into the latitude bands.
+   */
+  void BuildBands (void);
+  /**
+   * Set the changes from the previous links to the new ones, and trace
+   * them.
+   *
+   * \param links the new links
+   */
+  void SetLinks (std::vector<Link> &links);
+
+  /** A position of a latitude band */
+  typedef std::pair<double, uint32_t> BandEntry;   //!< longitude, index
+
+  Ptr<SatConstellation> m_constellation;
+  double m_elevationMask;           //!< in degrees
+  uint32_t m_threads;
+  bool m_pruning;
+
+  std::vector<cartesian> m_positions;
+  std::vector<double> m_theta;
+  std::vector<double> m_phi;
+  std::vector<bool> m_terminals;
+  std::vector<std::vector<BandEntry> > m_bands;
+  double m_bandHeight;              //!< in radians
+  double m_range;                   //!< the largest angle of a link, in radians
+  uint64_t m_checked;
+
+  std::vector<Link> m_links;
+  std::vector<Change> m_changes;
+
+  TracedCallback<uint32_t, uint32_t, bool> m_linkChangeTrace;
+};
+
+} // namespace ns3
+
+#endif /* SAT_VISIBILITY_H */
@@ -0,0 +1,396 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <limits>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+#include "wifi-tx-vector.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+class NetDevice;
+class MobilityModel;
+class PropagationLossModel;
+class PropagationDelayModel;
+class YansWifiPhy;
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ *
+ * With ReceiverCulling, a transmission is only handed to the PHYs within
+ * the distance at which the loss model can still bring it up to the
+ * lowest energy detection or CCA threshold of the PHYs of the channel,
+ * less CullingMargin.  That distance is found by probing the loss model
+ * along the x axis, which must then not decrease with distance.  It is
+ * found again after a PHY changes its thresholds or rx gain.  There is
+ * only culling when every model of the loss chain depends on the
+ * distance alone: a FriisPropagationLossModel,
+ * LogDistancePropagationLossModel, ThreeLogDistancePropagationLossModel,
+ * RangePropagationLossModel or FixedRssLossModel.  Any other model, as
+ * a TwoRayGroundPropagationLossModel depending on the heights, a
+ * MatrixPropagationLossModel or a random one, whose streams probing would
+ * draw from, takes the range to infinity.  The PHYs are kept in a grid of cells of that
+ * distance, rebuilt after a mobility model of a PHY notifies a course
+ * change.  PHYs which move at constant velocity are checked on every
+ * transmission.  The culled PHYs do not draw from a random delay model,
+ * which changes its stream.
+ *
+ * With PathCache, the received power and the propagation delay of every
+ * pair of PHYs are computed once and kept in a row per sender, along
+ * with the tx power they were computed for.  The row of a PHY and its
+ * column in the other rows are dropped when its mobility model notifies
+ * a course change, and PHYs moving at constant velocity are never
+ * cached.  The models are then called only for the tx powers not seen
+ * before, which gives the same results as long as they are
+ * deterministic: with a RandomPropagationDelayModel, or a loss chain
+ * holding a RandomPropagationLossModel, a NakagamiPropagationLossModel or
+ * a JakesPropagationLossModel, nothing is cached.  A
+ * row holds 16 bytes per PHY, and is only allocated once its PHY sends.
+ * PrecomputePaths fills the cache ahead, computing the losses on
+ * PathCacheThreads threads.
+ *
+ * With NodeLocalReceive, the start of a reception is scheduled with
+ * Simulator::ScheduleNodeLocal, which lets ns3::ParallelSimulatorImpl
+ * start the receptions of distinct nodes concurrently.  Every receiver
+ * then gets its own copy of the packet, so that the count of references
+ * to the packet is node-local.  YansWifiPhy::StartReceivePreambleAndHeader
+ * only touches the node-local state of the receiving node: its PHY, the
+ * WifiPhyStateHelper and InterferenceHelper of the PHY, and the PHY
+ * listeners, the DcfManager and MacLow of the node.  No packet may be
+ * freed there, and the sinks connected to the PhyRxBegin, PhyRxDrop and
+ * State traces of the PHYs and the DcfManager traces run concurrently.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  //inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * Adds the given YansWifiPhy to the PHY list
+   *
+   * \param phy the YansWifiPhy to be added to the PHY list
+   */
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  /**
+   * Forget the culling ranges, after the energy detection or CCA
+   * threshold or the rx gain of a PHY changed.
+   */
+  void NotifyThresholdsChanged (void);
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param packetType the type of packet, used for A-MPDU to say whether it's the last MPDU or not
+   * \param duration the transmission duration associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.  PHYs in sleep
+   * mode are skipped; they catch up with the transmission through
+   * CatchUp when they wake up.  Their propagation delays are found now,
+   * and the transmission is kept until it has left the air at the last
+   * of them, or they all caught up.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiTxVector txVector, WifiPreamble preamble, uint8_t packetType, Time duration) const;
+
+  /**
+   * \param receiver the PHY which resumes from sleep mode
+   *
+   * Hand receiver the transmissions it was skipped for while sleeping
+   * and which have not left the air yet: the ones still propagating are
+   * delivered as usual, the others only add to the energy it senses.
+   */
+  void CatchUp (Ptr<YansWifiPhy> receiver) const;
+
+  /**
+   * \param txPowerDbm the tx power of a transmission, tx gain included
+   * \return the distance beyond which ReceiverCulling skips the PHYs for
+   *         the transmission, infinity if the loss model never brings it
+   *         below the thresholds or does not depend on the distance alone
+   */
+  double GetCullingRange (double txPowerDbm) const;
+
+  /**
+   * Fill the PathCache for all the pairs of PHYs which do not move, at
+   * the highest tx power of each sender.
+   *
+   * The delays are computed on the calling thread.  With more than one
+   * PathCacheThreads, the senders are split between the threads, which
+   * compute the losses between copies of the positions of the PHYs in
+   * ConstantPositionMobilityModels of their own, so that no thread
+   * touches the reference counts of another.  That only holds for the
+   * models which read nothing but the positions and change nothing:
+   * unless every model of the loss chain is a FriisPropagationLossModel,
+   * LogDistancePropagationLossModel, ThreeLogDistancePropagationLossModel,
+   * RangePropagationLossModel, FixedRssLossModel or
+   * TwoRayGroundPropagationLossModel, the losses are computed on the
+   * calling thread, between the mobility models of the PHYs.
+   */
+  void PrecomputePaths (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+
+private:
+  /**
+   * A vector of pointers to YansWifiPhy.
+   */
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * What a PHY receives of a transmission, besides the packet and its
+   * TXVECTOR and preamble.  It travels by value in the receive events.
+   */
+  struct RxParameters
+  {
+    double rxPowerDbm;  //!< received power in dBm, before rx gain
+    uint8_t packetType; //!< A-MPDU packet type
+    Time duration;      //!< duration of the transmission
+  };
+
+  /**
+   * This method is scheduled by Send for each associated YansWifiPhy.
+   * The method then calls the corresponding YansWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param packet the packet being sent, shared by all the receivers
+   * \param params the received power, packet type and duration
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   */
+  void Receive (uint32_t i, Ptr<const Packet> packet, RxParameters params,
+                WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * Same as Receive, for a PHY which caught up with a transmission.
+   *
+   * \param phy the receiving YansWifiPhy
+   * \param packet the packet being sent, shared by all the receivers
+   * \param params the received power, packet type and duration
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   */
+  void ReceiveAfterSleep (Ptr<YansWifiPhy> phy, Ptr<const Packet> packet, RxParameters params,
+                          WifiTxVector txVector, WifiPreamble preamble) const;
+
+  /**
+   * The cached path from a sender to a receiver.
+   */
+  struct PathEntry
+  {
+    PathEntry ()
+      : rxPowerDbm (std::numeric_limits<double>::quiet_NaN ()),
+        delay (-1)
+    {
+    }
+    double rxPowerDbm; //!< received power at the tx power of the row, NaN if unknown
+    int64_t delay;     //!< propagation delay in time steps, -1 if unknown
+  };
+  /**
+   * The cached paths from one sender, by receiver.
+   */
+  struct PathRow
+  {
+    double txPowerDbm;             //!< the tx power the received powers are for
+    std::vector<PathEntry> paths;  //!< the paths, by receiver index
+  };
+
+  /**
+   * \param mobility the mobility model which changed course
+   *
+   * Invalidate the grid of the PHY positions and the cached paths of
+   * the PHYs of mobility.
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility) const;
+  /**
+   * Connect to the course changes of the PHYs added since the last call.
+   */
+  void TraceCourseChanges (void) const;
+  /**
+   * \param phy a PHY of the channel
+   * \return the index of phy in the PHY list
+   */
+  uint32_t GetIndex (Ptr<const YansWifiPhy> phy) const;
+  /**
+   * The senders a thread of PrecomputePaths computes the losses of.
+   */
+  class PathSlice;
+  /**
+   * Compute the losses of the cached paths of a slice which are unknown.
+   *
+   * \param slice the senders, and the positions of the PHYs to use
+   */
+  void PrecomputeLosses (PathSlice *slice) const;
+  /**
+   * \return whether PathCache is enabled, and the loss and delay models
+   *         draw no random numbers
+   */
+  bool IsPathCacheEnabled (void) const;
+  /**
+   * \param from the index of the sender
+   * \param to the index of the receiver
+   * \return the cached path between them, 0 if PathCache is disabled or
+   *         ignored, or either PHY moves
+   */
+  PathEntry * GetPath (uint32_t from, uint32_t to) const;
+  /**
+   * The propagation delay between two PHYs, through PathCache.
+   *
+   * \param from the index of the sender
+   * \param to the index of the receiver
+   * \param a the mobility model of the sender
+   * \param b the mobility model of the receiver
+   * \return the propagation delay
+   */
+  Time GetDelay (uint32_t from, uint32_t to, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /**
+   * The received power between two PHYs, through PathCache.
+   *
+   * \param txPowerDbm the tx power
+   * \param from the index of the sender
+   * \param to the index of the receiver
+   * \param a the mobility model of the sender
+   * \param b the mobility model of the receiver
+   * \return the received power in dBm
+   */
+  double GetRxPower (double txPowerDbm, uint32_t from, uint32_t to,
+                     Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /**
+   * Put the PHYs in the cells of the grid, and remember the lowest power
+   * any of them senses.
+   */
+  void BuildGrid (void) const;
+  /**
+   * \param sender the mobility model of the sender
+   * \param range the culling range of the transmission
+   *
+   * Fill m_candidates with the indices of the PHYs within range of
+   * sender, in PHY list order.
+   */
+  void FindCandidates (Ptr<MobilityModel> sender, double range) const;
+
+  /**
+   * A cell of the grid of the PHY positions, by x and y
+   */
+  typedef std::pair<int64_t, int64_t> Cell;
+  /**
+   * \param position a position
+   * \return the cell of the grid the position falls in
+   */
+  Cell GetCell (const Vector &position) const;
+
+  /**
+   * A transmission some sleeping PHYs were skipped for.
+   */
+  struct SkippedTx
+  {
+    Ptr<YansWifiPhy> sender;  //!< sending PHY
+    uint32_t senderIndex;     //!< index of the sending PHY in the PHY list
+    Ptr<const Packet> packet; //!< copy of the packet shared by the receivers
+    double txPowerDbm;        //!< tx power in dBm
+    WifiTxVector txVector;    //!< TXVECTOR of the packet
+    WifiPreamble preamble;    //!< preamble of the packet
+    uint8_t packetType;       //!< A-MPDU packet type
+    uint16_t channelNumber;   //!< channel number of the sender
+    Time start;               //!< start of the transmission
+    Time duration;            //!< duration of the transmission
+    Time end;                 //!< when the transmission has left the air at all the skipped PHYs
+    std::vector<uint32_t> receivers; //!< indices of the skipped PHYs yet to catch up, in PHY list order
+    std::vector<Time> delays; //!< propagation delays to the skipped PHYs, as receivers
+  };
+
+
+  PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
+  Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  mutable std::deque<SkippedTx> m_skipped; //!< recent transmissions sleeping PHYs were skipped for
+
+  bool m_culling;                      //!< whether ReceiverCulling is enabled
+  double m_cullingMarginDb;            //!< CullingMargin
+  mutable bool m_gridValid;            //!< whether m_grid holds the current positions
+  mutable double m_thresholdDbm;       //!< lowest received power a PHY acts upon, before rx gain
+  mutable double m_cellSize;           //!< side of a cell, 0 without a grid
+  mutable std::map<double, double> m_ranges;                //!< tx power -> culling range
+  mutable std::map<Cell, std::vector<uint32_t> > m_grid;    //!< indices of the PHYs in each cell
+  mutable std::vector<uint32_t> m_moving;                   //!< indices of the PHYs moving at constant velocity
+  mutable std::vector<uint32_t> m_candidates;               //!< indices of the PHYs a transmission reaches
+  mutable uint32_t m_nTraced;          //!< PHYs whose course changes are traced
+
+  bool m_pathCache;                    //!< whether PathCache is enabled
+  uint32_t m_pathCacheThreads;         //!< PathCacheThreads
+  mutable bool m_randomChecked;        //!< whether m_random holds for the current models
+  mutable bool m_random;               //!< whether the loss or delay model is random
+  bool m_nodeLocalReceive;             //!< whether NodeLocalReceive is enabled
+  mutable std::vector<PathRow> m_paths;                       //!< cached paths, by sender index
+  mutable std::vector<bool> m_mobile;                         //!< whether each PHY moves at constant velocity
+};
+
+} //namespace ns3
+
+#endif /* YANS_WIFI_CHANNEL_H */
@@ -260,27 +260,27 @@ RPSVector configureRAW (RPSVector rpslist, string RAWConfigFile)
         myfile >> NRPS;
         for (uint16_t kk=0; kk< NRPS; kk++)
         {
-            RPS *m_rps = new RPS;
-            RPS::RawAssignment *m_raw = new RPS::RawAssignment;
+            RPS m_rps;
+            RPS::RawAssignment m_raw;
             
             myfile >> Value;
-            m_raw->SetRawControl (Value);//support paged STA or not
+            m_raw.SetRawControl (Value);//support paged STA or not
             myfile >> Value;
-            m_raw->SetSlotCrossBoundary (Value);
+            m_raw.SetSlotCrossBoundary (Value);
             myfile >> Value;
-            m_raw->SetSlotFormat (Value);
+            m_raw.SetSlotFormat (Value);
             myfile >> Value;
-            m_raw->SetSlotDurationCount (Value);
+            m_raw.SetSlotDurationCount (Value);
             myfile >> Value;
-            m_raw->SetSlotNum (Value);
+            m_raw.SetSlotNum (Value);
             
             myfile >> page;
             myfile >> aid_start;
             myfile >> aid_end;
             rawinfo = (aid_end << 13) | (aid_start << 2) | page;
-            m_raw->SetRawGroup (rawinfo);
+            m_raw.SetRawGroup (rawinfo);
             
-            m_rps->SetRawAssignment(*m_raw);
+            m_rps.SetRawAssignment(m_raw);
             
             rpslist.rpsset.push_back (m_rps);
         }
@@ -316,6 +316,12 @@ int main (int argc, char *argv[])
   double poissonrate;
   bool S1g1MfieldEnabled;
   string RAWConfigFile;
+  bool RawDozeMode = false;
+  string RawGrouping;
+  bool ReceiverCulling = false;
+  bool PathCache = false;
+  bool LazyAccessTimeout = false;
+  uint32_t Threads = 0;
     
 
   CommandLine cmd;
@@ -334,11 +340,28 @@ int main (int argc, char *argv[])
   cmd.AddValue ("TrafficPath", "files path of traffic file", TrafficPath);
   cmd.AddValue ("S1g1MfieldEnabled", "S1g1MfieldEnabled", S1g1MfieldEnabled);
   cmd.AddValue ("RAWConfigFile", "RAW Config file Path", RAWConfigFile);
+  cmd.AddValue ("RawDozeMode", "stations sleep outside of their RAW slot", RawDozeMode);
+  cmd.AddValue ("RawGrouping", "RAW grouping computed each beacon: heuristic, or load (sized after TrafficPath); RAWConfigFile if empty", RawGrouping);
+  cmd.AddValue ("ReceiverCulling", "channel skips the stations too far away to sense a frame", ReceiverCulling);
+  cmd.AddValue ("PathCache", "channel computes the loss and delay between two nodes once", PathCache);
+  cmd.AddValue ("LazyAccessTimeout", "DCF restarts its access timeout at the end of each reception only", LazyAccessTimeout);
+  cmd.AddValue ("Threads", "threads of ParallelSimulatorImpl starting the receptions of a frame, and of the PathCache precompute; default simulator if 0", Threads);
 
 
   cmd.Parse (argc,argv);
 
   RngSeedManager::SetSeed (seed);
+  Config::SetDefault ("ns3::RegularWifiMac::LazyAccessTimeout", BooleanValue (LazyAccessTimeout));
+  if (Threads > 0)
+    {
+      //a frame reaches the stations within the propagation time over the
+      //diameter of the disc, far less than the PLCP preamble after which
+      //the receptions schedule their next events
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ParallelSimulatorImpl"));
+      Config::SetDefault ("ns3::ParallelSimulatorImpl::Threads", UintegerValue (Threads));
+      Config::SetDefault ("ns3::ParallelSimulatorImpl::BatchWindow",
+                          TimeValue (Seconds (2 * atof (rho.c_str ()) / 3e8)));
+    }
 
   NodeContainer wifiStaNode;
   wifiStaNode.Create (Nsta);
@@ -351,7 +374,12 @@ int main (int argc, char *argv[])
 
   YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
   phy.SetErrorRateModel ("ns3::YansErrorRateModel");
-  phy.SetChannel (channel.Create ());
+  Ptr<YansWifiChannel> wifiChannel = channel.Create ();
+  wifiChannel->SetAttribute ("ReceiverCulling", BooleanValue (ReceiverCulling));
+  wifiChannel->SetAttribute ("PathCache", BooleanValue (PathCache));
+  wifiChannel->SetAttribute ("PathCacheThreads", UintegerValue (Threads > 1 ? Threads : 1));
+  wifiChannel->SetAttribute ("NodeLocalReceive", BooleanValue (Threads > 0));
+  phy.SetChannel (wifiChannel);
   phy.Set ("ShortGuardEnabled", BooleanValue (false));
   phy.Set ("ChannelWidth", UintegerValue (bandWidth));
   phy.Set ("EnergyDetectionThreshold", DoubleValue (-110.0));
@@ -379,7 +407,8 @@ int main (int argc, char *argv[])
 
   mac.SetType ("ns3::StaWifiMac",
                 "Ssid", SsidValue (ssid),
-               "ActiveProbing", BooleanValue (false));
+               "ActiveProbing", BooleanValue (false),
+               "RawDozeMode", BooleanValue (RawDozeMode));
 
   NetDeviceContainer staDevice;
   staDevice = wifi.Install (phy, mac, wifiStaNode);
@@ -403,6 +432,23 @@ int main (int argc, char *argv[])
 
   apDevice = wifi.Install (phy, mac, wifiApNode);
 
+  if (!RawGrouping.empty ())
+    {
+      Ptr<RawGroupingStrategy> grouping;
+      if (RawGrouping == "heuristic")
+        {
+          grouping = CreateObjectWithAttributes<HeuristicRawGrouping> ("Outputpath", StringValue (folder));
+        }
+      else
+        {
+          NS_ABORT_MSG_UNLESS (RawGrouping == "load", "unknown RawGrouping " << RawGrouping);
+          grouping = CreateObjectWithAttributes<LoadRawGrouping> ("TrafficFile", StringValue (TrafficPath),
+                                                                  "PacketSize", UintegerValue (payloadSize));
+        }
+      Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+      ap->GetMac ()->SetAttribute ("RawGroupingStrategy", PointerValue (grouping));
+    }
+
   Config::Set ("/NodeList/*/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/BE_EdcaTxopN/Queue/MaxPacketNumber", UintegerValue(10));
   Config::Set ("/NodeList/*/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/BE_EdcaTxopN/Queue/MaxDelay", TimeValue (NanoSeconds (6000000000000)));
  
@@ -422,6 +468,7 @@ int main (int argc, char *argv[])
   mobilityAp.SetPositionAllocator (positionAlloc);
   mobilityAp.SetMobilityModel("ns3::ConstantPositionMobilityModel");
   mobilityAp.Install(wifiApNode);
+  wifiChannel->PrecomputePaths ();
 
 
    /* Internet stack*/
@@ -0,0 +1,817 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "parallel-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "pointer.h"
+#include "uinteger.h"
+#include "nstime.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::ParallelSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("ParallelSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ParallelSimulatorImpl);
+
+/**
+ * Wait until a condition is set, the condition staying set.
+ *
+ * \param condition the condition
+ */
+static void
+WaitForCondition (SystemCondition &condition)
+{
+  while (condition.TimedWait (1000000000))
+    {
+    }
+}
+
+/**
+ * A worker thread, which runs batch events each time it is started.
+ */
+class ParallelSimulatorImpl::Worker
+{
+public:
+  Worker (ParallelSimulatorImpl *impl)
+    : m_impl (impl),
+      m_task (0)
+  {
+    m_start.SetCondition (false);
+    m_thread = Create<SystemThread> (MakeCallback (&Worker::Loop, this));
+  }
+  void Loop (void)
+  {
+    m_id = SystemThread::Self ();
+    {
+      CriticalSection cs (m_impl->m_mutex);
+      m_impl->m_doneTasks++;
+      m_impl->m_done.SetCondition (true);
+      m_impl->m_done.Signal ();
+    }
+    while (true)
+      {
+        WaitForCondition (m_start);
+        m_start.SetCondition (false);
+        {
+          CriticalSection cs (m_impl->m_mutex);
+          if (m_impl->m_exit)
+            {
+              return;
+            }
+        }
+        m_impl->RunTasks (&m_task);
+      }
+  }
+
+  ParallelSimulatorImpl *m_impl;
+  Ptr<SystemThread> m_thread;
+  SystemThread::ThreadId m_id;
+  Task *m_task;                   //!< the batch event the thread runs
+  SystemCondition m_start;        //!< set when there is a batch to run
+};
+
+TypeId
+ParallelSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ParallelSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ParallelSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "The number of threads running the batches of node-local events, "
+                   "the main thread included. The events run one at a time if 1.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BatchWindow",
+                   "How much later than the first event of a batch its last event may be. "
+                   "The events of a batch must not schedule events before its last event.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&ParallelSimulatorImpl::m_batchWindow),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("MaxEventsPerBatchEvent",
+                   "The number of uids reserved for the events each batch event schedules.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_eventsPerTask),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+ParallelSimulatorImpl::ParallelSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = false;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = 0xffffffff;
+  m_unscheduledEvents = 0;
+  m_eventsWithContextEmpty = true;
+  m_main = SystemThread::Self ();
+  m_mainTask = 0;
+  m_batching = false;
+  m_batchEnd = 0;
+  m_nextTask = 0;
+  m_doneTasks = 0;
+  m_exit = false;
+  m_batches = 0;
+  m_batchEvents = 0;
+}
+
+ParallelSimulatorImpl::~ParallelSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ParallelSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  m_nodeLocal.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+ParallelSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+ParallelSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+ParallelSimulatorImpl::StartWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_exit = false;
+  m_doneTasks = 0;
+  m_done.SetCondition (false);
+  uint32_t started = 0;
+  while (m_workers.size () + 1 < m_threads)
+    {
+      Worker *worker = new Worker (this);
+      m_workers.push_back (worker);
+      worker->m_thread->Start ();
+      started++;
+    }
+  //wait for the workers to know their thread, which GetTask looks up
+  while (true)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        if (m_doneTasks == started)
+          {
+            break;
+          }
+        m_done.SetCondition (false);
+      }
+      WaitForCondition (m_done);
+    }
+}
+
+void
+ParallelSimulatorImpl::StopWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+  {
+    CriticalSection cs (m_mutex);
+    m_exit = true;
+  }
+  for (std::vector<Worker *>::const_iterator i = m_workers.begin (); i != m_workers.end (); i++)
+    {
+      (*i)->m_start.SetCondition (true);
+      (*i)->m_start.Signal ();
+    }
+  for (std::vector<Worker *>::const_iterator i = m_workers.begin (); i != m_workers.end (); i++)
+    {
+      (*i)->m_thread->Join ();
+      delete *i;
+    }
+  m_workers.clear ();
+}
+
+ParallelSimulatorImpl::Task *
+ParallelSimulatorImpl::GetTask (void) const
+{
+  if (!m_batching)
+    {
+      return 0;
+    }
+  if (SystemThread::Equals (m_main))
+    {
+      return m_mainTask;
+    }
+  for (std::vector<Worker *>::const_iterator i = m_workers.begin (); i != m_workers.end (); i++)
+    {
+      if (SystemThread::Equals ((*i)->m_id))
+        {
+          return (*i)->m_task;
+        }
+    }
+  return 0;
+}
+
+void
+ParallelSimulatorImpl::Insert (const Scheduler::Event &ev, bool nodeLocal)
+{
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  if (nodeLocal)
+    {
+      m_nodeLocal.insert (ev.key.m_uid);
+    }
+}
+
+void
+ParallelSimulatorImpl::ProcessOneEvent (void)
+{
+  Scheduler::Event next = m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= m_currentTs);
+  m_unscheduledEvents--;
+
+  if (!m_nodeLocal.empty () && m_nodeLocal.erase (next.key.m_uid) > 0)
+    {
+      //gather the node-local events of distinct contexts which follow
+      std::vector<Task> tasks;
+      std::set<uint32_t> contexts;
+      Task task;
+      task.event = next;
+      tasks.push_back (task);
+      contexts.insert (next.key.m_context);
+      uint64_t last = next.key.m_ts + m_batchWindow.GetTimeStep ();
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event ev = m_events->PeekNext ();
+          if (ev.key.m_ts > last
+              || m_nodeLocal.find (ev.key.m_uid) == m_nodeLocal.end ()
+              || !contexts.insert (ev.key.m_context).second)
+            {
+              break;
+            }
+          m_events->RemoveNext ();
+          m_nodeLocal.erase (ev.key.m_uid);
+          m_unscheduledEvents--;
+          task.event = ev;
+          tasks.push_back (task);
+        }
+      if (tasks.size () > 1)
+        {
+          ProcessBatch (tasks);
+          ProcessEventsWithContext ();
+          return;
+        }
+    }
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  m_currentTs = next.key.m_ts;
+  m_currentContext = next.key.m_context;
+  m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+
+  ProcessEventsWithContext ();
+}
+
+void
+ParallelSimulatorImpl::ProcessBatch (std::vector<Task> &tasks)
+{
+  NS_LOG_FUNCTION (this << tasks.size ());
+  uint32_t n = tasks.size ();
+  if ((uint64_t) m_uid + (uint64_t) n * m_eventsPerTask > 0xffffffff)
+    {
+      NS_FATAL_ERROR ("ParallelSimulatorImpl ran out of event uids");
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      tasks[i].nextUid = m_uid + i * m_eventsPerTask;
+      tasks[i].endUid = tasks[i].nextUid + m_eventsPerTask;
+    }
+  m_uid += n * m_eventsPerTask;
+  m_batches++;
+  m_batchEvents += n;
+
+  if (m_workers.size () + 1 < m_threads)
+    {
+      StartWorkers ();
+    }
+  m_done.SetCondition (false);
+  {
+    //a worker still in RunTasks may take the events as soon as they are there
+    CriticalSection cs (m_mutex);
+    m_tasks.swap (tasks);
+    m_batchEnd = m_tasks.back ().event.key.m_ts;
+    m_batching = true;
+    m_nextTask = 0;
+    m_doneTasks = 0;
+  }
+  for (std::vector<Worker *>::const_iterator i = m_workers.begin (); i != m_workers.end (); i++)
+    {
+      (*i)->m_start.SetCondition (true);
+      (*i)->m_start.Signal ();
+    }
+  RunTasks (&m_mainTask);
+  while (true)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        if (m_doneTasks == n)
+          {
+            break;
+          }
+      }
+      WaitForCondition (m_done);
+    }
+  m_batching = false;
+
+  //apply the changes to the event list in the order of the batch
+  for (std::vector<Task>::const_iterator task = m_tasks.begin (); task != m_tasks.end (); task++)
+    {
+      for (std::vector<Operation>::const_iterator op = task->operations.begin ();
+           op != task->operations.end (); op++)
+        {
+          if (op->remove)
+            {
+              m_events->Remove (op->event);
+              m_nodeLocal.erase (op->event.key.m_uid);
+              // whenever we remove an event from the event list, we have to unref it.
+              op->event.impl->Unref ();
+              m_unscheduledEvents--;
+            }
+          else
+            {
+              Insert (op->event, op->nodeLocal);
+            }
+        }
+      task->event.impl->Unref ();
+    }
+  const Scheduler::Event &last = m_tasks.back ().event;
+  m_currentTs = last.key.m_ts;
+  m_currentContext = last.key.m_context;
+  m_currentUid = last.key.m_uid;
+}
+
+void
+ParallelSimulatorImpl::RunTasks (Task **current)
+{
+  while (true)
+    {
+      uint32_t i;
+      {
+        CriticalSection cs (m_mutex);
+        if (m_nextTask == m_tasks.size ())
+          {
+            return;
+          }
+        i = m_nextTask++;
+      }
+      *current = &m_tasks[i];
+      m_tasks[i].event.impl->Invoke ();
+      *current = 0;
+      {
+        CriticalSection cs (m_mutex);
+        m_doneTasks++;
+        if (m_doneTasks == m_tasks.size ())
+          {
+            m_done.SetCondition (true);
+            m_done.Signal ();
+          }
+      }
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsFinished (void) const
+{
+  return m_events->IsEmpty () || m_stop;
+}
+
+void
+ParallelSimulatorImpl::ProcessEventsWithContext (void)
+{
+  if (m_eventsWithContextEmpty)
+    {
+      return;
+    }
+
+  // swap queues
+  EventsWithContext eventsWithContext;
+  {
+    CriticalSection cs (m_eventsWithContextMutex);
+    m_eventsWithContext.swap (eventsWithContext);
+    m_eventsWithContextEmpty = true;
+  }
+  while (!eventsWithContext.empty ())
+    {
+      EventWithContext event = eventsWithContext.front ();
+      eventsWithContext.pop_front ();
+      Scheduler::Event ev;
+      ev.impl = event.event;
+      ev.key.m_ts = m_currentTs + event.timestamp;
+      ev.key.m_context = event.context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (ev, false);
+    }
+}
+
+void
+ParallelSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  ProcessEventsWithContext ();
+  m_stop = false;
+
+  while (!m_events->IsEmpty () && !m_stop)
+    {
+      ProcessOneEvent ();
+    }
+
+  NS_LOG_INFO ("ran " << m_batchEvents << " events in " << m_batches << " batches");
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+}
+
+void
+ParallelSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+ParallelSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  Simulator::Schedule (time, &Simulator::Stop);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleFromTask (Task *task, uint32_t context, Time const &time,
+                                         EventImpl *event, bool nodeLocal)
+{
+  Time tAbsolute = time + TimeStep (task->event.key.m_ts);
+  NS_ASSERT (tAbsolute >= TimeStep (task->event.key.m_ts));
+  if ((uint64_t) tAbsolute.GetTimeStep () < m_batchEnd)
+    {
+      NS_FATAL_ERROR ("A node-local event scheduled an event before the last event of its batch");
+    }
+  if (task->nextUid == task->endUid)
+    {
+      NS_FATAL_ERROR ("A node-local event scheduled more than MaxEventsPerBatchEvent events");
+    }
+  Operation op;
+  op.event.impl = event;
+  op.event.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  op.event.key.m_context = context;
+  op.event.key.m_uid = task->nextUid;
+  op.remove = false;
+  op.nodeLocal = nodeLocal;
+  task->nextUid++;
+  task->operations.push_back (op);
+  return EventId (event, op.event.key.m_ts, op.event.key.m_context, op.event.key.m_uid);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+ParallelSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      return ScheduleFromTask (task, task->event.key.m_context, time, event, false);
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+
+  Time tAbsolute = time + TimeStep (m_currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (m_currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  Insert (ev, false);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+ParallelSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      ScheduleFromTask (task, context, time, event, false);
+    }
+  else if (SystemThread::Equals (m_main))
+    {
+      Time tAbsolute = time + TimeStep (m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (ev, false);
+    }
+  else
+    {
+      EventWithContext ev;
+      ev.context = context;
+      ev.timestamp = time.GetTimeStep ();
+      ev.event = event;
+      {
+        CriticalSection cs (m_eventsWithContextMutex);
+        m_eventsWithContext.push_back (ev);
+        m_eventsWithContextEmpty = false;
+      }
+    }
+}
+
+void
+ParallelSimulatorImpl::ScheduleNodeLocal (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      ScheduleFromTask (task, context, time, event, m_threads > 1);
+    }
+  else
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleNodeLocal Thread-unsafe invocation!");
+      Time tAbsolute = time + TimeStep (m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (ev, m_threads > 1);
+    }
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      return ScheduleFromTask (task, task->event.key.m_context, TimeStep (0), event, false);
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = m_currentTs;
+  ev.key.m_context = GetContext ();
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  Insert (ev, false);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  if (GetTask () != 0)
+    {
+      NS_FATAL_ERROR ("A node-local event called Simulator::ScheduleDestroy");
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+  EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  m_uid++;
+  return id;
+}
+
+Time
+ParallelSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      return TimeStep (task->event.key.m_ts);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+ParallelSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+ParallelSimulatorImpl::Remove (const EventId &id)
+{
+  Task *task = GetTask ();
+  if (id.GetUid () == 2)
+    {
+      if (task != 0)
+        {
+          NS_FATAL_ERROR ("A node-local event removed a destroy event");
+        }
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  event.impl->Cancel ();
+  if (task != 0)
+    {
+      //the event leaves the list after the batch
+      Operation op;
+      op.event = event;
+      op.remove = true;
+      op.nodeLocal = false;
+      task->operations.push_back (op);
+      return;
+    }
+  m_events->Remove (event);
+  m_nodeLocal.erase (event.key.m_uid);
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  m_unscheduledEvents--;
+}
+
+void
+ParallelSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  uint64_t currentTs = m_currentTs;
+  uint32_t currentUid = m_currentUid;
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      currentTs = task->event.key.m_ts;
+      currentUid = task->event.key.m_uid;
+    }
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < currentTs ||
+      (id.GetTs () == currentTs &&
+       id.GetUid () <= currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+ParallelSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+ParallelSimulatorImpl::GetContext (void) const
+{
+  Task *task = GetTask ();
+  if (task != 0)
+    {
+      return task->event.key.m_context;
+    }
+  return m_currentContext;
+}
+
+} // namespace ns3
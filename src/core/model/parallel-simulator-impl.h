@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_SIMULATOR_IMPL_H
+#define PARALLEL_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+#include "system-condition.h"
+#include "ptr.h"
+
+#include <list>
+#include <set>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::ParallelSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * A single process simulator implementation which runs the node-local
+ * events of distinct nodes on a pool of threads.
+ *
+ * The events scheduled with Simulator::ScheduleNodeLocal are declared to
+ * touch the state of their node only.  When the next events of the event
+ * list are node-local events of distinct contexts, no later than
+ * BatchWindow after the first of them, they form a batch, whose events
+ * run concurrently on the main thread and the Threads - 1 worker threads.
+ * The batch stops at the first event which is not node-local, or whose
+ * context is already in the batch, so that the events of a batch are
+ * those the default implementation would run next, in that order.
+ *
+ * The results do not depend on the number of threads:
+ *  - each event of a batch sees Simulator::Now and Simulator::GetContext
+ *    as if it ran alone;
+ *  - the events a batch event schedules get uids from a range reserved
+ *    for it, MaxEventsPerBatchEvent uids after those of the previous
+ *    event of the batch, so that they are ordered as the default
+ *    implementation orders them;
+ *  - they enter the event list, and the events a batch event removes
+ *    leave it, once the batch is over, in the order of the batch.
+ *
+ * A batch event must not schedule an event before the last event of its
+ * batch, which would have run in between, nor ScheduleDestroy one.
+ * Trace sinks and logs called from node-local events run on the worker
+ * threads: their output may interleave.
+ *
+ * The uids reserved for a batch are not reused: a batch of n events uses
+ * n times MaxEventsPerBatchEvent of the 2^32 uids of a simulation.
+ */
+class ParallelSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  ParallelSimulatorImpl ();
+  ~ParallelSimulatorImpl ();
+
+  // Inherited from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual void ScheduleNodeLocal (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An insertion into, or a removal from, the event list */
+  struct Operation
+  {
+    Scheduler::Event event;
+    bool remove;
+    bool nodeLocal;            //!< whether an inserted event is node-local
+  };
+
+  /** An event of the current batch */
+  struct Task
+  {
+    Scheduler::Event event;
+    uint32_t nextUid;          //!< the uid of the next event it schedules
+    uint32_t endUid;           //!< the end of the uids reserved for it
+    std::vector<Operation> operations;
+  };
+
+  class Worker;
+
+  /** Process the next event of the list, or the batch it starts. */
+  void ProcessOneEvent (void);
+  /** Insert the events scheduled from other threads. */
+  void ProcessEventsWithContext (void);
+  /**
+   * Run a batch on all the threads, then apply the operations of its
+   * events on the event list.
+   *
+   * \param tasks the events of the batch, in the order of the list
+   */
+  void ProcessBatch (std::vector<Task> &tasks);
+  /**
+   * Run the events of the current batch not taken by another thread yet.
+   *
+   * \param current where to keep the task of the calling thread
+   */
+  void RunTasks (Task **current);
+  /**
+   * \return the batch event the calling thread runs, 0 if none
+   */
+  Task * GetTask (void) const;
+  /**
+   * Schedule an event from a batch event.
+   *
+   * \param task the batch event
+   * \param context the context of the event
+   * \param time the delay until the event expires
+   * \param event the event to schedule
+   * \param nodeLocal whether the event is node-local
+   * \return the id of the event
+   */
+  EventId ScheduleFromTask (Task *task, uint32_t context, Time const &time,
+                            EventImpl *event, bool nodeLocal);
+  /**
+   * Insert an event into the event list.
+   *
+   * \param ev the event
+   * \param nodeLocal whether the event is node-local
+   */
+  void Insert (const Scheduler::Event &ev, bool nodeLocal);
+  void StartWorkers (void);
+  void StopWorkers (void);
+
+  struct EventWithContext {
+    uint32_t context;
+    uint64_t timestamp;
+    EventImpl *event;
+  };
+  typedef std::list<struct EventWithContext> EventsWithContext;
+  EventsWithContext m_eventsWithContext;
+  bool m_eventsWithContextEmpty;
+  SystemMutex m_eventsWithContextMutex;
+
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;
+  bool m_stop;
+  Ptr<Scheduler> m_events;
+
+  uint32_t m_uid;
+  uint32_t m_currentUid;
+  uint64_t m_currentTs;
+  uint32_t m_currentContext;
+  // number of events that have been inserted but not yet scheduled,
+  // not counting the "destroy" events; this is used for validation
+  int m_unscheduledEvents;
+  SystemThread::ThreadId m_main;
+
+  std::set<uint32_t> m_nodeLocal;   //!< the uids of the node-local events of the list
+
+  uint32_t m_threads;
+  Time m_batchWindow;
+  uint32_t m_eventsPerTask;
+
+  std::vector<Worker *> m_workers;
+  std::vector<Task> m_tasks;        //!< the current batch
+  Task *m_mainTask;                 //!< the batch event the main thread runs
+  bool m_batching;
+  uint64_t m_batchEnd;              //!< the timestamp of the last batch event
+  SystemMutex m_mutex;              //!< protects the counters below
+  uint32_t m_nextTask;
+  uint32_t m_doneTasks;
+  bool m_exit;
+  SystemCondition m_done;           //!< set when all the batch events ran
+
+  uint64_t m_batches;
+  uint64_t m_batchEvents;
+};
+
+} // namespace ns3
+
+#endif /* PARALLEL_SIMULATOR_IMPL_H */
@@ -42,4 +42,10 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+void
+SimulatorImpl::ScheduleNodeLocal (uint32_t context, Time const &time, EventImpl *event)
+{
+  ScheduleWithContext (context, time, event);
+}
+
 } // namespace ns3
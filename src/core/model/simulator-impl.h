@@ -111,6 +111,20 @@ public:
    * \returns A unique identifier for the newly-scheduled event.
    */
   virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event) = 0;
+  /**
+   * Schedule a future event execution in the context of a node, declaring
+   * that the event reads and writes the state of that node only.
+   *
+   * Such an event must not touch the objects of other nodes, global
+   * state, or packets it shares with other nodes, so that an
+   * implementation may run it concurrently with the node-local events of
+   * other nodes.  The base implementation calls ScheduleWithContext().
+   *
+   * \param context Event context, the id of the node.
+   * \param time Delay until the event expires.
+   * \param event The event to schedule.
+   */
+  virtual void ScheduleNodeLocal (uint32_t context, Time const &time, EventImpl *event);
   /**
    * Schedule an event to run at the current virtual time.
    *
@@ -251,6 +251,11 @@ Simulator::ScheduleWithContext (uint32_t context, const Time &time, EventImpl *i
 {
   return GetImpl ()->ScheduleWithContext (context, time, impl);
 }
+void
+Simulator::ScheduleNodeLocal (uint32_t context, const Time &time, EventImpl *impl)
+{
+  return GetImpl ()->ScheduleNodeLocal (context, time, impl);
+}
 EventId
 Simulator::ScheduleDestroy (const Ptr<EventImpl> &ev)
 {
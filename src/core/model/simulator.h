@@ -755,6 +755,9 @@ public:
    */
   static void ScheduleWithContext (uint32_t context, const Time &time, EventImpl *event);
 
+  /** \copydoc SimulatorImpl::ScheduleNodeLocal */
+  static void ScheduleNodeLocal (uint32_t context, const Time &time, EventImpl *event);
+
   /** \copydoc SimulatorImpl::ScheduleDestroy */
   static EventId ScheduleDestroy (const Ptr<EventImpl> &event);
 
@@ -26,10 +26,14 @@
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
 
 #include <ctime>
 #include <list>
 #include <utility>
+#include <vector>
+#include <sstream>
 
 using namespace ns3;
 
@@ -225,6 +229,175 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * Node-local events of several nodes, in the same batches of
+ * ParallelSimulatorImpl, schedule, remove and cancel events of their
+ * nodes: the events must run in the same order, at the same times, as
+ * with DefaultSimulatorImpl.
+ */
+class ParallelSimulatorOrderTestCase : public TestCase
+{
+public:
+  ParallelSimulatorOrderTestCase (unsigned int threads, Time window);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the scenario with the current simulator implementation.
+   *
+   * \param log the events which are not node-local, in the order they ran
+   * \param nodeLogs the node-local events of each node
+   */
+  void RunScenario (std::vector<std::string> &log, std::vector<std::vector<std::string> > &nodeLogs);
+  void Send (unsigned int frame);
+  void Receive (unsigned int node, unsigned int frame);
+  void EndReceive (unsigned int node, unsigned int frame);
+  void Timeout (unsigned int node);
+  /**
+   * \param what the name of the event
+   * \param node the node of the event
+   * \param frame the frame of the event
+   * \return a line of the logs
+   */
+  std::string Entry (std::string what, unsigned int node, unsigned int frame) const;
+
+  unsigned int m_threads;
+  Time m_window;
+  std::vector<std::string> *m_log;
+  std::vector<std::vector<std::string> > *m_nodeLogs;
+  std::vector<EventId> m_timeouts;
+  std::string m_error;
+};
+
+static const unsigned int g_orderNodes = 12;
+static const unsigned int g_orderFrames = 20;
+
+ParallelSimulatorOrderTestCase::ParallelSimulatorOrderTestCase (unsigned int threads, Time window)
+  : TestCase ("Check that ParallelSimulatorImpl runs the node-local events in order with "
+              + std::string (threads > 2 ? "many threads" : "2 threads")
+              + (window.IsZero () ? "" : " and a batch window")),
+    m_threads (threads),
+    m_window (window)
+{
+}
+
+std::string
+ParallelSimulatorOrderTestCase::Entry (std::string what, unsigned int node, unsigned int frame) const
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << what << " " << node << " " << frame
+      << " " << Simulator::GetContext ();
+  return oss.str ();
+}
+
+void
+ParallelSimulatorOrderTestCase::Send (unsigned int frame)
+{
+  m_log->push_back (Entry ("send", 0, frame));
+  for (unsigned int node = 0; node < g_orderNodes; node++)
+    {
+      //with a window, the frame reaches the nodes at different times
+      Time delay = m_window.IsZero () ? Time (0) : NanoSeconds ((node * 7 + frame) % 3);
+      Simulator::ScheduleNodeLocal (node, MicroSeconds (1) + delay,
+                                    MakeEvent (&ParallelSimulatorOrderTestCase::Receive, this, node, frame));
+    }
+}
+
+void
+ParallelSimulatorOrderTestCase::Receive (unsigned int node, unsigned int frame)
+{
+  (*m_nodeLogs)[node].push_back (Entry ("receive", node, frame));
+  if (Simulator::GetContext () != node)
+    {
+      m_error = "Bad context";
+    }
+  EventId &timeout = m_timeouts[node];
+  if (node % 3 == 0)
+    {
+      Simulator::Remove (timeout);
+    }
+  else if (node % 3 == 1)
+    {
+      timeout.Cancel ();
+    }
+  //the nodes receive more frames than they send timeouts: some run
+  if (frame % 4 != 3)
+    {
+      timeout = Simulator::Schedule (MicroSeconds (30 + node % 4), &ParallelSimulatorOrderTestCase::Timeout, this, node);
+    }
+  if (timeout.IsExpired () != (frame % 4 == 3 && node % 3 != 2))
+    {
+      m_error = "Bad expiry";
+    }
+  //several nodes end their receptions together
+  Simulator::Schedule (MicroSeconds (5 + node % 2), &ParallelSimulatorOrderTestCase::EndReceive, this, node, frame);
+  if (m_window.IsZero ())
+    {
+      Simulator::ScheduleNow (&ParallelSimulatorOrderTestCase::EndReceive, this, node, frame + 1000);
+    }
+}
+
+void
+ParallelSimulatorOrderTestCase::EndReceive (unsigned int node, unsigned int frame)
+{
+  m_log->push_back (Entry ("end", node, frame));
+  if (node == g_orderNodes - 1 && frame + 1 < g_orderFrames)
+    {
+      Send (frame + 1);
+    }
+}
+
+void
+ParallelSimulatorOrderTestCase::Timeout (unsigned int node)
+{
+  m_log->push_back (Entry ("timeout", node, 0));
+}
+
+void
+ParallelSimulatorOrderTestCase::RunScenario (std::vector<std::string> &log,
+                                             std::vector<std::vector<std::string> > &nodeLogs)
+{
+  m_log = &log;
+  m_nodeLogs = &nodeLogs;
+  nodeLogs.resize (g_orderNodes);
+  m_timeouts.clear ();
+  m_timeouts.resize (g_orderNodes);
+  Simulator::Schedule (MicroSeconds (10), &ParallelSimulatorOrderTestCase::Send, this, 0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+ParallelSimulatorOrderTestCase::DoRun (void)
+{
+  m_error = "";
+  std::vector<std::string> log;
+  std::vector<std::vector<std::string> > nodeLogs;
+  RunScenario (log, nodeLogs);
+
+  Config::SetDefault ("ns3::ParallelSimulatorImpl::Threads", UintegerValue (m_threads));
+  Config::SetDefault ("ns3::ParallelSimulatorImpl::BatchWindow", TimeValue (m_window));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::ParallelSimulatorImpl"));
+  std::vector<std::string> parallelLog;
+  std::vector<std::vector<std::string> > parallelNodeLogs;
+  RunScenario (parallelLog, parallelNodeLogs);
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_error.empty (), true, m_error.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (parallelLog.size (), log.size (), "Not the same number of events");
+  for (unsigned int i = 0; i < log.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallelLog[i], log[i], "Not the same event at " << i);
+    }
+  for (unsigned int node = 0; node < g_orderNodes; node++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (nodeLogs[node].size (), g_orderFrames, "Missed receptions");
+      NS_TEST_ASSERT_MSG_EQ ((parallelNodeLogs[node] == nodeLogs[node]), true,
+                             "Not the same receptions at node " << node);
+    }
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -235,7 +408,8 @@ public:
 #ifdef HAVE_RT
       "ns3::RealtimeSimulatorImpl",
 #endif
-      "ns3::DefaultSimulatorImpl"
+      "ns3::DefaultSimulatorImpl",
+      "ns3::ParallelSimulatorImpl"
     };
     std::string schedulerTypes[] = {
       "ns3::ListScheduler",
@@ -262,5 +436,8 @@ public:
               }
           }
       }
+    AddTestCase (new ParallelSimulatorOrderTestCase (2, Time (0)), TestCase::QUICK);
+    AddTestCase (new ParallelSimulatorOrderTestCase (8, Time (0)), TestCase::QUICK);
+    AddTestCase (new ParallelSimulatorOrderTestCase (8, NanoSeconds (2)), TestCase::QUICK);
   }
 } g_threadedSimulatorTestSuite;
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the propagation of a Walker constellation of
+// --planes planes of --perPlane PolarSatPosition satellites, at 550 km and
+// 53 degrees, every --interval seconds for --steps steps.
+//
+// The positions are computed once by a GetCoord on each satellite, as
+// spider-test does, and once by a SatConstellation::Propagate on all of
+// them.  The wall clock time per satellite and step is reported for both.
+//
+// ./waf --run "sat-constellation-bench --planes=72 --perPlane=22"
+// ./waf --run "sat-constellation-bench --planes=100 --perPlane=100 --steps=10"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/satposition.h"
+#include "ns3/satconstellation.h"
+
+using namespace ns3;
+
+static double g_sum;
+
+static void
+StepEach (std::vector<PolarSatPosition> *satellites)
+{
+  for (std::vector<PolarSatPosition>::iterator it = satellites->begin (); it != satellites->end (); it++)
+    {
+      coordinate current = it->GetCoord ();
+      g_sum += current.theta + current.phi;
+    }
+}
+
+static void
+StepConstellation (Ptr<SatConstellation> constellation)
+{
+  constellation->Propagate (Simulator::Now ());
+  for (uint32_t i = 0; i < constellation->GetN (); i++)
+    {
+      coordinate current = constellation->GetCoord (i);
+      g_sum += current.theta + current.phi;
+    }
+}
+
+static int64_t
+Run (std::vector<PolarSatPosition> *satellites, Ptr<SatConstellation> constellation,
+     uint32_t steps, double interval, double &sum)
+{
+  for (uint32_t i = 0; i < steps; i++)
+    {
+      if (constellation)
+        {
+          Simulator::Schedule (Seconds (i * interval), &StepConstellation, constellation);
+        }
+      else
+        {
+          Simulator::Schedule (Seconds (i * interval), &StepEach, satellites);
+        }
+    }
+  g_sum = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  sum = g_sum;
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t planes = 72;
+  uint32_t perPlane = 22;
+  uint32_t steps = 100;
+  double interval = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("perPlane", "Number of satellites in each plane", perPlane);
+  cmd.AddValue ("steps", "Number of steps", steps);
+  cmd.AddValue ("interval", "Time between two steps, in seconds", interval);
+  cmd.Parse (argc, argv);
+
+  std::vector<PolarSatPosition> satellites;
+  satellites.reserve (planes * perPlane);
+  Ptr<SatConstellation> constellation = CreateObject<SatConstellation> ();
+  for (uint32_t p = 0; p < planes; p++)
+    {
+      for (uint32_t s = 0; s < perPlane; s++)
+        {
+          double lon = 360.0 * p / planes - 180;
+          double alpha = 360.0 * s / perPlane;
+          satellites.push_back (PolarSatPosition (550, 53, lon, alpha, p));
+          constellation->Add (satellites.back ());
+        }
+    }
+
+  double eachSum;
+  double constellationSum;
+  int64_t eachMs = Run (&satellites, 0, steps, interval, eachSum);
+  int64_t constellationMs = Run (0, constellation, steps, interval, constellationSum);
+
+  double n = (double) satellites.size () * steps;
+  std::cout << std::setw (12) << "satellites" << std::setw (14) << "each ns"
+            << std::setw (18) << "constellation ns" << std::setw (12) << "same" << std::endl;
+  std::cout << std::setw (12) << satellites.size () << std::fixed << std::setprecision (1)
+            << std::setw (14) << eachMs * 1e6 / n
+            << std::setw (18) << constellationMs * 1e6 / n
+            << std::setw (12) << (eachSum == constellationSum ? "yes" : "no") << std::endl;
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Benchmark of SatContactPlan on a Walker constellation of --planes planes
+// of --perPlane satellites at 550 km and 53 degrees, with --terminals
+// terminals spread over the Earth, over --hours hours.
+//
+// The contact plan, with a --step step and a 1 ms tolerance, is compared
+// with polling SatVisibility every --poll seconds, which times the link
+// transitions within --poll seconds: the wall clock time, the simulator
+// events of each, and the transitions found are reported.
+//
+// The plan only finds the contacts, and the gaps within a contact, which
+// span one of its steps.  The bench checks that every transition the
+// polling finds and the plan misses belongs to a contact or a gap no
+// longer than --step, which should be a multiple of --poll.
+//
+// ./waf --run "sat-contact-plan-bench --hours=2 --poll=1"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <utility>
+
+#include "ns3/core-module.h"
+#include "ns3/satposition.h"
+#include "ns3/satconstellation.h"
+#include "ns3/satvisibility.h"
+#include "ns3/satcontactplan.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t planes = 24;
+  uint32_t perPlane = 12;
+  uint32_t nTerminals = 50;
+  double hours = 1;
+  double step = 30;
+  double poll = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("perPlane", "Number of satellites in each plane", perPlane);
+  cmd.AddValue ("terminals", "Number of terminals", nTerminals);
+  cmd.AddValue ("hours", "Horizon, in hours", hours);
+  cmd.AddValue ("step", "Step of the contact plan, in seconds", step);
+  cmd.AddValue ("poll", "Interval of the polling, in seconds", poll);
+  cmd.Parse (argc, argv);
+
+  Ptr<SatConstellation> constellation = CreateObject<SatConstellation> ();
+  for (uint32_t p = 0; p < planes; p++)
+    {
+      for (uint32_t s = 0; s < perPlane; s++)
+        {
+          constellation->Add (PolarSatPosition (550, 53, 360.0 * p / planes - 180, 360.0 * s / perPlane, p));
+        }
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < nTerminals; i++)
+    {
+      TermSatPosition terminal;
+      terminal.set (RAD_TO_DEG (asin (rng->GetValue (-1, 1))), rng->GetValue (-180, 180));
+      constellation->Add (terminal);
+    }
+  Time stop = Seconds (hours * 3600);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<SatContactPlan> plan = CreateObject<SatContactPlan> ();
+  plan->SetAttribute ("Step", TimeValue (Seconds (step)));
+  plan->SetAttribute ("Tolerance", TimeValue (MilliSeconds (1)));
+  plan->SetConstellation (constellation);
+  plan->Compute (Seconds (0), stop);
+  int64_t planMs = clock.End ();
+
+  clock.Start ();
+  Ptr<SatVisibility> visibility = CreateObject<SatVisibility> ();
+  visibility->SetConstellation (constellation);
+  uint64_t polls = 0;
+  uint64_t transitions = 0;
+  uint64_t shorter = 0;
+  std::map<std::pair<uint32_t, uint32_t>, Time> lastChange;
+  for (Time t = Seconds (0); t <= stop; t += Seconds (poll))
+    {
+      visibility->Update (t);
+      const std::vector<SatVisibility::Change> &changes = visibility->GetChanges ();
+      for (std::vector<SatVisibility::Change>::const_iterator it = changes.begin (); it != changes.end (); it++)
+        {
+          std::pair<uint32_t, uint32_t> link (it->first, it->second);
+          std::map<std::pair<uint32_t, uint32_t>, Time>::iterator last = lastChange.find (link);
+          if (last != lastChange.end () && t - last->second <= Seconds (step))
+            {
+              shorter++;
+            }
+          lastChange[link] = t;
+        }
+      transitions += changes.size ();
+      polls++;
+    }
+  int64_t pollMs = clock.End ();
+
+  std::cout << std::setw (14) << "method" << std::setw (10) << "ms" << std::setw (12) << "events"
+            << std::setw (14) << "transitions" << std::setw (12) << "accuracy" << std::endl;
+  std::cout << std::setw (14) << "contact plan" << std::setw (10) << planMs
+            << std::setw (12) << plan->GetNTransitions ()
+            << std::setw (14) << plan->GetNTransitions () << std::setw (12) << "1 ms" << std::endl;
+  std::ostringstream accuracy;
+  accuracy << poll << " s";
+  std::cout << std::setw (14) << "polling" << std::setw (10) << pollMs
+            << std::setw (12) << polls
+            << std::setw (14) << transitions << std::setw (12) << accuracy.str () << std::endl;
+  std::cout << shorter << " contacts or gaps no longer than the step of the plan" << std::endl;
+
+  //a missed contact or gap takes its two transitions with it
+  NS_ABORT_MSG_UNLESS (plan->GetNTransitions () <= transitions
+                       && transitions - plan->GetNTransitions () <= 2 * shorter,
+                       "the plan misses transitions of contacts or gaps longer than its step");
+  return 0;
+}
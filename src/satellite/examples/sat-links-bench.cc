@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Benchmark of SatVisibility on a Walker constellation of --planes planes
+// of --perPlane satellites at 550 km and 53 degrees, with --terminals
+// terminals spread over the Earth, updated every --interval seconds for
+// --steps steps.
+//
+// The wall clock time per update is reported for a check of all the
+// pairs, for the latitude bands, and for the bands on --threads threads,
+// with the pairs checked, the links and the link changes per update.
+//
+// ./waf --run "sat-links-bench --planes=72 --perPlane=22 --threads=4"
+//
+
+#include <iostream>
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/satposition.h"
+#include "ns3/satconstellation.h"
+#include "ns3/satvisibility.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t planes = 72;
+  uint32_t perPlane = 22;
+  uint32_t nTerminals = 100;
+  uint32_t steps = 10;
+  double interval = 10;
+  uint32_t threads = 4;
+
+  CommandLine cmd;
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("perPlane", "Number of satellites in each plane", perPlane);
+  cmd.AddValue ("terminals", "Number of terminals", nTerminals);
+  cmd.AddValue ("steps", "Number of updates", steps);
+  cmd.AddValue ("interval", "Time between two updates, in seconds", interval);
+  cmd.AddValue ("threads", "Number of threads of the last run", threads);
+  cmd.Parse (argc, argv);
+
+  Ptr<SatConstellation> constellation = CreateObject<SatConstellation> ();
+  for (uint32_t p = 0; p < planes; p++)
+    {
+      for (uint32_t s = 0; s < perPlane; s++)
+        {
+          constellation->Add (PolarSatPosition (550, 53, 360.0 * p / planes - 180, 360.0 * s / perPlane, p));
+        }
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < nTerminals; i++)
+    {
+      TermSatPosition terminal;
+      terminal.set (RAD_TO_DEG (asin (rng->GetValue (-1, 1))), rng->GetValue (-180, 180));
+      constellation->Add (terminal);
+    }
+
+  std::cout << std::setw (16) << "run" << std::setw (12) << "ms/update" << std::setw (14) << "checked"
+            << std::setw (10) << "links" << std::setw (10) << "changes" << std::endl;
+  for (uint32_t run = 0; run < 3; run++)
+    {
+      Ptr<SatVisibility> visibility = CreateObject<SatVisibility> ();
+      visibility->SetAttribute ("Pruning", BooleanValue (run > 0));
+      visibility->SetAttribute ("Threads", UintegerValue (run == 2 ? threads : 1));
+      visibility->SetConstellation (constellation);
+      uint64_t checked = 0;
+      uint64_t links = 0;
+      uint64_t changes = 0;
+      SystemWallClockMs clock;
+      clock.Start ();
+      for (uint32_t i = 0; i < steps; i++)
+        {
+          visibility->Update (Seconds (i * interval));
+          checked += visibility->GetChecked ();
+          links += visibility->GetLinks ().size ();
+          changes += i > 0 ? visibility->GetChanges ().size () : 0;
+        }
+      int64_t elapsed = clock.End ();
+      std::ostringstream name;
+      name << (run == 0 ? "all pairs" : "bands") << ", " << (run == 2 ? threads : 1) << " thr";
+      std::cout << std::setw (16) << name.str () << std::fixed << std::setprecision (1)
+                << std::setw (12) << (double) elapsed / steps
+                << std::setw (14) << checked / steps
+                << std::setw (10) << links / steps
+                << std::setw (10) << (steps > 1 ? changes / (steps - 1) : 0) << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the pairwise visibility checks of SatGeometry.
+//
+// --satellites satellites are drawn between 500 and 1500 km, and
+// --terminals terminals on the ground.  Every pair of satellites is checked
+// with are_satellites_mutually_visible and every satellite and terminal
+// with check_elevation, --rounds times, on the spherical coordinates and
+// on the Cartesian positions.  The checks per second are reported for
+// both, with the number of checks whose outcomes differ.
+//
+// ./waf --run "sat-visibility-bench --satellites=1000"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/satgeometry.h"
+
+using namespace ns3;
+
+template <typename T>
+static int64_t
+Run (const std::vector<T> &satellites, const std::vector<T> &terminals,
+     uint32_t rounds, std::vector<bool> &outcomes)
+{
+  outcomes.clear ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t round = 0; round < rounds; round++)
+    {
+      for (uint32_t i = 0; i < satellites.size (); i++)
+        {
+          for (uint32_t j = i + 1; j < satellites.size (); j++)
+            {
+              bool visible = SatGeometry::are_satellites_mutually_visible (satellites[i], satellites[j]);
+              if (round == 0)
+                {
+                  outcomes.push_back (visible);
+                }
+            }
+          for (uint32_t j = 0; j < terminals.size (); j++)
+            {
+              bool visible = SatGeometry::check_elevation (satellites[i], terminals[j], DEG_TO_RAD (10)) > 0;
+              if (round == 0)
+                {
+                  outcomes.push_back (visible);
+                }
+            }
+        }
+    }
+  return clock.End ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nSatellites = 1000;
+  uint32_t nTerminals = 100;
+  uint32_t rounds = 5;
+
+  CommandLine cmd;
+  cmd.AddValue ("satellites", "Number of satellites", nSatellites);
+  cmd.AddValue ("terminals", "Number of terminals", nTerminals);
+  cmd.AddValue ("rounds", "Number of times all the pairs are checked", rounds);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<coordinate> satellites;
+  std::vector<coordinate> terminals;
+  for (uint32_t i = 0; i < nSatellites + nTerminals; i++)
+    {
+      coordinate point;
+      point.r = EARTH_RADIUS + (i < nSatellites ? rng->GetValue (500, 1500) : 0);
+      point.theta = rng->GetValue (0, PI);
+      point.phi = rng->GetValue (0, 2 * PI);
+      (i < nSatellites ? satellites : terminals).push_back (point);
+    }
+  std::vector<cartesian> cartesianSatellites;
+  std::vector<cartesian> cartesianTerminals;
+  for (uint32_t i = 0; i < satellites.size (); i++)
+    {
+      cartesianSatellites.push_back (SatGeometry::to_cartesian (satellites[i]));
+    }
+  for (uint32_t i = 0; i < terminals.size (); i++)
+    {
+      cartesianTerminals.push_back (SatGeometry::to_cartesian (terminals[i]));
+    }
+
+  std::vector<bool> sphericalOutcomes;
+  std::vector<bool> cartesianOutcomes;
+  int64_t sphericalMs = Run (satellites, terminals, rounds, sphericalOutcomes);
+  int64_t cartesianMs = Run (cartesianSatellites, cartesianTerminals, rounds, cartesianOutcomes);
+  uint32_t differ = 0;
+  for (uint32_t i = 0; i < sphericalOutcomes.size (); i++)
+    {
+      differ += (sphericalOutcomes[i] != cartesianOutcomes[i]);
+    }
+
+  double checks = (double) sphericalOutcomes.size () * rounds;
+  std::cout << std::setw (12) << "checks" << std::setw (16) << "spherical M/s"
+            << std::setw (16) << "cartesian M/s" << std::setw (10) << "differ" << std::endl;
+  std::cout << std::setw (12) << sphericalOutcomes.size () << std::fixed << std::setprecision (2)
+            << std::setw (16) << checks / sphericalMs / 1e3
+            << std::setw (16) << checks / cartesianMs / 1e3
+            << std::setw (10) << differ << std::endl;
+  return 0;
+}
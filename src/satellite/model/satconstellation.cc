@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "satconstellation.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include <math.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatConstellation");
+
+NS_OBJECT_ENSURE_REGISTERED (SatConstellation);
+
+TypeId
+SatConstellation::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatConstellation")
+    .SetParent<Object> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatConstellation> ()
+  ;
+  return tid;
+}
+
+SatConstellation::SatConstellation ()
+  : m_time (Seconds (0))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatConstellation::~SatConstellation ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+SatConstellation::Add (const PolarSatPosition &position)
+{
+  return Add (POLAR, position, position.inclination_);
+}
+
+uint32_t
+SatConstellation::Add (const SunSynStaPosition &position)
+{
+  return Add (SUN_SYN, position, position.inclination_);
+}
+
+uint32_t
+SatConstellation::Add (const GeoSatPosition &position)
+{
+  return Add (GEO, position, 0);
+}
+
+uint32_t
+SatConstellation::Add (const TermSatPosition &position)
+{
+  return Add (TERM, position, 0);
+}
+
+uint32_t
+SatConstellation::Add (enum Kind kind, const SatPosition &position, double inclination)
+{
+  NS_LOG_FUNCTION (this << kind << inclination);
+  Block &block = m_blocks[kind];
+  m_kinds.push_back (kind);
+  m_slots.push_back (block.r.size ());
+  block.r.push_back (position.initialCoord.r);
+  block.theta0.push_back (position.initialCoord.theta);
+  block.phi0.push_back (position.initialCoord.phi);
+  block.sinInc.push_back (sin (inclination));
+  block.cosInc.push_back (cos (inclination));
+  block.period.push_back (position.staPeriod);
+  block.initial.push_back (position.initialTime.GetTimeStep ());
+  block.elapsed.push_back (0);
+  block.theta.push_back (position.initialCoord.theta);
+  block.phi.push_back (position.initialCoord.phi);
+  block.x.push_back (0);
+  block.y.push_back (0);
+  block.z.push_back (0);
+  return m_kinds.size () - 1;
+}
+
+uint32_t
+SatConstellation::GetN (void) const
+{
+  return m_kinds.size ();
+}
+
+bool
+SatConstellation::IsTerminal (uint32_t i) const
+{
+  NS_ASSERT (i < m_kinds.size ());
+  return m_kinds[i] == TERM;
+}
+
+void
+SatConstellation::Propagate (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  m_time = time;
+  for (uint32_t kind = 0; kind < N_KINDS; kind++)
+    {
+      SetElapsed (m_blocks[kind], time);
+    }
+  PropagatePolar (m_blocks[POLAR]);
+  PropagateSunSyn (m_blocks[SUN_SYN]);
+  PropagateEquatorial (m_blocks[GEO], true);
+  PropagateEquatorial (m_blocks[TERM], false);
+  for (uint32_t kind = 0; kind < N_KINDS; kind++)
+    {
+      ToCartesian (m_blocks[kind]);
+    }
+}
+
+Time
+SatConstellation::GetTime (void) const
+{
+  return m_time;
+}
+
+coordinate
+SatConstellation::GetCoord (uint32_t i) const
+{
+  NS_ASSERT (i < m_kinds.size ());
+  const Block &block = m_blocks[m_kinds[i]];
+  uint32_t slot = m_slots[i];
+  coordinate current;
+  current.r = block.r[slot];
+  current.theta = block.theta[slot];
+  current.phi = block.phi[slot];
+  return current;
+}
+
+cartesian
+SatConstellation::GetCartesian (uint32_t i) const
+{
+  NS_ASSERT (i < m_kinds.size ());
+  const Block &block = m_blocks[m_kinds[i]];
+  uint32_t slot = m_slots[i];
+  cartesian current;
+  current.x = block.x[slot];
+  current.y = block.y[slot];
+  current.z = block.z[slot];
+  return current;
+}
+
+void
+SatConstellation::SetElapsed (Block &block, Time time)
+{
+  int64_t now = time.GetTimeStep ();
+  uint32_t n = block.r.size ();
+  //the orbits of a constellation usually share their initial time
+  int64_t last = 0;
+  double lastElapsed = Time (now).GetSeconds ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (block.initial[i] != last)
+        {
+          last = block.initial[i];
+          lastElapsed = Time (now - last).GetSeconds ();
+        }
+      block.elapsed[i] = lastElapsed;
+    }
+}
+
+//The functions below are PolarSatPosition::GetCoord and its siblings,
+//with the same expressions so that they give the same results.
+
+static inline void
+PolarCoord (double elapsed, double period, double theta0, double phi0,
+            double sinInc, double cosInc, double &theta, double &phi)
+{
+  double partial = fmod (elapsed, period) / period * 2 * PI;
+  double thetaCur = fmod (theta0 + partial, 2 * PI);
+  theta = PI / 2 - asin (sinInc * sin (thetaCur));
+  double phiNew = atan (cosInc * tan (thetaCur)) + phi0;
+  if (thetaCur > PI / 2 && thetaCur < 3 * PI / 2)
+    {
+      phiNew += PI;
+    }
+  phi = fmod (phiNew + 2 * PI, 2 * PI);
+}
+
+static inline void
+SunSynCoord (double elapsed, double period, double theta0, double phi0,
+             double sinInc, double cosInc, double &theta, double &phi)
+{
+  double partial = fmod (elapsed, period) / period * 2 * PI;
+  double thetaIncr = fmod (partial, 2 * PI);
+  theta = PI / 2 - asin (sinInc * sin (thetaIncr) + sin (theta0));
+  double phiNew = atan (cosInc * tan (thetaIncr)) + phi0;
+  if (thetaIncr > PI / 2 && thetaIncr < 3 * PI / 2)
+    {
+      phiNew += PI;
+    }
+  phi = fmod (phiNew + 2 * PI, 2 * PI);
+}
+
+static inline double
+EquatorialPhi (double elapsed, double period, double phi0, bool wrap)
+{
+  double partial = (wrap ? fmod (elapsed, period) : elapsed) / period * 2 * PI;
+  return fmod (phi0 + partial, 2 * PI);
+}
+
+void
+SatConstellation::PropagatePolar (Block &block)
+{
+  uint32_t n = block.r.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      PolarCoord (block.elapsed[i], block.period[i], block.theta0[i], block.phi0[i],
+                  block.sinInc[i], block.cosInc[i], block.theta[i], block.phi[i]);
+    }
+}
+
+void
+SatConstellation::PropagateSunSyn (Block &block)
+{
+  uint32_t n = block.r.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SunSynCoord (block.elapsed[i], block.period[i], block.theta0[i], block.phi0[i],
+                   block.sinInc[i], block.cosInc[i], block.theta[i], block.phi[i]);
+    }
+}
+
+void
+SatConstellation::PropagateEquatorial (Block &block, bool wrap)
+{
+  uint32_t n = block.r.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      block.phi[i] = EquatorialPhi (block.elapsed[i], block.period[i], block.phi0[i], wrap);
+    }
+}
+
+coordinate
+SatConstellation::GetCoord (uint32_t i, Time time) const
+{
+  NS_ASSERT (i < m_kinds.size ());
+  const Block &block = m_blocks[m_kinds[i]];
+  uint32_t slot = m_slots[i];
+  double elapsed = Time (time.GetTimeStep () - block.initial[slot]).GetSeconds ();
+  coordinate current;
+  current.r = block.r[slot];
+  current.theta = block.theta0[slot];
+  switch (m_kinds[i])
+    {
+    case POLAR:
+      PolarCoord (elapsed, block.period[slot], block.theta0[slot], block.phi0[slot],
+                  block.sinInc[slot], block.cosInc[slot], current.theta, current.phi);
+      break;
+    case SUN_SYN:
+      SunSynCoord (elapsed, block.period[slot], block.theta0[slot], block.phi0[slot],
+                   block.sinInc[slot], block.cosInc[slot], current.theta, current.phi);
+      break;
+    default:
+      current.phi = EquatorialPhi (elapsed, block.period[slot], block.phi0[slot], m_kinds[i] == GEO);
+      break;
+    }
+  return current;
+}
+
+cartesian
+SatConstellation::GetCartesian (uint32_t i, Time time) const
+{
+  return SatGeometry::to_cartesian (GetCoord (i, time));
+}
+
+void
+SatConstellation::ToCartesian (Block &block)
+{
+  uint32_t n = block.r.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SatGeometry::spherical_to_cartesian (block.r[i], block.theta[i], block.phi[i],
+                                           block.x[i], block.y[i], block.z[i]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "satcontactplan.h"
+#include "satvisibility.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (SatContactPlan);
+
+TypeId
+SatContactPlan::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatContactPlan")
+    .SetParent<Object> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatContactPlan> ()
+    .AddAttribute ("Constellation",
+                   "The satellites and terminals to link.",
+                   PointerValue (),
+                   MakePointerAccessor (&SatContactPlan::SetConstellation,
+                                        &SatContactPlan::GetConstellation),
+                   MakePointerChecker<SatConstellation> ())
+    .AddAttribute ("ElevationMask",
+                   "The lowest elevation, in degrees, of a satellite linked to a terminal.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SatContactPlan::m_elevationMask),
+                   MakeDoubleChecker<double> (0, 90))
+    .AddAttribute ("Step",
+                   "The time between two checks of all the links, which bounds the shortest contact found.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&SatContactPlan::m_step),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("Tolerance",
+                   "The accuracy of the times of the link transitions.",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&SatContactPlan::m_tolerance),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("Threads",
+                   "The number of threads checking all the links, if threads are enabled.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SatContactPlan::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("LinkChange",
+                     "A link came up or went down.",
+                     MakeTraceSourceAccessor (&SatContactPlan::m_linkChangeTrace),
+                     "ns3::SatVisibility::LinkChangeCallback")
+  ;
+  return tid;
+}
+
+SatContactPlan::SatContactPlan ()
+  : m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatContactPlan::~SatContactPlan ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatContactPlan::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_constellation = 0;
+  Object::DoDispose ();
+}
+
+void
+SatContactPlan::SetConstellation (Ptr<SatConstellation> constellation)
+{
+  NS_LOG_FUNCTION (this << constellation);
+  m_constellation = constellation;
+}
+
+Ptr<SatConstellation>
+SatContactPlan::GetConstellation (void) const
+{
+  return m_constellation;
+}
+
+bool
+SatContactPlan::ContactLess (const Contact &a, const Contact &b)
+{
+  if (a.start != b.start)
+    {
+      return a.start < b.start;
+    }
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+bool
+SatContactPlan::TransitionLess (const Transition &a, const Transition &b)
+{
+  if (a.time != b.time)
+    {
+      return a.time < b.time;
+    }
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+bool
+SatContactPlan::Links (uint32_t i, uint32_t j, Time time) const
+{
+  return SatVisibility::AreLinked (m_constellation->GetCartesian (i, time), m_constellation->IsTerminal (i),
+                                   m_constellation->GetCartesian (j, time), m_constellation->IsTerminal (j),
+                                   m_elevationMask);
+}
+
+Time
+SatContactPlan::FindTransition (uint32_t i, uint32_t j, Time before, Time after, bool up) const
+{
+  while (after - before > m_tolerance)
+    {
+      Time middle = before + (after - before) / 2;
+      if (Links (i, j, middle) == up)
+        {
+          after = middle;
+        }
+      else
+        {
+          before = middle;
+        }
+    }
+  return after;
+}
+
+void
+SatContactPlan::Compute (Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << start << stop);
+  NS_ASSERT (m_constellation != 0);
+  NS_ASSERT (start <= stop);
+  m_event.Cancel ();
+  m_contacts.clear ();
+  m_transitions.clear ();
+  m_next = 0;
+
+  Ptr<SatVisibility> visibility = CreateObject<SatVisibility> ();
+  visibility->SetAttribute ("ElevationMask", DoubleValue (m_elevationMask));
+  visibility->SetAttribute ("Threads", UintegerValue (m_threads));
+  visibility->SetConstellation (m_constellation);
+
+  typedef std::map<std::pair<uint32_t, uint32_t>, Time> OpenContacts;
+  OpenContacts open;
+  Time before = start;
+  Time time = start;
+  while (true)
+    {
+      visibility->Update (time);
+      const std::vector<SatVisibility::Change> &changes = visibility->GetChanges ();
+      for (std::vector<SatVisibility::Change>::const_iterator it = changes.begin (); it != changes.end (); it++)
+        {
+          std::pair<uint32_t, uint32_t> link (it->first, it->second);
+          Transition transition;
+          transition.time = time == start ? start : FindTransition (it->first, it->second, before, time, it->up);
+          transition.first = it->first;
+          transition.second = it->second;
+          transition.up = it->up;
+          m_transitions.push_back (transition);
+          if (it->up)
+            {
+              open[link] = transition.time;
+            }
+          else
+            {
+              OpenContacts::iterator contact = open.find (link);
+              NS_ASSERT (contact != open.end ());
+              Contact c;
+              c.first = it->first;
+              c.second = it->second;
+              c.start = contact->second;
+              c.end = transition.time;
+              m_contacts.push_back (c);
+              open.erase (contact);
+            }
+        }
+      if (time == stop)
+        {
+          break;
+        }
+      before = time;
+      time = std::min (time + m_step, stop);
+    }
+  for (OpenContacts::const_iterator it = open.begin (); it != open.end (); it++)
+    {
+      Contact c;
+      c.first = it->first.first;
+      c.second = it->first.second;
+      c.start = it->second;
+      c.end = stop;
+      m_contacts.push_back (c);
+    }
+  std::sort (m_contacts.begin (), m_contacts.end (), ContactLess);
+  std::sort (m_transitions.begin (), m_transitions.end (), TransitionLess);
+  NS_LOG_DEBUG (m_contacts.size () << " contacts, " << m_transitions.size () << " transitions");
+}
+
+const std::vector<SatContactPlan::Contact> &
+SatContactPlan::GetContacts (void) const
+{
+  return m_contacts;
+}
+
+uint32_t
+SatContactPlan::GetNTransitions (void) const
+{
+  return m_transitions.size ();
+}
+
+bool
+SatContactPlan::IsLinked (uint32_t i, uint32_t j, Time time) const
+{
+  uint32_t first = std::min (i, j);
+  uint32_t second = std::max (i, j);
+  for (std::vector<Contact>::const_iterator it = m_contacts.begin ();
+       it != m_contacts.end () && it->start <= time; it++)
+    {
+      if (it->first == first && it->second == second && time < it->end)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+SatContactPlan::Schedule (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  Time now = Simulator::Now ();
+  m_next = 0;
+  while (m_next < m_transitions.size () && m_transitions[m_next].time < now)
+    {
+      m_next++;
+    }
+  if (m_next < m_transitions.size ())
+    {
+      m_event = Simulator::Schedule (m_transitions[m_next].time - now, &SatContactPlan::Fire, this);
+    }
+}
+
+void
+SatContactPlan::Fire (void)
+{
+  const Transition &transition = m_transitions[m_next];
+  NS_LOG_FUNCTION (this << transition.first << transition.second << transition.up);
+  m_next++;
+  if (m_next < m_transitions.size ())
+    {
+      m_event = Simulator::Schedule (m_transitions[m_next].time - Simulator::Now (), &SatContactPlan::Fire, this);
+    }
+  m_linkChangeTrace (transition.first, transition.second, transition.up);
+}
+
+} // namespace ns3
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "satellite-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatelliteMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (SatelliteMobilityModel);
+
+TypeId
+SatelliteMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatelliteMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatelliteMobilityModel> ()
+    .AddAttribute ("Constellation",
+                   "The constellation of the node.",
+                   PointerValue (),
+                   MakePointerAccessor (&SatelliteMobilityModel::m_constellation),
+                   MakePointerChecker<SatConstellation> ())
+    .AddAttribute ("Index",
+                   "The index of the node in the constellation.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&SatelliteMobilityModel::m_index),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+SatelliteMobilityModel::SatelliteMobilityModel ()
+  : m_index (0),
+    m_positionValid (false),
+    m_velocityValid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatelliteMobilityModel::~SatelliteMobilityModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatelliteMobilityModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_constellation = 0;
+  MobilityModel::DoDispose ();
+}
+
+void
+SatelliteMobilityModel::SetConstellation (Ptr<SatConstellation> constellation, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << constellation << index);
+  m_constellation = constellation;
+  m_index = index;
+  m_positionValid = false;
+  m_velocityValid = false;
+  NotifyCourseChange ();
+}
+
+Ptr<SatConstellation>
+SatelliteMobilityModel::GetConstellation (void) const
+{
+  return m_constellation;
+}
+
+uint32_t
+SatelliteMobilityModel::GetIndex (void) const
+{
+  return m_index;
+}
+
+bool
+SatelliteMobilityModel::IsTerminal (void) const
+{
+  NS_ASSERT (m_constellation != 0);
+  return m_constellation->IsTerminal (m_index);
+}
+
+cartesian
+SatelliteMobilityModel::GetCartesian (void) const
+{
+  NS_ASSERT (m_constellation != 0);
+  Time now = Simulator::Now ();
+  if (!m_positionValid || m_positionTime != now)
+    {
+      m_position = m_constellation->GetCartesian (m_index, now);
+      m_positionTime = now;
+      m_positionValid = true;
+    }
+  return m_position;
+}
+
+Vector
+SatelliteMobilityModel::DoGetPosition (void) const
+{
+  cartesian position = GetCartesian ();
+  return Vector (position.x * 1000, position.y * 1000, position.z * 1000);
+}
+
+void
+SatelliteMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_FATAL_ERROR ("the position of a SatelliteMobilityModel follows its orbit");
+}
+
+Vector
+SatelliteMobilityModel::DoGetVelocity (void) const
+{
+  NS_ASSERT (m_constellation != 0);
+  Time now = Simulator::Now ();
+  if (!m_velocityValid || m_velocityTime != now)
+    {
+      Time dt = MilliSeconds (1);
+      cartesian before = m_constellation->GetCartesian (m_index, now - dt);
+      cartesian after = m_constellation->GetCartesian (m_index, now + dt);
+      //km per 2 ms, in m/s
+      double scale = 1000 / (2 * dt.GetSeconds ());
+      m_velocity = Vector ((after.x - before.x) * scale,
+                           (after.y - before.y) * scale,
+                           (after.z - before.z) * scale);
+      m_velocityTime = now;
+      m_velocityValid = true;
+    }
+  return m_velocity;
+}
+
+} // namespace ns3
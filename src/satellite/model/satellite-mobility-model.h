@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATELLITE_MOBILITY_MODEL_H
+#define SATELLITE_MOBILITY_MODEL_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "satgeometry.h"
+#include "satconstellation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * The position of a node on an orbit, or on the ground, of a
+ * SatConstellation.
+ *
+ * The position, in meters in the frame of SatGeometry, is that of the
+ * Index-th satellite or terminal of the Constellation at the current
+ * simulation time.  It is computed at the first request of each time, so
+ * that the channels asking it for every receiver of a frame cost one
+ * orbit evaluation.  The velocity is the difference of the positions one
+ * millisecond before and after, computed at most once per time as well.
+ *
+ * The position follows the orbit: it cannot be set.
+ */
+class SatelliteMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SatelliteMobilityModel ();
+  virtual ~SatelliteMobilityModel ();
+
+  /**
+   * \param constellation the constellation of the node
+   * \param index the index of the node in the constellation
+   */
+  void SetConstellation (Ptr<SatConstellation> constellation, uint32_t index);
+  /**
+   * \return the constellation of the node
+   */
+  Ptr<SatConstellation> GetConstellation (void) const;
+  /**
+   * \return the index of the node in the constellation
+   */
+  uint32_t GetIndex (void) const;
+  /**
+   * \return whether the node is a terminal
+   */
+  bool IsTerminal (void) const;
+  /**
+   * \return the current position, in km
+   */
+  cartesian GetCartesian (void) const;
+
+private:
+  virtual void DoDispose (void);
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+
+  Ptr<SatConstellation> m_constellation;
+  uint32_t m_index;
+
+  mutable cartesian m_position;     //!< the position at m_positionTime, in km
+  mutable Time m_positionTime;
+  mutable bool m_positionValid;
+  mutable Vector m_velocity;        //!< the velocity at m_velocityTime, in m/s
+  mutable Time m_velocityTime;
+  mutable bool m_velocityValid;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_MOBILITY_MODEL_H */
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "satellite-propagation-model.h"
+#include "satellite-mobility-model.h"
+#include "satvisibility.h"
+#include "satgeometry.h"
+#include "ns3/mobility-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include <math.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatellitePropagationModel");
+
+NS_OBJECT_ENSURE_REGISTERED (SatellitePropagationDelayModel);
+
+TypeId
+SatellitePropagationDelayModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatellitePropagationDelayModel")
+    .SetParent<PropagationDelayModel> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatellitePropagationDelayModel> ()
+  ;
+  return tid;
+}
+
+SatellitePropagationDelayModel::SatellitePropagationDelayModel ()
+{
+}
+
+Time
+SatellitePropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  Ptr<SatelliteMobilityModel> satA = DynamicCast<SatelliteMobilityModel> (a);
+  Ptr<SatelliteMobilityModel> satB = DynamicCast<SatelliteMobilityModel> (b);
+  if (satA != 0 && satB != 0)
+    {
+      return Seconds (SatGeometry::propdelay (satA->GetCartesian (), satB->GetCartesian ()));
+    }
+  //the positions of the other models are in meters
+  return Seconds (a->GetDistanceFrom (b) / 1000 / LIGHT);
+}
+
+int64_t
+SatellitePropagationDelayModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (SatellitePropagationLossModel);
+
+TypeId
+SatellitePropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatellitePropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatellitePropagationLossModel> ()
+    .AddAttribute ("Frequency",
+                   "The carrier frequency (in Hz) at which propagation occurs.",
+                   DoubleValue (2e9),
+                   MakeDoubleAccessor (&SatellitePropagationLossModel::SetFrequency,
+                                       &SatellitePropagationLossModel::GetFrequency),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SystemLoss", "The system loss",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&SatellitePropagationLossModel::m_systemLoss),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("ElevationMask",
+                   "The lowest elevation, in degrees, of a satellite heard by a terminal.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SatellitePropagationLossModel::m_elevationMask),
+                   MakeDoubleChecker<double> (0, 90))
+    .AddAttribute ("Blockage",
+                   "Whether the nodes of a constellation which are not linked receive nothing.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&SatellitePropagationLossModel::m_blockage),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+SatellitePropagationLossModel::SatellitePropagationLossModel ()
+{
+}
+
+void
+SatellitePropagationLossModel::SetFrequency (double frequency)
+{
+  m_frequency = frequency;
+  static const double C = 299792458.0; // speed of light in vacuum
+  m_lambda = C / frequency;
+}
+
+double
+SatellitePropagationLossModel::GetFrequency (void) const
+{
+  return m_frequency;
+}
+
+double
+SatellitePropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                              Ptr<MobilityModel> a,
+                                              Ptr<MobilityModel> b) const
+{
+  Ptr<SatelliteMobilityModel> satA = DynamicCast<SatelliteMobilityModel> (a);
+  Ptr<SatelliteMobilityModel> satB = DynamicCast<SatelliteMobilityModel> (b);
+  double distance;
+  if (satA != 0 && satB != 0)
+    {
+      cartesian positionA = satA->GetCartesian ();
+      cartesian positionB = satB->GetCartesian ();
+      if (m_blockage
+          && !SatVisibility::AreLinked (positionA, satA->IsTerminal (),
+                                        positionB, satB->IsTerminal (), m_elevationMask))
+        {
+          NS_LOG_DEBUG ("no line of sight");
+          return -1000;
+        }
+      distance = SatGeometry::distance (positionA, positionB) * 1000;
+    }
+  else
+    {
+      distance = a->GetDistanceFrom (b);
+    }
+  if (distance <= 0)
+    {
+      return txPowerDbm;
+    }
+  double numerator = m_lambda * m_lambda;
+  double denominator = 16 * M_PI * M_PI * distance * distance * m_systemLoss;
+  double rxPowerDbm = txPowerDbm + 10 * log10 (numerator / denominator);
+  NS_LOG_DEBUG ("distance=" << distance << "m, rx power=" << rxPowerDbm << "dBm");
+  return rxPowerDbm;
+}
+
+int64_t
+SatellitePropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
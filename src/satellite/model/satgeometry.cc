@@ -181,4 +181,69 @@ int SatGeometry::are_satellites_mutually_visible(coordinate first, coordinate se
 	}
 }
 
+cartesian
+SatGeometry::to_cartesian(coordinate a)
+{
+	cartesian c;
+	spherical_to_cartesian(a.r, a.theta, a.phi, c.x, c.y, c.z);
+	return c;
+}
+
+// The squared distance between points a and b, in km^2
+static double
+distance_2(cartesian a, cartesian b)
+{
+	double dx = a.x - b.x;
+	double dy = a.y - b.y;
+	double dz = a.z - b.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+double
+SatGeometry::distance(cartesian a, cartesian b)
+{
+	return sqrt(distance_2(a, b));
+}
+
+double
+SatGeometry::propdelay(cartesian a, cartesian b)
+{
+	return distance(a, b)/LIGHT;
+}
+
+// As check_elevation on spherical coordinates.  sin(theta) is
+// sqrt(1 - cos(theta)^2) since theta is within (0, PI), and the visibility
+// test compares squares.
+double
+SatGeometry::check_elevation(cartesian satellite, cartesian terminal,
+    double elev_mask_)
+{
+	double S_2 = satellite.x * satellite.x + satellite.y * satellite.y
+	    + satellite.z * satellite.z;
+	double E = EARTH_RADIUS;
+	double E_2 = E * E;
+	double d_2 = distance_2(satellite, terminal);
+	if (d_2 < S_2 - E_2) {
+		// elevation angle > 0
+		double S = sqrt(S_2);
+		double d = sqrt(d_2);
+		double cos_theta = (E_2 + S_2 - d_2)/(2*E*S);
+		double sin_2 = 1 - cos_theta * cos_theta;
+		double alpha = acos((sin_2 > 0 ? sqrt(sin_2) : 0) * S/d);
+		return ( (alpha > elev_mask_) ? alpha : 0);
+	} else
+		return 0;
+}
+
+// As are_satellites_mutually_visible on spherical coordinates, comparing
+// the squares of the radii.
+int
+SatGeometry::are_satellites_mutually_visible(cartesian first, cartesian second)
+{
+	double c = first.x * first.x + first.y * first.y + first.z * first.z;
+	double d = distance_2(first, second)/4;
+	double grazing_radius = (EARTH_RADIUS + ATMOS_MARGIN);
+	return c - d >= grazing_radius * grazing_radius;
+}
+
 } //namespace ns3
@@ -72,6 +72,12 @@ namespace ns3 {
         // z = rcos(theta)
 };
 
+ struct cartesian {
+        double x;        // km
+        double y;        // km
+        double z;        // km
+};
+
 // Library of routines involving satellite geometry
 class SatGeometry
 {
@@ -88,6 +94,13 @@ public:
 	static double get_altitude(coordinate);
 	static double check_elevation(coordinate, coordinate, double);
 	static int are_satellites_mutually_visible(coordinate, coordinate);
+        // The same, on Cartesian positions: no trigonometry for the
+        // distances, nor square root for the visibility tests
+	static cartesian to_cartesian(coordinate);
+	static double distance(cartesian, cartesian);
+	static double propdelay(cartesian, cartesian);
+	static double check_elevation(cartesian, cartesian, double);
+	static int are_satellites_mutually_visible(cartesian, cartesian);
         static Time TimeElapse (Time initial );
 };
 
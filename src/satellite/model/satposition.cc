@@ -43,20 +43,52 @@
 #include <math.h>
 
 #include "ns3/simulator.h"
+#include "ns3/log.h"
 
 namespace ns3 {
-SatPosition::SatPosition(Time initial)
+
+NS_LOG_COMPONENT_DEFINE ("SatPosition");
+
+SatPosition::SatPosition(Time initial) : cartesianValid_(false)
 {
     initialTime = initial;
     
 }
 
 
-SatPosition::SatPosition()
+SatPosition::SatPosition() : cartesianValid_(false)
 {    
 }
 
 
+coordinate
+SatPosition::GetCoord()
+{
+    return initialCoord;
+}
+
+
+cartesian
+SatPosition::GetCartesian()
+{
+    Time now = Simulator::Now ();
+    if (!cartesianValid_ || cartesianTime_ != now)
+    {
+        cartesian_ = SatGeometry::to_cartesian(GetCoord());
+        cartesianTime_ = now;
+        cartesianValid_ = true;
+    }
+    return cartesian_;
+}
+
+
+void
+SatPosition::ForgetCartesian()
+{
+    cartesianValid_ = false;
+}
+
+
 
 Time
 SatPosition::TimeElapse ()
@@ -95,6 +127,7 @@ TermSatPosition::TermSatPosition()
 void 
 TermSatPosition::set(double latitude, double longitude)
 {
+	ForgetCartesian();
 	if (latitude < -90 || latitude > 90)
 		fprintf(stderr, "TermSatPosition:  latitude out of bounds %f\n",
 		   latitude);
@@ -171,6 +204,7 @@ PolarSatPosition::PolarSatPosition(double altitude, double Inc, double Lon,
 void 
 PolarSatPosition::set(double Altitude, double Lon, double Alpha, double Incl)
 {
+	ForgetCartesian();
 	if (Altitude < 0) 
         {
 		fprintf(stderr, "PolarSatPosition:  altitude out of \
@@ -211,8 +245,8 @@ PolarSatPosition::set(double Altitude, double Lon, double Alpha, double Incl)
 	double num = initialCoord.r * initialCoord.r * initialCoord.r;
 	staPeriod = 2 * PI * sqrt(num/MU); // seconds 
         //staPeriod=10810.3095141;
-         std::cout << "SunSynStaPosition/polar staPeriod (s)" << staPeriod  << "\t" << initialCoord.r << ", initialCoord.theta " << (initialCoord.theta * 180)/PI << std::endl;
-         std::cout << "SunSynStaPosition/polar inclination_" << inclination_  << std::endl;
+        NS_LOG_INFO ("SunSynStaPosition/polar staPeriod (s)" << staPeriod  << "\t" << initialCoord.r << ", initialCoord.theta " << (initialCoord.theta * 180)/PI);
+        NS_LOG_INFO ("SunSynStaPosition/polar inclination_" << inclination_);
 
 }
 
@@ -335,7 +369,7 @@ SunSynStaPosition::set(double Altitude, double Lon, double Alpha)
             
     inclination_ = acos (cosinc) * 180 / PI;
     PolarSatPosition::set( Altitude,  Lon,  Alpha, inclination_);
-    std::cout << "SunSynStaPosition inclination_ " << RAD_TO_DEG(inclination_)  << ", Alpha " << Alpha << std::endl;
+    NS_LOG_INFO ("SunSynStaPosition inclination_ " << RAD_TO_DEG(inclination_)  << ", Alpha " << Alpha);
 }
 
 
@@ -445,6 +479,7 @@ GeoSatPosition::GetCoord()
 void 
 GeoSatPosition::set(double longitude)
 {
+	ForgetCartesian();
 	if (longitude < -180 || longitude > 180)
 		fprintf(stderr, "GeoSatPosition:  longitude out of bounds %f\n",
 		    longitude);
@@ -67,11 +67,22 @@ class SatPosition : public Object
 
         //coordinate Getcoord(); 
         Time TimeElapse ();
+        virtual coordinate GetCoord();
+        // GetCoord in Cartesian coordinates, computed once per simulation
+        // time; set() methods forget it
+        cartesian GetCartesian();
         
         Time initialTime;
         coordinate initialCoord;
         double staPeriod;
         uint8_t staType;
+
+ protected:
+        void ForgetCartesian();
+
+        cartesian cartesian_;
+        Time cartesianTime_;
+        bool cartesianValid_;
 };
 
 class TermSatPosition : public SatPosition 
@@ -0,0 +1,452 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "satvisibility.h"
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <algorithm>
+#include <math.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatVisibility");
+
+NS_OBJECT_ENSURE_REGISTERED (SatVisibility);
+
+/** The positions a thread checks: first, first + step, and so on */
+class SatVisibility::Slice
+{
+public:
+  Slice (const SatVisibility *visibility, uint32_t first, uint32_t step)
+    : m_visibility (visibility),
+      m_first (first),
+      m_step (step),
+      m_checked (0)
+  {
+  }
+  void Run (void)
+  {
+    m_visibility->Scan (this);
+  }
+
+  const SatVisibility *m_visibility;
+  uint32_t m_first;
+  uint32_t m_step;
+  std::vector<Link> m_links;
+  uint64_t m_checked;
+};
+
+static const double TWO_PI = 2 * M_PI;
+
+static bool
+LinkLess (const SatVisibility::Link &a, const SatVisibility::Link &b)
+{
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+TypeId
+SatVisibility::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatVisibility")
+    .SetParent<Object> ()
+    .SetGroupName ("Satellite")
+    .AddConstructor<SatVisibility> ()
+    .AddAttribute ("Constellation",
+                   "The satellites and terminals to link.",
+                   PointerValue (),
+                   MakePointerAccessor (&SatVisibility::SetConstellation,
+                                        &SatVisibility::GetConstellation),
+                   MakePointerChecker<SatConstellation> ())
+    .AddAttribute ("ElevationMask",
+                   "The lowest elevation, in degrees, of a satellite linked to a terminal.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SatVisibility::m_elevationMask),
+                   MakeDoubleChecker<double> (0, 90))
+    .AddAttribute ("Threads",
+                   "The number of threads checking the pairs, if threads are enabled.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SatVisibility::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Pruning",
+                   "Whether to check only the pairs of the neighbouring latitude bands, "
+                   "rather than all the pairs.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&SatVisibility::m_pruning),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("LinkChange",
+                     "A link came up or went down at an Update.",
+                     MakeTraceSourceAccessor (&SatVisibility::m_linkChangeTrace),
+                     "ns3::SatVisibility::LinkChangeCallback")
+  ;
+  return tid;
+}
+
+SatVisibility::SatVisibility ()
+  : m_bandHeight (M_PI),
+    m_range (M_PI),
+    m_checked (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatVisibility::~SatVisibility ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatVisibility::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_constellation = 0;
+  Object::DoDispose ();
+}
+
+void
+SatVisibility::SetConstellation (Ptr<SatConstellation> constellation)
+{
+  NS_LOG_FUNCTION (this << constellation);
+  m_constellation = constellation;
+  m_links.clear ();
+  m_changes.clear ();
+}
+
+Ptr<SatConstellation>
+SatVisibility::GetConstellation (void) const
+{
+  return m_constellation;
+}
+
+void
+SatVisibility::Update (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  NS_ASSERT (m_constellation != 0);
+  m_constellation->Propagate (time);
+  uint32_t n = m_constellation->GetN ();
+  m_positions.resize (n);
+  m_theta.resize (n);
+  m_phi.resize (n);
+  m_terminals.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      coordinate coord = m_constellation->GetCoord (i);
+      m_positions[i] = m_constellation->GetCartesian (i);
+      m_theta[i] = coord.theta;
+      m_phi[i] = coord.phi;
+      m_terminals[i] = m_constellation->IsTerminal (i);
+    }
+  if (m_pruning)
+    {
+      BuildBands ();
+    }
+
+  uint32_t threads = std::max<uint32_t> (1, std::min (m_threads, n));
+  std::vector<Slice> slices;
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      slices.push_back (Slice (this, t, threads));
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > workers;
+  for (uint32_t t = 1; t < threads; t++)
+    {
+      workers.push_back (Create<SystemThread> (MakeCallback (&Slice::Run, &slices[t])));
+      workers.back ()->Start ();
+    }
+  slices[0].Run ();
+  for (uint32_t t = 0; t < workers.size (); t++)
+    {
+      workers[t]->Join ();
+    }
+#else
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      slices[t].Run ();
+    }
+#endif
+
+  std::vector<Link> links;
+  m_checked = 0;
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      links.insert (links.end (), slices[t].m_links.begin (), slices[t].m_links.end ());
+      m_checked += slices[t].m_checked;
+    }
+  std::sort (links.begin (), links.end (), LinkLess);
+  SetLinks (links);
+  NS_LOG_DEBUG (m_links.size () << " links, " << m_changes.size () << " changes, "
+                << m_checked << " pairs checked");
+}
+
+void
+SatVisibility::BuildBands (void)
+{
+  //the largest distance of a link: two satellites at the largest radius
+  //whose line grazes the atmosphere, or a satellite at the horizon of a
+  //terminal
+  double satelliteRadius = 0;
+  double minRadius = -1;
+  bool terminals = false;
+  uint32_t satellites = 0;
+  for (uint32_t i = 0; i < m_positions.size (); i++)
+    {
+      const cartesian &p = m_positions[i];
+      double r = sqrt (p.x * p.x + p.y * p.y + p.z * p.z);
+      if (m_terminals[i])
+        {
+          terminals = true;
+        }
+      else
+        {
+          satellites++;
+          satelliteRadius = std::max (satelliteRadius, r);
+        }
+      if (minRadius < 0 || r < minRadius)
+        {
+          minRadius = r;
+        }
+    }
+  double grazing = EARTH_RADIUS + ATMOS_MARGIN;
+  double range2 = 0;
+  if (satellites > 1)
+    {
+      range2 = std::max (range2, 4 * (satelliteRadius * satelliteRadius - grazing * grazing));
+    }
+  if (satellites > 0 && terminals)
+    {
+      range2 = std::max (range2, satelliteRadius * satelliteRadius - EARTH_RADIUS * EARTH_RADIUS);
+    }
+  //two points at radii of at least minRadius, a chord d apart, are at most
+  //acos (1 - d^2 / (2 minRadius^2)) apart seen from the center
+  double c = minRadius > 0 ? range2 / (2 * minRadius * minRadius) : 2;
+  m_range = c >= 2 ? TWO_PI : acos (1 - c) * (1 + 1e-9) + 1e-9;
+
+  uint32_t nBands = 1;
+  if (m_range < M_PI)
+    {
+      nBands = std::max (1.0, floor (M_PI / m_range));
+    }
+  m_bandHeight = M_PI / nBands;
+  m_bands.assign (nBands, std::vector<BandEntry> ());
+  for (uint32_t i = 0; i < m_positions.size (); i++)
+    {
+      //positions out of the model, such as a sun-synchronous orbit whose
+      //asin is out of range, are never linked
+      if (!(m_theta[i] >= 0 && m_theta[i] <= M_PI && m_phi[i] >= 0))
+        {
+          continue;
+        }
+      uint32_t band = std::min<uint32_t> (nBands - 1, m_theta[i] / m_bandHeight);
+      m_bands[band].push_back (BandEntry (m_phi[i], i));
+    }
+  for (uint32_t band = 0; band < nBands; band++)
+    {
+      std::sort (m_bands[band].begin (), m_bands[band].end ());
+    }
+  NS_LOG_DEBUG (nBands << " bands, range " << m_range << " rad");
+}
+
+void
+SatVisibility::Scan (Slice *slice) const
+{
+  uint32_t n = m_positions.size ();
+  for (uint32_t i = slice->m_first; i < n; i += slice->m_step)
+    {
+      if (!m_pruning)
+        {
+          for (uint32_t j = i + 1; j < n; j++)
+            {
+              Check (i, j, slice->m_links);
+            }
+          slice->m_checked += n - i - 1;
+          continue;
+        }
+      if (!(m_theta[i] >= 0 && m_theta[i] <= M_PI && m_phi[i] >= 0))
+        {
+          continue;
+        }
+      //the longitudes within m_range of i, when its cap holds no pole
+      double sinTheta = sin (m_theta[i]);
+      double halfWidth = M_PI;
+      if (m_range < M_PI / 2 && sinTheta > sin (m_range))
+        {
+          halfWidth = asin (sin (m_range) / sinTheta) * (1 + 1e-9) + 1e-9;
+        }
+      double lo = m_phi[i] - halfWidth;
+      double hi = m_phi[i] + halfWidth;
+      //the longitude intervals to scan, wrapped around 2 PI
+      double from[2];
+      double to[2];
+      uint32_t nIntervals = 1;
+      if (halfWidth >= M_PI)
+        {
+          from[0] = -1;
+          to[0] = 2 * TWO_PI;
+        }
+      else if (lo < 0)
+        {
+          from[0] = lo + TWO_PI;
+          to[0] = 2 * TWO_PI;
+          from[1] = -1;
+          to[1] = hi;
+          nIntervals = 2;
+        }
+      else if (hi >= TWO_PI)
+        {
+          from[0] = lo;
+          to[0] = 2 * TWO_PI;
+          from[1] = -1;
+          to[1] = hi - TWO_PI;
+          nIntervals = 2;
+        }
+      else
+        {
+          from[0] = lo;
+          to[0] = hi;
+        }
+      uint32_t band = std::min<uint32_t> (m_bands.size () - 1, m_theta[i] / m_bandHeight);
+      uint32_t firstBand = band > 0 ? band - 1 : 0;
+      uint32_t lastBand = std::min<uint32_t> (m_bands.size () - 1, band + 1);
+      for (uint32_t b = firstBand; b <= lastBand; b++)
+        {
+          const std::vector<BandEntry> &entries = m_bands[b];
+          for (uint32_t k = 0; k < nIntervals; k++)
+            {
+              std::vector<BandEntry>::const_iterator it =
+                std::lower_bound (entries.begin (), entries.end (), BandEntry (from[k], 0));
+              for (; it != entries.end () && it->first <= to[k]; it++)
+                {
+                  if (it->second > i)
+                    {
+                      Check (i, it->second, slice->m_links);
+                      slice->m_checked++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool
+SatVisibility::AreLinked (const cartesian &a, bool aTerminal,
+                          const cartesian &b, bool bTerminal, double elevationMask)
+{
+  if (aTerminal && bTerminal)
+    {
+      return false;
+    }
+  else if (aTerminal)
+    {
+      return SatGeometry::check_elevation (b, a, DEG_TO_RAD (elevationMask)) != 0;
+    }
+  else if (bTerminal)
+    {
+      return SatGeometry::check_elevation (a, b, DEG_TO_RAD (elevationMask)) != 0;
+    }
+  return SatGeometry::are_satellites_mutually_visible (a, b)
+         && SatGeometry::are_satellites_mutually_visible (b, a);
+}
+
+void
+SatVisibility::Check (uint32_t i, uint32_t j, std::vector<Link> &links) const
+{
+  const cartesian &a = m_positions[i];
+  const cartesian &b = m_positions[j];
+  if (AreLinked (a, m_terminals[i], b, m_terminals[j], m_elevationMask))
+    {
+      Link link;
+      link.first = i;
+      link.second = j;
+      link.distance = SatGeometry::distance (a, b);
+      links.push_back (link);
+    }
+}
+
+void
+SatVisibility::SetLinks (std::vector<Link> &links)
+{
+  m_changes.clear ();
+  std::vector<Link>::const_iterator old = m_links.begin ();
+  std::vector<Link>::const_iterator now = links.begin ();
+  while (old != m_links.end () || now != links.end ())
+    {
+      Change change;
+      if (now == links.end () || (old != m_links.end () && LinkLess (*old, *now)))
+        {
+          change.first = old->first;
+          change.second = old->second;
+          change.up = false;
+          old++;
+        }
+      else if (old == m_links.end () || LinkLess (*now, *old))
+        {
+          change.first = now->first;
+          change.second = now->second;
+          change.up = true;
+          now++;
+        }
+      else
+        {
+          old++;
+          now++;
+          continue;
+        }
+      m_changes.push_back (change);
+    }
+  m_links.swap (links);
+  for (std::vector<Change>::const_iterator it = m_changes.begin (); it != m_changes.end (); it++)
+    {
+      m_linkChangeTrace (it->first, it->second, it->up);
+    }
+}
+
+const std::vector<SatVisibility::Link> &
+SatVisibility::GetLinks (void) const
+{
+  return m_links;
+}
+
+const std::vector<SatVisibility::Change> &
+SatVisibility::GetChanges (void) const
+{
+  return m_changes;
+}
+
+bool
+SatVisibility::IsLinked (uint32_t i, uint32_t j) const
+{
+  Link link;
+  link.first = std::min (i, j);
+  link.second = std::max (i, j);
+  return std::binary_search (m_links.begin (), m_links.end (), link, LinkLess);
+}
+
+uint64_t
+SatVisibility::GetChecked (void) const
+{
+  return m_checked;
+}
+
+} // namespace ns3
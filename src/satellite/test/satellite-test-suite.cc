@@ -2,9 +2,24 @@
 
 // Include a header file from your module to test.
 #include "ns3/satellite.h"
+#include "ns3/satposition.h"
+#include "ns3/satconstellation.h"
+#include "ns3/satvisibility.h"
+#include "ns3/satcontactplan.h"
+#include "ns3/satellite-mobility-model.h"
+#include "ns3/satellite-propagation-model.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
+#include <sstream>
+#include <vector>
+#include <set>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -46,6 +61,581 @@ SatelliteTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * SatConstellation::Propagate gives the positions GetCoord gives, for
+ * every kind of SatPosition, at times within and beyond their periods.
+ */
+class SatConstellationTestCase : public TestCase
+{
+public:
+  SatConstellationTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (void);
+  void CheckCoord (coordinate expected, coordinate actual, std::string name);
+
+  PolarSatPosition m_polar[4];
+  SunSynStaPosition m_sunSyn;
+  GeoSatPosition m_geo[2];
+  TermSatPosition m_term[2];
+  Ptr<SatConstellation> m_constellation;
+};
+
+SatConstellationTestCase::SatConstellationTestCase ()
+  : TestCase ("SatConstellation propagates as SatPosition::GetCoord")
+{
+}
+
+void
+SatConstellationTestCase::CheckCoord (coordinate expected, coordinate actual, std::string name)
+{
+  NS_TEST_EXPECT_MSG_EQ (actual.r, expected.r, name << " r");
+  NS_TEST_EXPECT_MSG_EQ (actual.theta, expected.theta, name << " theta");
+  NS_TEST_EXPECT_MSG_EQ (actual.phi, expected.phi, name << " phi");
+}
+
+void
+SatConstellationTestCase::Check (void)
+{
+  m_constellation->Propagate (Simulator::Now ());
+  std::ostringstream at;
+  at << " at " << Simulator::Now ().GetSeconds () << " s";
+  uint32_t i = 0;
+  for (uint32_t j = 0; j < 4; j++, i++)
+    {
+      CheckCoord (m_polar[j].GetCoord (), m_constellation->GetCoord (i), "polar" + at.str ());
+    }
+  CheckCoord (m_sunSyn.GetCoord (), m_constellation->GetCoord (i++), "sun-synchronous" + at.str ());
+  for (uint32_t j = 0; j < 2; j++, i++)
+    {
+      CheckCoord (m_geo[j].GetCoord (), m_constellation->GetCoord (i), "geo" + at.str ());
+    }
+  for (uint32_t j = 0; j < 2; j++, i++)
+    {
+      CheckCoord (m_term[j].GetCoord (), m_constellation->GetCoord (i), "terminal" + at.str ());
+    }
+  for (i = 0; i < m_constellation->GetN (); i++)
+    {
+      coordinate coord = m_constellation->GetCoord (i);
+      cartesian position = m_constellation->GetCartesian (i);
+      double x, y, z;
+      SatGeometry::spherical_to_cartesian (coord.r, coord.theta, coord.phi, x, y, z);
+      NS_TEST_EXPECT_MSG_EQ (position.x, x, "x of " << i << at.str ());
+      NS_TEST_EXPECT_MSG_EQ (position.y, y, "y of " << i << at.str ());
+      NS_TEST_EXPECT_MSG_EQ (position.z, z, "z of " << i << at.str ());
+    }
+}
+
+void
+SatConstellationTestCase::DoRun (void)
+{
+  m_polar[0].set (800, 70, 30, 90);
+  m_polar[1].set (550, -120, 200, 53);
+  m_polar[2].set (1200, 10, 0, 120);
+  m_polar[3].set (780, 0, 315, 86.4);
+  m_polar[3].initialTime = Seconds (100);
+  m_sunSyn.set (800, 70, 0);
+  m_geo[0].set (100);
+  m_geo[1].set (-45);
+  m_geo[1].initialTime = Seconds (3600);
+  m_term[0].set (30, 70);
+  m_term[1].set (-60, -150);
+
+  m_constellation = CreateObject<SatConstellation> ();
+  for (uint32_t j = 0; j < 4; j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_constellation->Add (m_polar[j]), j, "index of a satellite");
+    }
+  m_constellation->Add (m_sunSyn);
+  for (uint32_t j = 0; j < 2; j++)
+    {
+      m_constellation->Add (m_geo[j]);
+    }
+  for (uint32_t j = 0; j < 2; j++)
+    {
+      m_constellation->Add (m_term[j]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_constellation->GetN (), 9, "satellites and terminals");
+
+  static const double times[] = { 0, 1234.5, 6500, 50000, 864000.25 };
+  for (uint32_t j = 0; j < sizeof (times) / sizeof (times[0]); j++)
+    {
+      Simulator::Schedule (Seconds (times[j]), &SatConstellationTestCase::Check, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_constellation = 0;
+}
+
+/**
+ * The Cartesian SatGeometry functions agree with the spherical ones, and
+ * SatPosition::GetCartesian follows the time and set().
+ */
+class SatGeometryCartesianTestCase : public TestCase
+{
+public:
+  SatGeometryCartesianTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckPosition (void);
+
+  PolarSatPosition m_polar;
+};
+
+SatGeometryCartesianTestCase::SatGeometryCartesianTestCase ()
+  : TestCase ("SatGeometry on Cartesian positions")
+{
+}
+
+void
+SatGeometryCartesianTestCase::CheckPosition (void)
+{
+  coordinate coord = m_polar.GetCoord ();
+  cartesian position = m_polar.GetCartesian ();
+  double x, y, z;
+  SatGeometry::spherical_to_cartesian (coord.r, coord.theta, coord.phi, x, y, z);
+  NS_TEST_EXPECT_MSG_EQ (position.x, x, "x at " << Simulator::Now ().GetSeconds () << " s");
+  NS_TEST_EXPECT_MSG_EQ (position.y, y, "y at " << Simulator::Now ().GetSeconds () << " s");
+  NS_TEST_EXPECT_MSG_EQ (position.z, z, "z at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+SatGeometryCartesianTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  std::vector<coordinate> points;
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      coordinate point;
+      //terminals on the ground, then LEO to GEO satellites
+      point.r = i < 10 ? EARTH_RADIUS : EARTH_RADIUS + rng->GetValue (300, GEO_ALTITUDE);
+      point.theta = rng->GetValue (0, PI);
+      point.phi = rng->GetValue (0, 2 * PI);
+      points.push_back (point);
+    }
+  uint32_t visible = 0;
+  uint32_t elevated = 0;
+  for (uint32_t i = 0; i < points.size (); i++)
+    {
+      cartesian a = SatGeometry::to_cartesian (points[i]);
+      for (uint32_t j = 0; j < points.size (); j++)
+        {
+          cartesian b = SatGeometry::to_cartesian (points[j]);
+          double distance = SatGeometry::distance (points[i], points[j]);
+          NS_TEST_EXPECT_MSG_EQ_TOL (SatGeometry::distance (a, b), distance, 1e-9 * (1 + distance),
+                                     "distance of " << i << " and " << j);
+          NS_TEST_EXPECT_MSG_EQ_TOL (SatGeometry::propdelay (a, b), SatGeometry::propdelay (points[i], points[j]),
+                                     1e-15, "delay of " << i << " and " << j);
+          if (i >= 10 && j >= 10 && i != j)
+            {
+              int spherical = SatGeometry::are_satellites_mutually_visible (points[i], points[j]);
+              NS_TEST_EXPECT_MSG_EQ (SatGeometry::are_satellites_mutually_visible (a, b), spherical,
+                                     "visibility of " << i << " and " << j);
+              visible += spherical;
+            }
+          if (i >= 10 && j < 10)
+            {
+              double elevation = SatGeometry::check_elevation (points[i], points[j], DEG_TO_RAD (10));
+              NS_TEST_EXPECT_MSG_EQ_TOL (SatGeometry::check_elevation (a, b, DEG_TO_RAD (10)), elevation, 1e-9,
+                                         "elevation of " << i << " over " << j);
+              elevated += (elevation > 0);
+            }
+        }
+    }
+  //both outcomes are covered
+  NS_TEST_EXPECT_MSG_GT (visible, 0, "visible pairs");
+  NS_TEST_EXPECT_MSG_LT (visible, 50 * 49, "hidden pairs");
+  NS_TEST_EXPECT_MSG_GT (elevated, 0, "satellites above a terminal");
+  NS_TEST_EXPECT_MSG_LT (elevated, 50 * 10, "satellites below a terminal");
+
+  //right above the terminal
+  coordinate terminal = points[0];
+  coordinate above = terminal;
+  above.r += 800;
+  NS_TEST_EXPECT_MSG_EQ_TOL (SatGeometry::check_elevation (SatGeometry::to_cartesian (above),
+                                                           SatGeometry::to_cartesian (terminal), 0),
+                             PI / 2, 1e-6, "elevation of a satellite at the zenith");
+
+  m_polar.set (800, 70, 30, 90);
+  Simulator::Schedule (Seconds (0), &SatGeometryCartesianTestCase::CheckPosition, this);
+  Simulator::Schedule (Seconds (1000), &SatGeometryCartesianTestCase::CheckPosition, this);
+  Simulator::Schedule (Seconds (1000), &PolarSatPosition::set, &m_polar, 1200, -10, 100, 45);
+  Simulator::Schedule (Seconds (1000), &SatGeometryCartesianTestCase::CheckPosition, this);
+  Simulator::Schedule (Seconds (2500.5), &SatGeometryCartesianTestCase::CheckPosition, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * SatVisibility finds the links of a brute force check of all the pairs,
+ * with and without the latitude bands and threads, and traces the
+ * changes between its updates.
+ */
+class SatVisibilityTestCase : public TestCase
+{
+public:
+  SatVisibilityTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the links of a constellation at a few times.
+   *
+   * \param constellation the constellation
+   * \param pruned whether the bands must check fewer pairs
+   */
+  void Check (Ptr<SatConstellation> constellation, bool pruned);
+  void LinkChange (uint32_t first, uint32_t second, bool up);
+
+  std::set<std::pair<uint32_t, uint32_t> > m_traced;
+};
+
+SatVisibilityTestCase::SatVisibilityTestCase ()
+  : TestCase ("SatVisibility links the pairs of a brute force check")
+{
+}
+
+void
+SatVisibilityTestCase::LinkChange (uint32_t first, uint32_t second, bool up)
+{
+  std::pair<uint32_t, uint32_t> link (first, second);
+  NS_TEST_EXPECT_MSG_EQ (m_traced.count (link), (up ? 0 : 1), "link " << first << "-" << second);
+  if (up)
+    {
+      m_traced.insert (link);
+    }
+  else
+    {
+      m_traced.erase (link);
+    }
+}
+
+void
+SatVisibilityTestCase::Check (Ptr<SatConstellation> constellation, bool pruned)
+{
+  Ptr<SatVisibility> all = CreateObject<SatVisibility> ();
+  all->SetAttribute ("Pruning", BooleanValue (false));
+  Ptr<SatVisibility> bands = CreateObject<SatVisibility> ();
+  Ptr<SatVisibility> threads = CreateObject<SatVisibility> ();
+  threads->SetAttribute ("Threads", UintegerValue (3));
+  Ptr<SatVisibility> engines[] = { all, bands, threads };
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      engines[k]->SetAttribute ("ElevationMask", DoubleValue (10));
+      engines[k]->SetConstellation (constellation);
+    }
+  m_traced.clear ();
+  bands->TraceConnectWithoutContext ("LinkChange", MakeCallback (&SatVisibilityTestCase::LinkChange, this));
+
+  uint32_t changes = 0;
+  for (double t = 0; t <= 3000; t += 300)
+    {
+      for (uint32_t k = 0; k < 3; k++)
+        {
+          engines[k]->Update (Seconds (t));
+        }
+      const std::vector<SatVisibility::Link> &expected = all->GetLinks ();
+      NS_TEST_EXPECT_MSG_GT (expected.size (), 0, "links at " << t << " s");
+      for (uint32_t k = 1; k < 3; k++)
+        {
+          const std::vector<SatVisibility::Link> &links = engines[k]->GetLinks ();
+          NS_TEST_ASSERT_MSG_EQ (links.size (), expected.size (), "links of engine " << k << " at " << t << " s");
+          for (uint32_t i = 0; i < links.size (); i++)
+            {
+              NS_TEST_EXPECT_MSG_EQ (links[i].first, expected[i].first, "link " << i << " at " << t << " s");
+              NS_TEST_EXPECT_MSG_EQ (links[i].second, expected[i].second, "link " << i << " at " << t << " s");
+              NS_TEST_EXPECT_MSG_EQ (links[i].distance, expected[i].distance, "link " << i << " at " << t << " s");
+            }
+        }
+      for (uint32_t i = 0; i < expected.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (bands->IsLinked (expected[i].second, expected[i].first), true, "linked");
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_traced.size (), expected.size (), "traced links at " << t << " s");
+      if (t > 0)
+        {
+          changes += bands->GetChanges ().size ();
+        }
+      NS_TEST_EXPECT_MSG_EQ ((bands->GetChecked () < all->GetChecked ()), pruned, "pairs checked at " << t << " s");
+    }
+  NS_TEST_EXPECT_MSG_GT (changes, 0, "changes after the first update");
+}
+
+void
+SatVisibilityTestCase::DoRun (void)
+{
+  //an Iridium-like constellation, a higher satellite and terminals up to
+  //the poles
+  Ptr<SatConstellation> leo = CreateObject<SatConstellation> ();
+  for (uint32_t p = 0; p < 6; p++)
+    {
+      for (uint32_t s = 0; s < 11; s++)
+        {
+          leo->Add (PolarSatPosition (780, 86.4, 30.0 * p - 180, 360.0 * s / 11, p));
+        }
+    }
+  leo->Add (PolarSatPosition (1200, 45, 20, 10, 6));
+  static const double latitudes[] = { 89, 60, 30, 0, -45, -89 };
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      TermSatPosition terminal;
+      terminal.set (latitudes[i], 170 - 60.0 * i);
+      leo->Add (terminal);
+    }
+  Check (leo, true);
+
+  //geostationary satellites are in range of most of the others
+  leo->Add (GeoSatPosition (100));
+  leo->Add (GeoSatPosition (-30));
+  Check (leo, false);
+}
+
+/**
+ * SatContactPlan finds the links of SatVisibility at times between its
+ * steps, with transitions within its tolerance, and fires one event per
+ * transition.
+ */
+class SatContactPlanTestCase : public TestCase
+{
+public:
+  SatContactPlanTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void LinkChange (uint32_t first, uint32_t second, bool up);
+
+  Ptr<SatContactPlan> m_plan;
+  std::set<std::pair<uint32_t, uint32_t> > m_traced;
+  uint32_t m_events;
+};
+
+SatContactPlanTestCase::SatContactPlanTestCase ()
+  : TestCase ("SatContactPlan predicts the links"),
+    m_events (0)
+{
+}
+
+void
+SatContactPlanTestCase::LinkChange (uint32_t first, uint32_t second, bool up)
+{
+  m_events++;
+  std::pair<uint32_t, uint32_t> link (first, second);
+  NS_TEST_EXPECT_MSG_EQ (m_traced.count (link), (up ? 0 : 1), "link " << first << "-" << second);
+  if (up)
+    {
+      m_traced.insert (link);
+    }
+  else
+    {
+      m_traced.erase (link);
+    }
+  //the plan holds at the time of the event
+  Time now = Simulator::Now ();
+  NS_TEST_EXPECT_MSG_EQ (m_plan->IsLinked (first, second, now), up, "link " << first << "-" << second << " at " << now);
+}
+
+void
+SatContactPlanTestCase::DoRun (void)
+{
+  Ptr<SatConstellation> constellation = CreateObject<SatConstellation> ();
+  for (uint32_t p = 0; p < 6; p++)
+    {
+      for (uint32_t s = 0; s < 11; s++)
+        {
+          constellation->Add (PolarSatPosition (780, 86.4, 30.0 * p - 180, 360.0 * s / 11, p));
+        }
+    }
+  static const double latitudes[] = { 60, 30, 0, -45 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      TermSatPosition terminal;
+      terminal.set (latitudes[i], 170 - 60.0 * i);
+      constellation->Add (terminal);
+    }
+  Time start = Seconds (100);
+  Time stop = Seconds (6100);
+  Time tolerance = MilliSeconds (1);
+  m_plan = CreateObject<SatContactPlan> ();
+  m_plan->SetAttribute ("ElevationMask", DoubleValue (10));
+  m_plan->SetAttribute ("Step", TimeValue (Seconds (60)));
+  m_plan->SetAttribute ("Tolerance", TimeValue (tolerance));
+  m_plan->SetConstellation (constellation);
+  m_plan->Compute (start, stop);
+
+  const std::vector<SatContactPlan::Contact> &contacts = m_plan->GetContacts ();
+  NS_TEST_ASSERT_MSG_GT (contacts.size (), 0, "contacts");
+  uint32_t ended = 0;
+  for (uint32_t i = 0; i < contacts.size (); i++)
+    {
+      const SatContactPlan::Contact &c = contacts[i];
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((contacts[i - 1].start <= c.start), true, "contacts sorted by start");
+        }
+      cartesian a = constellation->GetCartesian (c.first, c.start);
+      cartesian b = constellation->GetCartesian (c.second, c.start);
+      bool aTerminal = constellation->IsTerminal (c.first);
+      bool bTerminal = constellation->IsTerminal (c.second);
+      NS_TEST_EXPECT_MSG_EQ (SatVisibility::AreLinked (a, aTerminal, b, bTerminal, 10), true,
+                             "contact " << i << " at its start");
+      if (c.start > start)
+        {
+          a = constellation->GetCartesian (c.first, c.start - tolerance);
+          b = constellation->GetCartesian (c.second, c.start - tolerance);
+          NS_TEST_EXPECT_MSG_EQ (SatVisibility::AreLinked (a, aTerminal, b, bTerminal, 10), false,
+                                 "contact " << i << " before its start");
+        }
+      if (c.end < stop)
+        {
+          ended++;
+          a = constellation->GetCartesian (c.first, c.end);
+          b = constellation->GetCartesian (c.second, c.end);
+          NS_TEST_EXPECT_MSG_EQ (SatVisibility::AreLinked (a, aTerminal, b, bTerminal, 10), false,
+                                 "contact " << i << " at its end");
+          a = constellation->GetCartesian (c.first, c.end - tolerance);
+          b = constellation->GetCartesian (c.second, c.end - tolerance);
+          NS_TEST_EXPECT_MSG_EQ (SatVisibility::AreLinked (a, aTerminal, b, bTerminal, 10), true,
+                                 "contact " << i << " before its end");
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (ended, 0, "contacts ending within the horizon");
+
+  //the links of SatVisibility between the steps of the plan
+  Ptr<SatVisibility> visibility = CreateObject<SatVisibility> ();
+  visibility->SetAttribute ("ElevationMask", DoubleValue (10));
+  visibility->SetConstellation (constellation);
+  for (Time t = start; t < stop; t += Seconds (7))
+    {
+      visibility->Update (t);
+      uint32_t linked = 0;
+      for (uint32_t i = 0; i < contacts.size (); i++)
+        {
+          if (contacts[i].start <= t && t < contacts[i].end)
+            {
+              linked++;
+              NS_TEST_EXPECT_MSG_EQ (visibility->IsLinked (contacts[i].first, contacts[i].second), true,
+                                     "contact " << i << " at " << t);
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (visibility->GetLinks ().size (), linked, "links at " << t);
+    }
+
+  m_plan->TraceConnectWithoutContext ("LinkChange", MakeCallback (&SatContactPlanTestCase::LinkChange, this));
+  Simulator::Schedule (start, &SatContactPlan::Schedule, m_plan);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_events, m_plan->GetNTransitions (), "one event per transition");
+  NS_TEST_EXPECT_MSG_EQ (m_events, contacts.size () + ended, "transitions of the contacts");
+  m_plan->Dispose ();
+  m_plan = 0;
+}
+
+/**
+ * SatelliteMobilityModel follows the constellation, and the satellite
+ * propagation models use the slant range and the visibility.
+ */
+class SatelliteMobilityTestCase : public TestCase
+{
+public:
+  SatelliteMobilityTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (void);
+
+  Ptr<SatConstellation> m_constellation;
+  Ptr<SatelliteMobilityModel> m_models[4];
+};
+
+SatelliteMobilityTestCase::SatelliteMobilityTestCase ()
+  : TestCase ("SatelliteMobilityModel and the satellite propagation models")
+{
+}
+
+void
+SatelliteMobilityTestCase::Check (void)
+{
+  Time now = Simulator::Now ();
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      cartesian expected = m_constellation->GetCartesian (i, now);
+      Vector position = m_models[i]->GetPosition ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x * 1000, 1e-6, "x of " << i << " at " << now);
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y * 1000, 1e-6, "y of " << i << " at " << now);
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.z, expected.z * 1000, 1e-6, "z of " << i << " at " << now);
+    }
+  //circular orbits: sqrt (MU / r), and the rotation of the Earth
+  Vector velocity = m_models[0]->GetVelocity ();
+  double speed = sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  NS_TEST_EXPECT_MSG_EQ_TOL (speed, 1000 * sqrt (MU / (EARTH_RADIUS + 780)), 1, "speed of the satellite at " << now);
+  velocity = m_models[3]->GetVelocity ();
+  speed = sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  NS_TEST_EXPECT_MSG_EQ_TOL (speed, 1000 * 2 * PI * EARTH_RADIUS * cos (DEG_TO_RAD (30)) / EARTH_PERIOD, 0.01,
+                             "speed of the terminal at " << now);
+
+  Ptr<SatellitePropagationDelayModel> delay = CreateObject<SatellitePropagationDelayModel> ();
+  Ptr<SatellitePropagationLossModel> loss = CreateObject<SatellitePropagationLossModel> ();
+  loss->SetAttribute ("ElevationMask", DoubleValue (10));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      for (uint32_t j = 0; j < 4; j++)
+        {
+          cartesian a = m_constellation->GetCartesian (i, now);
+          cartesian b = m_constellation->GetCartesian (j, now);
+          NS_TEST_EXPECT_MSG_EQ (delay->GetDelay (m_models[i], m_models[j]), Seconds (SatGeometry::propdelay (a, b)),
+                                 "delay from " << i << " to " << j << " at " << now);
+          if (i == j)
+            {
+              continue;
+            }
+          double rx = loss->CalcRxPower (30, m_models[i], m_models[j]);
+          if (SatVisibility::AreLinked (a, m_constellation->IsTerminal (i),
+                                        b, m_constellation->IsTerminal (j), 10))
+            {
+              double lambda = 299792458.0 / 2e9;
+              double d = SatGeometry::distance (a, b) * 1000;
+              NS_TEST_EXPECT_MSG_EQ_TOL (rx, 30 + 20 * log10 (lambda / (4 * M_PI * d)), 1e-9,
+                                         "loss from " << i << " to " << j << " at " << now);
+            }
+          else
+            {
+              NS_TEST_EXPECT_MSG_EQ (rx, -1000, "loss from " << i << " to " << j << " at " << now);
+            }
+        }
+    }
+}
+
+void
+SatelliteMobilityTestCase::DoRun (void)
+{
+  m_constellation = CreateObject<SatConstellation> ();
+  m_constellation->Add (PolarSatPosition (780, 86.4, 70, 0, 0));
+  m_constellation->Add (PolarSatPosition (780, 86.4, 70, 30, 0));
+  m_constellation->Add (PolarSatPosition (780, 86.4, 100, 15, 1));
+  TermSatPosition terminal;
+  terminal.set (30, 80);
+  m_constellation->Add (terminal);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_models[i] = CreateObject<SatelliteMobilityModel> ();
+      m_models[i]->SetConstellation (m_constellation, i);
+    }
+  for (uint32_t t = 0; t < 6000; t += 250)
+    {
+      Simulator::Schedule (Seconds (t), &SatelliteMobilityTestCase::Check, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_models[i] = 0;
+    }
+  m_constellation = 0;
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +651,11 @@ SatelliteTestSuite::SatelliteTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new SatelliteTestCase1, TestCase::QUICK);
+  AddTestCase (new SatConstellationTestCase, TestCase::QUICK);
+  AddTestCase (new SatGeometryCartesianTestCase, TestCase::QUICK);
+  AddTestCase (new SatVisibilityTestCase, TestCase::QUICK);
+  AddTestCase (new SatContactPlanTestCase, TestCase::QUICK);
+  AddTestCase (new SatelliteMobilityTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/satgeometry.h"
+#include "ns3/satposition.h"
+#include "ns3/satconstellation.h"
+#include "ns3/satellite-mobility-model.h"
+#include "ns3/satellite-propagation-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * YansWifiChannel precomputes the same paths over the satellite loss
+ * model on one thread or several.  Two terminals at the north pole stand
+ * still, and are never linked: the loss model only finds that out from
+ * their SatelliteMobilityModels, which the threads must not replace with
+ * copies of the positions.  A ground station above them, out of the
+ * constellation, is in range of both.
+ */
+class SatellitePathCacheTestCase : public TestCase
+{
+public:
+  SatellitePathCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param threads the number of threads of PrecomputePaths
+   * \return the SNRs of the frames every PHY sends once
+   */
+  std::vector<double> Run (uint32_t threads);
+  Ptr<YansWifiPhy> CreatePhy (Ptr<YansWifiChannel> channel, Ptr<MobilityModel> mobility);
+  void Send (Ptr<YansWifiPhy> phy);
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+
+  std::vector<double> m_snr; //!< SNRs of the frames received
+};
+
+SatellitePathCacheTestCase::SatellitePathCacheTestCase ()
+  : TestCase ("YansWifiChannel precomputes the satellite losses on any number of threads")
+{
+}
+
+Ptr<YansWifiPhy>
+SatellitePathCacheTestCase::CreatePhy (Ptr<YansWifiChannel> channel, Ptr<MobilityModel> mobility)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  phy->SetReceiveOkCallback (MakeCallback (&SatellitePathCacheTestCase::Receive, this));
+  return phy;
+}
+
+void
+SatellitePathCacheTestCase::Send (Ptr<YansWifiPhy> phy)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  phy->SendPacket (Create<Packet> (100), txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+SatellitePathCacheTestCase::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_snr.push_back (snr);
+}
+
+std::vector<double>
+SatellitePathCacheTestCase::Run (uint32_t threads)
+{
+  Ptr<YansWifiChannel> channel = CreateObjectWithAttributes<YansWifiChannel> ("PathCache", BooleanValue (true),
+                                                                              "PathCacheThreads", UintegerValue (threads));
+  Ptr<SatellitePropagationLossModel> loss = CreateObject<SatellitePropagationLossModel> ();
+  loss->SetFrequency (5.18e9);
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<SatellitePropagationDelayModel> ());
+
+  Ptr<SatConstellation> constellation = CreateObject<SatConstellation> ();
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      TermSatPosition terminal;
+      terminal.set (90, 0);
+      constellation->Add (terminal);
+      Ptr<SatelliteMobilityModel> mobility = CreateObject<SatelliteMobilityModel> ();
+      mobility->SetConstellation (constellation, i);
+      phys.push_back (CreatePhy (channel, mobility));
+    }
+  Ptr<ConstantPositionMobilityModel> station = CreateObject<ConstantPositionMobilityModel> ();
+  station->SetPosition (Vector (0.0, 0.0, EARTH_RADIUS * 1000 + 100));
+  phys.push_back (CreatePhy (channel, station));
+
+  m_snr.clear ();
+  channel->PrecomputePaths ();
+  for (uint32_t k = 0; k < phys.size (); k++)
+    {
+      Simulator::Schedule (Seconds (1.0 + 0.1 * k), &SatellitePathCacheTestCase::Send, this, phys[k]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_snr;
+}
+
+void
+SatellitePathCacheTestCase::DoRun (void)
+{
+  std::vector<double> expected = Run (1);
+  //each terminal to the station, and the station to both terminals
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 4, "frames received after precomputing on one thread");
+  std::vector<double> threaded = Run (3);
+  NS_TEST_ASSERT_MSG_EQ (threaded.size (), expected.size (), "frames received after precomputing on 3 threads");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (threaded[i], expected[i], "SNR of frame " << i);
+    }
+}
+
+/**
+ * The satellite models with the wifi module
+ */
+class SatelliteWifiTestSuite : public TestSuite
+{
+public:
+  SatelliteWifiTestSuite ();
+};
+
+SatelliteWifiTestSuite::SatelliteWifiTestSuite ()
+  : TestSuite ("satellite-wifi", UNIT)
+{
+  AddTestCase (new SatellitePathCacheTestCase, TestCase::QUICK);
+}
+
+static SatelliteWifiTestSuite satelliteWifiTestSuite;
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the ACKs and CTSs a MacLow sends, as an AP
+// receiving the uplink frames of many stations.
+//
+// A PHY sends a data frame, or an RTS one time in ten, every 500 us on
+// behalf of a station drawn at random, and the MacLow of the AP answers
+// each with an ACK or a CTS.  The wall clock time per frame of the whole
+// simulation is reported with and without the ControlFrameTemplates of
+// MacLow, next to the number of answers received.
+//
+// ./waf --run "mac-low-control-frame-bench --frames=200000"
+//
+
+#include <iostream>
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/mac-low.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "yans-wifi-bench-phy.h"
+
+using namespace ns3;
+
+static uint32_t g_answers;
+
+static Mac48Address
+GetAddress (uint32_t n)
+{
+  //as Mac48Address::Allocate does
+  uint8_t buffer[6] = { 0, 0, 0, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t) n };
+  Mac48Address address;
+  address.CopyFrom (buffer);
+  return address;
+}
+
+static void
+Send (Ptr<YansWifiPhy> phy, Ptr<UniformRandomVariable> rng, uint32_t nStations, uint32_t left)
+{
+  WifiMacHeader hdr;
+  bool rts = rng->GetInteger (0, 9) == 0;
+  hdr.SetType (rts ? WIFI_MAC_CTL_RTS : WIFI_MAC_DATA);
+  hdr.SetAddr1 (GetAddress (0));
+  Mac48Address from = GetAddress (rng->GetInteger (1, nStations));
+  hdr.SetAddr2 (from);
+  hdr.SetAddr3 (GetAddress (0));
+  hdr.SetDsNotFrom ();
+  hdr.SetDsTo ();
+  hdr.SetDuration (MicroSeconds (rts ? 200 : 60));
+  Ptr<Packet> packet = Create<Packet> (rts ? 0 : 100);
+  packet->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  WifiTxVector txVector (WifiPhy::GetOfdmRate24Mbps (), 0, 0, false, 1, 0, false);
+  phy->SendPacket (packet, txVector, WIFI_PREAMBLE_LONG, 0);
+  if (left > 1)
+    {
+      Simulator::Schedule (MicroSeconds (500), &Send, phy, rng, nStations, left - 1);
+    }
+}
+
+static void
+Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  g_answers++;
+}
+
+static void
+ForwardUp (Ptr<Packet> packet, const WifiMacHeader *hdr)
+{
+}
+
+static int64_t
+Run (bool templates, uint32_t nStations, uint32_t nFrames)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<YansWifiPhy> stations = CreateBenchPhy (channel, Vector (0.0, 0.0, 0.0), CreateObject<YansErrorRateModel> ());
+  stations->SetReceiveOkCallback (MakeCallback (&Receive));
+  Ptr<YansWifiPhy> phy = CreateBenchPhy (channel, Vector (10.0, 0.0, 0.0), CreateObject<YansErrorRateModel> ());
+  Ptr<WifiRemoteStationManager> manager = CreateObjectWithAttributes<ConstantRateWifiManager> ("DataMode", StringValue ("OfdmRate24Mbps"));
+  manager->SetupPhy (phy);
+  Ptr<MacLow> low = CreateObjectWithAttributes<MacLow> ("ControlFrameTemplates", BooleanValue (templates));
+  low->SetAddress (GetAddress (0));
+  low->SetSifs (MicroSeconds (16));
+  low->SetSlotTime (MicroSeconds (9));
+  low->SetWifiRemoteStationManager (manager);
+  low->SetRxCallback (MakeCallback (&ForwardUp));
+  low->SetPhy (phy);
+
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  g_answers = 0;
+  Simulator::Schedule (MicroSeconds (100), &Send, stations, rng, nStations, nFrames);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  low->Dispose ();
+  manager->Dispose ();
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t frames = 200000;
+  uint32_t stations = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("frames", "Number of frames sent to the AP", frames);
+  cmd.AddValue ("stations", "Number of stations the frames are sent from", stations);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (12) << "templates" << std::setw (14) << "ns/frame"
+            << std::setw (12) << "answers" << std::endl;
+  for (uint32_t templates = 0; templates < 2; templates++)
+    {
+      int64_t elapsed = Run (templates, stations, frames);
+      std::cout << std::setw (12) << (templates ? "on" : "off")
+                << std::fixed << std::setprecision (1) << std::setw (14) << elapsed * 1e6 / frames
+                << std::setw (12) << g_answers << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the PHY computations made for every S1G data frame:
+// the durations MacLow::SendDataPacket asks the PHY for (the data frame
+// and its ACK) and the success rates of the two chunks of the frame at
+// its receiver (the PLCP header and the payload).
+//
+// The frames are sent over --links links whose SNRs are drawn once, so
+// that the SNRs repeat as between static stations, or, with --links=0,
+// at a new SNR each.  The wall clock time per frame is reported without
+// the caches, with the TxDurationCache of WifiPhy, with the PerCache of
+// YansErrorRateModel as well, and with the PerTableResolution tables
+// instead, next to the largest error of the payload success rates of
+// the tables.
+//
+// The same frames are then sent through MacLow::StartTransmission and
+// SendDataPacket by a station to an AP which acknowledges them, over a
+// YansWifiChannel, the station moving to the distance of the link of
+// each frame.  The wall clock time per frame of the whole simulation is
+// reported for each configuration, next to the number of ACKs received.
+//
+// ./waf --run "s1g-phy-tables-bench --frames=200000"
+// ./waf --run "s1g-phy-tables-bench --links=0"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "ns3/core-module.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/mac-low.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/constant-position-mobility-model.h"
+
+using namespace ns3;
+
+struct Frame
+{
+  uint32_t size;
+  double snr;
+  double distance; //!< between the station and the AP in the MacLow runs, in m
+};
+
+enum Config
+{
+  NO_CACHE,
+  DURATION_CACHE,
+  PER_CACHE,
+  PER_TABLE
+};
+
+static const char *g_configNames[] = { "no cache", "durations", "durations+per", "durations+table" };
+
+/**
+ * The station of the MacLow runs, which starts the transmission of the
+ * next frame once the previous one is acknowledged or not.
+ */
+class Station : public MacLowTransmissionListener
+{
+public:
+  Station (Ptr<MacLow> low, Ptr<ConstantPositionMobilityModel> mobility, Mac48Address ap,
+           const std::vector<Frame> &frames)
+    : m_low (low),
+      m_mobility (mobility),
+      m_ap (ap),
+      m_frames (frames),
+      m_next (0),
+      m_acks (0)
+  {
+  }
+  void Send (void)
+  {
+    if (m_next == m_frames.size ())
+      {
+        return;
+      }
+    const Frame &frame = m_frames[m_next++];
+    m_mobility->SetPosition (Vector (frame.distance, 0.0, 0.0));
+    WifiMacHeader hdr;
+    hdr.SetType (WIFI_MAC_DATA);
+    hdr.SetAddr1 (m_ap);
+    hdr.SetAddr2 (m_low->GetAddress ());
+    hdr.SetAddr3 (m_ap);
+    hdr.SetDsNotFrom ();
+    hdr.SetDsTo ();
+    MacLowTransmissionParameters params;
+    params.EnableAck ();
+    params.DisableRts ();
+    params.DisableNextData ();
+    params.DisableOverrideDurationId ();
+    //the size of the frame less the MAC header and the FCS
+    m_low->StartTransmission (Create<Packet> (frame.size - 28), &hdr, params, this);
+  }
+  uint32_t GetAcks (void) const
+  {
+    return m_acks;
+  }
+  virtual void GotCts (double snr, WifiMode txMode)
+  {
+  }
+  virtual void MissedCts (void)
+  {
+  }
+  virtual void GotAck (double snr, WifiMode txMode)
+  {
+    m_acks++;
+    Simulator::ScheduleNow (&Station::Send, this);
+  }
+  virtual void MissedAck (void)
+  {
+    Simulator::ScheduleNow (&Station::Send, this);
+  }
+  virtual void StartNext (void)
+  {
+  }
+  virtual void Cancel (void)
+  {
+  }
+  virtual void EndTxNoAck (void)
+  {
+  }
+
+private:
+  Ptr<MacLow> m_low;
+  Ptr<ConstantPositionMobilityModel> m_mobility;
+  Mac48Address m_ap;
+  const std::vector<Frame> &m_frames;
+  uint32_t m_next;
+  uint32_t m_acks;
+};
+
+static void
+ForwardUp (Ptr<Packet> packet, const WifiMacHeader *hdr)
+{
+}
+
+static Ptr<MacLow>
+CreateMacLow (enum Config config, double resolution, Ptr<YansWifiChannel> channel,
+              Ptr<MobilityModel> mobility, Mac48Address address, int64_t stream)
+{
+  Ptr<YansWifiPhy> phy = CreateObjectWithAttributes<YansWifiPhy> ("TxDurationCache", BooleanValue (config != NO_CACHE),
+                                                                  "ChannelWidth", UintegerValue (2),
+                                                                  "EnergyDetectionThreshold", DoubleValue (-110.0),
+                                                                  "CcaMode1Threshold", DoubleValue (-113.0));
+  phy->SetErrorRateModel (CreateObjectWithAttributes<YansErrorRateModel> ("PerCache", BooleanValue (config == PER_CACHE),
+                                                                          "PerTableResolution",
+                                                                          DoubleValue (config == PER_TABLE ? resolution : 0)));
+  phy->SetChannel (channel);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ah);
+  //the same draws in every configuration
+  phy->AssignStreams (stream);
+  Ptr<WifiRemoteStationManager> manager = CreateObjectWithAttributes<ConstantRateWifiManager>
+      ("DataMode", StringValue ("OfdmRate7_8MbpsBW2MHz"), "ControlMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+  manager->SetupPhy (phy);
+  Ptr<MacLow> low = CreateObject<MacLow> ();
+  low->SetAddress (address);
+  //as WifiMac::Configure80211ah
+  low->SetSifs (MicroSeconds (160));
+  low->SetSlotTime (MicroSeconds (52));
+  low->SetPifs (MicroSeconds (160 + 52));
+  low->SetAckTimeout (MicroSeconds (160 + 1120 + 52 + 2 * 4));
+  low->SetCtsTimeout (MicroSeconds (160 + 1120 + 52 + 2 * 4));
+  low->SetWifiRemoteStationManager (manager);
+  low->SetRxCallback (MakeCallback (&ForwardUp));
+  low->SetPhy (phy);
+  return low;
+}
+
+static int64_t
+RunMacLow (enum Config config, double resolution, const std::vector<Frame> &frames, uint32_t &acks)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Mac48Address apAddress ("00:00:00:00:00:01");
+  Ptr<ConstantPositionMobilityModel> stationMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MacLow> ap = CreateMacLow (config, resolution, channel, CreateObject<ConstantPositionMobilityModel> (), apAddress, 0);
+  Ptr<MacLow> low = CreateMacLow (config, resolution, channel, stationMobility, Mac48Address ("00:00:00:00:00:02"), 1);
+  Station station (low, stationMobility, apAddress, frames);
+  Simulator::Schedule (MicroSeconds (100), &Station::Send, &station);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  acks = station.GetAcks ();
+  ap->Dispose ();
+  low->Dispose ();
+  return elapsed;
+}
+
+static int64_t
+Run (enum Config config, double resolution, const std::vector<Frame> &frames, std::vector<double> &rates)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetAttribute ("TxDurationCache", BooleanValue (config != NO_CACHE));
+  Ptr<YansErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  error->SetAttribute ("PerCache", BooleanValue (config == PER_CACHE));
+  error->SetAttribute ("PerTableResolution", DoubleValue (config == PER_TABLE ? resolution : 0));
+
+  WifiMode dataMode = WifiPhy::GetOfdmRate7_8MbpsBW2MHz ();
+  WifiMode headerMode = WifiPhy::GetOfdmRate650KbpsBW2MHz ();
+  WifiTxVector dataTxVector (dataMode, 0, 0, false, 1, 0, false);
+  WifiTxVector ackTxVector (headerMode, 0, 0, false, 1, 0, false);
+  double frequency = phy->GetFrequency ();
+  rates.clear ();
+  rates.reserve (frames.size ());
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  int64_t total = 0;
+  for (std::vector<Frame>::const_iterator it = frames.begin (); it != frames.end (); it++)
+    {
+      Time data = phy->CalculateTxDuration (it->size, dataTxVector, WIFI_PREAMBLE_S1G_LONG, frequency, 0, 0);
+      Time ack = phy->CalculateTxDuration (14, ackTxVector, WIFI_PREAMBLE_S1G_LONG, frequency, 0, 0);
+      total += data.GetNanoSeconds () + ack.GetNanoSeconds ();
+      double header = error->GetChunkSuccessRate (headerMode, it->snr, 48);
+      double payload = error->GetChunkSuccessRate (dataMode, it->snr, it->size * 8);
+      rates.push_back (header * payload);
+    }
+  int64_t elapsed = clock.End ();
+  NS_ABORT_IF (total <= 0);
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t frames = 200000;
+  uint32_t links = 64;
+  double resolution = 0.05;
+
+  CommandLine cmd;
+  cmd.AddValue ("frames", "Number of data frames", frames);
+  cmd.AddValue ("links", "Number of links the frames are sent over; a new SNR each frame if 0", links);
+  cmd.AddValue ("resolution", "PerTableResolution of the tables, in dB", resolution);
+  cmd.Parse (argc, argv);
+
+  static const uint32_t sizes[] = { 64, 100, 128, 256, 512, 1024, 1500 };
+  Ptr<UniformRandomVariable> db = CreateObject<UniformRandomVariable> ();
+  db->SetAttribute ("Min", DoubleValue (0));
+  db->SetAttribute ("Max", DoubleValue (30));
+  //SNRs from about 13 dB to 43 dB, with the log distance loss and the
+  //noise of 2 MHz channels
+  Ptr<UniformRandomVariable> distance = CreateObject<UniformRandomVariable> ();
+  distance->SetAttribute ("Min", DoubleValue (10));
+  distance->SetAttribute ("Max", DoubleValue (100));
+  std::vector<double> linkSnrs;
+  std::vector<double> linkDistances;
+  for (uint32_t i = 0; i < links; i++)
+    {
+      linkSnrs.push_back (std::pow (10.0, db->GetValue () / 10));
+      linkDistances.push_back (distance->GetValue ());
+    }
+  std::vector<Frame> sequence;
+  for (uint32_t i = 0; i < frames; i++)
+    {
+      Frame frame;
+      frame.size = sizes[i % 7] + 36;
+      frame.snr = links > 0 ? linkSnrs[i % links] : std::pow (10.0, db->GetValue () / 10);
+      frame.distance = links > 0 ? linkDistances[i % links] : distance->GetValue ();
+      sequence.push_back (frame);
+    }
+
+  std::cout << std::setw (18) << "config" << std::setw (14) << "ns/frame"
+            << std::setw (14) << "max error" << std::setw (16) << "MacLow ns/frame"
+            << std::setw (10) << "ACKs" << std::endl;
+  std::vector<double> exact;
+  for (uint32_t c = NO_CACHE; c <= PER_TABLE; c++)
+    {
+      std::vector<double> rates;
+      int64_t elapsed = Run ((enum Config) c, resolution, sequence, rates);
+      if (c == NO_CACHE)
+        {
+          exact = rates;
+        }
+      double maxError = 0;
+      for (uint32_t i = 0; i < rates.size (); i++)
+        {
+          maxError = std::max (maxError, std::fabs (rates[i] - exact[i]));
+        }
+      uint32_t acks;
+      int64_t macLowElapsed = RunMacLow ((enum Config) c, resolution, sequence, acks);
+      std::cout << std::setw (18) << g_configNames[c]
+                << std::fixed << std::setprecision (1) << std::setw (14) << elapsed * 1e6 / frames
+                << std::scientific << std::setprecision (2) << std::setw (14) << maxError
+                << std::fixed << std::setprecision (1) << std::setw (16) << macLowElapsed * 1e6 / frames
+                << std::setw (10) << acks << std::endl;
+    }
+  return 0;
+}
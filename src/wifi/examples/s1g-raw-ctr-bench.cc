@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the beacon-time RAW regrouping done by S1gRawCtr.
+//
+// For each station count, one S1gRawCtr is fed the same kind of input
+// ApWifiMac hands it on every beacon: the list of associated sensors and
+// the AIDs received during the last beacon interval.  Sensor n transmits
+// every (1 + n % 20) beacons.  The wall clock time spent in
+// UpdateRAWGroupping is reported per beacon, with the controller trace
+// written to outputpath + "rawctr.txt" unless --trace=0.  With
+// --incremental=1 the controller is fed association and reception events
+// instead of the full station lists.
+//
+// ./waf --run "s1g-raw-ctr-bench --beacons=200 --trace=0"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/s1g-raw-control.h"
+
+using namespace ns3;
+
+static double
+RunOne (uint16_t nStations, uint32_t nBeacons, bool trace, bool incremental, std::string outputpath)
+{
+  S1gRawCtr ctr;
+  ctr.SetTraceEnabled (trace);
+  ctr.SetIncremental (incremental);
+  std::vector<uint16_t> sensors;
+  std::vector<uint16_t> offload;
+  std::vector<uint16_t> received;
+  for (uint16_t aid = 1; aid <= nStations; aid++)
+    {
+      sensors.push_back (aid);
+      if (incremental)
+        {
+          ctr.NotifyAssociated (aid, 1);
+        }
+    }
+
+  SystemWallClockMs clock;
+  int64_t elapsed = 0;
+  for (uint32_t beacon = 1; beacon <= nBeacons; beacon++)
+    {
+      //stations allowed in the last beacon whose period has come up
+      received.clear ();
+      for (std::vector<uint16_t>::const_iterator it = ctr.m_aidList.begin (); it != ctr.m_aidList.end (); it++)
+        {
+          if (beacon % (1 + *it % 20) == 0)
+            {
+              received.push_back (*it);
+            }
+        }
+
+      clock.Start ();
+      if (incremental)
+        {
+          for (std::vector<uint16_t>::const_iterator it = received.begin (); it != received.end (); it++)
+            {
+              ctr.NotifyReceived (*it);
+            }
+          ctr.UpdateRAWGroupping (102400, outputpath);
+        }
+      else
+        {
+          ctr.UpdateRAWGroupping (sensors, offload, received, 102400, outputpath);
+        }
+      elapsed += clock.End ();
+    }
+  return elapsed * 1000.0 / nBeacons;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t beacons = 100;
+  bool trace = true;
+  bool incremental = false;
+  std::string outputpath = "/tmp/s1g-raw-ctr-bench-";
+
+  CommandLine cmd;
+  cmd.AddValue ("beacons", "Number of beacons to run for each station count", beacons);
+  cmd.AddValue ("trace", "Whether S1gRawCtr writes its trace file", trace);
+  cmd.AddValue ("incremental", "Drive S1gRawCtr with association and reception events", incremental);
+  cmd.AddValue ("outputpath", "Prefix of the trace file written by S1gRawCtr", outputpath);
+  cmd.Parse (argc, argv);
+
+  uint16_t counts[] = { 64, 1024, 8191 };
+  std::cout << std::setw (10) << "stations" << std::setw (10) << "beacons"
+            << std::setw (16) << "us/beacon" << std::endl;
+  for (uint32_t i = 0; i < sizeof (counts) / sizeof (counts[0]); i++)
+    {
+      double us = RunOne (counts[i], beacons, trace, incremental, outputpath);
+      std::cout << std::setw (10) << counts[i] << std::setw (10) << beacons
+                << std::setw (16) << std::fixed << std::setprecision (1) << us << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the sensor transmission interval estimate made by
+// S1gRawCtr on every beacon.
+//
+// The receptions of a recorded controller trace (the "rawctr.txt" file
+// S1gRawCtr writes when its trace is enabled) are replayed into a
+// SensorTable, and the sensors which tried in a beacon are estimated
+// either one by one with Sensor::EstimateTransmissionInterval ("scalar")
+// or in one SensorTable::EstimateTransmissionIntervals pass ("batched").
+// Both must predict the same next transmission ids.  Times are wall
+// clock microseconds per beacon.  The reception bookkeeping is timed on
+// its own and subtracted from the times of the estimators.
+//
+// Without --trace, a trace is first recorded from an S1gRawCtr driven as
+// in s1g-raw-ctr-bench, to outputpath + "rawctr.txt".
+//
+// ./waf --run "s1g-raw-estimator-bench --stations=8191 --beacons=200"
+// ./waf --run "s1g-raw-estimator-bench --trace=/path/to/rawctr.txt"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/s1g-raw-control.h"
+
+using namespace ns3;
+
+struct Reception
+{
+  uint16_t aid;
+  uint16_t received;
+};
+
+//the receptions of one beacon interval
+typedef std::vector<Reception> Beacon;
+
+static void
+Record (uint16_t nStations, uint32_t nBeacons, std::string outputpath)
+{
+  S1gRawCtr ctr;
+  ctr.SetTraceEnabled (true);
+  std::vector<uint16_t> sensors;
+  std::vector<uint16_t> offload;
+  std::vector<uint16_t> received;
+  for (uint16_t aid = 1; aid <= nStations; aid++)
+    {
+      sensors.push_back (aid);
+    }
+  for (uint32_t beacon = 1; beacon <= nBeacons; beacon++)
+    {
+      received.clear ();
+      for (std::vector<uint16_t>::const_iterator it = ctr.m_aidList.begin (); it != ctr.m_aidList.end (); it++)
+        {
+          if (beacon % (1 + *it % 20) == 0)
+            {
+              received.push_back (*it);
+            }
+        }
+      ctr.UpdateRAWGroupping (sensors, offload, received, 102400, outputpath);
+    }
+}
+
+static std::vector<Beacon>
+Load (std::string filename, uint16_t &maxAid)
+{
+  std::ifstream file (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "cannot open " << filename);
+  std::vector<Beacon> beacons;
+  uint64_t first = 0;
+  uint64_t beacon;
+  uint16_t aid, type, scheduled, received;
+  uint64_t transInOneBeacon;
+  maxAid = 0;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream fields (line);
+      if (line.empty () || line[0] == '#'
+          || !(fields >> beacon >> aid >> type >> scheduled >> received >> transInOneBeacon)
+          || type != RawCtrTrace::SENSOR)
+        {
+          continue;
+        }
+      if (beacons.empty ())
+        {
+          first = beacon;
+        }
+      NS_ABORT_MSG_IF (beacon < first, "trace beacons out of order");
+      beacons.resize (beacon - first + 1);
+      Reception r;
+      r.aid = aid;
+      r.received = received;
+      beacons.back ().push_back (r);
+      maxAid = std::max (maxAid, aid);
+    }
+  return beacons;
+}
+
+//the bookkeeping of S1gRawCtr before the estimate
+static void
+Receive (SensorTable &table, const Beacon &beacon, uint64_t currentId)
+{
+  for (Beacon::const_iterator it = beacon.begin (); it != beacon.end (); it++)
+    {
+      Sensor * sensor = table.Lookup (it->aid);
+      UpdateInfo & info = sensor->GetUpdateInfo ();
+      if (it->received > 0)
+        {
+          sensor->SetTransmissionSuccess (true);
+          if (sensor->GetEverSuccess () == false)
+            {
+              info = (UpdateInfo){currentId-1,currentId-1,currentId-1,false,currentId-1,currentId-1,currentId-1,false};
+              sensor->SetEverSuccess (true);
+              sensor->ResetTransIntervalList ();
+            }
+          info.lastTryBFpreSuccessId = info.lastTryBFCurrentSuccessId;
+          info.preSuccessId = info.CurrentSuccessId;
+          info.CurrentSuccessId = currentId;
+          info.lastTryBFCurrentSuccessId = std::max (info.preSuccessId, info.CurrentUnSuccessId);
+          info.preTrySuccess = info.CurrentTrySuccess;
+          info.CurrentTrySuccess = true;
+        }
+      else
+        {
+          sensor->SetTransmissionSuccess (false);
+          info.preUnsuccessId = info.CurrentUnSuccessId;
+          info.CurrentUnSuccessId = currentId;
+          info.preSuccessId = info.CurrentSuccessId;
+          info.preTrySuccess = info.CurrentTrySuccess;
+          info.CurrentTrySuccess = false;
+        }
+      sensor->SetNumPacketsReceived (it->received);
+    }
+}
+
+enum Estimator
+{
+  NONE,
+  SCALAR,
+  BATCHED
+};
+
+/**
+ * Replay the trace into table.  With check, the next transmission ids of
+ * every beacon are appended to it.
+ */
+static void
+Replay (SensorTable &table, const std::vector<Beacon> &beacons, enum Estimator estimator,
+        std::vector<uint64_t> *check)
+{
+  std::vector<uint16_t> aids;
+  for (uint32_t b = 0; b < beacons.size (); b++)
+    {
+      uint64_t currentId = b + 1;
+      Receive (table, beacons[b], currentId);
+      aids.clear ();
+      for (Beacon::const_iterator it = beacons[b].begin (); it != beacons[b].end (); it++)
+        {
+          aids.push_back (it->aid);
+        }
+      if (estimator == SCALAR)
+        {
+          for (std::vector<uint16_t>::const_iterator it = aids.begin (); it != aids.end (); it++)
+            {
+              table.Lookup (*it)->EstimateTransmissionInterval (currentId, 102400);
+            }
+        }
+      else if (estimator == BATCHED)
+        {
+          table.EstimateTransmissionIntervals (aids, currentId);
+        }
+      if (check != 0)
+        {
+          for (std::vector<uint16_t>::const_iterator it = aids.begin (); it != aids.end (); it++)
+            {
+              check->push_back (table.Lookup (*it)->GetEstimateNextTransmissionId ());
+            }
+        }
+    }
+}
+
+static void
+Fill (SensorTable &table, uint16_t maxAid)
+{
+  for (uint16_t aid = 1; aid <= maxAid; aid++)
+    {
+      table.Add (aid);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t beacons = 200;
+  uint16_t stations = 8191;
+  uint32_t repeat = 20;
+  std::string trace;
+  std::string outputpath = "/tmp/s1g-raw-estimator-bench-";
+
+  CommandLine cmd;
+  cmd.AddValue ("trace", "Controller trace to replay; recorded first if empty", trace);
+  cmd.AddValue ("stations", "Number of stations of the recorded trace", stations);
+  cmd.AddValue ("beacons", "Number of beacons of the recorded trace", beacons);
+  cmd.AddValue ("repeat", "Number of replays of the trace timed for each estimator", repeat);
+  cmd.AddValue ("outputpath", "Prefix of the recorded trace file", outputpath);
+  cmd.Parse (argc, argv);
+
+  if (trace.empty ())
+    {
+      Record (stations, beacons, outputpath);
+      trace = outputpath + "rawctr.txt";
+    }
+  uint16_t maxAid;
+  std::vector<Beacon> replay = Load (trace, maxAid);
+  uint64_t estimates = 0;
+  for (std::vector<Beacon>::const_iterator it = replay.begin (); it != replay.end (); it++)
+    {
+      estimates += it->size ();
+    }
+
+  //both estimators must predict the same next transmission ids
+  std::vector<uint64_t> scalarIds;
+  std::vector<uint64_t> batchedIds;
+  {
+    SensorTable scalar;
+    SensorTable batched;
+    Fill (scalar, maxAid);
+    Fill (batched, maxAid);
+    Replay (scalar, replay, SCALAR, &scalarIds);
+    Replay (batched, replay, BATCHED, &batchedIds);
+  }
+  NS_ABORT_MSG_IF (scalarIds != batchedIds, "scalar and batched estimates disagree");
+
+  int64_t elapsed[3] = { 0, 0, 0 };
+  for (uint32_t r = 0; r < repeat; r++)
+    {
+      for (uint32_t e = NONE; e <= BATCHED; e++)
+        {
+          SensorTable table;
+          Fill (table, maxAid);
+          SystemWallClockMs clock;
+          clock.Start ();
+          Replay (table, replay, (enum Estimator) e, 0);
+          elapsed[e] += clock.End ();
+        }
+    }
+
+  double perBeacon = 1000.0 / repeat / replay.size ();
+  elapsed[SCALAR] -= elapsed[NONE];
+  elapsed[BATCHED] -= elapsed[NONE];
+  std::cout << std::setw (10) << "beacons" << std::setw (14) << "estimates"
+            << std::setw (16) << "bookkeeping us" << std::setw (14) << "scalar us"
+            << std::setw (14) << "batched us" << std::endl;
+  std::cout << std::setw (10) << replay.size () << std::setw (14) << estimates
+            << std::fixed << std::setprecision (1)
+            << std::setw (16) << elapsed[NONE] * perBeacon
+            << std::setw (14) << elapsed[SCALAR] * perBeacon
+            << std::setw (14) << elapsed[BATCHED] * perBeacon << std::endl;
+  return 0;
+}
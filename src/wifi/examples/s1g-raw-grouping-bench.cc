@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the RAW grouping strategies ApWifiMac can ask for the
+// RPS of every S1G beacon.
+//
+// For each station count, the stations are spread over the four pages
+// and station n sends a frame every (1 + n % 20) beacons.  Both the
+// HeuristicRawGrouping and the LoadRawGrouping are fed the association
+// and reception events, and the wall clock time of GetRps is reported
+// per beacon, next to the beacon interval it has to fit in.  The RAW
+// groups of the last beacon of LoadRawGrouping are summed up: their
+// number and the most frames expected in one slot.
+//
+// With --traffic, the LoadRawGrouping groups for a traffic file of
+// OptimalRawGroup/traffic are printed instead.
+//
+// ./waf --run "s1g-raw-grouping-bench --beacons=50"
+// ./waf --run "s1g-raw-grouping-bench --traffic=OptimalRawGroup/traffic/data-32-0.82.txt --stations=32"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+#include "ns3/core-module.h"
+#include "ns3/raw-grouping-strategy.h"
+
+using namespace ns3;
+
+//station n of the four pages
+static uint16_t
+GetAid (uint32_t n)
+{
+  return ((n % 4) << 11) | (1 + n / 4 % 1023);
+}
+
+static int64_t
+Run (Ptr<RawGroupingStrategy> grouping, uint32_t nStations, uint32_t nBeacons)
+{
+  for (uint32_t n = 0; n < nStations; n++)
+    {
+      grouping->NotifyAssociated (GetAid (n), 1);
+    }
+  int64_t elapsed = 0;
+  for (uint32_t beacon = 1; beacon <= nBeacons; beacon++)
+    {
+      for (uint32_t n = 0; n < nStations; n++)
+        {
+          if (beacon % (1 + n % 20) == 0)
+            {
+              grouping->NotifyReceived (GetAid (n));
+            }
+        }
+      SystemWallClockMs clock;
+      clock.Start ();
+      grouping->GetRps (102400);
+      elapsed += clock.End ();
+    }
+  return elapsed;
+}
+
+static void
+PrintGroups (const std::vector<LoadRawGrouping::Group> &groups)
+{
+  std::cout << std::setw (10) << "aid start" << std::setw (10) << "aid end" << std::setw (8) << "slots"
+            << std::setw (12) << "slot count" << std::setw (16) << "busiest slot" << std::endl;
+  for (std::vector<LoadRawGrouping::Group>::const_iterator it = groups.begin (); it != groups.end (); it++)
+    {
+      std::cout << std::setw (10) << it->aidStart << std::setw (10) << it->aidEnd
+                << std::setw (8) << it->slotNum << std::setw (12) << it->slotDurationCount
+                << std::fixed << std::setprecision (2) << std::setw (16) << it->maxSlotLoad << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t beacons = 50;
+  uint32_t stations = 0;
+  std::string traffic;
+
+  CommandLine cmd;
+  cmd.AddValue ("beacons", "Number of beacons to run for each station count", beacons);
+  cmd.AddValue ("stations", "Station count to run; 32 to 8192 if 0", stations);
+  cmd.AddValue ("traffic", "Traffic file to print the LoadRawGrouping groups of", traffic);
+  cmd.Parse (argc, argv);
+
+  if (!traffic.empty ())
+    {
+      Ptr<LoadRawGrouping> grouping = CreateObjectWithAttributes<LoadRawGrouping> ("TrafficFile", StringValue (traffic));
+      for (uint16_t aid = 1; aid <= std::max (stations, 1u); aid++)
+        {
+          grouping->NotifyAssociated (aid, 1);
+        }
+      PrintGroups (grouping->Solve (102400));
+      return 0;
+    }
+
+  std::vector<uint32_t> counts;
+  if (stations != 0)
+    {
+      counts.push_back (stations);
+    }
+  else
+    {
+      for (uint32_t n = 32; n <= 8192; n *= 4)
+        {
+          counts.push_back (n);
+        }
+    }
+  std::cout << std::setw (10) << "stations" << std::setw (14) << "beacon us"
+            << std::setw (14) << "heuristic us" << std::setw (14) << "load us"
+            << std::setw (8) << "groups" << std::setw (16) << "busiest slot" << std::endl;
+  for (std::vector<uint32_t>::const_iterator n = counts.begin (); n != counts.end (); n++)
+    {
+      Ptr<HeuristicRawGrouping> heuristic = CreateObject<HeuristicRawGrouping> ();
+      Ptr<LoadRawGrouping> load = CreateObject<LoadRawGrouping> ();
+      int64_t heuristicMs = Run (heuristic, *n, beacons);
+      int64_t loadMs = Run (load, *n, beacons);
+      const std::vector<LoadRawGrouping::Group> & groups = load->Solve (102400);
+      double busiest = 0;
+      for (std::vector<LoadRawGrouping::Group>::const_iterator it = groups.begin (); it != groups.end (); it++)
+        {
+          busiest = std::max (busiest, it->maxSlotLoad);
+        }
+      std::cout << std::setw (10) << *n << std::setw (14) << 102400
+                << std::fixed << std::setprecision (1)
+                << std::setw (14) << heuristicMs * 1000.0 / beacons
+                << std::setw (14) << loadMs * 1000.0 / beacons
+                << std::setw (8) << groups.size ()
+                << std::setprecision (2) << std::setw (16) << busiest << std::endl;
+    }
+  return 0;
+}
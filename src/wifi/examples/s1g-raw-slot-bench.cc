@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the RAW slot lookup done by every station on every
+// S1G beacon.
+//
+// For each number of RAW groups, an RPS element splits the AIDs of the
+// four pages evenly among the groups.  Per beacon, the AP decodes the
+// beacon into an S1gBeaconInfo once ("build") and each of --stations
+// stations then looks up its slot, either with S1gBeaconInfo::FindSlot
+// ("lookup") or by scanning all the RAWs as StaWifiMac used to ("scan").
+// Times are wall clock microseconds per beacon.
+// An RPS element holds at most 42 RAW assignments, so that is the
+// largest number of groups.
+//
+// ./waf --run "s1g-raw-slot-bench --beacons=200"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/s1g-beacon-tag.h"
+
+using namespace ns3;
+
+static RPS
+MakeRps (uint16_t nGroups)
+{
+  RPS rps;
+  for (uint16_t k = 0; k < nGroups; k++)
+    {
+      uint32_t page = k % 4;
+      uint32_t inPage = (nGroups - page + 3) / 4;
+      uint32_t index = k / 4;
+      uint32_t aidStart = 1024 * index / inPage;
+      uint32_t aidEnd = 1024 * (index + 1) / inPage - 1;
+      RPS::RawAssignment raw;
+      raw.SetRawControl (0);
+      raw.SetSlotCrossBoundary (1);
+      raw.SetSlotFormat (1);
+      raw.SetSlotDurationCount (102400 / nGroups / 8 / 120);
+      raw.SetSlotNum (7);
+      raw.SetRawGroup ((aidEnd << 13) | (aidStart << 2) | page);
+      rps.SetRawAssignment (raw);
+    }
+  return rps;
+}
+
+//the slot search StaWifiMac did before S1gBeaconInfo::FindSlot
+static bool
+ScanSlot (const S1gBeaconInfo &info, uint16_t aid, uint64_t &startUs)
+{
+  bool found = false;
+  const std::vector<S1gBeaconInfo::Raw> & raws = info.GetRaws ();
+  for (std::vector<S1gBeaconInfo::Raw>::const_iterator raw = raws.begin (); raw != raws.end (); ++raw)
+    {
+      if (raw->page == ((aid >> 11) & 0x0003)
+          && raw->rawStartAid <= (aid & 0x03ff) && (aid & 0x03ff) <= raw->rawEndAid)
+        {
+          startUs = (500 + raw->slotDurationCount * 120) * ((aid & 0x03ff) % raw->slotNum) + raw->startUs;
+          found = true;
+        }
+    }
+  return found;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t beacons = 200;
+  uint16_t stations = 8191;
+
+  CommandLine cmd;
+  cmd.AddValue ("beacons", "Number of beacons to run for each number of RAW groups", beacons);
+  cmd.AddValue ("stations", "Number of stations looking up their slot every beacon", stations);
+  cmd.Parse (argc, argv);
+
+  uint16_t groups[] = { 1, 2, 4, 8, 16, 32, 42 };
+  std::cout << std::setw (8) << "groups" << std::setw (10) << "stations"
+            << std::setw (14) << "build us" << std::setw (14) << "lookup us"
+            << std::setw (14) << "scan us" << std::endl;
+  for (uint32_t i = 0; i < sizeof (groups) / sizeof (groups[0]); i++)
+    {
+      S1gBeaconHeader beacon;
+      beacon.SetRPS (MakeRps (groups[i]));
+
+      SystemWallClockMs clock;
+      Ptr<S1gBeaconInfo> info;
+      clock.Start ();
+      for (uint32_t b = 0; b < beacons; b++)
+        {
+          info = Create<S1gBeaconInfo> (beacon);
+        }
+      int64_t build = clock.End ();
+
+      uint64_t check = 0;
+      clock.Start ();
+      for (uint32_t b = 0; b < beacons; b++)
+        {
+          for (uint16_t aid = 1; aid <= stations; aid++)
+            {
+              S1gBeaconInfo::Slot slot;
+              if (info->FindSlot (aid, slot))
+                {
+                  check += slot.startUs;
+                }
+            }
+        }
+      int64_t lookup = clock.End ();
+
+      clock.Start ();
+      for (uint32_t b = 0; b < beacons; b++)
+        {
+          for (uint16_t aid = 1; aid <= stations; aid++)
+            {
+              uint64_t startUs;
+              if (ScanSlot (*info, aid, startUs))
+                {
+                  check -= startUs;
+                }
+            }
+        }
+      int64_t scan = clock.End ();
+      NS_ABORT_MSG_IF (check != 0, "lookup and scan disagree");
+      std::cout << std::setw (8) << groups[i] << std::setw (10) << stations
+                << std::fixed << std::setprecision (1)
+                << std::setw (14) << build * 1000.0 / beacons
+                << std::setw (14) << lookup * 1000.0 / beacons
+                << std::setw (14) << scan * 1000.0 / beacons << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the per-station lookups of a WifiRemoteStationManager
+// at an AP with many associated stations.
+//
+// Every station is associated, supports all the modes of the PHY and
+// gets a first frame, untimed.  Then, for each data frame, sent to a
+// station drawn at random, the manager is asked the TX vector of the
+// data, gets the outcome of the transmission (an ACK 90% of the time) and
+// is told about a frame received from the station, as MacLow does.  The
+// wall clock time per data frame is reported for ConstantRateWifiManager
+// and MinstrelWifiManager at each station count.
+//
+// ./waf --run "wifi-remote-station-manager-bench --frames=200000"
+// ./waf --run "wifi-remote-station-manager-bench --stations=8000"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/adhoc-wifi-mac.h"
+
+using namespace ns3;
+
+static Mac48Address
+GetAddress (uint32_t n)
+{
+  //as Mac48Address::Allocate does
+  uint8_t buffer[6] = { 0, 0, 0, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t) n };
+  Mac48Address address;
+  address.CopyFrom (buffer);
+  return address;
+}
+
+static int64_t
+Run (std::string type, uint32_t nStations, uint32_t nFrames)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  if (type == "ns3::ConstantRateWifiManager")
+    {
+      factory.Set ("DataMode", StringValue ("OfdmRate24Mbps"));
+    }
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+  //MinstrelWifiManager asks the MAC for the slot and ACK timeout
+  Ptr<AdhocWifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  manager->SetupPhy (phy);
+  manager->SetupMac (mac);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t n = 1; n <= nStations; n++)
+    {
+      Mac48Address address = GetAddress (n);
+      addresses.push_back (address);
+      for (uint32_t i = 0; i < phy->GetNModes (); i++)
+        {
+          manager->AddSupportedMode (address, phy->GetMode (i));
+        }
+      manager->RecordGotAssocTxOk (address);
+    }
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  WifiMode ackMode = phy->GetMode (0);
+  //MinstrelWifiManager sets its rate tables up at the first frame to each station
+  for (std::vector<Mac48Address>::const_iterator it = addresses.begin (); it != addresses.end (); it++)
+    {
+      hdr.SetAddr1 (*it);
+      manager->GetDataTxVector (*it, &hdr, packet, 1028);
+      manager->ReportDataOk (*it, &hdr, 20, ackMode, 20);
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      Mac48Address address = addresses[rng->GetInteger (0, nStations - 1)];
+      hdr.SetAddr1 (address);
+      WifiTxVector txVector = manager->GetDataTxVector (address, &hdr, packet, 1028);
+      if (rng->GetValue () < 0.9)
+        {
+          manager->ReportDataOk (address, &hdr, 20, ackMode, 20);
+        }
+      else
+        {
+          manager->ReportDataFailed (address, &hdr);
+        }
+      manager->ReportRxOk (address, &hdr, 20, txVector.GetMode ());
+    }
+  int64_t elapsed = clock.End ();
+  manager->Dispose ();
+  mac->Dispose ();
+  phy->Dispose ();
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t frames = 200000;
+  uint32_t stations = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("frames", "Number of data frames for each manager and station count", frames);
+  cmd.AddValue ("stations", "Station count to run; 10, 1000 and 8000 if 0", stations);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint32_t> counts;
+  if (stations != 0)
+    {
+      counts.push_back (stations);
+    }
+  else
+    {
+      counts.push_back (10);
+      counts.push_back (1000);
+      counts.push_back (8000);
+    }
+  std::cout << std::setw (10) << "stations" << std::setw (16) << "constant ns"
+            << std::setw (16) << "minstrel ns" << std::endl;
+  for (std::vector<uint32_t>::const_iterator n = counts.begin (); n != counts.end (); n++)
+    {
+      int64_t constantMs = Run ("ns3::ConstantRateWifiManager", *n, frames);
+      int64_t minstrelMs = Run ("ns3::MinstrelWifiManager", *n, frames);
+      std::cout << std::setw (10) << *n << std::fixed << std::setprecision (1)
+                << std::setw (16) << constantMs * 1e6 / frames
+                << std::setw (16) << minstrelMs * 1e6 / frames << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,39 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// The PHYs of the micro-benchmarks which drive a YansWifiChannel
+// directly, without a node or a net device.
+//
+
+#ifndef YANS_WIFI_BENCH_PHY_H
+#define YANS_WIFI_BENCH_PHY_H
+
+#include "ns3/vector.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/error-rate-model.h"
+
+/**
+ * \param channel the channel of the PHY
+ * \param position the position of the PHY, which stands still
+ * \param errorRateModel the error rate model of the PHY
+ * \return an 802.11a YansWifiPhy on channel
+ */
+ns3::Ptr<ns3::YansWifiPhy> CreateBenchPhy (ns3::Ptr<ns3::YansWifiChannel> channel, ns3::Vector position,
+                                           ns3::Ptr<ns3::ErrorRateModel> errorRateModel);
+
+#endif /* YANS_WIFI_BENCH_PHY_H */
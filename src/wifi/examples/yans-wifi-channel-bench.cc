@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Micro-benchmark of the delivery of frames by YansWifiChannel.
+//
+// One PHY sends 1000 byte frames back to back at 6 Mbit/s to receivers
+// spread on a 10 m circle around it, all of which receive every frame.
+// For each receiver count, the receptions (one receive event of the
+// channel each) per second of wall clock time are reported, with the
+// peak resident set size of the process so far.  The receiver counts run
+// in increasing order, so the peak is that of the last count.
+//
+// ./waf --run "yans-wifi-channel-bench --receptions=1000000"
+// ./waf --run "yans-wifi-channel-bench --receivers=5000"
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <sys/resource.h>
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "yans-wifi-bench-phy.h"
+
+using namespace ns3;
+
+static uint64_t g_received;
+
+static void
+Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  g_received++;
+}
+
+static void
+Send (Ptr<YansWifiPhy> phy, uint32_t nFrames)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  Ptr<Packet> packet = Create<Packet> (1000);
+  phy->SendPacket (packet, txVector, WIFI_PREAMBLE_LONG, 0);
+  if (nFrames > 1)
+    {
+      Simulator::Schedule (MilliSeconds (2), &Send, phy, nFrames - 1);
+    }
+}
+
+static long
+GetPeakRssKb (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t receivers = 0;
+  uint64_t receptions = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("receivers", "Receiver count to run; 1, 100 and 5000 if 0", receivers);
+  cmd.AddValue ("receptions", "Receptions to time for each receiver count", receptions);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint32_t> counts;
+  if (receivers != 0)
+    {
+      counts.push_back (receivers);
+    }
+  else
+    {
+      counts.push_back (1);
+      counts.push_back (100);
+      counts.push_back (5000);
+    }
+  std::cout << std::setw (10) << "receivers" << std::setw (10) << "frames"
+            << std::setw (14) << "receptions" << std::setw (16) << "receptions/s"
+            << std::setw (16) << "peak RSS kB" << std::endl;
+  for (std::vector<uint32_t>::const_iterator n = counts.begin (); n != counts.end (); n++)
+    {
+      Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+      channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+      Ptr<YansWifiPhy> sender = CreateBenchPhy (channel, Vector (0.0, 0.0, 0.0), CreateObject<NistErrorRateModel> ());
+      for (uint32_t r = 0; r < *n; r++)
+        {
+          double angle = 2 * M_PI * r / *n;
+          Ptr<YansWifiPhy> receiver = CreateBenchPhy (channel, Vector (10 * std::cos (angle), 10 * std::sin (angle), 0.0),
+                                                      CreateObject<NistErrorRateModel> ());
+          receiver->SetReceiveOkCallback (MakeCallback (&Receive));
+        }
+      uint32_t nFrames = std::max<uint64_t> (receptions / *n, 1);
+      Simulator::Schedule (Seconds (1.0), &Send, sender, nFrames);
+      g_received = 0;
+      SystemWallClockMs clock;
+      clock.Start ();
+      Simulator::Run ();
+      int64_t elapsedMs = clock.End ();
+      Simulator::Destroy ();
+      NS_ABORT_MSG_UNLESS (g_received == (uint64_t) nFrames * *n, "frames lost: " << g_received);
+      std::cout << std::setw (10) << *n << std::setw (10) << nFrames
+                << std::setw (14) << g_received
+                << std::setw (16) << (uint64_t) (g_received * 1000.0 / std::max<int64_t> (elapsedMs, 1))
+                << std::setw (16) << GetPeakRssKb () << std::endl;
+    }
+  return 0;
+}
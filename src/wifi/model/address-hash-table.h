@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADDRESS_HASH_TABLE_H
+#define ADDRESS_HASH_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/mac48-address.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Maps a MAC address, and optionally a TID, to a pointer.
+ *
+ * An open addressing hash table with linear probing, at most half full.
+ * The table does not own the objects it points to, so that their
+ * addresses stay the same as the table grows.  Entries are never removed
+ * one by one: WifiRemoteStationManager only forgets all its stations at
+ * once.
+ */
+template <typename T>
+class AddressHashTable
+{
+public:
+  AddressHashTable ();
+
+  /**
+   * \param address a MAC address
+   * \param tid a TID, 0 to key by address only
+   *
+   * \return the key of address and tid
+   */
+  static uint64_t GetKey (Mac48Address address, uint8_t tid);
+  /**
+   * \param key a key of GetKey
+   *
+   * \return the object of key, 0 if there is none
+   */
+  T * Find (uint64_t key) const;
+  /**
+   * \param key a key of GetKey, which must not be in the table
+   * \param value the object of key
+   */
+  void Insert (uint64_t key, T *value);
+  /**
+   * Forget all the objects, without deleting them.
+   */
+  void Clear (void);
+  /**
+   * \return the number of objects in the table
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  struct Slot
+  {
+    uint64_t key;
+    T *value;
+  };
+
+  /**
+   * \param key a key of GetKey
+   *
+   * \return the first slot to probe for key
+   */
+  uint32_t GetSlot (uint64_t key) const;
+  void Grow (void);
+
+  static const uint64_t EMPTY = ~(uint64_t) 0;
+
+  std::vector<Slot> m_slots;
+  uint32_t m_shift;   //!< 64 minus the log2 of the number of slots
+  uint32_t m_size;
+};
+
+template <typename T>
+AddressHashTable<T>::AddressHashTable ()
+  : m_shift (64),
+    m_size (0)
+{
+}
+
+template <typename T>
+uint64_t
+AddressHashTable<T>::GetKey (Mac48Address address, uint8_t tid)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key << 8) | tid;
+}
+
+template <typename T>
+uint32_t
+AddressHashTable<T>::GetSlot (uint64_t key) const
+{
+  //Fibonacci hashing: the high bits of the product mix all the bits of the key
+  return (key * 0x9e3779b97f4a7c15ULL) >> m_shift;
+}
+
+template <typename T>
+T *
+AddressHashTable<T>::Find (uint64_t key) const
+{
+  if (m_size == 0)
+    {
+      return 0;
+    }
+  uint32_t mask = m_slots.size () - 1;
+  for (uint32_t i = GetSlot (key); ; i = (i + 1) & mask)
+    {
+      const Slot &slot = m_slots[i];
+      if (slot.key == key)
+        {
+          return slot.value;
+        }
+      if (slot.key == EMPTY)
+        {
+          return 0;
+        }
+    }
+}
+
+template <typename T>
+void
+AddressHashTable<T>::Insert (uint64_t key, T *value)
+{
+  NS_ASSERT (key != EMPTY && Find (key) == 0);
+  if (2 * (m_size + 1) > m_slots.size ())
+    {
+      Grow ();
+    }
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t i = GetSlot (key);
+  while (m_slots[i].key != EMPTY)
+    {
+      i = (i + 1) & mask;
+    }
+  m_slots[i].key = key;
+  m_slots[i].value = value;
+  m_size++;
+}
+
+template <typename T>
+void
+AddressHashTable<T>::Grow (void)
+{
+  std::vector<Slot> old;
+  old.swap (m_slots);
+  Slot empty;
+  empty.key = EMPTY;
+  empty.value = 0;
+  m_slots.resize (old.empty () ? 16 : 2 * old.size (), empty);
+  m_shift = 64;
+  for (uint32_t n = m_slots.size (); n > 1; n >>= 1)
+    {
+      m_shift--;
+    }
+  m_size = 0;
+  for (typename std::vector<Slot>::const_iterator it = old.begin (); it != old.end (); it++)
+    {
+      if (it->key != EMPTY)
+        {
+          Insert (it->key, it->value);
+        }
+    }
+}
+
+template <typename T>
+void
+AddressHashTable<T>::Clear (void)
+{
+  m_slots.clear ();
+  m_shift = 64;
+  m_size = 0;
+}
+
+template <typename T>
+uint32_t
+AddressHashTable<T>::GetSize (void) const
+{
+  return m_size;
+}
+
+} //namespace ns3
+
+#endif /* ADDRESS_HASH_TABLE_H */
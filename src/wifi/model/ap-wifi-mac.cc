@@ -34,6 +34,7 @@
 #include "mac-tx-middle.h"
 #include "mgt-headers.h"
 #include "extension-headers.h"
+#include "s1g-beacon-tag.h"
 #include "mac-low.h"
 #include "amsdu-subframe-header.h"
 #include "msdu-aggregator.h"
@@ -106,6 +107,22 @@ ApWifiMac::GetTypeId (void)
                    MakeUintegerAccessor (&ApWifiMac::GetSlotNum,
                                          &ApWifiMac::SetSlotNum),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RawCtrTrace", "Whether the RAW controller writes its per-station records to Outputpath + \"rawctr.txt\".",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&ApWifiMac::SetRawCtrTrace,
+                                        &ApWifiMac::GetRawCtrTrace),
+                   MakeBooleanChecker ())
+    .AddAttribute ("IncrementalRawGrouping", "If true, the RAW controller is fed association and reception events as they "
+                   "happen and its RPS is sent in S1G beacons instead of RPSsetup.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ApWifiMac::SetIncrementalRawGrouping,
+                                        &ApWifiMac::GetIncrementalRawGrouping),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RawGroupingStrategy", "If set, the strategy is fed association and reception events and "
+                   "computes the RPS of every S1G beacon, instead of IncrementalRawGrouping or RPSsetup.",
+                   PointerValue (),
+                   MakePointerAccessor (&ApWifiMac::m_rawGrouping),
+                   MakePointerChecker<RawGroupingStrategy> ())
     .AddAttribute ("RPSsetup", "configuration of RAW",
                    RPSVectorValue (),
                    MakeRPSVectorAccessor (&ApWifiMac::m_rpsset),
@@ -144,6 +161,13 @@ ApWifiMac::DoDispose ()
   m_beaconDca = 0;
   m_enableBeaconGeneration = false;
   m_beaconEvent.Cancel ();
+  m_S1gRawCtr.FlushTrace ();
+  m_beacons.Clear ();
+  if (m_rawGrouping != 0)
+    {
+      m_rawGrouping->Dispose ();
+      m_rawGrouping = 0;
+    }
   RegularWifiMac::DoDispose ();
 }
 
@@ -303,6 +327,30 @@ ApWifiMac::SetSlotNum (uint32_t count)
     m_slotNum = count;
 }
 
+void
+ApWifiMac::SetRawCtrTrace (bool enable)
+{
+  m_S1gRawCtr.SetTraceEnabled (enable);
+}
+
+bool
+ApWifiMac::GetRawCtrTrace (void) const
+{
+  return m_S1gRawCtr.GetTraceEnabled ();
+}
+
+void
+ApWifiMac::SetIncrementalRawGrouping (bool enable)
+{
+  m_S1gRawCtr.SetIncremental (enable);
+}
+
+bool
+ApWifiMac::GetIncrementalRawGrouping (void) const
+{
+  return m_S1gRawCtr.GetIncremental ();
+}
+
 
 void
 ApWifiMac::StartBeaconing (void)
@@ -563,6 +611,14 @@ ApWifiMac::SendAssocResp (Mac48Address to, bool success, uint8_t staType)
             }
           m_sensorList.push_back (aid);
           NS_LOG_UNCOND ("m_sensorList =" << m_sensorList.size ());
+          if (m_S1gRawCtr.GetIncremental ())
+            {
+              m_S1gRawCtr.NotifyAssociated (aid, staType);
+            }
+          if (m_rawGrouping != 0)
+            {
+              m_rawGrouping->NotifyAssociated (aid, staType);
+            }
   
         }
        else if (staType == 2)
@@ -574,6 +630,14 @@ ApWifiMac::SendAssocResp (Mac48Address to, bool success, uint8_t staType)
             }
           m_OffloadList.push_back (aid);
           NS_LOG_UNCOND ("m_OffloadList =" << m_OffloadList.size ());
+          if (m_S1gRawCtr.GetIncremental ())
+            {
+              m_S1gRawCtr.NotifyAssociated (aid, staType);
+            }
+          if (m_rawGrouping != 0)
+            {
+              m_rawGrouping->NotifyAssociated (aid, staType);
+            }
         }
     }
 Addheader:
@@ -605,25 +669,35 @@ ApWifiMac::SendOneBeacon (void)
       compatibility.SetBeaconInterval (m_beaconInterval.GetMicroSeconds ());
       beacon.SetBeaconCompatibility (compatibility);
      
-      RPS *m_rps;
+      const RPS *m_rps;
       static uint16_t RpsIndex = 0;
-      if (RpsIndex < m_rpsset.rpsset.size())
+      if (m_rawGrouping != 0)
          {
-            m_rps = m_rpsset.rpsset.at(RpsIndex);
-            NS_LOG_DEBUG ("< RpsIndex =" << RpsIndex);
-            RpsIndex++;
-          }
+            beacon.SetRPS (m_rawGrouping->GetRps (m_beaconInterval.GetMicroSeconds ()));
+         }
+      else if (m_S1gRawCtr.GetIncremental ())
+         {
+            beacon.SetRPS (m_S1gRawCtr.UpdateRAWGroupping (m_beaconInterval.GetMicroSeconds (), m_outputpath));
+         }
       else
          {
-            m_rps = m_rpsset.rpsset.at(0);
-            NS_LOG_DEBUG ("RpsIndex =" << RpsIndex);
-            RpsIndex = 1;
-          }
-      beacon.SetRPS (*m_rps);
+          if (RpsIndex < m_rpsset.rpsset.size())
+             {
+                m_rps = &m_rpsset.rpsset.at(RpsIndex);
+                NS_LOG_DEBUG ("< RpsIndex =" << RpsIndex);
+                RpsIndex++;
+              }
+          else
+             {
+                m_rps = &m_rpsset.rpsset.at(0);
+                NS_LOG_DEBUG ("RpsIndex =" << RpsIndex);
+                RpsIndex = 1;
+              }
+          beacon.SetRPS (*m_rps);
+         }
       /*
       RPS m_rps;
       NS_LOG_UNCOND ("send beacon at" << Simulator::Now ());
-      m_S1gRawCtr.deleteRps ();
       m_rps = m_S1gRawCtr.UpdateRAWGroupping (m_sensorList, m_OffloadList, m_receivedAid, m_beaconInterval.GetMicroSeconds (), m_outputpath);
       m_receivedAid.clear (); //release storage
       //m_rps = m_S1gRawCtr.GetRPS ();
@@ -650,6 +724,12 @@ ApWifiMac::SendOneBeacon (void)
       AuthenCtrl.SetThreshold (AuthenThreshold); //centralized
       beacon.SetAuthCtrl (AuthenCtrl);
       packet->AddHeader (beacon);
+      //decode the beacon once here for all the stations receiving it
+      S1gBeaconHeader decoded;
+      packet->PeekHeader (decoded);
+      S1gBeaconTag tag;
+      tag.SetBeaconInfo (m_beacons, Create<S1gBeaconInfo> (decoded));
+      packet->AddPacketTag (tag);
       m_beaconDca->Queue (packet, hdr);
 
      }
@@ -749,7 +829,18 @@ ApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                 uint8_t aid_l = mac[5];
                 uint8_t aid_h = mac[4] & 0x1f;
                 uint16_t aid = (aid_h << 8) | (aid_l << 0); //assign mac address as AID
-                m_receivedAid.push_back(aid); //to change
+                if (m_rawGrouping != 0)
+                  {
+                    m_rawGrouping->NotifyReceived (aid);
+                  }
+                if (m_S1gRawCtr.GetIncremental ())
+                  {
+                    m_S1gRawCtr.NotifyReceived (aid);
+                  }
+                else
+                  {
+                    m_receivedAid.push_back(aid); //to change
+                  }
             }
           else if (to.IsGroup ()
                    || m_stationManager->IsAssociated (to))
@@ -908,6 +999,14 @@ ApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                     if (*it == aid)
                     {   m_sensorList.erase (it); //remove from association list
                         NS_LOG_UNCOND ("erase aid " << aid << " by Ap from m_sensorList ");
+                        if (m_S1gRawCtr.GetIncremental ())
+                          {
+                            m_S1gRawCtr.NotifyDisassociated (aid);
+                          }
+                        if (m_rawGrouping != 0)
+                          {
+                            m_rawGrouping->NotifyDisassociated (aid);
+                          }
                         break;
                     }
                 }
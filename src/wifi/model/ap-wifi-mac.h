@@ -30,6 +30,8 @@
 #include "ns3/random-variable-stream.h"
 #include "rps.h"
 #include "s1g-raw-control.h"
+#include "raw-grouping-strategy.h"
+#include "s1g-beacon-tag.h"
 #include "ns3/string.h"
 
 
@@ -219,12 +221,29 @@ private:
   uint32_t GetSlotCrossBoundary (void) const;
   uint32_t GetSlotDurationCount (void) const;
   uint32_t GetSlotNum (void) const;
+  /**
+   * Enable or disable the trace file written by the RAW controller
+   * under the Outputpath prefix.
+   *
+   * \param enable enable or disable the RAW controller trace
+   */
+  void SetRawCtrTrace (bool enable);
+  bool GetRawCtrTrace (void) const;
+  /**
+   * Drive the RAW controller incrementally from association and
+   * reception events, and send its RPS in S1G beacons instead of
+   * RPSsetup.
+   *
+   * \param enable enable or disable incremental RAW grouping
+   */
+  void SetIncrementalRawGrouping (bool enable);
+  bool GetIncrementalRawGrouping (void) const;
     
   RPSVector m_rpsset;
   void SetTotalStaNum (uint32_t num);
   uint32_t GetTotalStaNum (void) const;
     
-  typedef std::vector<ns3::RPS *>::iterator RPSlistCI;
+  typedef std::vector<ns3::RPS>::iterator RPSlistCI;
     
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
@@ -242,6 +261,8 @@ private:
   std::vector<uint16_t> m_receivedAid;
     
   S1gRawCtr m_S1gRawCtr;
+  Ptr<RawGroupingStrategy> m_rawGrouping;   //!< computes the RPS of every beacon when set
+  S1gBeaconTable m_beacons;                  //!< recent beacons, shared with the stations through S1gBeaconTag
   Ptr<DcaTxop> m_beaconDca;                  //!< Dedicated DcaTxop for beacons
   Time m_beaconInterval;                     //!< Interval between beacons
   bool m_enableBeaconGeneration;             //!< Flag if beacons are being generated
@@ -155,7 +155,9 @@ DcaTxop::DcaTxop ()
     m_currentPacket (0)
 {
   NS_LOG_FUNCTION (this);
-  AccessAllowedIfRaw (true);
+  m_rawGate = Create<RawAccessGate> ();
+  m_rawQueue = m_rawGate->AddQueue (MakeCallback (&DcaTxop::RawStart, this),
+                                    MakeCallback (&DcaTxop::OutsideRawStart, this));
   m_transmissionListener = new DcaTxop::TransmissionListener (this);
   m_dcf = new DcaTxop::Dcf (this);
   m_queue = CreateObject<WifiMacQueue> ();
@@ -294,10 +296,24 @@ DcaTxop::AssignStreams (int64_t stream)
   return 1;
 }
 
+void
+DcaTxop::SetRawAccessGate (Ptr<RawAccessGate> gate)
+{
+  m_rawGate = gate;
+  m_rawQueue = m_rawGate->AddQueue (MakeCallback (&DcaTxop::RawStart, this),
+                                    MakeCallback (&DcaTxop::OutsideRawStart, this));
+}
+
+uint32_t
+DcaTxop::GetRawAccessQueue (void) const
+{
+  return m_rawQueue;
+}
+
 void
 DcaTxop::AccessAllowedIfRaw (bool allowed)
 {
-  AccessIfRaw = allowed;
+  m_rawGate->SetAllowed (m_rawQueue, allowed);
 }
     
 void
@@ -307,7 +323,7 @@ DcaTxop::RestartAccessIfNeeded (void)
   if ((m_currentPacket != 0
        || !m_queue->IsEmpty ())
       && !m_dcf->IsAccessRequested ()
-      && AccessIfRaw)          // always TRUE outside RAW
+      && m_rawGate->IsAllowed (m_rawQueue))          // always TRUE outside RAW
     {
       m_manager->RequestAccess (m_dcf);
     }
@@ -320,7 +336,7 @@ DcaTxop::StartAccessIfNeeded (void)
   if (m_currentPacket == 0
       && !m_queue->IsEmpty ()
       && !m_dcf->IsAccessRequested ()
-      && AccessIfRaw)      // always TRUE outside RAW
+      && m_rawGate->IsAllowed (m_rawQueue))      // always TRUE outside RAW
     {
       NS_LOG_UNCOND("DcaTxop::StartAccessIfNeeded " << Simulator::Now () << "\t" << m_low->GetAddress ());  
       m_manager->RequestAccess (m_dcf);
@@ -333,7 +349,7 @@ DcaTxop::StartAccessIfNeededRaw (void) //possibilely necessary, start new backof
     NS_LOG_FUNCTION (this);
     if (!m_queue->IsEmpty ()
         && !m_dcf->IsAccessRequested ()
-        && AccessIfRaw)      // always TRUE outside RAW
+        && m_rawGate->IsAllowed (m_rawQueue))      // always TRUE outside RAW
     {
        m_manager->RequestAccess (m_dcf);
     }
@@ -479,7 +495,7 @@ DcaTxop::NotifyAccessGranted (void)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_UNCOND("DcaTxop::NotifyAccessGranted " << Simulator::Now () << "\t" << m_low->GetAddress ());
-  if (!AccessIfRaw) 
+  if (!m_rawGate->IsAllowed (m_rawQueue)) 
     {
         return;
     }
@@ -30,6 +30,7 @@
 #include "ns3/wifi-mode.h"
 #include "ns3/wifi-remote-station-manager.h"
 #include "ns3/dcf.h"
+#include "ns3/raw-access-gate.h"
 
 namespace ns3 {
 
@@ -82,8 +83,6 @@ public:
 
   DcaTxop ();
   ~DcaTxop ();
-    
-  bool AccessIfRaw;
 
   /**
    * Set MacLow associated with this DcaTxop.
@@ -155,6 +154,17 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \param gate the RAW access gate shared by the queues of the station
+   *
+   * Consult gate instead of the gate private to this DcaTxop.
+   * The gate calls RawStart and OutsideRawStart at the RAW boundaries.
+   */
+  void SetRawAccessGate (Ptr<RawAccessGate> gate);
+  /**
+   * \return the index of this DcaTxop in its RAW access gate
+   */
+  uint32_t GetRawAccessQueue (void) const;
   void AccessAllowedIfRaw (bool allowed);
   void RawStart (void);
   void OutsideRawStart (void);
@@ -345,6 +355,8 @@ private:
   Ptr<WifiRemoteStationManager> m_stationManager;
   TransmissionListener *m_transmissionListener;
   RandomStream *m_rng;
+  Ptr<RawAccessGate> m_rawGate; //!< whether the RAW allows this queue to contend
+  uint32_t m_rawQueue;          //!< index of this queue in m_rawGate
 
   bool m_accessOngoing;
   Ptr<const Packet> m_currentPacket;
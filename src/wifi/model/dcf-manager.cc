@@ -335,6 +335,7 @@ DcfManager::DcfManager ()
     m_lastSwitchingDuration (MicroSeconds (0)),
     m_rxing (false),
     m_sleeping (false),
+    m_lazyAccessTimeout (false),
     m_slotTimeUs (0),
     m_sifs (Seconds (0.0)),
     m_phyListener (0),
@@ -541,6 +542,18 @@ DcfManager::IsBusy (void) const
   return false;
 }
 
+void
+DcfManager::SetLazyAccessTimeout (bool enable)
+{
+  m_lazyAccessTimeout = enable;
+}
+
+bool
+DcfManager::GetLazyAccessTimeout (void) const
+{
+  return m_lazyAccessTimeout;
+}
+
 void
 DcfManager::RequestAccess (DcfState *state)
 {
@@ -719,6 +732,11 @@ DcfManager::DoRestartAccessTimeoutIfNeeded (void)
    * Is there a DcfState which needs to access the medium, and,
    * if there is one, how many slots for AIFS+backoff does it require ?
    */
+  if (m_lazyAccessTimeout && m_rxing)
+    {
+      //the end of the reception restarts the timeout
+      return;
+    }
   bool accessTimeoutNeeded = false;
   Time expectedBackoffEnd = Simulator::GetMaximumSimulationTime ();
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++)
@@ -774,7 +792,10 @@ DcfManager::NotifyRxEndOkNow (void)
   m_lastRxReceivedOk = true;
   m_rxing = false;
   m_RxingTrace (0, Simulator::Now ().GetMicroSeconds ());
-
+  if (m_lazyAccessTimeout)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
 }
 
 void
@@ -787,6 +808,10 @@ DcfManager::NotifyRxEndErrorNow (void)
   m_lastRxReceivedOk = false;
   m_rxing = false;
   m_RxingTrace (0, Simulator::Now ().GetMicroSeconds ());
+  if (m_lazyAccessTimeout)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
 }
 
 void
@@ -794,6 +819,7 @@ DcfManager::NotifyTxStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   m_TxStart (Simulator::Now ().GetMicroSeconds (), duration.GetMicroSeconds ());
+  bool aborted = m_rxing;
   if (m_rxing)
     {
       //this may be caused only if PHY has started to receive a packet
@@ -809,6 +835,10 @@ DcfManager::NotifyTxStartNow (Time duration)
   UpdateBackoff ();
   m_lastTxStart = Simulator::Now ();
   m_lastTxDuration = duration;
+  if (m_lazyAccessTimeout && aborted)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
 }
 
 void
@@ -325,6 +325,24 @@ public:
    * highest priority, etc.
    */
   void Add (DcfState *dcf);
+  /**
+   * \param enable whether the access timeout is left alone during receptions
+   *
+   * By default, the access timeout is scheduled for the earliest backoff
+   * end whatever the state of the medium, and rescheduled each time it
+   * expires too early because the medium got busy in between.  A lazy
+   * DcfManager schedules nothing while it receives, when the end of the
+   * backoffs is not known yet (an error adds an EIFS), and restarts the
+   * timeout at the end of the reception instead.  The access is granted
+   * at the same times, but for a correct reception which ends an EIFS:
+   * the default DcfManager still waits for the end of the EIFS, the lazy
+   * one only for a DIFS after the reception.
+   */
+  void SetLazyAccessTimeout (bool enable);
+  /**
+   * \return whether the access timeout is left alone during receptions
+   */
+  bool GetLazyAccessTimeout (void) const;
 
   /**
    * \param state a DcfState
@@ -553,6 +571,7 @@ private:
   Time m_lastSwitchingDuration;
   bool m_rxing;
   bool m_sleeping;
+  bool m_lazyAccessTimeout;
   Time m_eifsNoDifs;
   EventId m_accessTimeout;
   uint32_t m_slotTimeUs;
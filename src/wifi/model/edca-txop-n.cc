@@ -266,7 +266,9 @@ EdcaTxopN::EdcaTxopN ()
     m_ampduExist (false)
 {
   NS_LOG_FUNCTION (this);
-  AccessAllowedIfRaw (true);
+  m_rawGate = Create<RawAccessGate> ();
+  m_rawQueue = m_rawGate->AddQueue (MakeCallback (&EdcaTxopN::RawStart, this),
+                                    MakeCallback (&EdcaTxopN::OutsideRawStart, this));
   m_transmissionListener = new EdcaTxopN::TransmissionListener (this);
   m_blockAckListener = new EdcaTxopN::AggregationCapableTransmissionListener (this);
   m_dcf = new EdcaTxopN::Dcf (this);
@@ -482,7 +484,7 @@ void
 EdcaTxopN::NotifyAccessGranted (void)
 {
   NS_LOG_FUNCTION (this);
-  if (!AccessIfRaw)
+  if (!m_rawGate->IsAllowed (m_rawQueue))
     {
         return;
     }
@@ -949,15 +951,24 @@ EdcaTxopN::GetMsduAggregator (void) const
   return m_aggregator;
 }
 
+void
+EdcaTxopN::SetRawAccessGate (Ptr<RawAccessGate> gate)
+{
+  m_rawGate = gate;
+  m_rawQueue = m_rawGate->AddQueue (MakeCallback (&EdcaTxopN::RawStart, this),
+                                    MakeCallback (&EdcaTxopN::OutsideRawStart, this));
+}
+
+uint32_t
+EdcaTxopN::GetRawAccessQueue (void) const
+{
+  return m_rawQueue;
+}
+
 void
 EdcaTxopN::AccessAllowedIfRaw (bool allowed)
 {
-  AccessIfRaw = allowed;
-    /*if (Simulator::Now ().GetMicroSeconds () > 50000000)
-    {
-         NS_LOG_UNCOND ("EdcaTxopN::NotifyAccessGranted, " << Simulator::Now () << ", " << allowed << ", " << m_low->GetAddress ());
-    }*/
-    
+  m_rawGate->SetAllowed (m_rawQueue, allowed);
 }
 
 void
@@ -967,7 +978,7 @@ EdcaTxopN::RestartAccessIfNeeded (void)
   if ((m_currentPacket != 0
        || !m_queue->IsEmpty () || m_baManager->HasPackets ())
       && !m_dcf->IsAccessRequested ()
-      && AccessIfRaw)
+      && m_rawGate->IsAllowed (m_rawQueue))
     {
       m_manager->RequestAccess (m_dcf);
         int newdata=10;
@@ -982,7 +993,7 @@ EdcaTxopN::StartAccessIfNeeded (void)
   if (m_currentPacket == 0
       && (!m_queue->IsEmpty () || m_baManager->HasPackets ())
       && !m_dcf->IsAccessRequested ()
-      && AccessIfRaw)    // always TRUE outside RAW
+      && m_rawGate->IsAllowed (m_rawQueue))    // always TRUE outside RAW
     {
         int newdata=20;
         m_AccessQuest_record (Simulator::Now ().GetMicroSeconds (), newdata);
@@ -996,7 +1007,7 @@ EdcaTxopN::StartAccessIfNeededRaw (void)
     NS_LOG_FUNCTION (this);
     if ((!m_queue->IsEmpty () || m_baManager->HasPackets () || m_currentPacket != 0)
         && !m_dcf->IsAccessRequested ()
-        && AccessIfRaw)    // always TRUE outside RAW
+        && m_rawGate->IsAllowed (m_rawQueue))    // always TRUE outside RAW
     {
         m_manager->RequestAccess (m_dcf);
     }
@@ -1013,7 +1024,7 @@ EdcaTxopN::RawStart (void)
   m_dcf->RawStart ();
   m_stationManager->RawStart ();
   m_dcf->StartBackoffNow (m_rng->GetNext (0, m_dcf->GetCw ()));
-    if ((!m_queue->IsEmpty () || m_baManager->HasPackets ()) && AccessIfRaw)
+    if ((!m_queue->IsEmpty () || m_baManager->HasPackets ()) && m_rawGate->IsAllowed (m_rawQueue))
       {
         int newdata=30;
         m_AccessQuest_record (Simulator::Now ().GetMicroSeconds (), newdata);
@@ -30,6 +30,7 @@
 #include "wifi-remote-station-manager.h"
 #include "qos-utils.h"
 #include "dcf.h"
+#include "raw-access-gate.h"
 #include "ctrl-headers.h"
 #include "block-ack-manager.h"
 #include <map>
@@ -98,8 +99,7 @@ public:
   EdcaTxopN ();
   virtual ~EdcaTxopN ();
   void DoDispose ();
-    
-    bool AccessIfRaw;
+
   /**
    * Set MacLow associated with this EdcaTxopN.
    *
@@ -464,6 +464,17 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
     
+  /**
+   * \param gate the RAW access gate shared by the queues of the station
+   *
+   * Consult gate instead of the gate private to this EdcaTxopN.
+   * The gate calls RawStart and OutsideRawStart at the RAW boundaries.
+   */
+  void SetRawAccessGate (Ptr<RawAccessGate> gate);
+  /**
+   * \return the index of this EdcaTxopN in its RAW access gate
+   */
+  uint32_t GetRawAccessQueue (void) const;
   void AccessAllowedIfRaw (bool allowed);
   void RawStart (void);
   void OutsideRawStart (void);
@@ -543,6 +554,8 @@ private:
   TransmissionListener *m_transmissionListener;
   AggregationCapableTransmissionListener *m_blockAckListener;
   RandomStream *m_rng;
+  Ptr<RawAccessGate> m_rawGate; //!< whether the RAW allows this queue to contend
+  uint32_t m_rawQueue;          //!< index of this queue in m_rawGate
   Ptr<WifiRemoteStationManager> m_stationManager;
   uint8_t m_fragmentNumber;
 
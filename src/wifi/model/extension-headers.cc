@@ -87,7 +87,7 @@ S1gBeaconHeader::SetTIM (TIM tim)
 }
 
 void
-S1gBeaconHeader::SetRPS (RPS rps)
+S1gBeaconHeader::SetRPS (const RPS &rps)
 {
   m_rps = rps;
 }
@@ -147,7 +147,7 @@ S1gBeaconHeader::GetTIM (void) const
   return m_tim;
 }
     
-RPS
+const RPS &
 S1gBeaconHeader::GetRPS (void) const
 {
   return m_rps;
@@ -51,7 +51,7 @@ public:
   void SetAccessNetwork (uint8_t accessnetwork);
   void SetBeaconCompatibility (S1gBeaconCompatibility compatibility);
   void SetTIM (TIM tim);
-  void SetRPS (RPS rps);
+  void SetRPS (const RPS &rps);
   void SetAuthCtrl (AuthenticationCtrl auth);
 
   //Mac48Address GetSA (void) const;
@@ -62,7 +62,7 @@ public:
   uint8_t GetAccessNetwork (void) const;
   S1gBeaconCompatibility GetBeaconCompatibility (void) const;
   TIM GetTIM (void) const;
-  RPS GetRPS (void) const;
+  const RPS & GetRPS (void) const;
   AuthenticationCtrl GetAuthCtrl (void) const;
     
   static TypeId GetTypeId (void);
@@ -136,7 +136,10 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_runningSum (false),
+    m_nPassed (0),
+    m_passedPower (0.0)
 {
 }
 
@@ -187,6 +190,44 @@ InterferenceHelper::GetErrorRateModel (void) const
   return m_errorRateModel;
 }
 
+void
+InterferenceHelper::SetRunningSum (bool enable)
+{
+  m_runningSum = enable;
+  m_nPassed = 0;
+  m_passedPower = m_firstPower;
+}
+
+bool
+InterferenceHelper::GetRunningSum (void) const
+{
+  return m_runningSum;
+}
+
+uint32_t
+InterferenceHelper::GetNNiChanges (void) const
+{
+  return m_niChanges.size ();
+}
+
+void
+InterferenceHelper::PassChanges (void)
+{
+  Time now = Simulator::Now ();
+  while (m_nPassed < m_niChanges.size () && m_niChanges[m_nPassed].GetTime () < now)
+    {
+      m_passedPower += m_niChanges[m_nPassed].GetDelta ();
+      m_nPassed++;
+    }
+  if (!m_rxing && m_nPassed > 0)
+    {
+      //no frame being received needs them any more
+      m_firstPower = m_passedPower;
+      m_niChanges.erase (m_niChanges.begin (), m_niChanges.begin () + m_nPassed);
+      m_nPassed = 0;
+    }
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
@@ -194,7 +235,15 @@ InterferenceHelper::GetEnergyDuration (double energyW)
   double noiseInterferenceW = 0.0;
   Time end = now;
   noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  NiChanges::const_iterator first = m_niChanges.begin ();
+  if (m_runningSum)
+    {
+      //the changes before now only add to the energy
+      PassChanges ();
+      noiseInterferenceW = m_passedPower;
+      first += m_nPassed;
+    }
+  for (NiChanges::const_iterator i = first; i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
@@ -214,6 +263,10 @@ void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
   Time now = Simulator::Now ();
+  if (m_runningSum)
+    {
+      PassChanges ();
+    }
   if (!m_rxing)
     {
       NiChanges::iterator nowIterator = GetPosition (now);
@@ -229,7 +282,12 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
       AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
   AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
+  if (!m_rxing)
+    {
+      //the changes before the new one were all folded in m_firstPower
+      m_nPassed = 0;
+      m_passedPower = m_firstPower;
+    }
 }
 
 
@@ -732,6 +790,8 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  m_nPassed = 0;
+  m_passedPower = 0.0;
 }
 
 InterferenceHelper::NiChanges::iterator
@@ -758,6 +818,10 @@ InterferenceHelper::NotifyRxEnd ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = false;
+  if (m_runningSum)
+    {
+      PassChanges ();
+    }
 }
 
 } //namespace ns3
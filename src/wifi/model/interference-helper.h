@@ -159,6 +159,24 @@ private:
    * \return Error rate model
    */
   Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Keep the energy received up to now as a running sum over the NI
+   * changes already passed, instead of summing them again from the
+   * first one on every GetEnergyDuration, and drop the passed changes
+   * whenever no frame is being received.  The changes are summed in the
+   * same order either way, so the results are the same.
+   *
+   * \param enable whether to keep the running sum
+   */
+  void SetRunningSum (bool enable);
+  /**
+   * \return whether the running sum is kept
+   */
+  bool GetRunningSum (void) const;
+  /**
+   * \return the number of NI changes kept
+   */
+  uint32_t GetNNiChanges (void) const;
 
   /**
    * \param energyW the minimum energy (W) requested
@@ -337,6 +355,15 @@ private:
    * \param change
    */
   void AddNiChangeEvent (NiChange change);
+  /**
+   * Add the NI changes before now to the running sum, and with no frame
+   * being received, drop them.
+   */
+  void PassChanges (void);
+
+  bool m_runningSum;     //!< whether the passed NI changes are kept as a running sum
+  uint32_t m_nPassed;    //!< number of leading NI changes added to m_passedPower
+  double m_passedPower;  //!< m_firstPower plus the deltas of the passed NI changes
 };
 
 } //namespace ns3
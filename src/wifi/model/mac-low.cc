@@ -27,6 +27,8 @@
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/buffer.h"
 
 #include "mac-low.h"
 #include "wifi-phy.h"
@@ -351,6 +353,24 @@ private:
 };
 
 
+/**
+ * Serialize the header of an ACK or a CTS and its FCS.
+ *
+ * \param hdr the header
+ * \param frame the 14 bytes of the frame
+ */
+static void
+SerializeAckOrCts (const WifiMacHeader &hdr, uint8_t *frame)
+{
+  Buffer buffer;
+  buffer.AddAtStart (hdr.GetSerializedSize () + WIFI_MAC_FCS_LENGTH);
+  NS_ASSERT (buffer.GetSize () == 14);
+  hdr.Serialize (buffer.Begin ());
+  WifiMacTrailer fcs;
+  fcs.Serialize (buffer.End ());
+  buffer.CopyData (frame, buffer.GetSize ());
+}
+
 MacLow::MacLow ()
   : m_normalAckTimeoutEvent (),
     m_fastAckTimeoutEvent (),
@@ -368,7 +388,9 @@ MacLow::MacLow ()
     m_listener (0),
     m_phyMacLowListener (0),
     m_ctsToSelfSupported (false),
-    m_receivedAtLeastOneMpdu (false)
+    m_receivedAtLeastOneMpdu (false),
+    m_controlFrameTemplates (true),
+    m_controlFrequency (0)
 {
   NS_LOG_FUNCTION (this);
   m_lastNavDuration = Seconds (0);
@@ -377,6 +399,19 @@ MacLow::MacLow ()
   m_ampdu = false;
   m_sentMpdus = 0;
   m_aggregateQueue = CreateObject<WifiMacQueue> ();
+
+  m_ackHeader.SetType (WIFI_MAC_CTL_ACK);
+  m_ackHeader.SetDsNotFrom ();
+  m_ackHeader.SetDsNotTo ();
+  m_ackHeader.SetNoRetry ();
+  m_ackHeader.SetNoMoreFragments ();
+  SerializeAckOrCts (m_ackHeader, m_ackFrame);
+  m_ctsHeader.SetType (WIFI_MAC_CTL_CTS);
+  m_ctsHeader.SetDsNotFrom ();
+  m_ctsHeader.SetDsNotTo ();
+  m_ctsHeader.SetNoMoreFragments ();
+  m_ctsHeader.SetNoRetry ();
+  SerializeAckOrCts (m_ctsHeader, m_ctsFrame);
 }
 
 MacLow::~MacLow ()
@@ -392,6 +427,12 @@ MacLow::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("Wifi")
     .AddConstructor<MacLow> ()
+    .AddAttribute ("ControlFrameTemplates",
+                   "Whether the ACKs and CTSs are copied from serialized templates, "
+                   "and the durations of the control frames kept by mode.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MacLow::m_controlFrameTemplates),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -519,6 +560,7 @@ void
 MacLow::SetPhy (Ptr<WifiPhy> phy)
 {
   m_phy = phy;
+  m_controlFrequency = 0;
   m_phy->SetReceiveOkCallback (MakeCallback (&MacLow::DeaggregateAmpduAndReceive, this));
   m_phy->SetReceiveErrorCallback (MakeCallback (&MacLow::ReceiveError, this));
   SetupPhyMacLowListener (phy);
@@ -1308,7 +1350,7 @@ MacLow::GetAckDuration (WifiTxVector ackTxVector) const
     {
       preamble = WIFI_PREAMBLE_LONG;
     }
-  return m_phy->CalculateTxDuration (GetAckSize (), ackTxVector, preamble, m_phy->GetFrequency (), 0, 0);
+  return GetControlFrameDuration (CONTROL_ACK, ackTxVector, preamble);
 }
 
 Time
@@ -1331,7 +1373,8 @@ MacLow::GetBlockAckDuration (Mac48Address to, WifiTxVector blockAckReqTxVector,
     {
       preamble = WIFI_PREAMBLE_LONG;
     }
-  return m_phy->CalculateTxDuration (GetBlockAckSize (type), blockAckReqTxVector, preamble, m_phy->GetFrequency (), 0, 0);
+  return GetControlFrameDuration (type == BASIC_BLOCK_ACK ? CONTROL_BASIC_BLOCK_ACK : CONTROL_COMPRESSED_BLOCK_ACK,
+                                  blockAckReqTxVector, preamble);
 }
 
 Time
@@ -1357,7 +1400,7 @@ MacLow::GetCtsDuration (WifiTxVector ctsTxVector) const
         //CTS should always use non-HT PPDU (HT PPDU cases not supported yet)
         preamble = WIFI_PREAMBLE_LONG;
     }
-  return m_phy->CalculateTxDuration (GetCtsSize (), ctsTxVector, preamble, m_phy->GetFrequency (), 0, 0);
+  return GetControlFrameDuration (CONTROL_CTS, ctsTxVector, preamble);
 }
 
 uint32_t
@@ -1368,6 +1411,86 @@ MacLow::GetCtsSize (void) const
   return cts.GetSize () + 4;
 }
 
+Time
+MacLow::GetControlFrameDuration (enum ControlFrame frame, WifiTxVector txVector, WifiPreamble preamble) const
+{
+  Time *cached = 0;
+  if (m_controlFrameTemplates
+      && txVector.GetNss () == 1 && txVector.GetNess () == 0 && !txVector.IsStbc ())
+    {
+      if (m_controlFrequency != m_phy->GetFrequency ())
+        {
+          //a new PHY or channel
+          for (uint32_t i = 0; i < CONTROL_FRAMES; i++)
+            {
+              m_controlDurations[i].clear ();
+            }
+          m_controlFrequency = m_phy->GetFrequency ();
+        }
+      std::vector<Time> &durations = m_controlDurations[frame];
+      uint32_t uid = txVector.GetMode ().GetUid ();
+      if (uid >= durations.size ())
+        {
+          durations.resize (uid + 1, Seconds (0));
+        }
+      cached = &durations[uid];
+      if (!cached->IsZero ())
+        {
+          return *cached;
+        }
+    }
+  uint32_t size;
+  switch (frame)
+    {
+    case CONTROL_ACK:
+      size = GetAckSize ();
+      break;
+    case CONTROL_CTS:
+      size = GetCtsSize ();
+      break;
+    case CONTROL_BASIC_BLOCK_ACK:
+      size = GetBlockAckSize (BASIC_BLOCK_ACK);
+      break;
+    default:
+      size = GetBlockAckSize (COMPRESSED_BLOCK_ACK);
+      break;
+    }
+  Time duration = m_phy->CalculateTxDuration (size, txVector, preamble, m_phy->GetFrequency (), 0, 0);
+  if (cached != 0)
+    {
+      *cached = duration;
+    }
+  return duration;
+}
+
+Ptr<Packet>
+MacLow::CreateAckOrCts (uint8_t *frame, const WifiMacHeader &hdr) const
+{
+  Ptr<Packet> packet;
+  if (m_controlFrameTemplates)
+    {
+      uint16_t duration = hdr.GetRawDuration ();
+      frame[2] = duration & 0xff;
+      frame[3] = duration >> 8;
+      hdr.GetAddr1 ().CopyTo (frame + 4);
+      packet = Create<Packet> (frame, 14);
+      if (!packet->BeginItem ().HasNext ())
+        {
+          return packet;
+        }
+      //the packet metadata is enabled, give it the header
+      packet->RemoveAtStart (packet->GetSize ());
+    }
+  else
+    {
+      packet = Create<Packet> ();
+    }
+  packet->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  return packet;
+}
+
 uint32_t
 MacLow::GetSize (Ptr<const Packet> packet, const WifiMacHeader *hdr) const
 {
@@ -2221,22 +2344,13 @@ MacLow::SendCtsAfterRts (Mac48Address source, Time duration, WifiTxVector rtsTxV
    * right after SIFS.
    */
   WifiTxVector ctsTxVector = GetCtsTxVector (source, rtsTxVector.GetMode ());
-  WifiMacHeader cts;
-  cts.SetType (WIFI_MAC_CTL_CTS);
-  cts.SetDsNotFrom ();
-  cts.SetDsNotTo ();
-  cts.SetNoMoreFragments ();
-  cts.SetNoRetry ();
-  cts.SetAddr1 (source);
-  duration -= GetCtsDuration (source, rtsTxVector);
+  m_ctsHeader.SetAddr1 (source);
+  duration -= GetCtsDuration (ctsTxVector);
   duration -= GetSifs ();
   NS_ASSERT (duration >= MicroSeconds (0));
-  cts.SetDuration (duration);
+  m_ctsHeader.SetDuration (duration);
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (cts);
-  WifiMacTrailer fcs;
-  packet->AddTrailer (fcs);
+  Ptr<Packet> packet = CreateAckOrCts (m_ctsFrame, m_ctsHeader);
 
   SnrTag tag;
   tag.Set (rtsSnr);
@@ -2254,7 +2368,7 @@ MacLow::SendCtsAfterRts (Mac48Address source, Time duration, WifiTxVector rtsTxV
       //CTS should always use non-HT PPDU (HT PPDU cases not supported yet)
       preamble = WIFI_PREAMBLE_LONG;
     }
-  ForwardDown (packet, &cts, ctsTxVector, preamble);
+  ForwardDown (packet, &m_ctsHeader, ctsTxVector, preamble);
 }
 
 void
@@ -2396,22 +2510,13 @@ MacLow::SendAckAfterData (Mac48Address source, Time duration, WifiMode dataTxMod
    * a packet after SIFS.
    */
   WifiTxVector ackTxVector = GetAckTxVector (source, dataTxMode);
-  WifiMacHeader ack;
-  ack.SetType (WIFI_MAC_CTL_ACK);
-  ack.SetDsNotFrom ();
-  ack.SetDsNotTo ();
-  ack.SetNoRetry ();
-  ack.SetNoMoreFragments ();
-  ack.SetAddr1 (source);
+  m_ackHeader.SetAddr1 (source);
   duration -= GetAckDuration (ackTxVector);
   duration -= GetSifs ();
   NS_ASSERT (duration >= MicroSeconds (0));
-  ack.SetDuration (duration);
+  m_ackHeader.SetDuration (duration);
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (ack);
-  WifiMacTrailer fcs;
-  packet->AddTrailer (fcs);
+  Ptr<Packet> packet = CreateAckOrCts (m_ackFrame, m_ackHeader);
 
   SnrTag tag;
   tag.Set (dataSnr);
@@ -2433,7 +2538,7 @@ MacLow::SendAckAfterData (Mac48Address source, Time duration, WifiMode dataTxMod
      //ACK should always use non-HT PPDU (HT PPDU cases not supported yet)
      preamble = WIFI_PREAMBLE_LONG;
     }
-  ForwardDown (packet, &ack, ackTxVector, preamble);
+  ForwardDown (packet, &m_ackHeader, ackTxVector, preamble);
 }
 
 bool
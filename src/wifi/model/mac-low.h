@@ -862,6 +862,40 @@ private:
    * \return the total CTS size
    */
   uint32_t GetCtsSize (void) const;
+  /**
+   * The control frames whose durations are kept in tables by mode
+   */
+  enum ControlFrame
+  {
+    CONTROL_ACK,
+    CONTROL_CTS,
+    CONTROL_BASIC_BLOCK_ACK,
+    CONTROL_COMPRESSED_BLOCK_ACK,
+    CONTROL_FRAMES
+  };
+  /**
+   * Return the time required to transmit a control frame.  With
+   * ControlFrameTemplates, the durations of the TXVECTORs of a single
+   * spatial stream are computed once per mode.
+   *
+   * \param frame the control frame
+   * \param txVector the TXVECTOR of the control frame
+   * \param preamble the preamble of the control frame, which must only
+   *        depend on the mode for a given frame
+   * \return the time required to transmit the control frame (including preamble and FCS)
+   */
+  Time GetControlFrameDuration (enum ControlFrame frame, WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * Build an ACK or a CTS.  With ControlFrameTemplates, the frame is
+   * copied from its serialized template, patched with the duration and
+   * receiver of its header, unless the packet metadata is enabled and the
+   * traces need to see the header.
+   *
+   * \param frame the serialized template, m_ackFrame or m_ctsFrame
+   * \param hdr the header of the ACK or CTS
+   * \return the ACK or CTS, with its FCS
+   */
+  Ptr<Packet> CreateAckOrCts (uint8_t *frame, const WifiMacHeader &hdr) const;
   /**
    * Return the total size of the packet after WifiMacHeader and FCS trailer
    * have been added.
@@ -1370,6 +1404,14 @@ private:
   WifiTxVector m_currentTxVector;     //!< TXVECTOR used for the current packet transmission
   bool m_receivedAtLeastOneMpdu;      //!< Flag whether an MPDU has already been successfully received while receiving an A-MPDU
   std::vector<Item> m_txPackets;      //!< Contain temporary items to be sent with the next A-MPDU transmission, once RTS/CTS exchange has succeeded. It is not used in other cases.
+
+  bool m_controlFrameTemplates;       //!< Flag whether the ACKs and CTSs are built from templates
+  WifiMacHeader m_ackHeader;          //!< Header of the ACKs, patched for each ACK
+  WifiMacHeader m_ctsHeader;          //!< Header of the CTSs, patched for each CTS
+  uint8_t m_ackFrame[14];             //!< Serialized ACK, header and FCS
+  uint8_t m_ctsFrame[14];             //!< Serialized CTS, header and FCS
+  mutable std::vector<Time> m_controlDurations[CONTROL_FRAMES]; //!< Durations of the control frames, by mode UID, zero if not known yet
+  mutable double m_controlFrequency;  //!< Frequency of m_controlDurations
 };
 
 } //namespace ns3
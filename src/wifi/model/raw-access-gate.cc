@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "raw-access-gate.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+RawAccessGate::RawAccessGate ()
+  : m_allowed (0)
+{
+}
+
+uint32_t
+RawAccessGate::AddQueue (Callback<void> rawStart, Callback<void> outsideRawStart)
+{
+  NS_ASSERT_MSG (m_queues.size () < 32, "too many queues on one RAW access gate");
+  Queue queue;
+  queue.rawStart = rawStart;
+  queue.outsideRawStart = outsideRawStart;
+  m_allowed |= (1u << m_queues.size ());
+  m_queues.push_back (queue);
+  return m_queues.size () - 1;
+}
+
+void
+RawAccessGate::SetWakeUpCallback (Callback<void> wakeUp)
+{
+  m_wakeUp = wakeUp;
+}
+
+void
+RawAccessGate::SetAllowed (uint32_t queue, bool allowed)
+{
+  NS_ASSERT (queue < m_queues.size ());
+  if (allowed)
+    {
+      m_allowed |= (1u << queue);
+    }
+  else
+    {
+      m_allowed &= ~(1u << queue);
+    }
+}
+
+void
+RawAccessGate::SetAllAllowed (bool allowed)
+{
+  m_allowed = allowed ? 0xffffffff : 0;
+}
+
+void
+RawAccessGate::SetOnlyAllowed (uint32_t queue)
+{
+  NS_ASSERT (queue < m_queues.size ());
+  m_allowed = (1u << queue);
+}
+
+bool
+RawAccessGate::IsAllowed (uint32_t queue) const
+{
+  return (m_allowed >> queue) & 1;
+}
+
+void
+RawAccessGate::StartRaw (void)
+{
+  for (uint32_t i = 0; i < m_queues.size (); i++)
+    {
+      m_queues[i].rawStart ();
+    }
+}
+
+void
+RawAccessGate::ScheduleSlot (Time start, Time duration)
+{
+  m_slotStartEvent.Cancel ();
+  m_slotStartEvent = Simulator::Schedule (start, &RawAccessGate::SlotStart, this, duration);
+}
+
+void
+RawAccessGate::SlotStart (Time duration)
+{
+  //the slot of an earlier RAW must not close this one
+  m_slotEndEvent.Cancel ();
+  m_slotEndEvent = Simulator::Schedule (duration, &RawAccessGate::SlotEnd, this);
+  if (!m_wakeUp.IsNull ())
+    {
+      m_wakeUp ();
+    }
+  SetAllAllowed (true);
+  StartRaw ();
+}
+
+void
+RawAccessGate::SlotEnd (void)
+{
+  SetAllAllowed (false);
+}
+
+void
+RawAccessGate::ScheduleRawEnd (Time delay)
+{
+  m_rawEndEvent.Cancel ();
+  m_rawEndEvent = Simulator::Schedule (delay, &RawAccessGate::RawEnd, this);
+}
+
+void
+RawAccessGate::CancelRawEnd (void)
+{
+  m_rawEndEvent.Cancel ();
+}
+
+bool
+RawAccessGate::IsRawEndPending (void) const
+{
+  return m_rawEndEvent.IsRunning ();
+}
+
+void
+RawAccessGate::RawEnd (void)
+{
+  m_slotEndEvent.Cancel ();
+  if (!m_wakeUp.IsNull ())
+    {
+      m_wakeUp ();
+    }
+  //each queue reopens itself just before it restarts its backoff: the
+  //access may be granted to a queue while the next ones are notified
+  for (uint32_t i = 0; i < m_queues.size (); i++)
+    {
+      m_queues[i].outsideRawStart ();
+    }
+}
+
+void
+RawAccessGate::Dispose (void)
+{
+  m_slotStartEvent.Cancel ();
+  m_slotEndEvent.Cancel ();
+  m_rawEndEvent.Cancel ();
+  m_wakeUp = MakeNullCallback<void> ();
+}
+
+} //namespace ns3
@@ -0,0 +1,513 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "raw-grouping-strategy.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RawGroupingStrategy");
+
+NS_OBJECT_ENSURE_REGISTERED (RawGroupingStrategy);
+
+TypeId
+RawGroupingStrategy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RawGroupingStrategy")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+RawGroupingStrategy::~RawGroupingStrategy ()
+{
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (HeuristicRawGrouping);
+
+TypeId
+HeuristicRawGrouping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HeuristicRawGrouping")
+    .SetParent<RawGroupingStrategy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<HeuristicRawGrouping> ()
+    .AddAttribute ("Outputpath", "Prefix of the files written by the RAW controller.",
+                   StringValue ("stationfile"),
+                   MakeStringAccessor (&HeuristicRawGrouping::m_outputpath),
+                   MakeStringChecker ())
+    .AddAttribute ("Trace", "Whether the RAW controller writes its per-station records to Outputpath + \"rawctr.txt\".",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&HeuristicRawGrouping::SetTraceEnabled,
+                                        &HeuristicRawGrouping::GetTraceEnabled),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+HeuristicRawGrouping::HeuristicRawGrouping ()
+{
+  NS_LOG_FUNCTION (this);
+  m_ctr.SetIncremental (true);
+}
+
+HeuristicRawGrouping::~HeuristicRawGrouping ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HeuristicRawGrouping::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ctr.FlushTrace ();
+  RawGroupingStrategy::DoDispose ();
+}
+
+void
+HeuristicRawGrouping::SetTraceEnabled (bool enable)
+{
+  m_ctr.SetTraceEnabled (enable);
+}
+
+bool
+HeuristicRawGrouping::GetTraceEnabled (void) const
+{
+  return m_ctr.GetTraceEnabled ();
+}
+
+void
+HeuristicRawGrouping::NotifyAssociated (uint16_t aid, uint8_t staType)
+{
+  m_ctr.NotifyAssociated (aid, staType);
+}
+
+void
+HeuristicRawGrouping::NotifyDisassociated (uint16_t aid)
+{
+  m_ctr.NotifyDisassociated (aid);
+}
+
+void
+HeuristicRawGrouping::NotifyReceived (uint16_t aid)
+{
+  m_ctr.NotifyReceived (aid);
+}
+
+RPS
+HeuristicRawGrouping::GetRps (uint64_t beaconIntervalUs)
+{
+  return m_ctr.UpdateRAWGroupping (beaconIntervalUs, m_outputpath);
+}
+
+
+namespace {
+
+/**
+ * \param aid the AID of a station
+ * \return the page and the 10 bits RAW AID of the station, by which
+ *         S1gBeaconInfo finds its RAW
+ */
+uint16_t
+GetRawKey (uint16_t aid)
+{
+  return ((aid >> 11) << 10) | (aid & 0x03ff);
+}
+
+/**
+ * Order AIDs as the RAW groups cover them
+ */
+bool
+RawKeyLess (uint16_t a, uint16_t b)
+{
+  return GetRawKey (a) < GetRawKey (b) || (GetRawKey (a) == GetRawKey (b) && a < b);
+}
+
+//AIDs of the four pages
+const uint32_t AID_SPACE = 8192;
+//RAWs use slot format 1: at most 7 slots, slot duration count of 11 bits
+const uint16_t MAX_SLOT_NUM = 7;
+const uint16_t MAX_SLOT_DURATION_COUNT = 2037;
+const uint32_t BISECTIONS = 40;
+
+/**
+ * The slot loads of one group for all the slot numbers at once
+ */
+struct GroupLoads
+{
+  double slot[MAX_SLOT_NUM + 1][MAX_SLOT_NUM];
+  double busiest[MAX_SLOT_NUM + 1];
+
+  void Clear (void)
+  {
+    std::fill (&slot[0][0], &slot[0][0] + (MAX_SLOT_NUM + 1) * MAX_SLOT_NUM, 0.0);
+    std::fill (busiest, busiest + MAX_SLOT_NUM + 1, 0.0);
+  }
+  bool Fits (uint16_t rawAid, double load, double maxSlotLoad) const
+  {
+    for (uint16_t s = 1; s <= MAX_SLOT_NUM; s++)
+      {
+        if (std::max (busiest[s], slot[s][rawAid % s] + load) <= maxSlotLoad)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+  void Add (uint16_t rawAid, double load)
+  {
+    for (uint16_t s = 1; s <= MAX_SLOT_NUM; s++)
+      {
+        double & l = slot[s][rawAid % s];
+        l += load;
+        busiest[s] = std::max (busiest[s], l);
+      }
+  }
+  /**
+   * \return the slot number which needs the least time, among those
+   *         meeting maxSlotLoad if any; the most slots on a tie
+   */
+  uint16_t ChooseSlotNum (double maxSlotLoad, double exchangeUs, double &us) const
+  {
+    bool anyFits = false;
+    for (uint16_t s = 1; s <= MAX_SLOT_NUM; s++)
+      {
+        anyFits = anyFits || busiest[s] <= maxSlotLoad;
+      }
+    uint16_t best = 0;
+    us = 0;
+    for (uint16_t s = 1; s <= MAX_SLOT_NUM; s++)
+      {
+        if (anyFits && busiest[s] > maxSlotLoad)
+          {
+            continue;
+          }
+        double sUs = s * exchangeUs * std::max (1.0, busiest[s]);
+        if (best == 0 || sUs <= us)
+          {
+            best = s;
+            us = sUs;
+          }
+      }
+    return best;
+  }
+};
+
+} //anonymous namespace
+
+
+NS_OBJECT_ENSURE_REGISTERED (LoadRawGrouping);
+
+TypeId
+LoadRawGrouping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LoadRawGrouping")
+    .SetParent<RawGroupingStrategy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<LoadRawGrouping> ()
+    .AddAttribute ("ExchangeDuration", "Airtime of one data frame and its ACK, including the mean backoff.",
+                   TimeValue (MicroSeconds (2000)),
+                   MakeTimeAccessor (&LoadRawGrouping::m_exchangeDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("PacketSize", "Size in bytes of the frames of the traffic file rates.",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&LoadRawGrouping::m_packetSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Smoothing", "Weight of the frames received in the last beacon interval "
+                   "in the load of a station; 0 keeps the loads of the traffic file.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&LoadRawGrouping::m_alpha),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("MaxGroups", "Maximum number of RAW groups in one beacon.  "
+                   "Each page of AIDs needs its own groups.",
+                   UintegerValue (42),
+                   MakeUintegerAccessor (&LoadRawGrouping::m_maxGroups),
+                   MakeUintegerChecker<uint32_t> (4, 42))
+    .AddAttribute ("TrafficFile", "File of \"station rate\" lines giving the initial loads, the rate in Mbit/s.",
+                   StringValue (""),
+                   MakeStringAccessor (&LoadRawGrouping::m_trafficFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+LoadRawGrouping::LoadRawGrouping ()
+  : m_load (AID_SPACE, 0.0),
+    m_received (AID_SPACE, 0),
+    m_beaconIntervalUs (0),
+    m_trafficFileRead (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LoadRawGrouping::~LoadRawGrouping ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LoadRawGrouping::NotifyAssociated (uint16_t aid, uint8_t staType)
+{
+  NS_LOG_FUNCTION (this << aid << (uint16_t) staType);
+  NS_ASSERT (aid < AID_SPACE);
+  std::vector<uint16_t>::iterator it = std::lower_bound (m_aids.begin (), m_aids.end (), aid, RawKeyLess);
+  if (it == m_aids.end () || *it != aid)
+    {
+      m_aids.insert (it, aid);
+      m_received[aid] = 0;
+    }
+}
+
+void
+LoadRawGrouping::NotifyDisassociated (uint16_t aid)
+{
+  NS_LOG_FUNCTION (this << aid);
+  std::vector<uint16_t>::iterator it = std::lower_bound (m_aids.begin (), m_aids.end (), aid, RawKeyLess);
+  if (it != m_aids.end () && *it == aid)
+    {
+      m_aids.erase (it);
+    }
+}
+
+void
+LoadRawGrouping::NotifyReceived (uint16_t aid)
+{
+  if (aid < AID_SPACE && m_received[aid] < 0xffff)
+    {
+      m_received[aid]++;
+    }
+}
+
+void
+LoadRawGrouping::SetLoad (uint16_t aid, double load)
+{
+  NS_ASSERT (aid < AID_SPACE);
+  m_load[aid] = load;
+}
+
+double
+LoadRawGrouping::GetLoad (uint16_t aid) const
+{
+  NS_ASSERT (aid < AID_SPACE);
+  return m_load[aid];
+}
+
+void
+LoadRawGrouping::ReadTrafficFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream file (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "cannot open " << filename);
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream fields (line);
+      uint32_t station;
+      double rate;
+      if (fields >> station >> rate && station + 1 < AID_SPACE)
+        {
+          m_load[station + 1] = rate * 1e6 / (8.0 * m_packetSize);
+        }
+    }
+  m_trafficFileRead = true;
+}
+
+void
+LoadRawGrouping::ReadTrafficFileOnce (void)
+{
+  if (!m_trafficFileRead && !m_trafficFile.empty ())
+    {
+      ReadTrafficFile (m_trafficFile);
+    }
+}
+
+double
+LoadRawGrouping::GetAvailableUs (uint32_t nGroups) const
+{
+  //the beacon overhead S1gRawCtr accounts for
+  uint64_t overheadUs = ((nGroups * 6 + 60) * 8 + 14) / 12 * 40 + 560;
+  return m_beaconIntervalUs > overheadUs ? m_beaconIntervalUs - overheadUs : 0;
+}
+
+double
+LoadRawGrouping::Partition (double maxSlotLoad, double limitUs, bool longest)
+{
+  m_groups.clear ();
+  m_groupUs.clear ();
+  double exchangeUs = m_exchangeDuration.GetMicroSeconds ();
+  double totalUs = 0;
+  GroupLoads loads;
+  uint32_t i = 0;
+  while (i < m_aids.size ())
+    {
+      //among the groups starting at station i whose slots meet maxSlotLoad,
+      //keep the one wasting the smallest part of its time, the longest
+      //on a tie or if longest
+      Group group;
+      group.aidStart = m_aids[i];
+      group.slotDurationCount = 0;
+      double groupUs = 0;
+      double bestWaste = 2;
+      uint32_t next = i + 1;
+      double groupLoad = 0;
+      loads.Clear ();
+      //a RAW group never spans two pages
+      for (uint32_t j = i; j < m_aids.size () && (m_aids[j] >> 11) == (m_aids[i] >> 11); j++)
+        {
+          uint16_t rawAid = m_aids[j] & 0x03ff;
+          if (j > i && !loads.Fits (rawAid, m_beaconLoad[j], maxSlotLoad))
+            {
+              break;
+            }
+          loads.Add (rawAid, m_beaconLoad[j]);
+          groupLoad += m_beaconLoad[j];
+          double us;
+          uint16_t slotNum = loads.ChooseSlotNum (maxSlotLoad, exchangeUs, us);
+          double waste = us > 0 ? 1 - groupLoad * exchangeUs / us : 0;
+          if (longest || waste <= bestWaste + 1e-12)
+            {
+              bestWaste = waste;
+              group.aidEnd = m_aids[j];
+              group.slotNum = slotNum;
+              group.maxSlotLoad = loads.busiest[slotNum];
+              groupUs = us;
+              next = j + 1;
+            }
+        }
+      m_groups.push_back (group);
+      m_groupUs.push_back (groupUs);
+      totalUs += groupUs;
+      i = next;
+      if (totalUs > limitUs || (m_groups.size () >= m_maxGroups && i < m_aids.size ()))
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+    }
+  return totalUs;
+}
+
+bool
+LoadRawGrouping::Fits (double maxSlotLoad, bool timeLimited)
+{
+  double limitUs = timeLimited ? GetAvailableUs (1) : std::numeric_limits<double>::infinity ();
+  double us = Partition (maxSlotLoad, limitUs, false);
+  return us != std::numeric_limits<double>::infinity ()
+         && (!timeLimited || us <= GetAvailableUs (m_groups.size ()));
+}
+
+const std::vector<LoadRawGrouping::Group> &
+LoadRawGrouping::Solve (uint64_t beaconIntervalUs)
+{
+  NS_LOG_FUNCTION (this << beaconIntervalUs);
+  ReadTrafficFileOnce ();
+  m_beaconIntervalUs = beaconIntervalUs;
+  double seconds = beaconIntervalUs / 1e6;
+  m_beaconLoad.resize (m_aids.size ());
+  double lo = 0;
+  double hi = 0;
+  for (uint32_t i = 0; i < m_aids.size (); i++)
+    {
+      double load = m_load[m_aids[i]] * seconds;
+      m_beaconLoad[i] = load;
+      lo = std::max (lo, load);
+      hi += load;
+    }
+
+  //no slot expects less than the busiest station, nor more than all of
+  //them.  When even the fewest groups do not fit in the beacon interval,
+  //the stations expect more frames than it carries: only MaxGroups bounds
+  //the split then, and the RAWs are shrunk below.
+  bool timeLimited = Fits (hi, true);
+  if (!Fits (lo, timeLimited))
+    {
+      for (uint32_t k = 0; k < BISECTIONS && hi - lo > 1e-9 * hi; k++)
+        {
+          double mid = (lo + hi) / 2;
+          if (Fits (mid, timeLimited))
+            {
+              hi = mid;
+            }
+          else
+            {
+              lo = mid;
+            }
+        }
+      lo = hi;
+    }
+  double us = Partition (lo, std::numeric_limits<double>::infinity (), false);
+  if (us == std::numeric_limits<double>::infinity ())
+    {
+      //too many groups: one per page then
+      us = Partition (hi, us, true);
+    }
+
+  //fill the beacon interval
+  double scale = us > 0 ? GetAvailableUs (m_groups.size ()) / us : 0;
+  for (uint32_t g = 0; g < m_groups.size (); g++)
+    {
+      Group & group = m_groups[g];
+      double slotUs = m_groupUs[g] * scale / group.slotNum;
+      double count = std::floor ((slotUs - 500) / 120);
+      group.slotDurationCount = (uint16_t) std::max (0.0, std::min (count, (double) MAX_SLOT_DURATION_COUNT));
+      NS_LOG_DEBUG ("group " << group.aidStart << "-" << group.aidEnd << ", " << group.slotNum
+                    << " slots, SlotDurationCount = " << group.slotDurationCount
+                    << ", busiest slot expects " << group.maxSlotLoad);
+    }
+  return m_groups;
+}
+
+RPS
+LoadRawGrouping::GetRps (uint64_t beaconIntervalUs)
+{
+  NS_LOG_FUNCTION (this << beaconIntervalUs);
+  ReadTrafficFileOnce ();
+  double seconds = beaconIntervalUs / 1e6;
+  for (std::vector<uint16_t>::const_iterator it = m_aids.begin (); it != m_aids.end (); it++)
+    {
+      m_load[*it] = (1 - m_alpha) * m_load[*it] + m_alpha * m_received[*it] / seconds;
+      m_received[*it] = 0;
+    }
+
+  RPS rps;
+  const std::vector<Group> & groups = Solve (beaconIntervalUs);
+  for (std::vector<Group>::const_iterator it = groups.begin (); it != groups.end (); it++)
+    {
+      RPS::RawAssignment raw;
+      raw.SetRawControl (0);
+      raw.SetSlotCrossBoundary (1);
+      raw.SetSlotFormat (1);
+      raw.SetSlotDurationCount (it->slotDurationCount);
+      raw.SetSlotNum (it->slotNum);
+      uint32_t page = (it->aidStart >> 11) & 0x0003;
+      raw.SetRawGroup (((it->aidEnd & 0x03ff) << 13) | ((it->aidStart & 0x03ff) << 2) | page);
+      rps.SetRawAssignment (raw);
+    }
+  return rps;
+}
+
+} //namespace ns3
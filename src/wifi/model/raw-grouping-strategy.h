@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RAW_GROUPING_STRATEGY_H
+#define RAW_GROUPING_STRATEGY_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "rps.h"
+#include "s1g-raw-control.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Computes the RPS element of the S1G beacons of an ApWifiMac.
+ *
+ * The AP tells the strategy which stations associate and leave and from
+ * which station it receives each data frame, and asks it for the RPS of
+ * every beacon it sends.
+ */
+class RawGroupingStrategy : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual ~RawGroupingStrategy ();
+
+  /**
+   * \param aid the AID of a station which associated
+   * \param staType the type of the station, 1 for a sensor and 2 for an
+   *        offload station
+   */
+  virtual void NotifyAssociated (uint16_t aid, uint8_t staType) = 0;
+  /**
+   * \param aid the AID of a station which disassociated
+   */
+  virtual void NotifyDisassociated (uint16_t aid) = 0;
+  /**
+   * \param aid the AID of the station a data frame was received from
+   */
+  virtual void NotifyReceived (uint16_t aid) = 0;
+  /**
+   * \param beaconIntervalUs the beacon interval, in microseconds
+   * \return the RPS of the beacon being sent
+   */
+  virtual RPS GetRps (uint64_t beaconIntervalUs) = 0;
+};
+
+/**
+ * \ingroup wifi
+ *
+ * The sensor and offload station heuristic of S1gRawCtr: one RAW group
+ * per station allowed to send in the beacon, sized after the estimated
+ * transmission interval of the station.
+ */
+class HeuristicRawGrouping : public RawGroupingStrategy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  HeuristicRawGrouping ();
+  virtual ~HeuristicRawGrouping ();
+
+  virtual void NotifyAssociated (uint16_t aid, uint8_t staType);
+  virtual void NotifyDisassociated (uint16_t aid);
+  virtual void NotifyReceived (uint16_t aid);
+  virtual RPS GetRps (uint64_t beaconIntervalUs);
+
+private:
+  virtual void DoDispose (void);
+
+  void SetTraceEnabled (bool enable);
+  bool GetTraceEnabled (void) const;
+
+  S1gRawCtr m_ctr;
+  std::string m_outputpath;
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Sizes the RAW groups and slots after the predicted load of every
+ * station.
+ *
+ * The load of a station is the number of frames it is expected to send
+ * per second.  It is read from a traffic file, as those of
+ * OptimalRawGroup/traffic, and follows the frames received from the
+ * station with an exponentially weighted moving average.
+ *
+ * Each beacon, the associated stations are split in groups of
+ * consecutive AIDs of one page, each group gets one RAW with up to 7
+ * slots, and a station goes to slot (AID mod slot number) of its group.
+ * As RAWs address the 10 low bits of the AIDs of a page, stations whose
+ * AIDs differ only in bit 10 always share a slot.  A slot lasts
+ * long enough to carry the expected frames of its busiest slot, one
+ * ExchangeDuration each.  The solver looks for the smallest number of
+ * expected frames in the busiest slot of the beacon (the contention of
+ * the worst slot) for which all the RAWs still fit in the beacon
+ * interval: a bisection over that number, each step building the groups
+ * greedily in one pass over the stations.  Each group is cut where its
+ * slots waste the smallest part of their time.  The RAW durations are
+ * then stretched or shrunk to fill the beacon interval.
+ *
+ * A solve makes about 40 passes over the stations, s1g-raw-grouping-bench
+ * times it.
+ */
+class LoadRawGrouping : public RawGroupingStrategy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LoadRawGrouping ();
+  virtual ~LoadRawGrouping ();
+
+  /**
+   * One RAW group of the solution
+   */
+  struct Group
+  {
+    uint16_t aidStart;
+    uint16_t aidEnd;
+    uint16_t slotNum;
+    uint16_t slotDurationCount;
+    double maxSlotLoad;        //!< expected frames in the busiest slot
+  };
+
+  virtual void NotifyAssociated (uint16_t aid, uint8_t staType);
+  virtual void NotifyDisassociated (uint16_t aid);
+  virtual void NotifyReceived (uint16_t aid);
+  virtual RPS GetRps (uint64_t beaconIntervalUs);
+
+  /**
+   * \param aid the AID of a station
+   * \param load the frames per second the station is expected to send
+   */
+  void SetLoad (uint16_t aid, double load);
+  /**
+   * \param aid the AID of a station
+   * \return the frames per second the station is expected to send
+   */
+  double GetLoad (uint16_t aid) const;
+  /**
+   * Read the loads of the stations from a file of "station rate" lines,
+   * the rate in Mbit/s.  Station i is the i-th station installed, whose
+   * AID is i + 1.
+   *
+   * \param filename the traffic file
+   */
+  void ReadTrafficFile (std::string filename);
+  /**
+   * Compute the groups for the current loads, without updating the loads
+   * from the received frames.
+   *
+   * \param beaconIntervalUs the beacon interval, in microseconds
+   * \return the RAW groups, by page and RAW AID
+   */
+  const std::vector<Group> & Solve (uint64_t beaconIntervalUs);
+
+private:
+  /**
+   * Split the stations in groups whose busiest slot expects at most
+   * maxSlotLoad frames.
+   *
+   * \param maxSlotLoad the most expected frames in one slot
+   * \param limitUs stop as soon as the groups need more than limitUs
+   * \param longest make each group as long as maxSlotLoad allows
+   * \return the microseconds the groups need, infinity if they need
+   *         more than limitUs or if there are more than MaxGroups
+   */
+  double Partition (double maxSlotLoad, double limitUs, bool longest);
+  /**
+   * \param maxSlotLoad the most expected frames in one slot
+   * \param timeLimited whether the groups must fit in the beacon interval
+   * \return whether the stations split in at most MaxGroups groups whose
+   *         busiest slot expects at most maxSlotLoad frames
+   */
+  bool Fits (double maxSlotLoad, bool timeLimited);
+  /**
+   * \param nGroups a number of RAW groups
+   * \return the microseconds of the beacon interval left to the RAWs
+   */
+  double GetAvailableUs (uint32_t nGroups) const;
+  void ReadTrafficFileOnce (void);
+
+  std::vector<uint16_t> m_aids;       //!< associated AIDs, by page and RAW AID
+  std::vector<double> m_load;         //!< frames per second, by AID
+  std::vector<uint16_t> m_received;   //!< frames received this beacon, by AID
+  std::vector<double> m_beaconLoad;   //!< expected frames per beacon, as m_aids
+  std::vector<Group> m_groups;
+  std::vector<double> m_groupUs;      //!< the microseconds each group needs
+  uint64_t m_beaconIntervalUs;
+
+  Time m_exchangeDuration;
+  uint32_t m_packetSize;
+  double m_alpha;
+  uint32_t m_maxGroups;
+  std::string m_trafficFile;
+  bool m_trafficFileRead;
+};
+
+} //namespace ns3
+
+#endif /* RAW_GROUPING_STRATEGY_H */
@@ -308,6 +308,19 @@ RegularWifiMac::GetCtsToSelfSupported () const
   return m_low->GetCtsToSelfSupported ();
 }
 
+void
+RegularWifiMac::SetLazyAccessTimeout (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_dcfManager->SetLazyAccessTimeout (enable);
+}
+
+bool
+RegularWifiMac::GetLazyAccessTimeout (void) const
+{
+  return m_dcfManager->GetLazyAccessTimeout ();
+}
+
 void
 RegularWifiMac::SetSlot (Time slotTime)
 {
@@ -708,6 +721,13 @@ RegularWifiMac::GetTypeId (void)
                    MakeBooleanAccessor (&RegularWifiMac::SetCtsToSelfSupported,
                                         &RegularWifiMac::GetCtsToSelfSupported),
                    MakeBooleanChecker ())
+    .AddAttribute ("LazyAccessTimeout",
+                   "Whether the DcfManager leaves its access timeout alone during "
+                   "receptions, and restarts it at their end.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RegularWifiMac::SetLazyAccessTimeout,
+                                        &RegularWifiMac::GetLazyAccessTimeout),
+                   MakeBooleanChecker ())
     .AddAttribute ("DcaTxop", "The DcaTxop object",
                    PointerValue (),
                    MakePointerAccessor (&RegularWifiMac::GetDcaTxop),
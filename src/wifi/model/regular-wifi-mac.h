@@ -128,6 +128,16 @@ public:
    *         false otherwise.
    */
   bool GetCtsToSelfSupported () const;
+  /**
+   * \param enable whether the DcfManager leaves its access timeout alone
+   *        during receptions, see DcfManager::SetLazyAccessTimeout
+   */
+  void SetLazyAccessTimeout (bool enable);
+  /**
+   * \return whether the DcfManager leaves its access timeout alone
+   *         during receptions
+   */
+  bool GetLazyAccessTimeout (void) const;
   /**
    * \return the MAC address associated to this MAC layer.
    */
@@ -20,8 +20,10 @@
 
 #include "rps.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/log.h" //for test
 #include <sstream>
+#include <cstring>
 
 namespace ns3 {
 
@@ -183,15 +185,154 @@ RPS::RawAssignment::GetSize (void) const
 }
 
 
+RPS::RawAssignmentView::RawAssignmentView (const uint8_t * start)
+  : m_start (start)
+{
+}
+
+uint8_t
+RPS::RawAssignmentView::GetRawControl (void) const
+{
+  return m_start[0];
+}
+
+uint16_t
+RPS::RawAssignmentView::GetRawSlot (void) const
+{
+  return (uint16_t (m_start[2]) << 8) | uint16_t (m_start[1]);
+}
+
+uint8_t
+RPS::RawAssignmentView::GetSlotFormat (void) const
+{
+  return (GetRawSlot () >> 15) & 0x0001;
+}
+
+uint8_t
+RPS::RawAssignmentView::GetSlotCrossBoundary (void) const
+{
+  return (GetRawSlot () >> 14) & 0x0001;
+}
+
+uint16_t
+RPS::RawAssignmentView::GetSlotDurationCount (void) const
+{
+  if (GetSlotFormat () == 0)
+    {
+      return (GetRawSlot () >> 6) & 0x00ff;
+    }
+  return (GetRawSlot () >> 3) & 0x07ff;
+}
+
+uint16_t
+RPS::RawAssignmentView::GetSlotNum (void) const
+{
+  if (GetSlotFormat () == 0)
+    {
+      return GetRawSlot () & 0x003f;
+    }
+  return GetRawSlot () & 0x0007;
+}
+
+uint32_t
+RPS::RawAssignmentView::GetRawGroup (void) const
+{
+  return (uint32_t (m_start[5]) << 16) | (uint32_t (m_start[4]) << 8) | uint32_t (m_start[3]);
+}
+
+uint8_t
+RPS::RawAssignmentView::GetPage (void) const
+{
+  return m_start[3] & 0x03;
+}
+
+uint16_t
+RPS::RawAssignmentView::GetRawStartAid (void) const
+{
+  return (GetRawGroup () >> 2) & 0x000007ff;
+}
+
+uint16_t
+RPS::RawAssignmentView::GetRawEndAid (void) const
+{
+  return (GetRawGroup () >> 13) & 0x000007ff;
+}
+
+RPS::Iterator::Iterator (const uint8_t * pos)
+  : m_pos (pos)
+{
+}
+
+RPS::RawAssignmentView
+RPS::Iterator::operator * (void) const
+{
+  return RawAssignmentView (m_pos);
+}
+
+RPS::Iterator &
+RPS::Iterator::operator ++ (void)
+{
+  m_pos += RAW_ASSIGNMENT_SIZE;
+  return *this;
+}
+
+bool
+RPS::Iterator::operator == (const Iterator & o) const
+{
+  return m_pos == o.m_pos;
+}
+
+bool
+RPS::Iterator::operator != (const Iterator & o) const
+{
+  return m_pos != o.m_pos;
+}
+
+const uint8_t RPS::RAW_ASSIGNMENT_SIZE;
+const uint8_t RPS::MAX_RAW_ASSIGNMENTS;
+
 RPS::RPS ()
 {
   m_length = 0;
 }
 
+RPS::RPS (const RPS & o)
+  : WifiInformationElement (o),
+    m_length (o.m_length)
+{
+  std::memcpy (m_rps, o.m_rps, m_length);
+}
+
+RPS &
+RPS::operator = (const RPS & o)
+{
+  m_length = o.m_length;
+  std::memcpy (m_rps, o.m_rps, m_length);
+  return *this;
+}
+
 RPS::~RPS ()
 {
 }
 
+RPS::Iterator
+RPS::Begin (void) const
+{
+  return Iterator (m_rps);
+}
+
+RPS::Iterator
+RPS::End (void) const
+{
+  return Iterator (m_rps + GetNRawAssignments () * RAW_ASSIGNMENT_SIZE);
+}
+
+uint8_t
+RPS::GetNRawAssignments (void) const
+{
+  return m_length / RAW_ASSIGNMENT_SIZE;
+}
+
 //suppose all subfield of RAW Assignment are presented, 12 octets
 // change in future
 
@@ -200,47 +341,46 @@ RPS::~RPS ()
 void
 RPS::SetRawAssignment (RPS::RawAssignment raw)
 {
-    //m_length = 0;
-     //uint8_t m_rpsarry[12]; //! Support up to 10 RAW Assignment subfield
-    //uint8_t len = assignment.GetSize ();
-    m_rpsarry.push_back(raw.GetRawControl ());
-    m_length++;
-    m_rpsarry.push_back((uint8_t)raw.GetRawSlot ());
-    m_length++;
-    m_rpsarry.push_back((uint8_t)(raw.GetRawSlot () >> 8));
-    m_length++;
-    //m_rpsarry.push_back(raw.GetRawStart ());
-    //m_length++;
-    m_rpsarry.push_back((uint8_t)(raw.GetRawGroup ()));//(7-0)
-    m_length++;
-    m_rpsarry.push_back((uint8_t)(raw.GetRawGroup () >> 8));//(15-8)
-    m_length++;
-    m_rpsarry.push_back( (uint8_t)(raw.GetRawGroup () >> 16));//(23-16)
-    m_length++;
-    //m_rpsarry.push_back((uint8_t)raw.GetChannelInd ());
-    //m_length++;
-    //m_rpsarry.push_back((uint8_t)(raw.GetChannelInd () >> 16));
-    //m_length++;
-    //m_rpsarry.push_back((uint8_t)raw.GetPRAW ());
-    //m_length++;
-    //m_rpsarry.push_back((uint8_t)(raw.GetPRAW () >> 8));
-    //m_length++;
-    //m_rpsarry.push_back( (uint8_t)(raw.GetPRAW () >> 16));
-    //m_length++;
-
-    m_rps = &m_rpsarry[0];
-    //printf (" set m_rps %x\n" , m_rps[6]);
-
-}
-
-uint8_t *
+    NS_ABORT_MSG_IF (m_length + RAW_ASSIGNMENT_SIZE > (int) sizeof (m_rps),
+                     "more than " << (int) MAX_RAW_ASSIGNMENTS << " RAW assignments in one RPS");
+    uint8_t * start = m_rps + m_length;
+    uint16_t rawslot = raw.GetRawSlot ();
+    uint32_t rawgroup = raw.GetRawGroup ();
+    start[0] = raw.GetRawControl ();
+    start[1] = (uint8_t)rawslot;
+    start[2] = (uint8_t)(rawslot >> 8);
+    start[3] = (uint8_t)rawgroup; //(7-0)
+    start[4] = (uint8_t)(rawgroup >> 8); //(15-8)
+    start[5] = (uint8_t)(rawgroup >> 16); //(23-16)
+    m_length += RAW_ASSIGNMENT_SIZE;
+}
+
+const uint8_t *
 RPS::GetRawAssignment (void) const
 {
-    //printf (" get m_rps addressx\n" , m_rps);
-    //printf (" get m_rps %x\n" , m_rps[6]);
     return m_rps;
 }
 
+void
+RPS::SetSlotDurationCount (uint8_t index, uint16_t count)
+{
+  NS_ASSERT (index < GetNRawAssignments ());
+  uint8_t * start = m_rps + index * RAW_ASSIGNMENT_SIZE;
+  uint16_t rawslot = (uint16_t (start[2]) << 8) | uint16_t (start[1]);
+  bool format = (rawslot >> 15) & 0x0001;
+  NS_ASSERT ((!format && count < 256) || (format && count < 2048));
+  if (format)
+    {
+      rawslot = (rawslot & ~(0x07ff << 3)) | ((count & 0x07ff) << 3);
+    }
+  else
+    {
+      rawslot = (rawslot & ~(0x00ff << 6)) | ((count & 0x00ff) << 6);
+    }
+  start[1] = (uint8_t)rawslot;
+  start[2] = (uint8_t)(rawslot >> 8);
+}
+
 WifiInformationElementId
 RPS::ElementId () const
 {
@@ -262,9 +402,7 @@ RPS::SerializeInformationField (Buffer::Iterator start) const
 uint8_t
 RPS::DeserializeInformationField (Buffer::Iterator start, uint8_t length)
 {
-  //static uint8_t m_rpsarry[12];
-  start.Read (m_rpsarry_temp, length);
-  m_rps = m_rpsarry_temp;
+  start.Read (m_rps, length);
   m_length = length;
   return length;
 }
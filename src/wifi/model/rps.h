@@ -93,8 +93,52 @@ public:
           
           uint8_t raw_length; //!< length of (single) Raw Assignment
        };
-    
+
+      /**
+       * Read-only view of one RAW Assignment subfield inside an RPS.
+       * Fields are decoded on access from the RPS buffer, nothing is
+       * copied.  A view is only valid as long as the RPS it comes from.
+       */
+      class RawAssignmentView
+       {
+       public:
+          RawAssignmentView (const uint8_t * start);
+
+          uint8_t GetRawControl (void) const;
+          uint16_t GetRawSlot (void) const;
+          uint8_t GetSlotFormat (void) const;
+          uint8_t GetSlotCrossBoundary (void) const;
+          uint16_t GetSlotDurationCount (void) const;
+          uint16_t GetSlotNum (void) const;
+          uint32_t GetRawGroup (void) const;
+          uint8_t GetPage (void) const;
+          uint16_t GetRawStartAid (void) const;
+          uint16_t GetRawEndAid (void) const;
+
+       private:
+          const uint8_t * m_start;
+       };
+
+      /**
+       * Iterates over the RAW Assignment subfields of an RPS.
+       */
+      class Iterator
+       {
+       public:
+          Iterator (const uint8_t * pos);
+
+          RawAssignmentView operator * (void) const;
+          Iterator & operator ++ (void);
+          bool operator == (const Iterator & o) const;
+          bool operator != (const Iterator & o) const;
+
+       private:
+          const uint8_t * m_pos;
+       };
+
   RPS ();
+  RPS (const RPS & o);
+  RPS & operator = (const RPS & o);
   ~RPS ();
  
    /**
@@ -108,8 +152,23 @@ public:
    *
    * \Return the Partial Virtual Bitmap
    */
-  uint8_t * GetRawAssignment (void) const;  //to do, use std::vector
-    
+  const uint8_t * GetRawAssignment (void) const;
+  /**
+   * \param index the index of a RAW Assignment subfield
+   * \param count the new slot duration count of that subfield
+   *
+   * Patch the slot duration count in place, in the slot format of the
+   * subfield.
+   */
+  void SetSlotDurationCount (uint8_t index, uint16_t count);
+
+  Iterator Begin (void) const;
+  Iterator End (void) const;
+  /**
+   * \return the number of RAW Assignment subfields
+   */
+  uint8_t GetNRawAssignments (void) const;
+
 
   WifiInformationElementId ElementId () const;
   uint8_t GetInformationFieldSize () const;
@@ -117,15 +176,13 @@ public:
   void SerializeInformationField (Buffer::Iterator start) const;
   uint8_t DeserializeInformationField (Buffer::Iterator start, uint8_t length);
     
-  uint8_t m_length;
+  static const uint8_t RAW_ASSIGNMENT_SIZE = 6;
+  /** The most RAW Assignment subfields one information field can carry */
+  static const uint8_t MAX_RAW_ASSIGNMENTS = 255 / RAW_ASSIGNMENT_SIZE;
+
+  uint8_t m_length; //!< Total length of all RAW Assignments
 private:
-  RPS::RawAssignment assignment; //!< RawAssignment subfield
-  uint8_t * m_rps; //! Support up to 10 RAW Assignment subfield
-  //uint8_t m_rpsarry[12];
-    uint8_t m_rpsarry_temp[1200];
-  std::vector<uint8_t> m_rpsarry;
-  
-  //uint8_t m_length; //!< Total length of all RAW Assignments
+  uint8_t m_rps[255]; //!< RAW Assignment subfields, up to the largest information field
 };
 
 std::ostream &operator << (std::ostream &os, const RPS &rps);
@@ -140,7 +197,7 @@ ATTRIBUTE_HELPER_HEADER (RPS);
 class RPSVector
 {
 public:
-    typedef std::vector<ns3::RPS *> RPSlist;
+    typedef std::vector<ns3::RPS> RPSlist;
     RPSlist rpsset;
     
     uint32_t getlen();
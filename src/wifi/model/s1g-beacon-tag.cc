@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "s1g-beacon-tag.h"
+#include "ns3/tag.h"
+#include <algorithm>
+#include <stdint.h>
+
+namespace ns3 {
+
+S1gBeaconInfo::S1gBeaconInfo (const S1gBeaconHeader &beacon)
+  : m_header (beacon),
+    m_rawDurationUs (0)
+{
+  const RPS & rps = m_header.GetRPS ();
+  m_raws.reserve (rps.GetNRawAssignments ());
+  for (RPS::Iterator it = rps.Begin (); it != rps.End (); ++it)
+    {
+      RPS::RawAssignmentView view = *it;
+      Raw raw;
+      raw.rawType = view.GetRawControl () & 0x07;
+      raw.page = view.GetPage ();
+      raw.rawStartAid = view.GetRawStartAid () & 0x03ff;
+      raw.rawEndAid = view.GetRawEndAid () & 0x03ff;
+      raw.slotDurationCount = view.GetSlotDurationCount ();
+      raw.slotNum = view.GetSlotNum ();
+      raw.startUs = m_rawDurationUs;
+      m_rawDurationUs += (500 + raw.slotDurationCount * 120) * raw.slotNum;
+      m_raws.push_back (raw);
+    }
+  BuildSegments ();
+}
+
+void
+S1gBeaconInfo::BuildSegments (void)
+{
+  for (uint8_t page = 0; page < 4; page++)
+    {
+      //boundaries of the RAW groups of this page
+      std::vector<uint16_t> bounds;
+      bounds.push_back (0);
+      for (std::vector<Raw>::const_iterator it = m_raws.begin (); it != m_raws.end (); ++it)
+        {
+          if (it->page == page && it->slotNum != 0 && it->rawStartAid <= it->rawEndAid)
+            {
+              bounds.push_back (it->rawStartAid);
+              bounds.push_back (it->rawEndAid + 1);
+            }
+        }
+      std::sort (bounds.begin (), bounds.end ());
+      bounds.erase (std::unique (bounds.begin (), bounds.end ()), bounds.end ());
+
+      //the last RAW including a segment gives its slot
+      std::vector<Segment> & segments = m_segments[page];
+      segments.clear ();
+      for (std::vector<uint16_t>::const_iterator b = bounds.begin (); b != bounds.end (); ++b)
+        {
+          Segment segment;
+          segment.start = *b;
+          segment.rawIndex = -1;
+          for (int16_t i = m_raws.size () - 1; i >= 0; i--)
+            {
+              const Raw & raw = m_raws[i];
+              if (raw.page == page && raw.slotNum != 0
+                  && raw.rawStartAid <= *b && *b <= raw.rawEndAid)
+                {
+                  segment.rawIndex = i;
+                  break;
+                }
+            }
+          if (segments.empty () || segments.back ().rawIndex != segment.rawIndex)
+            {
+              segments.push_back (segment);
+            }
+        }
+    }
+}
+
+const S1gBeaconHeader &
+S1gBeaconInfo::GetHeader (void) const
+{
+  return m_header;
+}
+
+const std::vector<S1gBeaconInfo::Raw> &
+S1gBeaconInfo::GetRaws (void) const
+{
+  return m_raws;
+}
+
+uint64_t
+S1gBeaconInfo::GetRawDurationUs (void) const
+{
+  return m_rawDurationUs;
+}
+
+/**
+ * Order segments by their first AID
+ */
+struct SegmentStartLess
+{
+  template <typename T>
+  bool operator () (uint16_t aid, const T &segment) const
+  {
+    return aid < segment.start;
+  }
+};
+
+bool
+S1gBeaconInfo::FindSlot (uint16_t aid, Slot &slot) const
+{
+  const std::vector<Segment> & segments = m_segments[(aid >> 11) & 0x0003];
+  uint16_t rawAid = aid & 0x03ff;
+  std::vector<Segment>::const_iterator it = std::upper_bound (segments.begin (), segments.end (),
+                                                              rawAid, SegmentStartLess ());
+  if (it == segments.begin ())
+    {
+      return false;
+    }
+  --it;
+  if (it->rawIndex < 0)
+    {
+      return false;
+    }
+  const Raw & raw = m_raws[it->rawIndex];
+  slot.rawIndex = it->rawIndex;
+  slot.slot = rawAid % raw.slotNum;
+  slot.durationUs = 500 + raw.slotDurationCount * 120;
+  slot.startUs = slot.durationUs * slot.slot + raw.startUs;
+  return true;
+}
+
+
+/*
+ * Number of entries of a S1gBeaconTable
+ */
+static const uint32_t TABLE_SIZE = 256;
+
+S1gBeaconTable::S1gBeaconTable ()
+  : m_lastId (0)
+{
+}
+
+uint32_t
+S1gBeaconTable::Add (Ptr<const S1gBeaconInfo> info)
+{
+  if (m_entries.empty ())
+    {
+      Entry empty;
+      empty.id = 0;
+      m_entries.resize (TABLE_SIZE, empty);
+    }
+  m_lastId++;
+  if (m_lastId == 0)
+    {
+      m_lastId++;
+    }
+  Entry & entry = m_entries[m_lastId % TABLE_SIZE];
+  entry.id = m_lastId;
+  entry.info = info;
+  return m_lastId;
+}
+
+Ptr<const S1gBeaconInfo>
+S1gBeaconTable::Get (uint32_t id) const
+{
+  if (id == 0 || m_entries.empty ())
+    {
+      return 0;
+    }
+  const Entry & entry = m_entries[id % TABLE_SIZE];
+  if (entry.id != id)
+    {
+      return 0;
+    }
+  return entry.info;
+}
+
+void
+S1gBeaconTable::Clear (void)
+{
+  m_entries.clear ();
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (S1gBeaconTag);
+
+TypeId
+S1gBeaconTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::S1gBeaconTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<S1gBeaconTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+S1gBeaconTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+S1gBeaconTag::S1gBeaconTag ()
+  : m_table (0),
+    m_id (0)
+{
+}
+
+void
+S1gBeaconTag::SetBeaconInfo (S1gBeaconTable &table, Ptr<const S1gBeaconInfo> info)
+{
+  m_table = &table;
+  m_id = table.Add (info);
+}
+
+Ptr<const S1gBeaconInfo>
+S1gBeaconTag::GetBeaconInfo (void) const
+{
+  if (m_table == 0)
+    {
+      return 0;
+    }
+  return m_table->Get (m_id);
+}
+
+uint32_t
+S1gBeaconTag::GetSerializedSize (void) const
+{
+  return 12;
+}
+
+void
+S1gBeaconTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (reinterpret_cast<uintptr_t> (m_table));
+  i.WriteU32 (m_id);
+}
+
+void
+S1gBeaconTag::Deserialize (TagBuffer i)
+{
+  m_table = reinterpret_cast<const S1gBeaconTable *> (static_cast<uintptr_t> (i.ReadU64 ()));
+  m_id = i.ReadU32 ();
+}
+
+void
+S1gBeaconTag::Print (std::ostream &os) const
+{
+  os << "S1gBeacon=" << m_id;
+}
+
+} //namespace ns3
@@ -22,6 +22,7 @@
 
 #include "ap-wifi-mac.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
@@ -57,19 +58,42 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("S1gRawCtr");
 
+//association changes of a sensor not yet applied, incremental mode
+enum
+{
+  PENDING_NONE = 0,
+  PENDING_ADD = 1,
+  PENDING_REMOVE = 2
+};
+
+//orders AIDs by SensorTable::m_order
+struct LastTransmissionOrder
+{
+  LastTransmissionOrder (const std::vector<uint64_t> & order)
+    : m_order (order)
+  {
+  }
+  bool operator () (uint16_t a, uint16_t b) const
+  {
+    return m_order[a] < m_order[b];
+  }
+  const std::vector<uint64_t> & m_order;
+};
+
 //NS_OBJECT_ENSURE_REGISTERED (S1gRawCtr);
 
 //** AP update info after RAW ends(right before next beacon is sent)
 //list of sensor allowed to transmit in last beacon ************
 Sensor::Sensor ()
+  : m_table (0),
+    m_aid (0)
+{
+}
+
+Sensor::Sensor (SensorTable * table, uint16_t aid)
+  : m_table (table),
+    m_aid (aid)
 {
-  last_transmissionInterval = 1;
-    last2_transmissionInterval = 1;
-    m_transmissionIntervalMax =1;
-    m_transmissionIntervalMin = 1;
-    m_transInOneBeacon = 1;
-    m_transIntervalListSize = 5;
-    m_index = 0;
 }
 
 Sensor::~Sensor ()
@@ -79,20 +103,20 @@ Sensor::~Sensor ()
 uint16_t
 Sensor::GetTransInOneBeacon (void) const
 {
-   return m_transInOneBeacon;
+   return m_table->m_transInOneBeacon[m_aid];
 }
 
 void
 Sensor::SetTransInOneBeacon (uint16_t num)
 {
-     m_transInOneBeacon = num;
+     m_table->m_transInOneBeacon[m_aid] = num;
 }
 
 
 void
 Sensor::EstimateNextTransmissionId (uint64_t m_nextId)
 {
-    m_nextTransmissionId = m_nextId;
+    m_table->SetNextTransmissionId (m_aid, m_nextId);
 }
 
 
@@ -105,7 +129,7 @@ Sensor::SetAid (uint16_t aid)
 void
 Sensor::SetTransmissionSuccess (bool success)
 {
-    m_transmissionSuccess = success;
+    m_table->m_transmissionSuccess[m_aid] = success;
 }
 
 uint16_t
@@ -117,24 +141,397 @@ Sensor::GetAid (void) const
 bool
 Sensor::GetTransmissionSuccess (void) const
 {
-    return m_transmissionSuccess;
+    return m_table->m_transmissionSuccess[m_aid];
 }
 
 uint64_t
 Sensor::GetEstimateNextTransmissionId (void) const
 {
-    return m_nextTransmissionId;
+    return m_table->m_nextTransmissionId[m_aid];
 }
 
 void
 Sensor::SetEverSuccess(bool success)
 {
-    m_everSuccess = success;
+    m_table->m_everSuccess[m_aid] = success;
 }
 bool
 Sensor::GetEverSuccess (void) const
 {
-    return m_everSuccess;
+    return m_table->m_everSuccess[m_aid];
+}
+
+UpdateInfo &
+Sensor::GetUpdateInfo (void)
+{
+    return m_table->m_updateInfo[m_aid];
+}
+
+void
+Sensor::ResetTransIntervalList (void)
+{
+    uint16_t * list = &m_table->m_transIntervalList[m_aid * SensorTable::TRANS_INTERVAL_LIST_SIZE];
+    for (uint16_t i = 0; i < SensorTable::TRANS_INTERVAL_LIST_SIZE; i++)
+      {
+        list[i] = 1;
+      }
+}
+
+void
+Sensor::PushTransInterval (uint16_t interval)
+{
+    //newest first, the oldest entry is overwritten
+    uint8_t & head = m_table->m_transIntervalHead[m_aid];
+    head = (head == 0) ? SensorTable::TRANS_INTERVAL_LIST_SIZE - 1 : head - 1;
+    m_table->m_transIntervalList[m_aid * SensorTable::TRANS_INTERVAL_LIST_SIZE + head] = interval;
+}
+
+uint16_t
+Sensor::GetTransInterval (uint16_t index) const
+{
+    NS_ASSERT (index < SensorTable::TRANS_INTERVAL_LIST_SIZE);
+    uint16_t position = (m_table->m_transIntervalHead[m_aid] + index) % SensorTable::TRANS_INTERVAL_LIST_SIZE;
+    return m_table->m_transIntervalList[m_aid * SensorTable::TRANS_INTERVAL_LIST_SIZE + position];
+}
+
+//SensorTable
+SensorTable::SensorTable ()
+  : m_nextOrder (0),
+    m_trackDue (false),
+    m_lastDueId (0),
+    m_orderMark (0)
+{
+}
+
+SensorTable::~SensorTable ()
+{
+    for (std::vector<Sensor *>::iterator it = m_handles.begin (); it != m_handles.end (); it++)
+      {
+        delete *it;
+      }
+    m_handles.clear ();
+}
+
+void
+SensorTable::Grow (uint16_t aid)
+{
+    if (aid < m_handles.size ())
+      {
+        return;
+      }
+    uint32_t n = aid + 1;
+    m_handles.resize (n, 0);
+    m_denseIndex.resize (n, 0);
+    m_present.resize (n, 0);
+    m_nextTransmissionId.resize (n, 0);
+    m_transIntervalList.resize (n * TRANS_INTERVAL_LIST_SIZE, 1);
+    m_transIntervalHead.resize (n, 0);
+    m_transmissionSuccess.resize (n, 0);
+    m_everSuccess.resize (n, 0);
+    m_updateInfo.resize (n);
+    m_transmissionInterval.resize (n, 1);
+    m_lastTransmissionInterval.resize (n, 1);
+    m_last2TransmissionInterval.resize (n, 1);
+    m_transInOneBeacon.resize (n, 1);
+    m_receivedNum.resize (n, 0);
+    m_index.resize (n, 0);
+    m_order.resize (n, 0);
+    m_inDue.resize (n, 0);
+}
+
+Sensor *
+SensorTable::Add (uint16_t aid)
+{
+    NS_ASSERT (aid <= MAX_AID);
+    Grow (aid);
+    if (m_present[aid])
+      {
+        return m_handles[aid];
+      }
+    if (m_handles[aid] == 0)
+      {
+        m_handles[aid] = new Sensor (this, aid);
+      }
+    m_present[aid] = 1;
+    m_denseIndex[aid] = m_aids.size ();
+    m_aids.push_back (aid);
+
+    //same initial state as a freshly constructed sensor
+    SetNextTransmissionId (aid, 0);
+    m_transmissionSuccess[aid] = 0;
+    m_everSuccess[aid] = 0;
+    m_transmissionInterval[aid] = 1;
+    m_lastTransmissionInterval[aid] = 1;
+    m_last2TransmissionInterval[aid] = 1;
+    m_transInOneBeacon[aid] = 1;
+    m_receivedNum[aid] = 0;
+    m_index[aid] = 0;
+    m_order[aid] = m_nextOrder++;
+    m_handles[aid]->ResetTransIntervalList ();
+    return m_handles[aid];
+}
+
+void
+SensorTable::Remove (uint16_t aid)
+{
+    if (aid >= m_present.size () || !m_present[aid])
+      {
+        return;
+      }
+    //swap with the last dense entry
+    uint32_t index = m_denseIndex[aid];
+    uint16_t last = m_aids.back ();
+    m_aids[index] = last;
+    m_denseIndex[last] = index;
+    m_aids.pop_back ();
+    m_present[aid] = 0;
+}
+
+Sensor *
+SensorTable::Lookup (uint16_t aid) const
+{
+    if (aid >= m_present.size () || !m_present[aid])
+      {
+        return 0;
+      }
+    return m_handles[aid];
+}
+
+uint32_t
+SensorTable::GetN (void) const
+{
+    return m_aids.size ();
+}
+
+uint16_t
+SensorTable::GetAid (uint32_t i) const
+{
+    return m_aids[i];
+}
+
+void
+SensorTable::EnableDueTracking (void)
+{
+    m_trackDue = true;
+}
+
+void
+SensorTable::SetNextTransmissionId (uint16_t aid, uint64_t id)
+{
+    m_nextTransmissionId[aid] = id;
+    //a due sensor postponed by at most one beacon stays in m_due
+    if (m_trackDue && !(m_inDue[aid] && id <= m_lastDueId + 1))
+      {
+        m_calendar[id].push_back (aid);
+      }
+}
+
+void
+SensorTable::EstimateBatch::Resize (uint32_t n)
+{
+    preTrySuccess.resize (n);
+    success.resize (n);
+    received.resize (n);
+    interval.resize (n);
+    index.resize (n);
+    transInOneBeacon.resize (n);
+    sinceSuccess.resize (n);
+    currentSuccess.resize (n);
+    newInterval.resize (n);
+    newIndex.resize (n);
+    newTransInOneBeacon.resize (n);
+    nextId.resize (n);
+    push.resize (n);
+}
+
+/**
+ * \param mask all ones or all zeros
+ * \return a if mask is all ones, b otherwise, without a branch
+ */
+static inline uint64_t
+SelectMask (uint64_t mask, uint64_t a, uint64_t b)
+{
+    return (a & mask) | (b & ~mask);
+}
+
+//64 bit vector compares need AVX2 on x86-64, so there the update is also
+//built for AVX2 and the version for the running CPU is picked at load time
+#if defined (__GNUC__) && !defined (__clang__) && defined (__x86_64__) && defined (__linux__)
+#define ESTIMATE_TARGET_CLONES __attribute__ ((target_clones ("avx2", "default")))
+#else
+#define ESTIMATE_TARGET_CLONES
+#endif
+
+/**
+ * The cases of Sensor::EstimateTransmissionInterval as masks, so that the
+ * loop has no control flow.  All the arrays hold n entries and do not
+ * overlap.
+ */
+ESTIMATE_TARGET_CLONES
+static void
+EstimateBatchUpdate (uint32_t n,
+                     const uint64_t * __restrict pre, const uint64_t * __restrict success,
+                     const uint64_t * __restrict received, const uint64_t * __restrict interval,
+                     const uint64_t * __restrict index, const uint64_t * __restrict trans,
+                     const uint64_t * __restrict since, const uint64_t * __restrict currentSuccess,
+                     uint64_t * __restrict newInterval, uint64_t * __restrict newIndex,
+                     uint64_t * __restrict newTrans, uint64_t * __restrict nextId,
+                     uint64_t * __restrict push)
+{
+    for (uint32_t i = 0; i < n; i++)
+      {
+        uint64_t both = pre[i] & success[i];
+        uint64_t first = success[i] & (pre[i] ^ 1);
+        uint64_t failed = success[i] ^ 1;
+        uint64_t many = received[i] > 1;
+        uint64_t shorten = both & many & (interval[i] > 1);
+        uint64_t keep = both & many & (interval[i] == 1);
+        uint64_t single = both & (received[i] == 1);
+        uint64_t failedIndex = (index[i] + 1) & 0xffff;
+        uint64_t adjusted = trans[i] + (received[i] > trans[i]) - (received[i] < trans[i]);
+
+        uint64_t value = SelectMask (0 - failed, since[i] + 2 * failedIndex - 1, interval[i]);
+        value = SelectMask (0 - (single | first), since[i], value);
+        value = SelectMask (0 - shorten, interval[i] - 1, value);
+        newInterval[i] = value;
+        newTrans[i] = SelectMask (0 - (shorten | single | failed), 1, SelectMask (0 - keep, adjusted, trans[i]));
+        newIndex[i] = (0 - failed) & failedIndex;
+        nextId[i] = currentSuccess[i] + value;
+        push[i] = shorten | keep | single | first | failed;
+      }
+}
+
+void
+SensorTable::EstimateTransmissionIntervals (const std::vector<uint16_t> & aids, uint64_t currentId)
+{
+    uint32_t n = aids.size ();
+    if (n == 0)
+      {
+        return;
+      }
+    EstimateBatch & b = m_batch;
+    b.Resize (n);
+
+    //gather
+    for (uint32_t i = 0; i < n; i++)
+      {
+        uint16_t aid = aids[i];
+        const UpdateInfo & info = m_updateInfo[aid];
+        b.preTrySuccess[i] = info.preTrySuccess;
+        b.success[i] = m_transmissionSuccess[aid] != 0;
+        b.received[i] = m_receivedNum[aid];
+        b.interval[i] = m_transmissionInterval[aid];
+        b.index[i] = m_index[aid];
+        b.transInOneBeacon[i] = m_transInOneBeacon[aid];
+        b.sinceSuccess[i] = currentId - info.preSuccessId;
+        b.currentSuccess[i] = info.CurrentSuccessId;
+      }
+
+    EstimateBatchUpdate (n, &b.preTrySuccess[0], &b.success[0], &b.received[0], &b.interval[0],
+                         &b.index[0], &b.transInOneBeacon[0], &b.sinceSuccess[0], &b.currentSuccess[0],
+                         &b.newInterval[0], &b.newIndex[0], &b.newTransInOneBeacon[0], &b.nextId[0],
+                         &b.push[0]);
+
+    //scatter
+    for (uint32_t i = 0; i < n; i++)
+      {
+        uint16_t aid = aids[i];
+        if (b.preTrySuccess[i] & b.success[i])
+          {
+            m_last2TransmissionInterval[aid] = m_lastTransmissionInterval[aid];
+            m_lastTransmissionInterval[aid] = b.interval[i];
+          }
+        m_transmissionInterval[aid] = b.newInterval[i];
+        m_index[aid] = b.newIndex[i];
+        m_transInOneBeacon[aid] = b.newTransInOneBeacon[i];
+        if (b.push[i])
+          {
+            uint8_t & head = m_transIntervalHead[aid];
+            head = (head == 0) ? TRANS_INTERVAL_LIST_SIZE - 1 : head - 1;
+            m_transIntervalList[aid * TRANS_INTERVAL_LIST_SIZE + head] = b.newInterval[i];
+          }
+        SetNextTransmissionId (aid, b.nextId[i]);
+      }
+}
+
+void
+SensorTable::MoveToBack (uint16_t aid)
+{
+    m_order[aid] = m_nextOrder++;
+}
+
+const std::vector<uint16_t> &
+SensorTable::GetDue (uint64_t currentId)
+{
+    NS_ASSERT (m_trackDue && currentId >= m_lastDueId);
+    LastTransmissionOrder order (m_order);
+
+    //drop the sensors which left, or were rescheduled beyond the next
+    //beacon, since the last call.  Sensors moved to the back since then
+    //(or removed and added again) are gathered at the end.
+    std::vector<uint16_t>::iterator kept = m_due.begin ();
+    for (std::vector<uint16_t>::iterator it = m_due.begin (); it != m_due.end (); it++)
+      {
+        if (m_present[*it] && m_nextTransmissionId[*it] <= currentId + 1)
+          {
+            *kept++ = *it;
+          }
+        else
+          {
+            m_inDue[*it] = 0;
+          }
+      }
+    m_due.erase (kept, m_due.end ());
+    std::vector<uint16_t>::iterator moved = m_due.begin ();
+    m_arrivals.clear ();
+    for (std::vector<uint16_t>::iterator it = m_due.begin (); it != m_due.end (); it++)
+      {
+        if (m_order[*it] < m_orderMark)
+          {
+            *moved++ = *it;
+          }
+        else
+          {
+            m_arrivals.push_back (*it);
+          }
+      }
+    m_due.erase (moved, m_due.end ());
+
+    //add those whose next transmission id has come up; entries which no
+    //longer match the sensor's next transmission id are stale
+    while (!m_calendar.empty () && m_calendar.begin ()->first <= currentId)
+      {
+        std::vector<uint16_t> & bucket = m_calendar.begin ()->second;
+        for (std::vector<uint16_t>::iterator it = bucket.begin (); it != bucket.end (); it++)
+          {
+            uint16_t aid = *it;
+            if (m_present[aid] && !m_inDue[aid] && m_nextTransmissionId[aid] <= currentId)
+              {
+                m_inDue[aid] = 1;
+                m_arrivals.push_back (aid);
+              }
+          }
+        m_calendar.erase (m_calendar.begin ());
+      }
+    if (!m_arrivals.empty ())
+      {
+        std::sort (m_arrivals.begin (), m_arrivals.end (), order);
+        size_t n = m_due.size ();
+        m_due.insert (m_due.end (), m_arrivals.begin (), m_arrivals.end ());
+        std::inplace_merge (m_due.begin (), m_due.begin () + n, m_due.end (), order);
+      }
+
+    m_lastDueId = currentId;
+    m_orderMark = m_nextOrder;
+    m_dueNow.clear ();
+    for (std::vector<uint16_t>::iterator it = m_due.begin (); it != m_due.end (); it++)
+      {
+        if (m_nextTransmissionId[*it] <= currentId)
+          {
+            m_dueNow.push_back (*it);
+          }
+      }
+    return m_dueNow;
 }
 
 //OffloadStation
@@ -204,6 +601,75 @@ OffloadStation::GetFailedTransmissionCount (void) const
 }
 
 //
+RawCtrTrace::RawCtrTrace ()
+{
+}
+
+RawCtrTrace::~RawCtrTrace ()
+{
+    Close ();
+}
+
+void
+RawCtrTrace::Open (std::string filename)
+{
+    Close ();
+    m_file.open (filename.c_str (), std::ios::out | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS (m_file.is_open (), "RawCtrTrace::Open (): unable to open " << filename);
+    m_file << "#beacon\taid\ttype\tscheduled\treceived\ttransInOneBeacon\n";
+    m_buffer.reserve (BUFFER_RECORDS);
+}
+
+void
+RawCtrTrace::Close (void)
+{
+    if (m_file.is_open ())
+      {
+        Flush ();
+        m_file.close ();
+      }
+}
+
+bool
+RawCtrTrace::IsOpen (void) const
+{
+    return m_file.is_open ();
+}
+
+void
+RawCtrTrace::Record (uint64_t beacon, uint16_t aid, enum StationType type, bool scheduled, uint16_t received, uint64_t transInOneBeacon)
+{
+    Entry e;
+    e.beacon = beacon;
+    e.transInOneBeacon = transInOneBeacon;
+    e.aid = aid;
+    e.received = received;
+    e.type = type;
+    e.scheduled = scheduled;
+    m_buffer.push_back (e);
+    if (m_buffer.size () >= BUFFER_RECORDS)
+      {
+        Flush ();
+      }
+}
+
+void
+RawCtrTrace::Flush (void)
+{
+    if (!m_file.is_open ())
+      {
+        m_buffer.clear ();
+        return;
+      }
+    for (std::vector<Entry>::const_iterator it = m_buffer.begin (); it != m_buffer.end (); it++)
+      {
+        m_file << it->beacon << "\t" << it->aid << "\t" << (uint16_t)it->type << "\t"
+               << it->scheduled << "\t" << it->received << "\t" << it->transInOneBeacon << "\n";
+      }
+    m_buffer.clear ();
+    m_file.flush ();
+}
+
 S1gRawCtr::S1gRawCtr ()
 {
    RpsIndex = 0;
@@ -219,7 +685,8 @@ S1gRawCtr::S1gRawCtr ()
     m_beaconOverhead = 0; // us
 
     MaxSlotForSensor = 40; //In order to guarantee channel for offload stations.
-    m_rps = new RPS;
+    m_traceEnabled = true;
+    m_incremental = false;
 
 }
 
@@ -228,100 +695,201 @@ S1gRawCtr::~S1gRawCtr ()
 }
 
 void
-S1gRawCtr::UdpateSensorStaInfo (std::vector<uint16_t> m_sensorlist, std::vector<uint16_t> m_receivedAid, std::string outputpath)
+S1gRawCtr::SetTraceEnabled (bool enable)
 {
-   //initialization
-  //if sorted queue is empty, put all sensor into queue
-  std::string ApNode;
-  std::ofstream outputfile;
-  std::ostringstream APId;
+    m_traceEnabled = enable;
+    if (!enable)
+      {
+        m_trace.Close ();
+      }
+}
 
-  uint16_t numsensor = m_sensorlist.size (); //need to be improved
-  /*if (m_stations.size() < numsensor)
-     {
-      for (uint16_t i = m_stations.size(); i < numsensor; i++)
-        {
-            Sensor * m_sta = new Sensor;
-            m_sta->SetAid (i+1);
-            m_sta->EstimateNextTransmissionId (currentId+1);
-            //NS_LOG_UNCOND ("initial, set next id = " << currentId);
-            //initialize UpdateInfo struct
-            m_sta->SetEverSuccess (false);
-            m_sta->m_snesorUpdatInfo = (UpdateInfo){currentId,currentId,currentId,false,currentId,currentId,currentId,false};
-            //
-            m_stations.push_back (m_sta); // should create a Dispose function?
-            //
-            APId.clear ();
-            APId.str ("");
-            APId << (i+1);
-            ApNode = APId.str();
-            sensorfile = outputpath + ApNode + ".txt";
-            outputfile.open (sensorfile, std::ios::out | std::ios::trunc);
-            outputfile.close();
-            //
-        }
-     } */
+bool
+S1gRawCtr::GetTraceEnabled (void) const
+{
+    return m_traceEnabled;
+}
+
+void
+S1gRawCtr::FlushTrace (void)
+{
+    m_trace.Flush ();
+}
+
+void
+S1gRawCtr::SetIncremental (bool incremental)
+{
+    m_incremental = incremental;
+    if (incremental)
+      {
+        m_stations.EnableDueTracking ();
+        m_pendingState.resize (SensorTable::MAX_AID + 1, PENDING_NONE);
+      }
+}
+
+bool
+S1gRawCtr::GetIncremental (void) const
+{
+    return m_incremental;
+}
+
+void
+S1gRawCtr::NotifyAssociated (uint16_t aid, uint8_t staType)
+{
+    NS_ASSERT (m_incremental && aid <= SensorTable::MAX_AID);
+    if (staType == 2)
+      {
+        if (std::find (m_offloadAids.begin (), m_offloadAids.end (), aid) == m_offloadAids.end ())
+          {
+            m_offloadAids.push_back (aid);
+          }
+        return;
+      }
+    if (staType != 1)
+      {
+        return;
+      }
+    if (m_pendingState[aid] == PENDING_REMOVE)
+      {
+        //still in the table, keeps its state as with the full recompute
+        m_pendingState[aid] = PENDING_NONE;
+        return;
+      }
+    if (m_pendingState[aid] == PENDING_ADD || LookupSensorSta (aid) != nullptr)
+      {
+        return;
+      }
+    m_pendingState[aid] = PENDING_ADD;
+    m_pendingAdd.push_back (aid);
+}
+
+void
+S1gRawCtr::NotifyDisassociated (uint16_t aid)
+{
+    NS_ASSERT (m_incremental && aid <= SensorTable::MAX_AID);
+    if (m_pendingState[aid] == PENDING_ADD)
+      {
+        m_pendingState[aid] = PENDING_NONE;
+        m_pendingAdd.erase (std::find (m_pendingAdd.begin (), m_pendingAdd.end (), aid));
+        return;
+      }
+    if (m_pendingState[aid] == PENDING_NONE && LookupSensorSta (aid) != nullptr)
+      {
+        m_pendingState[aid] = PENDING_REMOVE;
+        m_pendingRemove.push_back (aid);
+      }
+}
+
+void
+S1gRawCtr::NotifyReceived (uint16_t aid)
+{
+    m_pendingReceived.push_back (aid);
+}
+
+void
+S1gRawCtr::AddSensor (uint16_t aid)
+{
+    Sensor * m_sta = m_stations.Add (aid);
+    m_sta->EstimateNextTransmissionId (currentId+1);
+    //initialize UpdateInfo struct
+    m_sta->SetEverSuccess (false);
+    m_sta->GetUpdateInfo () = (UpdateInfo){currentId,currentId,currentId,false,currentId,currentId,currentId,false};
+    if (!m_incremental)
+      {
+        m_lastTransmissionList.push_back (aid);
+      }
+    NS_LOG_DEBUG ("initial, aid = " << aid);
+}
+
+void
+S1gRawCtr::ApplyAssociationChanges (void)
+{
+    for (std::vector<uint16_t>::iterator it = m_pendingAdd.begin (); it != m_pendingAdd.end (); it++)
+      {
+        m_pendingState[*it] = PENDING_NONE;
+        AddSensor (*it);
+      }
+    for (std::vector<uint16_t>::iterator it = m_pendingRemove.begin (); it != m_pendingRemove.end (); it++)
+      {
+        if (m_pendingState[*it] == PENDING_REMOVE)
+          {
+            m_pendingState[*it] = PENDING_NONE;
+            NS_LOG_DEBUG ( "Aid " << *it << " erased from m_stations since disassociated");
+            m_stations.Remove (*it);
+          }
+      }
+    m_pendingAdd.clear ();
+    m_pendingRemove.clear ();
+}
+
+void
+S1gRawCtr::ResetScratch (void)
+{
+    if (m_receivedCount.empty ())
+      {
+        m_receivedCount.resize (SensorTable::MAX_AID + 1, 0);
+        m_aidMark.resize (SensorTable::MAX_AID + 1, 0);
+      }
+    for (std::vector<uint16_t>::iterator it = m_scratchTouched.begin (); it != m_scratchTouched.end (); it++)
+      {
+        m_receivedCount[*it] = 0;
+        m_aidMark[*it] = 0;
+      }
+    m_scratchTouched.clear ();
+}
+
+void
+S1gRawCtr::UdpateSensorStaInfo (std::vector<uint16_t> m_sensorlist, std::vector<uint16_t> m_receivedAid)
+{
+  ResetScratch ();
 
     for (std::vector<uint16_t>::iterator ci = m_sensorlist.begin(); ci != m_sensorlist.end(); ci++)
     {
+        m_aidMark[*ci] = 1;
+        m_scratchTouched.push_back (*ci);
         if (LookupSensorSta (*ci) == nullptr)
         {
-            Sensor * m_sta = new Sensor;
-            m_sta->SetAid (*ci);
-            m_sta->EstimateNextTransmissionId (currentId+1);
-            //NS_LOG_UNCOND ("initial, set next id = " << currentId);
-            //initialize UpdateInfo struct
-            m_sta->SetEverSuccess (false);
-            m_sta->m_snesorUpdatInfo = (UpdateInfo){currentId,currentId,currentId,false,currentId,currentId,currentId,false};
-            for (uint16_t i = 0; i < m_sta->m_transIntervalListSize; i++)
-            {
-                m_sta->m_transIntervalList.push_back(1);
-            }
-            //
-            m_stations.push_back (m_sta); // should create a Dispose function?
-            //
-            APId.clear ();
-            APId.str ("");
-            APId << (*ci);
-            ApNode = APId.str();
-            sensorfile = outputpath + ApNode + ".txt";
-            outputfile.open (sensorfile, std::ios::out | std::ios::app);
-            outputfile.close();
-            //
-            m_lastTransmissionList.push_back (*ci);
-            NS_LOG_UNCOND ("initial, aid = " << *ci);
-
+            AddSensor (*ci);
         }
     }
 
-    bool disassoc;
-    //for (StationsCI it = m_stations.begin(); it != m_stations.end(); it++)
-    StationsCI itcheck = m_stations.begin();
-    for (uint16_t i = 0; i < m_stations.size(); i++)
-
+    //remove disassociated stations, i.e. those no longer in m_sensorlist
+    for (uint32_t i = 0; i < m_stations.GetN (); )
     {
-        disassoc = true;
-        for (std::vector<uint16_t>::iterator ci = m_sensorlist.begin(); ci != m_sensorlist.end(); ci++)
-        {
-            if ((*itcheck)->GetAid ()  == *ci)
-             {
-                 disassoc = false;
-                 if (i < m_stations.size() - 1)
-                     itcheck++;  //avoid itcheck increase to m_sensorlist.end()
-                 break;
-             }
-        }
+        uint16_t aid = m_stations.GetAid (i);
+        if (m_aidMark[aid])
+          {
+            i++;
+            continue;
+          }
+        NS_LOG_DEBUG ( "Aid " << aid << " erased from m_stations since disassociated");
+        m_stations.Remove (aid); //moves the last dense entry to i
+    }
 
-      if (disassoc == true)
-        {
-            NS_LOG_UNCOND ( "Aid " << (*itcheck)->GetAid () << " erased from m_stations since disassociated");
-            m_stations.erase(itcheck);
-        }
+    for (std::vector<uint16_t>::iterator ci = m_sensorlist.begin(); ci != m_sensorlist.end(); ci++)
+    {
+        m_aidMark[*ci] = 0;
     }
 
+    UpdateSensorReceptions (m_receivedAid);
+}
 
+void
+S1gRawCtr::UpdateSensorReceptions (const std::vector<uint16_t> & m_receivedAid)
+{
+    //from here on m_aidMark flags the AIDs allowed to transmit in last beacon
+    for (std::vector<uint16_t>::iterator it = m_aidList.begin(); it != m_aidList.end(); it++)
+    {
+        m_aidMark[*it] = 1;
+        m_scratchTouched.push_back (*it);
+    }
+    for (std::vector<uint16_t>::const_iterator ci = m_receivedAid.begin(); ci != m_receivedAid.end(); ci++)
+    {
+        m_receivedCount[*ci]++;
+        m_scratchTouched.push_back (*ci);
+    }
 
-    NS_LOG_UNCOND ("m_aidList.size() = " << m_aidList.size() << ", m_receivedAid = " << m_receivedAid.size () << ", m_stations.size() = " << m_stations.size() << ", currentId = " << currentId);
+    NS_LOG_DEBUG ("m_aidList.size() = " << m_aidList.size() << ", m_receivedAid = " << m_receivedAid.size () << ", m_stations.size() = " << m_stations.GetN () << ", currentId = " << currentId);
 
     //update transmission interval info, stations allowed to transmit in last beacon
     for (std::vector<uint16_t>::iterator it = m_aidList.begin(); it != m_aidList.end(); it++)
@@ -331,320 +899,180 @@ S1gRawCtr::UdpateSensorStaInfo (std::vector<uint16_t> m_sensorlist, std::vector<
          {
              return;
          }
+        UpdateInfo & info = stationTransmit->GetUpdateInfo ();
 
-         m_receivedsuccess = false;
-         for (std::vector<uint16_t>::iterator ci = m_receivedAid.begin(); ci != m_receivedAid.end(); ci++)
-         {
+        if (m_receivedCount[*it] > 0)
+          {
+            stationTransmit->SetTransmissionSuccess (true);
 
-             if (*ci == *it)
+            if (stationTransmit->GetEverSuccess () == false)
               {
-                //NS_LOG_UNCOND ("stations of aid " << *it << " received");
-                stationTransmit->SetTransmissionSuccess (true);
-                  //output to files.
-                  //write into currentID  coulumn
-                  //write  into allowed to send coulumn
-                  //write  into reaeived to receive coulumn
-                  /* APId.clear ();
-                  APId.str ("");
-                  APId << (*it);
-                  ApNode = APId.str();
-
-                  sensorfile = outputpath + ApNode + ".txt";
-                  outputfile.open (sensorfile, std::ios::out | std::ios::app);
-                  outputfile << currentId << "\t" << "1" << "\t" << "1" << "\n";
-                  outputfile.close(); */
-                  //
-
-                if (stationTransmit->GetEverSuccess () == false)
-                  {
-                      stationTransmit->m_snesorUpdatInfo = (UpdateInfo){currentId-1,currentId-1,currentId-1,false,currentId-1,currentId-1,currentId-1,false};
-                      stationTransmit->SetEverSuccess (true);
-                      /*for (uint16_t i = 0; i < stationTransmit->m_transIntervalListSize; i++)
-                      {
-                          stationTransmit->m_transIntervalList.push_back(1);
-                      }*/
-                      for (std::vector<uint16_t>::iterator ci = stationTransmit->m_transIntervalList.begin(); ci != stationTransmit->m_transIntervalList.end(); ci++)
-                      {
-                          (*ci) = 1;
-                      }
-                  }
-
-                stationTransmit->m_snesorUpdatInfo.lastTryBFpreSuccessId = stationTransmit->m_snesorUpdatInfo.lastTryBFCurrentSuccessId; //update, swith current to pre
+                info = (UpdateInfo){currentId-1,currentId-1,currentId-1,false,currentId-1,currentId-1,currentId-1,false};
+                stationTransmit->SetEverSuccess (true);
+                stationTransmit->ResetTransIntervalList ();
+              }
 
-                stationTransmit->m_snesorUpdatInfo.preSuccessId = stationTransmit->m_snesorUpdatInfo.CurrentSuccessId; //update, swith current to pre
-                stationTransmit->m_snesorUpdatInfo.CurrentSuccessId = currentId;
+            info.lastTryBFpreSuccessId = info.lastTryBFCurrentSuccessId; //update, swith current to pre
 
-                  stationTransmit->m_snesorUpdatInfo.lastTryBFCurrentSuccessId = std::max(stationTransmit->m_snesorUpdatInfo.preSuccessId, stationTransmit->m_snesorUpdatInfo.CurrentUnSuccessId);
+            info.preSuccessId = info.CurrentSuccessId; //update, swith current to pre
+            info.CurrentSuccessId = currentId;
 
-                stationTransmit->m_snesorUpdatInfo.preTrySuccess = stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess;
-                stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess = true;
+            info.lastTryBFCurrentSuccessId = std::max(info.preSuccessId, info.CurrentUnSuccessId);
 
-                goto EstimateInterval;
-              }
-         }
+            info.preTrySuccess = info.CurrentTrySuccess;
+            info.CurrentTrySuccess = true;
+          }
+        else
+          {
+            stationTransmit->SetTransmissionSuccess (false);
 
+            info.preUnsuccessId = info.CurrentUnSuccessId; //update, swith current to pre
+            info.CurrentUnSuccessId = currentId;
+            info.preSuccessId = info.CurrentSuccessId;
 
-            //NS_LOG_UNCOND ("stations of aid " << *it << " not received");
-            stationTransmit->SetTransmissionSuccess (false);
-            //output to files.
-            //write into currentID  coulumn
-            //write  into allowed to send coulumn
-            //write  into received to receive coulumn
-           /* APId.clear ();
-            APId.str ("");
-            APId << (*it);
-            ApNode = APId.str();
-
-            sensorfile = outputpath + ApNode + ".txt";
-            outputfile.open (sensorfile, std::ios::out | std::ios::app);
-            outputfile << currentId << "\t" << "1" << "\t" << "0" << "\n";
-            outputfile.close(); */
-            //
-
-            stationTransmit->m_snesorUpdatInfo.preUnsuccessId = stationTransmit->m_snesorUpdatInfo.CurrentUnSuccessId; //update, swith current to pre
-            stationTransmit->m_snesorUpdatInfo.CurrentUnSuccessId = currentId;
-            stationTransmit->m_snesorUpdatInfo.preSuccessId = stationTransmit->m_snesorUpdatInfo.CurrentSuccessId;
-
-            stationTransmit->m_snesorUpdatInfo.preTrySuccess = stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess;
-            stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess = false;
-
-    EstimateInterval :
-           //stationTransmit->EstimateTransmissionInterval (currentId);
-           //NS_LOG_UNCOND ("... "); //to do, remove it
-         uint16_t add=0;
+            info.preTrySuccess = info.CurrentTrySuccess;
+            info.CurrentTrySuccess = false;
+          }
      }
 
+    m_estimateAids.clear ();
     for (std::vector<uint16_t>::iterator it = m_aidList.begin(); it != m_aidList.end(); it++)
      {
         Sensor * stationTransmit = LookupSensorSta (*it);
         if (stationTransmit == nullptr)
           {
+            m_stations.EstimateTransmissionIntervals (m_estimateAids, currentId);
             return;
           }
 
-        uint16_t m_numReceived = 0;
-        for (std::vector<uint16_t>::iterator ci = m_receivedAid.begin(); ci != m_receivedAid.end(); ci++)
-          {
-            if (*ci == *it)
-             {
-                m_numReceived++;
-             }
-          }
-
-        //NS_LOG_UNCOND ("stations of aid " << *it << " received " << m_numReceived << " packets");
+        uint16_t m_numReceived = m_receivedCount[*it];
 
-         APId.clear ();
-         APId.str ("");
-         APId << (*it);
-         ApNode = APId.str();
-
-         sensorfile = outputpath + ApNode + ".txt";
-         outputfile.open (sensorfile, std::ios::out | std::ios::app);
-         outputfile << currentId << "\t" << "1" << "\t" << m_numReceived << "\t" << stationTransmit->GetTransInOneBeacon () << "\n";
-         outputfile.close();
+         if (m_trace.IsOpen ())
+           {
+             m_trace.Record (currentId, *it, RawCtrTrace::SENSOR, true, m_numReceived, stationTransmit->GetTransInOneBeacon ());
+           }
 
          stationTransmit->SetNumPacketsReceived (m_numReceived);
-         stationTransmit->EstimateTransmissionInterval (currentId, m_beaconInterval);
+         m_estimateAids.push_back (*it);
      }
 
- for (std::vector<uint16_t>::iterator ci = m_receivedAid.begin(); ci != m_receivedAid.end(); ci++)
+    //stations which were not allowed to transmit in last beacon but were received anyway
+ for (std::vector<uint16_t>::const_iterator ci = m_receivedAid.begin(); ci != m_receivedAid.end(); ci++)
     {
-      uint16_t m_numReceived = 0;
-      bool match = false;
-      for (std::vector<uint16_t>::iterator it = m_aidList.begin(); it != m_aidList.end(); it++)
-         {
-             if (*ci == *it)
-              {
-                match = true;
-                break;
-              }
-         }
-
         Sensor * stationTransmit = LookupSensorSta (*ci);
-    if (stationTransmit != nullptr && !match)
+    if (stationTransmit != nullptr && !m_aidMark[*ci])
         {
             m_aidList.push_back (*ci); //trick, avoid same receiveAid repeate several times
+            m_aidMark[*ci] = 1;
+            UpdateInfo & info = stationTransmit->GetUpdateInfo ();
              if (stationTransmit->GetEverSuccess () == false)
              {
-                 stationTransmit->m_snesorUpdatInfo = (UpdateInfo){currentId-1,currentId-1,currentId-1,false,currentId-1,currentId-1,currentId-1,false};
+                 info = (UpdateInfo){currentId-1,currentId-1,currentId-1,false,currentId-1,currentId-1,currentId-1,false};
                  stationTransmit->SetEverSuccess (true);
-                 for (std::vector<uint16_t>::iterator ci = stationTransmit->m_transIntervalList.begin(); ci != stationTransmit->m_transIntervalList.end(); ci++)
-                 {
-                     (*ci) = 1;
-                 }
+                 stationTransmit->ResetTransIntervalList ();
              }
              stationTransmit->SetTransmissionSuccess (true);
 
-             stationTransmit->m_snesorUpdatInfo.lastTryBFpreSuccessId = stationTransmit->m_snesorUpdatInfo.lastTryBFCurrentSuccessId; //update, swith current to pre
+             info.lastTryBFpreSuccessId = info.lastTryBFCurrentSuccessId; //update, swith current to pre
 
-             stationTransmit->m_snesorUpdatInfo.preSuccessId = stationTransmit->m_snesorUpdatInfo.CurrentSuccessId; //update, swith current to pre
-             stationTransmit->m_snesorUpdatInfo.CurrentSuccessId = currentId;
+             info.preSuccessId = info.CurrentSuccessId; //update, swith current to pre
+             info.CurrentSuccessId = currentId;
 
-             stationTransmit->m_snesorUpdatInfo.lastTryBFCurrentSuccessId = std::max(stationTransmit->m_snesorUpdatInfo.preSuccessId, stationTransmit->m_snesorUpdatInfo.CurrentUnSuccessId);
+             info.lastTryBFCurrentSuccessId = std::max(info.preSuccessId, info.CurrentUnSuccessId);
 
-             stationTransmit->m_snesorUpdatInfo.preTrySuccess = stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess;
-             stationTransmit->m_snesorUpdatInfo.CurrentTrySuccess = true;
+             info.preTrySuccess = info.CurrentTrySuccess;
+             info.CurrentTrySuccess = true;
 
-             //NS_LOG_UNCOND ("stations of aid " << *it << " received " << m_numReceived << " packets");
+            uint16_t m_numReceived = m_receivedCount[*ci];
 
-            for (std::vector<uint16_t>::iterator ct = m_receivedAid.begin(); ct != m_receivedAid.end(); ct++)
-            {
-                if (*ci == *ct)
-                {
-                    m_numReceived++;
-                }
-            }
-
-             APId.clear ();
-             APId.str ("");
-             APId << (*ci);
-             ApNode = APId.str();
-
-             sensorfile = outputpath + ApNode + ".txt";
-             outputfile.open (sensorfile, std::ios::out | std::ios::app);
-             outputfile << currentId << "\t" << "0" << "\t" << m_numReceived << "\t" << stationTransmit->GetTransInOneBeacon () << "\n";
-             outputfile.close();
+             if (m_trace.IsOpen ())
+               {
+                 m_trace.Record (currentId, *ci, RawCtrTrace::SENSOR, false, m_numReceived, stationTransmit->GetTransInOneBeacon ());
+               }
 
              stationTransmit->SetNumPacketsReceived (m_numReceived);
-             stationTransmit->EstimateTransmissionInterval (currentId, m_beaconInterval);
+             m_estimateAids.push_back (*ci);
         }
     }
 
+    //the sensors are independent, so their estimates are made in one pass
+    m_stations.EstimateTransmissionIntervals (m_estimateAids, currentId);
 }
 
 void
 Sensor::SetNumPacketsReceived (uint16_t numReceived)
 {
-    m_receivedNum = numReceived;
+    m_table->m_receivedNum[m_aid] = numReceived;
 }
 
 uint16_t
 Sensor::GetNumPacketsReceived (void) const
 {
-    return m_receivedNum;
+    return m_table->m_receivedNum[m_aid];
 }
 
 
 void
 Sensor::EstimateTransmissionInterval (uint64_t currentId, uint64_t m_beaconInterval)
 {
-    if (m_snesorUpdatInfo.preTrySuccess && m_transmissionSuccess)
+    SensorTable * t = m_table;
+    const uint16_t aid = m_aid;
+    UpdateInfo & info = t->m_updateInfo[aid];
+    uint64_t & interval = t->m_transmissionInterval[aid];
+    uint64_t & transInOneBeacon = t->m_transInOneBeacon[aid];
+    uint16_t & index = t->m_index[aid];
+    uint16_t numReceived = t->m_receivedNum[aid];
+    bool success = t->m_transmissionSuccess[aid];
+
+    if (info.preTrySuccess && success)
      {
-         m_index = 0;
-        last2_transmissionInterval = last_transmissionInterval;
-        last_transmissionInterval = m_transmissionInterval;
-        /*
-        if (GetNumPacketsReceived () > 1 && m_transmissionInterval != 1)
-         {
-             m_transmissionIntervalMin = last_transmissionInterval - 1;
-             m_transmissionIntervalMax = last_transmissionInterval - 1;
-         } */
-         //NS_LOG_UNCOND ("aid = " << m_aid << " ,m_transmissionIntervalMin = " << m_transmissionIntervalMin << ", m_transmissionIntervalMin = " << m_transmissionIntervalMax << " , GetNumPacketsReceived = " << GetNumPacketsReceived () << ", m_transmissionInterval = " << m_transmissionInterval);
+        index = 0;
+        t->m_last2TransmissionInterval[aid] = t->m_lastTransmissionInterval[aid];
+        t->m_lastTransmissionInterval[aid] = interval;
 
-         if (GetNumPacketsReceived () > 1 && m_transmissionInterval > 1)
+         if (numReceived > 1 && interval > 1)
            {
-             //m_transmissionIntervalMin = last_transmissionInterval - 1;
-             //m_transmissionIntervalMax = last_transmissionInterval - 1;
-             m_transmissionInterval = m_transmissionInterval - 1;
-             m_transInOneBeacon = 1;
-               uint16_t intervalsum = m_transmissionInterval;
-               /*
-               for (std::vector<uint16_t>::iterator ci = m_transIntervalList.begin(); ci != m_transIntervalList.end(); ci++)
-               {
-                   intervalsum = intervalsum + *ci;
-               }
-
-               m_transmissionInterval = intervalsum/(m_transIntervalListSize + 1); */
-               m_transIntervalList.pop_back ();
-               
-               std::vector<uint16_t>::iterator ci;
-               ci = m_transIntervalList.begin();
-               m_transIntervalList.insert (ci,m_transmissionInterval);
+             interval = interval - 1;
+             transInOneBeacon = 1;
+             PushTransInterval (interval);
            }
-         else if (GetNumPacketsReceived () > 1 && m_transmissionInterval == 1)
+         else if (numReceived > 1 && interval == 1)
           {
-              m_transIntervalList.pop_back ();
-              
-              std::vector<uint16_t>::iterator ci;
-              ci = m_transIntervalList.begin();
-              m_transIntervalList.insert (ci,m_transmissionInterval);
-             if ( GetNumPacketsReceived () > m_transInOneBeacon)
+             PushTransInterval (interval);
+             if (numReceived > transInOneBeacon)
               {
-                  m_transInOneBeacon++;
+                  transInOneBeacon++;
               }
-            else if ( GetNumPacketsReceived () < m_transInOneBeacon)
+            else if (numReceived < transInOneBeacon)
               {
-                  m_transInOneBeacon--;
+                  transInOneBeacon--;
               }
           }
-         else if (GetNumPacketsReceived () == 1)
+         else if (numReceived == 1)
           {
-             m_transInOneBeacon = 1;
-             //m_transmissionIntervalMax = currentId - m_snesorUpdatInfo.preSuccessId;
-              m_transmissionInterval = currentId - m_snesorUpdatInfo.preSuccessId;
-              m_transIntervalList.pop_back ();
-              
-              std::vector<uint16_t>::iterator ci;
-              ci = m_transIntervalList.begin();
-              m_transIntervalList.insert (ci,m_transmissionInterval);
+             transInOneBeacon = 1;
+             interval = currentId - info.preSuccessId;
+             PushTransInterval (interval);
           }
-
-         //NS_LOG_UNCOND ("aid = " << m_aid << " ,m_transmissionIntervalMin = " << m_transmissionIntervalMin << ", m_transmissionIntervalMin = " << m_transmissionIntervalMax << " , GetNumPacketsReceived = " << GetNumPacketsReceived ()<< ", m_transmissionInterval = " << m_transmissionInterval);
      }
-    else if (m_transmissionSuccess == true && m_snesorUpdatInfo.preTrySuccess == false)
+    else if (success == true && info.preTrySuccess == false)
      {
-        //m_transmissionIntervalMin = m_snesorUpdatInfo.CurrentUnSuccessId - m_snesorUpdatInfo.preSuccessId + 1;
-        //necessary to update Min here, in order to update min properly when first packets received.
-        //m_transmissionIntervalMax = currentId - m_snesorUpdatInfo.lastTryBFpreSuccessId - 1;
-         //m_transmissionIntervalMax = currentId - m_snesorUpdatInfo.preSuccessId;
-         m_transmissionInterval = currentId - m_snesorUpdatInfo.preSuccessId;
-         m_index = 0;
-         uint16_t intervalsum = m_transmissionInterval;
-         /*
-         for (std::vector<uint16_t>::iterator ci = m_transIntervalList.begin(); ci != m_transIntervalList.end(); ci++)
-         {
-             intervalsum = intervalsum + *ci;
-             //NS_LOG_UNCOND ("aid = " << GetAid () <<  ",  list = " << *ci);
-         }
-
-         m_transmissionInterval = intervalsum/(m_transIntervalListSize + 1); */
-         m_transIntervalList.pop_back ();
-         
-         std::vector<uint16_t>::iterator ci;
-         ci = m_transIntervalList.begin();
-         m_transIntervalList.insert (ci,m_transmissionInterval);
+        interval = currentId - info.preSuccessId;
+        index = 0;
+        PushTransInterval (interval);
      }
     else
      {
-        //m_transmissionIntervalMin = currentId - m_snesorUpdatInfo.CurrentSuccessId + 1;
-        //m_transmissionIntervalMax remains
-         m_transInOneBeacon = 1;
-
-        m_index++;
-        m_transmissionInterval = currentId - m_snesorUpdatInfo.preSuccessId;
-        m_transmissionInterval = m_transmissionInterval + 2*m_index - 1;
-        m_transIntervalList.pop_back ();
-         
-         std::vector<uint16_t>::iterator ci;
-         ci = m_transIntervalList.begin();
-         m_transIntervalList.insert (ci,m_transmissionInterval);
+        transInOneBeacon = 1;
+
+        index++;
+        interval = currentId - info.preSuccessId;
+        interval = interval + 2*index - 1;
+        PushTransInterval (interval);
      }
-    //NS_LOG_UNCOND ("aid = " << GetAid () <<  ",  m_transmissionInterval = " << m_transmissionInterval << ", m_index = " << m_index << ", m_transIntervalListSize = " << m_transIntervalList.size() << ", m_snesorUpdatInfo.preSuccessId = " << m_snesorUpdatInfo.preSuccessId);
 
-    /*
-    if (m_transmissionIntervalMax < m_transmissionIntervalMin)
-     {
-         //m_transmissionIntervalMax = 2 * m_transmissionIntervalMin;
-         m_transmissionIntervalMax = m_transmissionIntervalMin;
-     }*/
-    //NS_LOG_UNCOND ("aid = " << m_aid << " ,m_transmissionIntervalMin = " << m_transmissionIntervalMin << ", m_transmissionIntervalMax = " << m_transmissionIntervalMax );
-    //m_transmissionInterval = (m_transmissionIntervalMin + m_transmissionIntervalMax)/2;
-    uint64_t m_nextId = m_snesorUpdatInfo.CurrentSuccessId + m_transmissionInterval; ////** AP update info after RAW ends(right before next beacon is sent)
+    uint64_t m_nextId = info.CurrentSuccessId + interval; ////** AP update info after RAW ends(right before next beacon is sent)
     EstimateNextTransmissionId (m_nextId);
-    //NS_LOG_UNCOND (m_snesorUpdatInfo.lastTryBFpreSuccessId << "," << m_snesorUpdatInfo.lastTryBFCurrentSuccessId << ", " << m_snesorUpdatInfo.preSuccessId << ", " << currentId << ", " << m_snesorUpdatInfo.preTrySuccess << ", " << m_snesorUpdatInfo.preUnsuccessId);
-
-    //NS_LOG_UNCOND ("aid = " << GetAid () <<  ",  NextTransmissionId = " << m_nextId << ", currentId = " << currentId);
-
 }
 
 
@@ -654,27 +1082,32 @@ S1gRawCtr::calculateSensorNumWantToSend ()
     m_numSensorWantToSend = 0;
     m_numSendSensorWant = 0;
 
-    NS_LOG_UNCOND ("currentid update ");
+    NS_LOG_DEBUG ("currentid update ");
 
-    for (StationsCI it = m_stations.begin(); it != m_stations.end(); it++)
+    //in incremental mode only the stations due to transmit are visited
+    const std::vector<uint16_t> * due = 0;
+    uint32_t n = m_stations.GetN ();
+    if (m_incremental)
       {
-          //NS_LOG_UNCOND ("aid " << (*it)->GetAid () <<  "," << (*it)->GetEstimateNextTransmissionId () << ", " <<currentId);
-          //NS_ASSERT ((*it)->GetEstimateNextTransmissionId () >= currentId);
-        if ((*it)->GetEstimateNextTransmissionId () <= currentId)
+        due = &m_stations.GetDue (currentId);
+        n = due->size ();
+      }
+    for (uint32_t i = 0; i < n; i++)
+      {
+        Sensor * sta = m_stations.Lookup (due ? (*due)[i] : m_stations.GetAid (i));
+        if (sta->GetEstimateNextTransmissionId () <= currentId)
           {
-              //NS_LOG_UNCOND ("Sensor = " << (*it)->GetAid () << ", want to send  = " << (*it)->GetTransInOneBeacon ());
-
             m_numSensorWantToSend++;
-            if ((*it)->GetTransInOneBeacon () > (m_beaconInterval-m_beaconOverhead)/m_rawslotDuration - 1)
+            if (sta->GetTransInOneBeacon () > (m_beaconInterval-m_beaconOverhead)/m_rawslotDuration - 1)
               {
-                  (*it)->SetTransInOneBeacon ((m_beaconInterval-m_beaconOverhead)/m_rawslotDuration - 1);
+                  sta->SetTransInOneBeacon ((m_beaconInterval-m_beaconOverhead)/m_rawslotDuration - 1);
                   //limit TransInOneBeacon, prevent channel used only by one sensor
               }
-            m_numSendSensorWant = m_numSendSensorWant + (*it)->GetTransInOneBeacon ();
+            m_numSendSensorWant = m_numSendSensorWant + sta->GetTransInOneBeacon ();
           }
       }
 
-     NS_LOG_UNCOND ("m_numSensorWantToSend = " << m_numSensorWantToSend << ", m_numSendSensorWant = " << m_numSendSensorWant);
+     NS_LOG_DEBUG ("m_numSensorWantToSend = " << m_numSensorWantToSend << ", m_numSendSensorWant = " << m_numSendSensorWant);
 }
 
 void
@@ -725,6 +1158,39 @@ S1gRawCtr::SetSensorAllowedToSend ()
 }*/
 
 
+bool
+S1gRawCtr::ChooseSensor (Sensor * stationTransmit, uint32_t & SendNum)
+{
+   bool send = false;
+   if (stationTransmit->GetEstimateNextTransmissionId () <= currentId)
+    {
+       if (SendNum == m_numSendSensorAllowed)
+         {
+            stationTransmit->EstimateNextTransmissionId (currentId+1);
+            //Postpone transmission to next interval
+         }
+       else if ( SendNum + stationTransmit->GetTransInOneBeacon () > m_numSendSensorAllowed)
+        {
+            stationTransmit->EstimateNextTransmissionId (currentId+1);
+            //Postpone transmission to next interval
+
+            uint8_t numleft = m_numSendSensorAllowed - SendNum;
+            if (numleft > 0)
+             {
+                 stationTransmit->SetTransInOneBeacon (numleft);
+                 SendNum = SendNum + numleft;
+                 send = true;
+             }
+        }
+       else
+        {
+           SendNum = SendNum + stationTransmit->GetTransInOneBeacon ();
+           send = true;
+        }
+    }
+   return send;
+}
+
  void
  S1gRawCtr::SetSensorAllowedToSend ()
  {
@@ -733,101 +1199,60 @@ S1gRawCtr::SetSensorAllowedToSend ()
 
    m_numSendSensorAllowed  =  std::min(m_numSendSensorWant, numAllowed); //replace m_numSensorAllowedToSend with m_numSendSensorAllowed
    m_numSendSensorAllowed =  std::min(m_numSendSensorAllowed, MaxSlotForSensor);
-   //m_numSensorAllowedToSend =  std::min(m_numSensorWantToSend, numAllowed);
-   NS_LOG_UNCOND ("-------------------------------------------start");
-   NS_LOG_UNCOND ("m_numSendSensorWant = " << m_numSendSensorWant << ", numAllowed based on faireness = " << numAllowed);
+   NS_LOG_DEBUG ("m_numSendSensorWant = " << m_numSendSensorWant << ", numAllowed based on faireness = " << numAllowed);
 
    uint32_t SendNum = 0;
-     
-   std::vector<uint16_t>::iterator it = m_lastTransmissionList.begin();
-   //for (std::vector<uint16_t>::iterator it = m_lastTransmissionList.begin(); it != m_lastTransmissionList.end(); it++)
-    for (uint16_t i = 0; i < m_lastTransmissionList.size (); i++)
+
+   if (m_incremental)
      {
-         Sensor * stationTransmit;
-         if (LookupSensorSta (*it) == nullptr) //disassociated station
-           {
-             m_lastTransmissionList.erase (it);
-             it++;
-             continue;
-           }
-         stationTransmit = LookupSensorSta (*it);
-         it++;
-       if (stationTransmit->GetEstimateNextTransmissionId () <= currentId)
-        {
-           if (SendNum == m_numSendSensorAllowed)
+       //same order as m_lastTransmissionList, restricted to the stations due
+       const std::vector<uint16_t> & due = m_stations.GetDue (currentId);
+       for (std::vector<uint16_t>::const_iterator it = due.begin (); it != due.end (); it++)
+         {
+           if (ChooseSensor (LookupSensorSta (*it), SendNum))
              {
-                stationTransmit->EstimateNextTransmissionId (currentId+1);
-                //Postpone transmission to next interval
-                //NS_LOG_UNCOND ("aid = " << stationTransmit->GetAid () << " not allwed to send, since its full ");
-                //NS_LOG_UNCOND ("update NextTransmissionId to = " << currentId+1);
+               m_aidList.push_back (*it);
+               m_stations.MoveToBack (*it);
              }
-           else if ( SendNum + stationTransmit->GetTransInOneBeacon () > m_numSendSensorAllowed)
-            {
-                stationTransmit->EstimateNextTransmissionId (currentId+1);
-                //Postpone transmission to next interval
-                //NS_LOG_UNCOND ("aid = " << stationTransmit->GetAid () << " not allwed to send, since transmit number is " << stationTransmit->GetTransInOneBeacon () );
-                //NS_LOG_UNCOND ("update NextTransmissionId to = " << currentId+1);
-
-                uint8_t numleft = m_numSendSensorAllowed - SendNum;
-                if (numleft > 0)
-                 {
-                     it--;
-                     stationTransmit->SetTransInOneBeacon (numleft);
-                     m_aidList.push_back(stationTransmit->GetAid ());
-                     std::vector<uint16_t>::iterator position = LookupLastTransmission (stationTransmit->GetAid ());
-                     m_lastTransmissionList.erase (position);
-                     m_lastTransmissionList.push_back (stationTransmit->GetAid ());
-                     SendNum = SendNum + numleft;
-                     //NS_LOG_UNCOND ("reset Trans number to = " << numleft << " to send");
-                 }
-            }
-           else
-            {
-               it--;
-               m_aidList.push_back(stationTransmit->GetAid ());
-               std::vector<uint16_t>::iterator position = LookupLastTransmission (stationTransmit->GetAid ());
-               m_lastTransmissionList.erase (position);
-               m_lastTransmissionList.push_back (stationTransmit->GetAid ());
-               SendNum = SendNum + stationTransmit->GetTransInOneBeacon ();
-               //NS_LOG_UNCOND ("aid = " << stationTransmit->GetAid () << " allowed to send");
+         }
+       m_numSendSensorAllowed = SendNum;
+       NS_LOG_DEBUG ("m_numSendSensorAllowed = " << m_numSendSensorAllowed );
+       return;
+     }
 
-            }
-         ////put first send stations to m_aidList, choose stations based on last transmission time.
-        }
+   //m_lastTransmissionList is ordered by last transmission, least recent first.
+   //Stations chosen in this beacon are moved to the back in the order chosen,
+   //disassociated stations are dropped.
+   std::vector<uint16_t> chosen;
+   std::vector<uint16_t>::iterator kept = m_lastTransmissionList.begin ();
+   for (std::vector<uint16_t>::iterator it = m_lastTransmissionList.begin (); it != m_lastTransmissionList.end (); it++)
+     {
+       Sensor * stationTransmit = LookupSensorSta (*it);
+       if (stationTransmit == nullptr) //disassociated station
+         {
+           continue;
+         }
+       if (ChooseSensor (stationTransmit, SendNum))
+         {
+           m_aidList.push_back (*it);
+           chosen.push_back (*it);
+         }
+       else
+         {
+           *kept++ = *it;
+         }
     }
+   m_lastTransmissionList.erase (kept, m_lastTransmissionList.end ());
+   m_lastTransmissionList.insert (m_lastTransmissionList.end (), chosen.begin (), chosen.end ());
 
     m_numSendSensorAllowed = SendNum;
-    NS_LOG_UNCOND ("m_numSendSensorAllowed = " << m_numSendSensorAllowed );
+    NS_LOG_DEBUG ("m_numSendSensorAllowed = " << m_numSendSensorAllowed );
 
  }
 
-std::vector<uint16_t>::iterator
-S1gRawCtr::LookupLastTransmission (uint16_t aid)
-{
-
-    for (std::vector<uint16_t>::iterator it = m_lastTransmissionList.begin(); it != m_lastTransmissionList.end(); it++)
-    {
-       // NS_LOG_UNCOND ("m_lastTransmissionList = " << *it);
-    }
-
-  for (std::vector<uint16_t>::iterator it = m_lastTransmissionList.begin(); it != m_lastTransmissionList.end(); it++)
-    {
-        if (aid == *it)
-        {
-            return it;
-        }
-    }
-
-  NS_ASSERT ("ERROR OCUURS");
-}
-
-
-
-
-
 //offload
 void
-S1gRawCtr::UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vector<uint16_t> m_receivedAid, std::string outputpath)
+S1gRawCtr::UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vector<uint16_t> m_receivedAid)
 //to do
 //need to change Ap-wifi-mac.cc to get numsensor info
 //need to get successful transmission info.
@@ -853,11 +1278,6 @@ S1gRawCtr::UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vecto
     } should be removed*/
 
 
-    std::string ApNode;
-    std::ofstream outputfile;
-    std::ostringstream APId;
-
-
     for (std::vector<uint16_t>::iterator ci = m_OffloadList.begin(); ci != m_OffloadList.end(); ci++)
      {
         if (LookupOffloadSta (*ci) == nullptr)
@@ -867,15 +1287,12 @@ S1gRawCtr::UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vecto
               m_offloadSta->SetOffloadStaActive (true);
               m_offloadSta->IncreaseFailedTransmissionCount (0);
               m_offloadStations.push_back (m_offloadSta); // should create a Dispose function?
-              NS_LOG_UNCOND ("m_offloadStations.size () = " << m_offloadStations.size ());
-
-              APId.clear ();
-              APId.str ("");
-              APId << (*ci);
-              ApNode = APId.str();
-              sensorfile = outputpath + ApNode + ".txt";
-              outputfile.open (sensorfile, std::ios::out | std::ios::trunc);
-              outputfile.close();
+              if (m_offloadByAid.size () <= *ci)
+                {
+                  m_offloadByAid.resize (*ci + 1, 0);
+                }
+              m_offloadByAid[*ci] = m_offloadSta;
+              NS_LOG_DEBUG ("m_offloadStations.size () = " << m_offloadStations.size ());
           }
      }
 
@@ -889,33 +1306,21 @@ S1gRawCtr::UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vecto
             if (*ci == *it)
             {
                 //NS_LOG_UNCOND ("stations of aid " << *it << " received, " << *ci);
-                //output to files.
-                APId.clear ();
-                APId.str ("");
-                APId << (*it);
-                ApNode = APId.str();
-                sensorfile = outputpath + ApNode + ".txt";
-                outputfile.open (sensorfile, std::ios::out | std::ios::app);
-                outputfile << currentId << "\t" << "1" << "\t" << "1" << "\n";
-                outputfile.close();
-                //
+                if (m_trace.IsOpen ())
+                  {
+                    m_trace.Record (currentId, *it, RawCtrTrace::OFFLOAD, true, 1, 0);
+                  }
                 OffloadStaTransmit->SetTransmissionSuccess (true);
                 OffloadStaTransmit->IncreaseFailedTransmissionCount (1);
                 goto FailedMax;
             }
         }
 
-        //output to files.
         //NS_LOG_UNCOND ("stations of aid " << *it << " not received");
-        APId.clear ();
-        APId.str ("");
-        APId << (*it);
-        ApNode = APId.str();
-        sensorfile = outputpath + ApNode + ".txt";
-        outputfile.open (sensorfile, std::ios::out | std::ios::app);
-        outputfile << currentId << "\t" << "1" << "\t" << "0" << "\n";
-        outputfile.close();
-        //
+        if (m_trace.IsOpen ())
+          {
+            m_trace.Record (currentId, *it, RawCtrTrace::OFFLOAD, true, 0, 0);
+          }
 
         OffloadStaTransmit->SetTransmissionSuccess (false);
         OffloadStaTransmit->IncreaseFailedTransmissionCount (0);
@@ -949,6 +1354,9 @@ S1gRawCtr::SetOffloadAllowedToSend ()
       {
          numAllowed = 1;
       }
+    //the RAWs of the sensors and of the offload stations share one RPS
+    uint16_t rawsLeft = RPS::MAX_RAW_ASSIGNMENTS - std::min<uint16_t> (m_aidList.size (), RPS::MAX_RAW_ASSIGNMENTS);
+    numAllowed = std::min (numAllowed, rawsLeft);
     m_numOffloadAllowedToSend =  std::min(m_numOffloadStaActive, numAllowed);
     if (m_numOffloadAllowedToSend == 0)
       {
@@ -961,7 +1369,7 @@ S1gRawCtr::SetOffloadAllowedToSend ()
         m_offloadRawslotDuration = ((m_beaconInterval-m_beaconOverhead) - m_numSendSensorAllowed * m_rawslotDuration)/m_numOffloadAllowedToSend;
       }
     //m_numOffloadAllowedToSend = 1; //for test
-    NS_LOG_UNCOND ("SetOffloadAllowedToSend ()= " << m_numOffloadAllowedToSend);
+    NS_LOG_DEBUG ("SetOffloadAllowedToSend ()= " << m_numOffloadAllowedToSend);
 
     for (OffloadStationsCI it = m_offloadStations.begin(); it != m_offloadStations.end(); it++)
     {
@@ -977,19 +1385,20 @@ S1gRawCtr::SetOffloadAllowedToSend ()
 RPS
 S1gRawCtr::GetRPS ()
 {
- if (RpsIndex < rpslist.rpsset.size())
+  uint16_t index;
+  if (RpsIndex < rpslist.rpsset.size())
     {
-        m_rps = rpslist.rpsset.at(RpsIndex);
+        index = RpsIndex;
         NS_LOG_DEBUG ("< RpsIndex =" << RpsIndex);
         RpsIndex++;
     }
   else
     {
-        m_rps = rpslist.rpsset.at(0);
+        index = 0;
         NS_LOG_DEBUG ("RpsIndex =" << RpsIndex);
         RpsIndex = 1;
     }
-  return *m_rps;
+  return rpslist.rpsset.at(index);
 }
 
 // Beacon duration), before that use NGroup=1 and initialize by ap-wifi-mac
@@ -1000,10 +1409,38 @@ S1gRawCtr::UpdateRAWGroupping (std::vector<uint16_t> m_sensorlist, std::vector<u
      
      m_beaconInterval = BeaconInterval;
      //currentId++; //beaconInterval counter
+     if (m_traceEnabled && !m_trace.IsOpen ())
+       {
+         m_trace.Open (outputpath + "rawctr.txt");
+       }
      //work here
-     UdpateSensorStaInfo (m_sensorlist,  m_receivedAid, outputpath);
-     UdpateOffloadStaInfo (m_OffloadList, m_receivedAid, outputpath);
+     UdpateSensorStaInfo (m_sensorlist,  m_receivedAid);
+     UdpateOffloadStaInfo (m_OffloadList, m_receivedAid);
      //NS_LOG_UNCOND ("S1gRawCtr::UpdateRAWGrouppingaa =");
+     return FinishRAWGroupping ();
+}
+
+RPS
+S1gRawCtr::UpdateRAWGroupping (uint64_t BeaconInterval, std::string outputpath)
+{
+     NS_ASSERT (m_incremental);
+
+     m_beaconInterval = BeaconInterval;
+     if (m_traceEnabled && !m_trace.IsOpen ())
+       {
+         m_trace.Open (outputpath + "rawctr.txt");
+       }
+     ResetScratch ();
+     ApplyAssociationChanges ();
+     UpdateSensorReceptions (m_pendingReceived);
+     UdpateOffloadStaInfo (m_offloadAids, m_pendingReceived);
+     m_pendingReceived.clear ();
+     return FinishRAWGroupping ();
+}
+
+RPS
+S1gRawCtr::FinishRAWGroupping (void)
+{
      currentId++; //next id, actually
      calculateSensorNumWantToSend ();
      calculateActiveOffloadSta ();
@@ -1017,16 +1454,8 @@ S1gRawCtr::UpdateRAWGroupping (std::vector<uint16_t> m_sensorlist, std::vector<u
      SetOffloadAllowedToSend ();
 
      //NS_LOG_UNCOND ("S1gRawCtr::UpdateRAWGrouppingcc =");
-     m_rps = new RPS;
      configureRAW ();
-     RPS m_rpsAP =  GetRPS ();
-     return m_rpsAP;
-}
-
-void
-S1gRawCtr::deleteRps ()
-{
-    delete m_rps;
+     return GetRPS ();
 }
 
     /*
@@ -1094,30 +1523,29 @@ S1gRawCtr::configureRAW ( )
     uint32_t aid_end = 0;
     uint32_t rawinfo;
 
-    //Release storage.
-    rpslist.rpsset.clear();
-
     //uint16_t NGroups = m_aidList.size () + m_aidOffloadList.size();
     uint16_t NGroups = m_numSendSensorAllowed + m_aidOffloadList.size();
 
     if (NGroups == 0)
       {
+        //Release storage.
+        rpslist.rpsset.clear();
+        m_rps = RPS ();
         SlotDurationCount = m_slotDurationCount;
-        RPS::RawAssignment *m_raw = new RPS::RawAssignment;
+        RPS::RawAssignment m_raw;
 
-        m_raw->SetRawControl (RawControl);
-        m_raw->SetSlotCrossBoundary (SlotCrossBoundary);
-        m_raw->SetSlotFormat (SlotFormat);
-        m_raw->SetSlotDurationCount (SlotDurationCount);
-        m_raw->SetSlotNum (SlotNum);
+        m_raw.SetRawControl (RawControl);
+        m_raw.SetSlotCrossBoundary (SlotCrossBoundary);
+        m_raw.SetSlotFormat (SlotFormat);
+        m_raw.SetSlotDurationCount (SlotDurationCount);
+        m_raw.SetSlotNum (SlotNum);
 
         aid_start = 1;
         aid_end = 1;
         rawinfo = (aid_end << 13) | (aid_start << 2) | page;
-        m_raw->SetRawGroup (rawinfo);
+        m_raw.SetRawGroup (rawinfo);
 
-        m_rps->SetRawAssignment(*m_raw);
-        delete m_raw;
+        m_rps.SetRawAssignment(m_raw);
         rpslist.rpsset.push_back (m_rps);
         return;
       }
@@ -1129,43 +1557,46 @@ S1gRawCtr::configureRAW ( )
     //NS_LOG_UNCOND ("m_aidList =" << m_aidList.size () << ", m_aidOffloadList=" << m_aidOffloadList.size ());
     
     m_beaconOverhead = ((m_aidList.size () * 6 + 60) * 8 + 14 )/12 * 40 + 560;
-    NS_LOG_UNCOND ("m_beaconOverhead = " << m_beaconOverhead);
+    NS_LOG_DEBUG ("m_beaconOverhead = " << m_beaconOverhead);
 
+    if (m_incremental && PatchRps ())
+      {
+        return;
+      }
+
+    //Release storage.
+    rpslist.rpsset.clear();
+    m_rps = RPS ();
     
     for (std::vector<uint16_t>::iterator it = m_aidList.begin(); it != m_aidList.end(); it++)
       {
 
-          RPS::RawAssignment *m_raw = new RPS::RawAssignment;
+          RPS::RawAssignment m_raw;
           Sensor * stationTransmit = LookupSensorSta (*it);
           uint16_t num = stationTransmit->GetTransInOneBeacon ();
-          //SlotDurationCount = (num * m_rawslotDuration - 500)/120;
-          uint64_t revisedslotduration = std::ceil(num * (m_beaconInterval-m_beaconOverhead) * 1.0 / m_numSendSensorAllowed);
-          SlotDurationCount = std::ceil((revisedslotduration - 500.0)/120.0);
-
-          NS_ASSERT (SlotDurationCount <= 2037);
+          SlotDurationCount = GetSensorSlotDurationCount (num);
 
 
-          m_raw->SetRawControl (RawControl);//support paged STA or not
-          m_raw->SetSlotCrossBoundary (SlotCrossBoundary);
-          m_raw->SetSlotFormat (SlotFormat);
-          m_raw->SetSlotDurationCount (SlotDurationCount);//to change
-          //m_raw->SetSlotDurationCount (725);//to change
+          m_raw.SetRawControl (RawControl);//support paged STA or not
+          m_raw.SetSlotCrossBoundary (SlotCrossBoundary);
+          m_raw.SetSlotFormat (SlotFormat);
+          m_raw.SetSlotDurationCount (SlotDurationCount);//to change
+          //m_raw.SetSlotDurationCount (725);//to change
 
 
-          m_raw->SetSlotNum (SlotNum);
+          m_raw.SetSlotNum (SlotNum);
 
 
           aid_start = *it;
           aid_end = *it;
           //aid_start = 2;
           //aid_end = 66;
-          NS_LOG_UNCOND ("sensor, aid_start =" << aid_start << ", aid_end=" << aid_end << ", SlotDurationCount = " << SlotDurationCount << ", transmit num one beacon = " << num);
+          NS_LOG_DEBUG ("sensor, aid_start =" << aid_start << ", aid_end=" << aid_end << ", SlotDurationCount = " << SlotDurationCount << ", transmit num one beacon = " << num);
 
           rawinfo = (aid_end << 13) | (aid_start << 2) | page;
-          m_raw->SetRawGroup (rawinfo);
+          m_raw.SetRawGroup (rawinfo);
 
-          m_rps->SetRawAssignment(*m_raw);
-          delete m_raw;
+          m_rps.SetRawAssignment(m_raw);
       }
     
     //set remaining channel to another raw
@@ -1193,31 +1624,30 @@ S1gRawCtr::configureRAW ( )
 
 
 
-    uint64_t offloadcount = (m_offloadRawslotDuration - 500)/120;
+    uint16_t offloadcount = GetOffloadSlotDurationCount ();
     //printf("offloadcount is %u\n",  offloadcount);
     //NS_LOG_UNCOND ("m_offloadRawslotDuration = " << m_offloadRawslotDuration << ", offloadcount =" << offloadcount );
 
     for (std::vector<uint16_t>::iterator it = m_aidOffloadList.begin(); it != m_aidOffloadList.end(); it++)
      {
-        RPS::RawAssignment *m_raw2 = new RPS::RawAssignment;
+        RPS::RawAssignment m_raw2;
 
-        m_raw2->SetRawControl (RawControl);//support paged STA or not
-        m_raw2->SetSlotCrossBoundary (SlotCrossBoundary);
-        m_raw2->SetSlotFormat (SlotFormat);
-        m_raw2->SetSlotDurationCount (offloadcount); //to change
-         //m_raw2->SetSlotDurationCount (99); //to change
-        m_raw2->SetSlotNum (SlotNum);
+        m_raw2.SetRawControl (RawControl);//support paged STA or not
+        m_raw2.SetSlotCrossBoundary (SlotCrossBoundary);
+        m_raw2.SetSlotFormat (SlotFormat);
+        m_raw2.SetSlotDurationCount (offloadcount); //to change
+         //m_raw2.SetSlotDurationCount (99); //to change
+        m_raw2.SetSlotNum (SlotNum);
 
         aid_start = *it;
         aid_end = *it;
          //aid_start = 1;
          //aid_end = 1;
         rawinfo = (aid_end << 13) | (aid_start << 2) | page;
-        NS_LOG_UNCOND ("offload, aid_start =" << aid_start << ", aid_end=" << aid_end << ", offloadcount =" << offloadcount);
+        NS_LOG_DEBUG ("offload, aid_start =" << aid_start << ", aid_end=" << aid_end << ", offloadcount =" << offloadcount);
 
-        m_raw2->SetRawGroup (rawinfo);
-        m_rps->SetRawAssignment(*m_raw2);
-        delete m_raw2;
+        m_raw2.SetRawGroup (rawinfo);
+        m_rps.SetRawAssignment(m_raw2);
      }
 
 
@@ -1227,32 +1657,78 @@ S1gRawCtr::configureRAW ( )
     //delete m_rps;
 }
 
-//what if lookup fails, is it possibile?
+bool
+S1gRawCtr::PatchRps (void)
+{
+    //the RPS of the last beacon fits if it schedules the same stations in
+    //the same order: the other fields of its RAWs do not change
+    if (rpslist.rpsset.size () != 1
+        || m_rps.GetNRawAssignments () != m_aidList.size () + m_aidOffloadList.size ())
+      {
+        return false;
+      }
+    RPS::Iterator raw = m_rps.Begin ();
+    for (std::vector<uint16_t>::const_iterator it = m_aidList.begin (); it != m_aidList.end (); ++it, ++raw)
+      {
+        if ((*raw).GetRawStartAid () != *it)
+          {
+            return false;
+          }
+      }
+    for (std::vector<uint16_t>::const_iterator it = m_aidOffloadList.begin (); it != m_aidOffloadList.end (); ++it, ++raw)
+      {
+        if ((*raw).GetRawStartAid () != *it)
+          {
+            return false;
+          }
+      }
+
+    //the slot durations follow the number of sensors and the beacon overhead
+    uint8_t index = 0;
+    for (std::vector<uint16_t>::const_iterator it = m_aidList.begin (); it != m_aidList.end (); ++it)
+      {
+        m_rps.SetSlotDurationCount (index++, GetSensorSlotDurationCount (LookupSensorSta (*it)->GetTransInOneBeacon ()));
+      }
+    uint16_t offloadcount = GetOffloadSlotDurationCount ();
+    for (std::vector<uint16_t>::const_iterator it = m_aidOffloadList.begin (); it != m_aidOffloadList.end (); ++it)
+      {
+        m_rps.SetSlotDurationCount (index++, offloadcount);
+      }
+    rpslist.rpsset.front () = m_rps;
+    return true;
+}
+
+uint16_t
+S1gRawCtr::GetSensorSlotDurationCount (uint16_t num) const
+{
+    //SlotDurationCount = (num * m_rawslotDuration - 500)/120;
+    uint64_t revisedslotduration = std::ceil(num * (m_beaconInterval-m_beaconOverhead) * 1.0 / m_numSendSensorAllowed);
+    uint16_t SlotDurationCount = std::ceil((revisedslotduration - 500.0)/120.0);
+
+    NS_ASSERT (SlotDurationCount <= 2037);
+    return SlotDurationCount;
+}
+
+uint16_t
+S1gRawCtr::GetOffloadSlotDurationCount (void) const
+{
+    return (m_offloadRawslotDuration - 500)/120;
+}
+
 Sensor *
 S1gRawCtr::LookupSensorSta (uint16_t aid)
 {
-   for (StationsCI it = m_stations.begin(); it != m_stations.end(); it++)
-   {
-       if (aid == (*it)->GetAid ())
-        {
-           return (*it);
-        }
-   }
-    return nullptr;
+    return m_stations.Lookup (aid);
 }
 
-//what if lookup fails, is it possibile?
 OffloadStation *
 S1gRawCtr::LookupOffloadSta (uint16_t aid)
 {
-    for (OffloadStationsCI it = m_offloadStations.begin(); it != m_offloadStations.end(); it++)
-    {
-        if (aid == (*it)->GetAid ())
-        {
-            return (*it);
-        }
-    }
-    return nullptr;
+    if (aid >= m_offloadByAid.size ())
+      {
+        return nullptr;
+      }
+    return m_offloadByAid[aid];
 }
 
 void
@@ -29,6 +29,9 @@
 #include "supported-rates.h"
 #include "ns3/random-variable-stream.h"
 #include "rps.h"
+#include <vector>
+#include <map>
+#include <fstream>
 
 namespace ns3 {
     
@@ -56,10 +59,18 @@ struct UpdateInfo
                       CurrentTrySuccess(good){}*/
     };
     
+class SensorTable;
+
+/**
+ * Handle on the per-sensor state kept by the RAW controller.  The state
+ * itself lives in the AID-indexed columns of a SensorTable, so a Sensor is
+ * only a (table, aid) pair and is cheap to look up.
+ */
 class Sensor
 {
 public:
     Sensor ();
+    Sensor (SensorTable * table, uint16_t aid);
     virtual ~Sensor ();
     
     void SetAid (uint16_t aid); //to indify station
@@ -88,32 +99,144 @@ public:
     uint16_t GetTransInOneBeacon (void) const;
     void SetTransInOneBeacon (uint16_t num);
 
+    UpdateInfo & GetUpdateInfo (void);
+    void ResetTransIntervalList (void);
+    void PushTransInterval (uint16_t interval);
+    uint16_t GetTransInterval (uint16_t index) const;
 
-    std::vector<uint16_t> m_transIntervalList;
-    uint16_t m_transIntervalListSize;
-    
-    UpdateInfo m_snesorUpdatInfo;
-    
 private:
-    uint64_t m_transmissionInterval; // beacon as unit
-    uint64_t m_transInOneBeacon; // beacon as unit
-
-    uint64_t last_transmissionInterval;
-    uint64_t m_nextTransmissionId; // beacon as unit
-    uint16_t m_packetSize;
-    uint16_t m_dataRate;
-    uint8_t  m_staType;
+    SensorTable * m_table;
     uint16_t m_aid;
-    bool m_transmissionSuccess;
-    uint64_t m_transmissionIntervalMin;
-    uint64_t m_transmissionIntervalMax;
-    
-    uint16_t m_receivedNum;
-    uint64_t last2_transmissionInterval;
-    
-    uint16_t m_index;
-    
-    bool m_everSuccess;
+};
+
+/**
+ * Dense, AID-indexed storage for the sensors known by the RAW controller.
+ *
+ * Every per-sensor quantity is kept in its own column indexed by AID
+ * (structure of arrays), so lookups are O(1) and the per-beacon passes
+ * walk contiguous memory.  Columns grow to the largest AID seen.  The
+ * associated AIDs are also kept in a dense list for iteration.
+ */
+class SensorTable
+{
+public:
+    static const uint16_t MAX_AID = 8191;
+    static const uint16_t TRANS_INTERVAL_LIST_SIZE = 5;
+
+    SensorTable ();
+    ~SensorTable ();
+
+    /**
+     * \param aid the AID of the sensor to add
+     * \return the handle of the newly added sensor, or the existing one
+     */
+    Sensor * Add (uint16_t aid);
+    void Remove (uint16_t aid);
+    /**
+     * \param aid the AID of the sensor
+     * \return the handle of the sensor, or 0 if the AID is not in the table
+     */
+    Sensor * Lookup (uint16_t aid) const;
+    uint32_t GetN (void) const;
+    /**
+     * \param i index in [0, GetN ())
+     * \return the AID stored at dense index i; the order is unspecified
+     */
+    uint16_t GetAid (uint32_t i) const;
+
+    /**
+     * Keep a calendar of next transmission ids so that GetDue () does not
+     * have to scan the whole table.  Off by default.
+     */
+    void EnableDueTracking (void);
+    void SetNextTransmissionId (uint16_t aid, uint64_t id);
+    /**
+     * Sensors are kept in order of last transmission, least recent first,
+     * newly added ones last.  Move a sensor to the back of that order.
+     */
+    void MoveToBack (uint16_t aid);
+    /**
+     * Requires due tracking.  currentId must not decrease between calls.
+     *
+     * \param currentId the id of the current beacon interval
+     * \return the AIDs whose next transmission id is <= currentId, in
+     *         order of last transmission
+     */
+    const std::vector<uint16_t> & GetDue (uint64_t currentId);
+    /**
+     * Same results as Sensor::EstimateTransmissionInterval called on each
+     * sensor of aids in turn.  The state of the sensors is gathered into
+     * contiguous batch arrays, updated in one branch-free pass which the
+     * compiler can vectorize, and scattered back.
+     *
+     * \param aids the sensors to update, each AID at most once
+     * \param currentId the id of the current beacon interval
+     */
+    void EstimateTransmissionIntervals (const std::vector<uint16_t> & aids, uint64_t currentId);
+
+private:
+    friend class Sensor;
+
+    /**
+     * Inputs and results of EstimateTransmissionIntervals, one entry per
+     * sensor of the batch.  All the columns are 64 bits wide so that the
+     * update works on vectors of a single width.
+     */
+    struct EstimateBatch
+    {
+        void Resize (uint32_t n);
+
+        std::vector<uint64_t> preTrySuccess;
+        std::vector<uint64_t> success;
+        std::vector<uint64_t> received;
+        std::vector<uint64_t> interval;
+        std::vector<uint64_t> index;
+        std::vector<uint64_t> transInOneBeacon;
+        std::vector<uint64_t> sinceSuccess;     //!< currentId - preSuccessId
+        std::vector<uint64_t> currentSuccess;   //!< CurrentSuccessId
+        std::vector<uint64_t> newInterval;
+        std::vector<uint64_t> newIndex;
+        std::vector<uint64_t> newTransInOneBeacon;
+        std::vector<uint64_t> nextId;
+        std::vector<uint64_t> push;             //!< 1 if newInterval enters the interval list
+    };
+
+    SensorTable (const SensorTable &);
+    SensorTable & operator = (const SensorTable &);
+
+    void Grow (uint16_t aid);
+
+    std::vector<Sensor *> m_handles;
+    std::vector<uint32_t> m_denseIndex;   //!< AID -> index in m_aids
+    std::vector<uint16_t> m_aids;         //!< associated AIDs, dense
+    std::vector<uint8_t> m_present;
+
+    std::vector<uint64_t> m_nextTransmissionId;
+    std::vector<uint16_t> m_transIntervalList; //!< TRANS_INTERVAL_LIST_SIZE entries per AID, a ring
+    std::vector<uint8_t> m_transIntervalHead;  //!< position of the newest entry of each ring
+    std::vector<uint8_t> m_transmissionSuccess;
+    std::vector<uint8_t> m_everSuccess;
+    std::vector<UpdateInfo> m_updateInfo;
+
+    std::vector<uint64_t> m_transmissionInterval;
+    std::vector<uint64_t> m_lastTransmissionInterval;
+    std::vector<uint64_t> m_last2TransmissionInterval;
+    std::vector<uint64_t> m_transInOneBeacon;
+    std::vector<uint16_t> m_receivedNum;
+    std::vector<uint16_t> m_index;
+
+    std::vector<uint64_t> m_order;        //!< position in the order of last transmission
+    uint64_t m_nextOrder;
+
+    bool m_trackDue;
+    std::map<uint64_t, std::vector<uint16_t> > m_calendar; //!< next transmission id -> AIDs, may hold stale entries
+    std::vector<uint16_t> m_due;          //!< next transmission id <= m_lastDueId + 1, by m_order
+    std::vector<uint8_t> m_inDue;
+    std::vector<uint16_t> m_dueNow;       //!< returned by GetDue
+    std::vector<uint16_t> m_arrivals;
+    uint64_t m_lastDueId;
+    uint64_t m_orderMark;                 //!< m_nextOrder at the last GetDue
+    EstimateBatch m_batch;
 };
     
 class OffloadStation
@@ -154,6 +277,60 @@ private:
     //failure here menas AP receives no packets.
 };
 
+/**
+ * Trace sink of the RAW controller.
+ *
+ * All per-station records of the controller go to a single columnar text
+ * file, one line per station and beacon:
+ *
+ *   beacon  aid  type  scheduled  received  transInOneBeacon
+ *
+ * where type is 0 for a sensor and 1 for an offload station.  Records are
+ * kept in memory and written out when the buffer is full, on Flush () and
+ * when the trace is closed.  A closed trace records nothing.
+ */
+class RawCtrTrace
+{
+public:
+    enum StationType
+    {
+        SENSOR = 0,
+        OFFLOAD = 1
+    };
+
+    RawCtrTrace ();
+    ~RawCtrTrace ();
+
+    /**
+     * \param filename the file to write to, truncated on open
+     */
+    void Open (std::string filename);
+    void Close (void);
+    bool IsOpen (void) const;
+
+    void Record (uint64_t beacon, uint16_t aid, enum StationType type, bool scheduled, uint16_t received, uint64_t transInOneBeacon);
+    void Flush (void);
+
+private:
+    RawCtrTrace (const RawCtrTrace &);
+    RawCtrTrace & operator = (const RawCtrTrace &);
+
+    static const uint32_t BUFFER_RECORDS = 4096;
+
+    struct Entry
+    {
+        uint64_t beacon;
+        uint64_t transInOneBeacon;
+        uint16_t aid;
+        uint16_t received;
+        uint8_t type;
+        bool scheduled;
+    };
+
+    std::ofstream m_file;
+    std::vector<Entry> m_buffer;
+};
+
 class S1gRawCtr
 {
 public:
@@ -166,10 +343,36 @@ public:
 
   void configureRAW ();
   RPS GetRPS ();
-    
-  void deleteRps ();
-  void UdpateSensorStaInfo (std::vector<uint16_t> m_sensorlist, std::vector<uint16_t> m_receivedAid, std::string outputpath); //need to change, controlled by AP
-  void UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vector<uint16_t>  receivedStas, std::string outputpath);
+
+
+  /**
+   * \param enable whether per-station records are written to
+   *        outputpath + "rawctr.txt" by UpdateRAWGroupping
+   */
+  void SetTraceEnabled (bool enable);
+  bool GetTraceEnabled (void) const;
+  void FlushTrace (void);
+
+  /**
+   * In incremental mode the AP does not hand over its station lists every
+   * beacon.  It reports association changes and receptions as they
+   * happen, and UpdateRAWGroupping (BeaconInterval, outputpath) only
+   * visits the stations concerned plus those due to transmit.  The
+   * resulting RPS is the same as with the full recompute.  The mode must
+   * be chosen before the first beacon.
+   */
+  void SetIncremental (bool incremental);
+  bool GetIncremental (void) const;
+  /**
+   * \param aid the AID of the associated station
+   * \param staType 1 for a sensor, 2 for an offload station
+   */
+  void NotifyAssociated (uint16_t aid, uint8_t staType);
+  void NotifyDisassociated (uint16_t aid);
+  void NotifyReceived (uint16_t aid);
+  RPS UpdateRAWGroupping (uint64_t BeaconInterval, std::string outputpath);
+  void UdpateSensorStaInfo (std::vector<uint16_t> m_sensorlist, std::vector<uint16_t> m_receivedAid); //need to change, controlled by AP
+  void UdpateOffloadStaInfo (std::vector<uint16_t> m_OffloadList, std::vector<uint16_t>  receivedStas);
   void calculateActiveOffloadSta ();
   void SetOffloadAllowedToSend ();
   
@@ -182,16 +385,12 @@ public:
   Sensor * LookupSensorSta (uint16_t aid);
   OffloadStation * LookupOffloadSta (uint16_t aid); //can be combined with function LookupSensorSta.
     
-  std::vector<uint16_t>::iterator  LookupLastTransmission (uint16_t aid);
-  
-    
-    typedef std::vector<Sensor *> Stations;
-    typedef std::vector<Sensor *>::iterator StationsCI;
-    Stations m_stations;
+    SensorTable m_stations;
     
     typedef std::vector<OffloadStation *> OffloadStations;
     typedef std::vector<OffloadStation *>::iterator OffloadStationsCI;
     OffloadStations m_offloadStations;
+    OffloadStations m_offloadByAid; //indexed by AID
     
     
     uint16_t MaxSlotForSensor;
@@ -229,12 +428,49 @@ private:
   std::vector<RPS::RawAssignment *> RawAssignmentList;
     
   uint16_t RpsIndex;
-  RPS * m_rps;
+  RPS m_rps;
   RPSVector rpslist;
     
     bool  m_receivedsuccess;
-    
-    std::string  sensorfile;
+
+    //scratch columns indexed by AID, only the touched entries are reset
+    std::vector<uint16_t> m_receivedCount;
+    std::vector<uint8_t> m_aidMark;
+    std::vector<uint16_t> m_scratchTouched;
+    std::vector<uint16_t> m_estimateAids; //!< sensors whose interval is estimated in one batch
+    void ResetScratch (void);
+
+    void UpdateSensorReceptions (const std::vector<uint16_t> & receivedAid);
+    bool ChooseSensor (Sensor * sta, uint32_t & SendNum);
+    void AddSensor (uint16_t aid);
+    RPS FinishRAWGroupping (void);
+    /**
+     * \return whether the RPS of the last beacon was patched in place
+     *
+     * Only the slot durations are patched, so the RPS must schedule the
+     * same stations in the same order as the last beacon.
+     */
+    bool PatchRps (void);
+    /**
+     * \param num the transmissions of the sensor in one beacon
+     * \return the slot duration count of the sensor
+     */
+    uint16_t GetSensorSlotDurationCount (uint16_t num) const;
+    /**
+     * \return the slot duration count of an offload station
+     */
+    uint16_t GetOffloadSlotDurationCount (void) const;
+    void ApplyAssociationChanges (void);
+
+    bool m_incremental;
+    std::vector<uint16_t> m_pendingAdd;      //!< sensors associated since the last beacon, in order
+    std::vector<uint16_t> m_pendingRemove;   //!< sensors disassociated since the last beacon
+    std::vector<uint8_t> m_pendingState;     //!< per AID, PENDING_ADD or PENDING_REMOVE
+    std::vector<uint16_t> m_offloadAids;
+    std::vector<uint16_t> m_pendingReceived;
+
+    bool m_traceEnabled;
+    RawCtrTrace m_trace;
 };
 
 } //namespace ns3
@@ -34,6 +34,7 @@
 #include "mac-tx-middle.h"
 #include "wifi-mac-header.h"
 #include "extension-headers.h"
+#include "s1g-beacon-tag.h"
 #include "msdu-aggregator.h"
 #include "amsdu-subframe-header.h"
 #include "mgt-headers.h"
@@ -104,6 +105,13 @@ StaWifiMac::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&StaWifiMac::SetActiveProbing, &StaWifiMac::GetActiveProbing),
                    MakeBooleanChecker ())
+    .AddAttribute ("RawDozeMode",
+                   "If true, an associated station puts its PHY to sleep from the S1G beacon "
+                   "until its RAW slot starts, or until the RAWs end if it is in no RAW group. "
+                   "A sleeping PHY receives nothing from the channel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&StaWifiMac::m_rawDozeMode),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Assoc", "Associated with an access point.",
                      MakeTraceSourceAccessor (&StaWifiMac::m_assocLogger),
                      "ns3::Mac48Address::TracedCallback")
@@ -124,6 +132,7 @@ StaWifiMac::StaWifiMac ()
   NS_LOG_FUNCTION (this);
   m_rawStart = false;
   m_dataBuffered = false;
+  m_rawDozeMode = false;
   m_aid = 8192;
   uint32_t cwmin = 15;
   uint32_t cwmax = 1023;
@@ -134,6 +143,16 @@ StaWifiMac::StaWifiMac ()
   m_pspollDca->SetLow (m_low);
   m_pspollDca->SetManager (m_dcfManager);
   m_pspollDca->SetTxMiddle (m_txMiddle);
+
+  //one gate opens and closes all the queues at the RAW boundaries
+  m_rawGate = Create<RawAccessGate> ();
+  m_rawGate->SetWakeUpCallback (MakeCallback (&StaWifiMac::RawWakeUp, this));
+  m_pspollDca->SetRawAccessGate (m_rawGate);
+  m_dca->SetRawAccessGate (m_rawGate);
+  m_edca.find (AC_VO)->second->SetRawAccessGate (m_rawGate);
+  m_edca.find (AC_VI)->second->SetRawAccessGate (m_rawGate);
+  m_edca.find (AC_BE)->second->SetRawAccessGate (m_rawGate);
+  m_edca.find (AC_BK)->second->SetRawAccessGate (m_rawGate);
   fasTAssocType = false; //centraied control
   fastAssocThreshold = 0; // allow some station to associate at the begining
     Ptr<UniformRandomVariable> m_rv = CreateObject<UniformRandomVariable> ();
@@ -154,6 +173,8 @@ StaWifiMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_pspollDca = 0;
+  m_rawGate->Dispose ();
+  m_rawGate = 0;
   RegularWifiMac::DoDispose ();
 }
 
@@ -303,7 +324,7 @@ StaWifiMac::SendPspollIfnecessary (void)
     {
      // SendPspoll ();  //pspoll not really send, just put ps-poll frame in m_pspollDca queue
     }
-  else if (!m_rawStart && m_dataBuffered && !m_outsideRawEvent.IsRunning ()) //in case the next beacon coming during RAW, could it happen?
+  else if (!m_rawStart && m_dataBuffered && !m_rawGate->IsRawEndPending ()) //in case the next beacon coming during RAW, could it happen?
    {
      // SendPspoll ();
    }
@@ -312,12 +333,7 @@ StaWifiMac::SendPspollIfnecessary (void)
 void
 StaWifiMac::S1gBeaconReceived (void)
 {
-    if (m_outsideRawEvent.IsRunning ())
-     {
-        m_outsideRawEvent.Cancel ();          //avoid error when actual beacon interval become shorter, otherwise, AccessAllowedIfRaw will set again after raw starting
-        //Simulator::ScheduleNow(&StaWifiMac::OutsideRawStartBackoff, this);
-
-     }
+  m_rawGate->CancelRawEnd ();          //avoid error when actual beacon interval become shorter, otherwise, AccessAllowedIfRaw will set again after raw starting
 
   if (m_aid == 8192) // send assoication request when Staion is not assoicated
     {
@@ -325,136 +341,52 @@ StaWifiMac::S1gBeaconReceived (void)
     }
   else if (m_rawStart & m_inRawGroup && m_pagedStaRaw && m_dataBuffered ) // if m_pagedStaRaw is true, only m_dataBuffered can access channel
     {
-      m_outsideRawEvent = Simulator::Schedule(m_lastRawDurationus, &StaWifiMac::OutsideRawStartBackoff, this);
-
-      m_pspollDca->AccessAllowedIfRaw (true);
-      m_dca->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VO)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VI)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BE)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BK)->second->AccessAllowedIfRaw (false);
-      StartRawbackoff();
+      m_rawGate->ScheduleRawEnd (m_lastRawDurationus);
+      m_rawGate->SetOnlyAllowed (m_pspollDca->GetRawAccessQueue ());
+      m_rawGate->StartRaw ();
     }
   else if (m_rawStart && m_inRawGroup && !m_pagedStaRaw  )
     {
-      m_outsideRawEvent = Simulator::Schedule(m_lastRawDurationus, &StaWifiMac::OutsideRawStartBackoff, this);
-
-      m_pspollDca->AccessAllowedIfRaw (false);
-      m_dca->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VO)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VI)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BE)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BK)->second->AccessAllowedIfRaw (false);
-      Simulator::Schedule(m_statSlotStart, &StaWifiMac::RawSlotStartBackoff, this);
+      m_rawGate->ScheduleRawEnd (m_lastRawDurationus);
+      m_rawGate->SetAllAllowed (false);
+      m_rawGate->ScheduleSlot (m_statSlotStart, m_currentslotDuration);
+      if (m_statSlotStart > Seconds (0))
+        {
+          RawDoze ();
+        }
     }
   else if (m_rawStart && !m_inRawGroup) //|| (m_rawStart && m_inRawGroup && m_pagedStaRaw && !m_dataBuffered)
     {
-      m_outsideRawEvent = Simulator::Schedule(m_lastRawDurationus, &StaWifiMac::OutsideRawStartBackoff, this);
-
-      m_pspollDca->AccessAllowedIfRaw (false);
-      m_dca->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VO)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_VI)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BE)->second->AccessAllowedIfRaw (false);
-      m_edca.find (AC_BK)->second->AccessAllowedIfRaw (false);
-
-      StartRawbackoff();
+      m_rawGate->ScheduleRawEnd (m_lastRawDurationus);
+      m_rawGate->SetAllAllowed (false);
+      m_rawGate->StartRaw ();
+      RawDoze ();
     }
     // else (!m_rawStart),  this case cannot happen, since we assume s1g beacon always indicating one raw
     m_rawStart = false;
 }
 
 void
-StaWifiMac::RawSlotStartBackoff (void)
+StaWifiMac::RawDoze (void)
 {
-    if (m_insideBackoffEvent.IsRunning ())
-     {
-        m_insideBackoffEvent.Cancel ();
-     } //a bug is fixed, prevent previous RAW from disabling current RAW.
-    m_insideBackoffEvent = Simulator::Schedule(m_currentslotDuration, &StaWifiMac::InsideBackoff, this);
-    m_pspollDca->AccessAllowedIfRaw (true);
-    m_dca->AccessAllowedIfRaw (true);
-    m_edca.find (AC_VO)->second->AccessAllowedIfRaw (true);
-    m_edca.find (AC_VI)->second->AccessAllowedIfRaw (true);
-    m_edca.find (AC_BE)->second->AccessAllowedIfRaw (true);
-    m_edca.find (AC_BK)->second->AccessAllowedIfRaw (true);
-    StartRawbackoff();
-}
-
-void
-StaWifiMac::InsideBackoff (void)
-{
-   m_pspollDca->AccessAllowedIfRaw (false);
-   m_dca->AccessAllowedIfRaw (false);
-   m_edca.find (AC_VO)->second->AccessAllowedIfRaw (false);
-   m_edca.find (AC_VI)->second->AccessAllowedIfRaw (false);
-   m_edca.find (AC_BE)->second->AccessAllowedIfRaw (false);
-   m_edca.find (AC_BK)->second->AccessAllowedIfRaw (false);
-
-}
-
-
-void
-StaWifiMac::StartRawbackoff (void)
-{
-  m_pspollDca->RawStart (); //not really start raw useless allowedAccessRaw is true;
-  m_dca->RawStart ();
-  m_edca.find (AC_VO)->second->RawStart ();
-  m_edca.find (AC_VI)->second->RawStart ();
-  m_edca.find (AC_BE)->second->RawStart ();
-  m_edca.find (AC_BK)->second->RawStart ();
-
+  //a PHY busy with a frame would only go to sleep once the frame is over,
+  //possibly after the wake up, so it rather stays awake for this beacon
+  if (m_rawDozeMode && (m_phy->IsStateIdle () || m_phy->IsStateCcaBusy ()))
+    {
+      NS_LOG_DEBUG ("doze until " << Simulator::Now () + (m_inRawGroup ? m_statSlotStart : m_lastRawDurationus));
+      m_phy->SetSleepMode ();
+    }
 }
 
-
 void
-StaWifiMac::OutsideRawStartBackoff (void)
+StaWifiMac::RawWakeUp (void)
 {
-   if (m_insideBackoffEvent.IsRunning ())
-     {
-       m_insideBackoffEvent.Cancel ();
-     }
-  /*Simulator::ScheduleNow(&DcaTxop::OutsideRawStart, StaWifiMac::m_pspollDca);
-  Simulator::ScheduleNow(&DcaTxop::OutsideRawStart, StaWifiMac::m_dca);
-  Simulator::ScheduleNow(&EdcaTxopN::OutsideRawStart, StaWifiMac::m_edca.find (AC_VO)->second);
-  Simulator::ScheduleNow(&EdcaTxopN::OutsideRawStart, StaWifiMac::m_edca.find (AC_VI)->second);
-  Simulator::ScheduleNow(&EdcaTxopN::OutsideRawStart, StaWifiMac::m_edca.find (AC_BE)->second);
-  Simulator::ScheduleNow(&EdcaTxopN::OutsideRawStart, StaWifiMac::m_edca.find (AC_BK)->second);*/
-  StaWifiMac::m_pspollDca->OutsideRawStart ();
-  m_dca->OutsideRawStart();
-  m_edca.find (AC_VO)->second->OutsideRawStart();
-  m_edca.find (AC_VI)->second->OutsideRawStart();
-  m_edca.find (AC_BE)->second->OutsideRawStart();
-  m_edca.find (AC_BK)->second->OutsideRawStart();
-  /*
-  It seems Simulator::ScheduleNow take longer time to execuate than without schedule.
-
-  During debugging, we found that when OutsideRawStartBackoff and StaWifiMac::S1gBeaconReceived execuate at the
-  same time, even  function OutsideRawStartBackoff() at first execute, and function S1gBeaconReceived() execuate
-  later, the function OutsideRawStartBackoff calls executate later than functions called by S1gBeaconReceived ().
-
-  Here is an example, (m_rawStart && !m_inRawGroup) execuated in S1gBeaconReceived. We log the info,
-
-  first, OutsideRawStartBackoff calls
-  OutsideRawStartBackoff ,20	+42302720123.0ns	00:00:00:00:00:14, start to schedule
-  seconds, (m_rawStart && !m_inRawGroup) related functions is execuated,
-    raw start but not inRAWgroup
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 0, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 0, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 0, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 0, 00:00:00:00:00:14
-    m_rawStart && !m_inRawGroup, +42302720123.0ns, 00:00:00:00:00:14
-  Last, functions called by OutsideRawStartBackoff is execuated.
-    ousideRAW
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 1, 00:00:00:00:00:14
-    EdcaTxopN::OutsideRawStart, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 1, 00:00:00:00:00:14
-    EdcaTxopN::OutsideRawStart, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 1, 00:00:00:00:00:14
-    EdcaTxopN::OutsideRawStart, 00:00:00:00:00:14
-    EdcaTxopN::AccessAllowedIfRaw, +42302720123.0ns, 1, 00:00:00:00:00:14
-    EdcaTxopN::OutsideRawStart, 00:00:00:00:00:14
-  */
+  //with the gate still closed, the DcfManager drops the backoffs it had
+  //before the sleep, and RawStart or OutsideRawStart draw new ones
+  if (m_rawDozeMode && m_phy->IsStateSleep ())
+    {
+      m_phy->ResumeFromSleep ();
+    }
 }
 
 void
@@ -903,8 +835,20 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
     }
   else if (hdr->IsS1gBeacon ())
     {
-      S1gBeaconHeader beacon;
-      packet->RemoveHeader (beacon);
+      //use the beacon decoded by the AP when it is still available
+      S1gBeaconTag tag;
+      Ptr<const S1gBeaconInfo> info;
+      if (packet->PeekPacketTag (tag))
+        {
+          info = tag.GetBeaconInfo ();
+        }
+      if (info == 0)
+        {
+          S1gBeaconHeader parsed;
+          packet->RemoveHeader (parsed);
+          info = Create<S1gBeaconInfo> (parsed);
+        }
+      const S1gBeaconHeader & beacon = info->GetHeader ();
       bool goodBeacon = false;
     if ((IsWaitAssocResp () || IsAssociated ()) && hdr->GetAddr3 () != GetBssid ()) // for debug
      {
@@ -929,88 +873,21 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
     if (goodBeacon)
      {
         UnsetInRAWgroup ();
-        uint8_t * rawassign;
-        rawassign = beacon.GetRPS().GetRawAssignment();
-        uint16_t raw_len = beacon.GetRPS().GetInformationFieldSize();
-        uint16_t rawAssignment_len = 6;
-        if (raw_len % rawAssignment_len !=0)
+        m_lastRawDurationus = MicroSeconds (info->GetRawDurationUs ());
+        const std::vector<S1gBeaconInfo::Raw> & raws = info->GetRaws ();
+        if (!raws.empty ())
           {
-             NS_ASSERT ("RAW configuration incorrect!");
+            //the last RAW of the beacon sets the RAW type and slot duration
+            m_pagedStaRaw = (raws.back ().rawType == 4); // only support Generic Raw (paged STA RAW or not)
+            m_slotDuration = MicroSeconds (500 + raws.back ().slotDurationCount * 120);
           }
-        uint8_t RAW_number = raw_len/rawAssignment_len;
-
-         uint16_t m_slotDurationCount=0;
-         uint16_t m_slotNum=0;
-         uint64_t m_currentRAW_start=0;
-         m_lastRawDurationus = MicroSeconds(0);
-    for (uint8_t raw_index=0; raw_index < RAW_number; raw_index++)
-      {
-        uint8_t rawtypeindex = rawassign[raw_index*rawAssignment_len+0] & 0x07;
-        if (rawtypeindex == 4) // only support Generic Raw (paged STA RAW or not)
-          {
-            m_pagedStaRaw = true;
-          }
-        else
+        S1gBeaconInfo::Slot slot;
+        if (info->FindSlot (GetAID (), slot))
           {
-            m_pagedStaRaw = false;
+            m_statSlotStart = MicroSeconds (slot.startUs);
+            SetInRAWgroup ();
+            m_currentslotDuration = MicroSeconds (slot.durationUs); //To support variable time duration among multiple RAWs
           }
-        uint8_t pageindex = rawassign[raw_index*rawAssignment_len+3] & 0x03;
-
-         uint16_t m_rawslot;
-         m_rawslot = (uint16_t(rawassign[raw_index*rawAssignment_len+2]) << 8) | (uint16_t(rawassign[raw_index*rawAssignment_len+1]));
-         uint8_t m_SlotFormat = uint8_t (m_rawslot >> 15) & 0x0001;
-         uint8_t m_slotCrossBoundary = uint8_t (m_rawslot >> 14) & 0x0002;
-
-          m_currentRAW_start=m_currentRAW_start+(500 + m_slotDurationCount * 120)*m_slotNum;
-
-         NS_ASSERT (m_SlotFormat <= 1);
-
-         if (m_SlotFormat == 0)
-           {
-             m_slotDurationCount = (m_rawslot >> 6) & 0x00ff;
-             m_slotNum = m_rawslot & 0x003f;
-           }
-         else if (m_SlotFormat == 1)
-           {
-             m_slotDurationCount = (m_rawslot >> 3) & 0x07ff;
-             m_slotNum = m_rawslot & 0x0007;
-           }
-
-        m_slotDuration = MicroSeconds(500 + m_slotDurationCount * 120);
-        m_lastRawDurationus = m_lastRawDurationus + m_slotDuration * m_slotNum;
-
-         if (pageindex == ((GetAID() >> 11 ) & 0x0003)) //in the page indexed
-           {
-
-             uint8_t rawgroup_l = rawassign[raw_index*rawAssignment_len+3];
-             uint8_t rawgroup_m = rawassign[raw_index*rawAssignment_len+4];
-             uint8_t rawgroup_h = rawassign[raw_index*rawAssignment_len+5];
-             uint32_t rawgroup = (uint32_t(rawassign[raw_index*rawAssignment_len+5]) << 16) | (uint32_t(rawassign[raw_index*rawAssignment_len+4]) << 8) | uint32_t(rawassign[raw_index*rawAssignment_len+3]);
-             uint16_t raw_start = (rawgroup >> 2) & 0x000003ff;
-             uint16_t raw_end = (rawgroup >> 13) & 0x000003ff;
-
-               uint16_t statsPerSlot = 0;
-               uint16_t statRawSlot = 0;
-
-               Ptr<UniformRandomVariable> m_rv = CreateObject<UniformRandomVariable> ();
-               uint16_t offset = m_rv->GetValue (0, 1023);
-               offset =0; // for test
-               statsPerSlot = (raw_end - raw_start + 1)/m_slotNum;
-               //statRawSlot = ((GetAID() & 0x03ff)-raw_start)/statsPerSlot;
-               statRawSlot = ((GetAID() & 0x03ff)+offset)%m_slotNum;
-
-             if ((raw_start <= (GetAID() & 0x03ff)) && ((GetAID() & 0x03ff) <= raw_end))
-               {
-                 m_statSlotStart = MicroSeconds((500 + m_slotDurationCount * 120)*statRawSlot+m_currentRAW_start);
-                 SetInRAWgroup ();
-                 m_currentslotDuration = m_slotDuration; //To support variable time duration among multiple RAWs
-                  // NS_LOG_UNCOND (Simulator::Now () << ", StaWifiMac:: GetAID() = " << GetAID() << ", raw_start =" << raw_start << ", raw_end=" << raw_end << ", m_statSlotStart=" << m_statSlotStart << ", m_lastRawDurationus = " << m_lastRawDurationus << ", m_currentslotDuration = " << m_currentslotDuration);
-                  //break; //break should not used if multiple RAW is supported
-               }
-               //NS_LOG_UNCOND (Simulator::Now () << ", StaWifiMac:: GetAID() = " << GetAID() << ", raw_start =" << raw_start << ", raw_end=" << raw_end << ", m_statSlotStart=" << m_statSlotStart << ", m_lastRawDurationus = " << m_lastRawDurationus << ", m_currentslotDuration = " << m_currentslotDuration);
-
-           }
-      }
          m_rawStart = true; //?
 
          AuthenticationCtrl AuthenCtrl;
@@ -207,11 +207,16 @@ private:
   void SendPspoll (void);
   void SendPspollIfnecessary (void);
   void S1gBeaconReceived (void);
-  void StartRawbackoff (void);
-  void OutsideRawStartBackoff (void);
   bool Is(uint8_t blockbitmap, uint8_t j);
-  void InsideBackoff (void);
-  void RawSlotStartBackoff (void);
+  /**
+   * Put the PHY to sleep until the next RAW boundary of interest to this
+   * station, if RawDozeMode is enabled.
+   */
+  void RawDoze (void);
+  /**
+   * Resume the PHY from the sleep of RawDoze, if any.
+   */
+  void RawWakeUp (void);
 
 
   void SetDataBuffered (void);
@@ -228,8 +233,6 @@ private:
   bool m_inRawGroup;
   bool m_pagedStaRaw;
   bool m_dataBuffered;
-  EventId m_outsideRawEvent;
-  EventId m_insideBackoffEvent;
   enum MacState m_state;
   Time m_probeRequestTimeout;
   Time m_assocRequestTimeout;
@@ -246,6 +249,8 @@ private:
 
   bool m_activeProbing;
   Ptr<DcaTxop> m_pspollDca;  //!< Dedicated DcaTxop for beacons
+  Ptr<RawAccessGate> m_rawGate; //!< RAW access gate shared by all the queues
+  bool m_rawDozeMode;           //!< whether the PHY sleeps outside of the RAW slot
   virtual void DoDispose (void);
 
   TracedCallback<Mac48Address> m_assocLogger;
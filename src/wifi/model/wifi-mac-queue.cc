@@ -59,7 +59,8 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_size (0)
+  : m_peekedValid (false),
+    m_size (0)
 {
 }
 
@@ -92,6 +93,53 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
+void
+WifiMacQueue::Insert (PacketQueueI pos, const Item &item, bool front)
+{
+  PacketQueueI it = m_queue.insert (pos, item);
+  if (it->hdr.IsQosData ())
+    {
+      std::pair<Mac48Address, uint8_t> key (it->hdr.GetAddr1 (), it->hdr.GetQosTid ());
+      it->tidQueue = m_tidQueues.insert (std::make_pair (key, TidQueue ())).first;
+      TidQueue &tidQueue = it->tidQueue->second;
+      it->tidPos = tidQueue.insert (front ? tidQueue.begin () : tidQueue.end (), it);
+    }
+  //the timestamps never decrease
+  it->expiry = m_expiry.insert (m_expiry.end (), std::make_pair (it->tstamp, it));
+  m_size++;
+}
+
+void
+WifiMacQueue::Erase (PacketQueueI it)
+{
+  if (m_peekedValid && m_peeked == it)
+    {
+      m_peekedValid = false;
+    }
+  if (it->hdr.IsQosData ())
+    {
+      it->tidQueue->second.erase (it->tidPos);
+      if (it->tidQueue->second.empty ())
+        {
+          m_tidQueues.erase (it->tidQueue);
+        }
+    }
+  m_expiry.erase (it->expiry);
+  m_queue.erase (it);
+  m_size--;
+}
+
+WifiMacQueue::TidQueue *
+WifiMacQueue::FindTidQueue (uint8_t tid, Mac48Address addr)
+{
+  TidQueues::iterator it = m_tidQueues.find (std::make_pair (addr, tid));
+  if (it == m_tidQueues.end ())
+    {
+      return 0;
+    }
+  return &it->second;
+}
+
 void
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
@@ -101,33 +149,18 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
-  m_size++;
+  Insert (m_queue.end (), Item (packet, hdr, now), false);
 }
 
 void
 WifiMacQueue::Cleanup (void)
 {
-  if (m_queue.empty ())
-    {
-      return;
-    }
-
   Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
+  while (!m_expiry.empty ()
+         && m_expiry.begin ()->first + m_maxDelay <= now)
     {
-      if (i->tstamp + m_maxDelay > now)
-        {
-          i++;
-        }
-      else
-        {
-          i = m_queue.erase (i);
-          n++;
-        }
+      Erase (m_expiry.begin ()->second);
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -137,8 +170,7 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   if (!m_queue.empty ())
     {
       Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
+      Erase (m_queue.begin ());
       *hdr = i.hdr;
       return i.packet;
     }
@@ -164,6 +196,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      TidQueue *tidQueue = FindTidQueue (tid, dest);
+      if (tidQueue != 0)
+        {
+          PacketQueueI it = tidQueue->front ();
+          packet = it->packet;
+          *hdr = it->hdr;
+          Erase (it);
+        }
+      return packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -176,8 +220,7 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  Erase (it);
                   break;
                 }
             }
@@ -191,6 +234,19 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      TidQueue *tidQueue = FindTidQueue (tid, dest);
+      if (tidQueue == 0)
+        {
+          return 0;
+        }
+      m_peeked = tidQueue->front ();
+      m_peekedValid = true;
+      *hdr = m_peeked->hdr;
+      *timestamp = m_peeked->tstamp;
+      return m_peeked->packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -228,6 +284,9 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_tidQueues.clear ();
+  m_expiry.clear ();
+  m_peekedValid = false;
   m_size = 0;
 }
 
@@ -252,13 +311,18 @@ WifiMacQueue::GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQ
 bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
+  //the packets are removed after being peeked for A-MSDU aggregation
+  if (m_peekedValid && m_peeked->packet == packet)
+    {
+      Erase (m_peeked);
+      return true;
+    }
   PacketQueueI it = m_queue.begin ();
   for (; it != m_queue.end (); it++)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -274,8 +338,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  Insert (m_queue.begin (), Item (packet, hdr, now), true);
 }
 
 uint32_t
@@ -284,6 +347,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
 {
   Cleanup ();
   uint32_t nPackets = 0;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      TidQueue *tidQueue = FindTidQueue (tid, addr);
+      return tidQueue == 0 ? 0 : tidQueue->size ();
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -315,8 +383,7 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
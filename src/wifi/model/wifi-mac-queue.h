@@ -24,6 +24,7 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <map>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
@@ -47,6 +48,11 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the queue itself, the QoS data packets are kept in one list per
+ * receiver (address 1) and TID, and all the packets by timestamp, so that
+ * the lookups by TID and address 1 take the packets of that receiver and
+ * TID only, and the cleanup the packets it drops only.
  */
 class WifiMacQueue : public Object
 {
@@ -151,7 +157,8 @@ public:
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
    * takes no effects and return false. Deletion of the packet is
-   * performed in linear time (O(n)).
+   * performed in linear time (O(n)), except for the packet returned by
+   * the last PeekByTidAndAddress, which is removed in constant time.
    *
    * \param packet the packet to be removed
    *
@@ -224,6 +231,32 @@ protected:
    */
   virtual void Cleanup (void);
 
+  struct Item;
+  /**
+   * typedef for packet (struct Item) queue.
+   */
+  typedef std::list<struct Item> PacketQueue;
+  /**
+   * typedef for packet (struct Item) queue reverse iterator.
+   */
+  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
+  /**
+   * typedef for packet (struct Item) queue iterator.
+   */
+  typedef std::list<struct Item>::iterator PacketQueueI;
+  /**
+   * the QoS data packets of one receiver and TID, in queue order
+   */
+  typedef std::list<PacketQueueI> TidQueue;
+  /**
+   * the packets by timestamp
+   */
+  typedef std::multimap<Time, PacketQueueI> ExpiryQueue;
+  /**
+   * the packet lists of the receivers and TIDs
+   */
+  typedef std::map<std::pair<Mac48Address, uint8_t>, TidQueue> TidQueues;
+
   /**
    * A struct that holds information about a packet for putting
    * in a packet queue.
@@ -243,20 +276,11 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr;        //!< Wifi MAC header associated with the packet
     Time tstamp;              //!< timestamp when the packet arrived at the queue
+    TidQueues::iterator tidQueue;  //!< list of the receiver and TID, if QoS data
+    TidQueue::iterator tidPos;     //!< position in tidQueue
+    ExpiryQueue::iterator expiry;  //!< position in the packets by timestamp
   };
 
-  /**
-   * typedef for packet (struct Item) queue.
-   */
-  typedef std::list<struct Item> PacketQueue;
-  /**
-   * typedef for packet (struct Item) queue reverse iterator.
-   */
-  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
-  /**
-   * typedef for packet (struct Item) queue iterator.
-   */
-  typedef std::list<struct Item>::iterator PacketQueueI;
   /**
    * Return the appropriate address for the given packet (given by PacketQueue iterator).
    *
@@ -266,8 +290,33 @@ protected:
    * \return the address
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  /**
+   * Insert a packet in the queue and in its lists.
+   *
+   * \param pos the position in the queue
+   * \param item the packet
+   * \param front whether pos is the front of the queue, else its end
+   */
+  void Insert (PacketQueueI pos, const Item &item, bool front);
+  /**
+   * Remove a packet from the queue and from its lists.
+   *
+   * \param it the packet
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * \param tid the given TID
+   * \param addr the given receiver
+   *
+   * \return the QoS data packets of addr and tid, 0 if there is none
+   */
+  TidQueue * FindTidQueue (uint8_t tid, Mac48Address addr);
 
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  TidQueues m_tidQueues;   //!< QoS data packets by receiver and TID
+  ExpiryQueue m_expiry;    //!< packets by timestamp
+  PacketQueueI m_peeked;   //!< packet of the last PeekByTidAndAddress
+  bool m_peekedValid;      //!< whether m_peeked is still in the queue
   uint32_t m_size;     //!< Current queue size
   uint32_t m_maxSize;  //!< Queue capacity
   Time m_maxDelay;     //!< Time to live for packets in the queue
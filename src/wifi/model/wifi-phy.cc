@@ -29,8 +29,10 @@
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include <cmath>
+#include <map>
 
 namespace ns3 {
 
@@ -50,6 +52,9 @@ WifiPhyListener::~WifiPhyListener ()
 
 NS_OBJECT_ENSURE_REGISTERED (WifiPhy);
 
+//the most durations a PHY keeps, see WifiPhy::CalculateTxDuration
+static const uint32_t g_maxTxDurations = 4096;
+
 TypeId
 WifiPhy::GetTypeId (void)
 {
@@ -101,6 +106,12 @@ WifiPhy::GetTypeId (void)
                      "in monitor mode to sniff all frames being transmitted",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyMonitorSniffTxTrace),
                      "ns3::WifiPhy::MonitorSnifferTxCallback")
+    .AddAttribute ("TxDurationCache",
+                   "Whether the durations of the frames out of A-MPDUs are computed "
+                   "once, and then looked up.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&WifiPhy::m_txDurationCache),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -110,6 +121,7 @@ WifiPhy::WifiPhy ()
   NS_LOG_FUNCTION (this);
   m_totalAmpduSize = 0;
   m_totalAmpduNumSymbols = 0;
+  m_txDurationCache = true;
 }
 
 WifiPhy::~WifiPhy ()
@@ -117,6 +129,13 @@ WifiPhy::~WifiPhy ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+WifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_txDurations.clear ();
+}
+
 WifiMode
 WifiPhy::GetHTPlcpHeaderMode (WifiMode payloadMode, WifiPreamble preamble)
 {
@@ -809,8 +828,34 @@ else
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txvector, WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag)
 {
+  //the frames of A-MPDUs depend on the MPDUs sent before them
+  if (!m_txDurationCache || packetType != 0)
+    {
+      return CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
+             + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+    }
+  //the frequency only matters through the signal extension at 2.4 GHz
+  uint32_t uid = txvector.GetMode ().GetUid ();
+  NS_ASSERT (uid < (1 << 16) && txvector.GetNss () < 16 && txvector.GetNess () < 16 && preamble < 16);
+  uint64_t key = size
+    | ((uint64_t) uid << 32)
+    | ((uint64_t) txvector.GetNss () << 48)
+    | ((uint64_t) txvector.GetNess () << 52)
+    | ((uint64_t) txvector.IsStbc () << 56)
+    | ((uint64_t) preamble << 57)
+    | ((uint64_t) (frequency >= 2400 && frequency <= 2500) << 61);
+  std::map<uint64_t, Time>::const_iterator it = m_txDurations.find (key);
+  if (it != m_txDurations.end ())
+    {
+      return it->second;
+    }
+  if (m_txDurations.size () >= g_maxTxDurations)
+    {
+      m_txDurations.clear ();
+    }
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txvector, preamble)
     + GetPayloadDuration (size, txvector, preamble, frequency, packetType, incFlag);
+  m_txDurations.insert (std::make_pair (key, duration));
   return duration;
 }
 
@@ -22,6 +22,7 @@
 #define WIFI_PHY_H
 
 #include <stdint.h>
+#include <map>
 #include "ns3/callback.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
@@ -292,6 +293,11 @@ public:
    * \param incFlag this flag is used to indicate that the static variables need to be update or not. This function is called a couple of times for the same packet so static variables should not be increased each time.
    *
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
+   *
+   * With TxDurationCache, the durations of the frames which are not part
+   * of an A-MPDU are computed once for each size, mode, number of spatial
+   * and extension streams, STBC, preamble and band, in a table of the PHY
+   * which is emptied whenever it reaches 4096 entries.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txvector, enum WifiPreamble preamble, double frequency, uint8_t packetType, uint8_t incFlag);
 
@@ -1800,6 +1806,9 @@ static WifiMode GetOfdmRate86_666_7MbpsBW16MHz ();
    */
   virtual void SetChannelWidth (uint32_t channelwidth) = 0;
 
+protected:
+  virtual void DoDispose (void);
+
 private:
   /**
    * The trace source fired when a packet begins the transmission process on
@@ -1874,6 +1883,8 @@ private:
 
   uint32_t m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   uint32_t m_totalAmpduSize;       //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
+  bool m_txDurationCache;          //!< whether TxDurationCache is enabled
+  std::map<uint64_t, Time> m_txDurations; //!< durations of the frames out of A-MPDUs, by CalculateTxDuration key
 };
 
 /**
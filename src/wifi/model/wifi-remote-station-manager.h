@@ -31,6 +31,7 @@
 #include "wifi-mode.h"
 #include "wifi-tx-vector.h"
 #include "ht-capabilities.h"
+#include "address-hash-table.h"
 
 namespace ns3 {
 
@@ -1038,6 +1039,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  AddressHashTable<WifiRemoteStationState> m_stateIndex;  //!< m_states by address
+  AddressHashTable<WifiRemoteStation> m_stationIndex;     //!< m_stations by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   uint8_t m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
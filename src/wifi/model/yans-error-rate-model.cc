@@ -20,9 +20,13 @@
  */
 
 #include <cmath>
+#include <map>
+#include <vector>
 #include "yans-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 
 namespace ns3 {
 
@@ -30,6 +34,13 @@ NS_LOG_COMPONENT_DEFINE ("YansErrorRateModel");
 
 NS_OBJECT_ENSURE_REGISTERED (YansErrorRateModel);
 
+//the most probabilities a model keeps, see YansErrorRateModel::LookupPmu
+static const uint32_t g_maxPmus = 65536;
+
+//the SNRs the tables of YansErrorRateModel::LookupPmuTable span
+static const double g_pmuTableMinDb = -20;
+static const double g_pmuTableMaxDb = 50;
+
 TypeId
 YansErrorRateModel::GetTypeId (void)
 {
@@ -37,11 +48,26 @@ YansErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<YansErrorRateModel> ()
+    .AddAttribute ("PerCache",
+                   "Whether the bit error probability of each mode and SNR is "
+                   "computed once, and then looked up.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&YansErrorRateModel::m_perCache),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PerTableResolution",
+                   "If positive, the bit error probabilities are interpolated in "
+                   "tables with one entry every PerTableResolution dB of SNR, "
+                   "instead of being computed exactly.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansErrorRateModel::m_perTableResolution),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
 
 YansErrorRateModel::YansErrorRateModel ()
+  : m_perCache (true),
+    m_perTableResolution (0)
 {
 }
 
@@ -140,25 +166,23 @@ YansErrorRateModel::CalculatePd (double ber, unsigned int d) const
 }
 
 double
-YansErrorRateModel::GetFecBpskBer (double snr, double nbits,
+YansErrorRateModel::GetFecBpskPmu (double snr,
                                    uint32_t signalSpread, uint32_t phyRate,
                                    uint32_t dFree, uint32_t adFree) const
 {
   double ber = GetBpskBer (snr, signalSpread, phyRate);
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
-  
   double pd = CalculatePd (ber, dFree);
   double pmu = adFree * pd;
   pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, nbits);
-  return pms;
+  return pmu;
 }
 
 double
-YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
+YansErrorRateModel::GetFecQamPmu (double snr,
                                   uint32_t signalSpread,
                                   uint32_t phyRate,
                                   uint32_t m, uint32_t dFree,
@@ -167,7 +191,7 @@ YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
   double ber = GetQamBer (snr, m, signalSpread, phyRate);
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
   /* first term */
   double pd = CalculatePd (ber, dFree);
@@ -176,8 +200,193 @@ YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
   pd = CalculatePd (ber, dFree + 1);
   pmu += adFreePlusOne * pd;
   pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, static_cast<double> (nbits));
-  return pms;
+  return pmu;
+}
+
+double
+YansErrorRateModel::GetPmu (WifiMode mode, double snr) const
+{
+  if (mode.GetConstellationSize () == 2) //SIG MCS=10 not supported
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        {
+          return GetFecBpskPmu (snr,
+                                mode.GetBandwidth (), //signal spread
+                                mode.GetPhyRate (), //phy rate
+                                10, //dFree
+                                11); //adFree
+        }
+      else
+        {
+          return GetFecBpskPmu (snr,
+                                mode.GetBandwidth (), //signal spread
+                                mode.GetPhyRate (), //phy rate
+                                5, //dFree
+                                8); //adFree
+        }
+    }
+  else if (mode.GetConstellationSize () == 4)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               4, //m
+                               10, //dFree
+                               11, //adFree
+                               0); //adFreePlusOne
+        }
+      else
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               4, //m
+                               5, //dFree
+                               8, //adFree
+                               31); //adFreePlusOne
+        }
+    }
+  else if (mode.GetConstellationSize () == 16)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               16, //m
+                               10, //dFree
+                               11, //adFree
+                               0); //adFreePlusOne
+        }
+      else
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               16, //m
+                               5, //dFree
+                               8, //adFree
+                               31); //adFreePlusOne
+        }
+    }
+  else if (mode.GetConstellationSize () == 64)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_2_3)
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               64, //m
+                               6, //dFree
+                               1, //adFree
+                               16); //adFreePlusOne
+        }
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        {
+          //Table B.32  in Pâl Frenger et al., "Multi-rate Convolutional Codes".
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               64, //m
+                               4, //dFree
+                               14, //adFree
+                               69); //adFreePlusOne
+        }
+      else
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), //signal spread
+                               mode.GetPhyRate (), //phy rate
+                               64, //m
+                               5, //dFree
+                               8, //adFree
+                               31); //adFreePlusOne
+        }
+    }
+  else if (mode.GetConstellationSize () == 256)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), // signal spread
+                               mode.GetPhyRate (), // phy rate
+                               256, // m
+                               4,  // dFree
+                               14,  // adFree
+                               69  // adFreePlusOne
+                               );
+        }
+      else
+        {
+          return GetFecQamPmu (snr,
+                               mode.GetBandwidth (), // signal spread
+                               mode.GetPhyRate (), // phy rate
+                               256, // m
+                               5,  // dFree
+                               8,  // adFree
+                               31  // adFreePlusOne
+                               );
+        }
+    }
+  return -1;
+}
+
+double
+YansErrorRateModel::LookupPmu (WifiMode mode, double snr) const
+{
+  std::pair<uint32_t, double> key (mode.GetUid (), snr);
+  PmuCache::const_iterator it = m_pmus.find (key);
+  if (it != m_pmus.end ())
+    {
+      return it->second;
+    }
+  if (m_pmus.size () >= g_maxPmus)
+    {
+      m_pmus.clear ();
+    }
+  double pmu = GetPmu (mode, snr);
+  m_pmus.insert (std::make_pair (key, pmu));
+  return pmu;
+}
+
+double
+YansErrorRateModel::LookupPmuTable (WifiMode mode, double snr) const
+{
+  if (snr <= 0)
+    {
+      return GetPmu (mode, snr);
+    }
+  double x = (10 * std::log10 (snr) - g_pmuTableMinDb) / m_perTableResolution;
+  std::pair<uint32_t, double> key (mode.GetUid (), m_perTableResolution);
+  PmuTables::iterator it = m_pmuTables.find (key);
+  if (it == m_pmuTables.end ())
+    {
+      uint32_t n = static_cast<uint32_t> (std::ceil ((g_pmuTableMaxDb - g_pmuTableMinDb) / m_perTableResolution)) + 1;
+      std::vector<double> table (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          table[i] = GetPmu (mode, std::pow (10.0, (g_pmuTableMinDb + i * m_perTableResolution) / 10));
+        }
+      it = m_pmuTables.insert (std::make_pair (key, table)).first;
+    }
+  const std::vector<double> &table = it->second;
+  if (x < 0 || x >= table.size () - 1)
+    {
+      return GetPmu (mode, snr);
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double below = table[i];
+  double above = table[i + 1];
+  if (below <= 0 || above <= 0)
+    {
+      //unsupported mode, or the error probability vanishes
+      return GetPmu (mode, snr);
+    }
+  //the probability falls about exponentially with the SNR in dB
+  double f = x - i;
+  return std::exp ((1 - f) * std::log (below) + f * std::log (above));
 }
 
 double
@@ -188,147 +397,24 @@ YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbi
       || mode.GetModulationClass () == WIFI_MOD_CLASS_HT
       || mode.GetModulationClass () == WIFI_MOD_CLASS_S1G)
     {
-      if (mode.GetConstellationSize () == 2) //SIG MCS=10 not supported
-        {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-                double ErrorRate = GetFecBpskBer (snr,
-                                                  nbits,
-                                                  mode.GetBandwidth (), //signal spread
-                                                  mode.GetPhyRate (), //phy rate
-                                                  10, //dFree
-                                                  11); //adFree
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    mode.GetBandwidth (), //signal spread
-                                    mode.GetPhyRate (), //phy rate
-                                    10, //dFree
-                                    11); //adFree
-            }
-          else
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    mode.GetBandwidth (), //signal spread
-                                    mode.GetPhyRate (), //phy rate
-                                    5, //dFree
-                                    8); //adFree
-            }
-        }
-      else if (mode.GetConstellationSize () == 4)
+      double pmu;
+      if (m_perTableResolution > 0)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   4, //m
-                                   10, //dFree
-                                   11, //adFree
-                                   0); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   4, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          pmu = LookupPmuTable (mode, snr);
         }
-      else if (mode.GetConstellationSize () == 16)
+      else if (m_perCache)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   16, //m
-                                   10, //dFree
-                                   11, //adFree
-                                   0); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   16, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          pmu = LookupPmu (mode, snr);
         }
-      else if (mode.GetConstellationSize () == 64)
+      else
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_2_3)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   64, //m
-                                   6, //dFree
-                                   1, //adFree
-                                   16); //adFreePlusOne
-            }
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              //Table B.32  in Pâl Frenger et al., "Multi-rate Convolutional Codes".
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   64, //m
-                                   4, //dFree
-                                   14, //adFree
-                                   69); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), //signal spread
-                                   mode.GetPhyRate (), //phy rate
-                                   64, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          pmu = GetPmu (mode, snr);
         }
-      else if (mode.GetConstellationSize () == 256)
+      if (pmu < 0)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   256, // m
-                                   4,  // dFree
-                                   14,  // adFree
-                                   69  // adFreePlusOne
-                                   );
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   256, // m
-                                   5,  // dFree
-                                   8,  // adFree
-                                   31  // adFreePlusOne
-                                   );
-            }
+          return 0;
         }
+      return std::pow (1 - pmu, static_cast<double> (nbits));
     }
   else if (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS)
     {
@@ -22,6 +22,8 @@
 #define YANS_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <map>
+#include <vector>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 #include "dsss-error-rate-model.h"
@@ -52,6 +54,15 @@ namespace ns3 {
  *      57(2):440-449, February 2009.
  *    - More detailed description and validation can be found in
  *      http://www.nsnam.org/~pei/80211b.pdf
+ *
+ * The success rate of an OFDM chunk is (1 - p)^nbits, where p, the
+ * probability of a bit error after decoding, depends only on the mode and
+ * the SNR.  With PerCache, p is computed once for each mode and SNR, in a
+ * table of the model which is emptied whenever it reaches 65536 entries.
+ * With PerTableResolution, p is interpolated instead in tables of the
+ * model with one entry every PerTableResolution dB from -20 dB to 50 dB,
+ * which trades exact results for a bounded number of evaluations when the
+ * SNRs seldom repeat.
  */
 class YansErrorRateModel : public ErrorRateModel
 {
@@ -72,6 +83,28 @@ private:
    * \return the logarithm of val to base 2.
    */
   double Log2 (double val) const;
+  /**
+   * \param mode the mode of the chunk
+   * \param snr the SNR of the chunk, as a ratio
+   *
+   * \return the probability of a bit error after decoding, -1 if the
+   *         mode is not supported
+   */
+  double GetPmu (WifiMode mode, double snr) const;
+  /**
+   * \param mode the mode of the chunk
+   * \param snr the SNR of the chunk, as a ratio
+   *
+   * \return GetPmu (mode, snr), computed once
+   */
+  double LookupPmu (WifiMode mode, double snr) const;
+  /**
+   * \param mode the mode of the chunk
+   * \param snr the SNR of the chunk, as a ratio
+   *
+   * \return GetPmu (mode, snr), interpolated in the table of the mode
+   */
+  double LookupPmuTable (WifiMode mode, double snr) const;
   /**
    * Return BER of BPSK with the given parameters.
    *
@@ -134,20 +167,18 @@ private:
   double CalculatePd (double ber, unsigned int d) const;
   /**
    * \param snr
-   * \param nbits
    * \param signalSpread
    * \param phyRate
    * \param dFree
    * \param adFree
    *
-   * \return double
+   * \return the probability of a bit error after decoding
    */
-  double GetFecBpskBer (double snr, double nbits,
+  double GetFecBpskPmu (double snr,
                         uint32_t signalSpread, uint32_t phyRate,
                         uint32_t dFree, uint32_t adFree) const;
   /**
    * \param snr
-   * \param nbits
    * \param signalSpread
    * \param phyRate
    * \param m
@@ -155,13 +186,21 @@ private:
    * \param adFree
    * \param adFreePlusOne
    *
-   * \return double
+   * \return the probability of a bit error after decoding
    */
-  double GetFecQamBer (double snr, uint32_t nbits,
+  double GetFecQamPmu (double snr,
                        uint32_t signalSpread,
                        uint32_t phyRate,
                        uint32_t m, uint32_t dfree,
                        uint32_t adFree, uint32_t adFreePlusOne) const;
+
+  bool m_perCache;
+  double m_perTableResolution;
+
+  typedef std::map<std::pair<uint32_t, double>, double> PmuCache;                //!< (mode, SNR) -> p
+  typedef std::map<std::pair<uint32_t, double>, std::vector<double> > PmuTables; //!< (mode, resolution) -> table
+  mutable PmuCache m_pmus;        //!< probabilities of LookupPmu
+  mutable PmuTables m_pmuTables;  //!< tables of LookupPmuTable
 };
 
 } //namespace ns3
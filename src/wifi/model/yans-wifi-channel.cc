@@ -26,10 +26,23 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <typeinfo>
 
 namespace ns3 {
 
@@ -37,6 +50,102 @@ NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (YansWifiChannel);
 
+/** The senders a thread of PrecomputePaths computes the losses of: first, first + step, and so on */
+class YansWifiChannel::PathSlice
+{
+public:
+  PathSlice (const YansWifiChannel *channel, uint32_t first, uint32_t step)
+    : m_channel (channel),
+      m_first (first),
+      m_step (step)
+  {
+  }
+  void Run (void)
+  {
+    m_channel->PrecomputeLosses (this);
+  }
+
+  const YansWifiChannel *m_channel;
+  uint32_t m_first;
+  uint32_t m_step;
+  std::vector<Ptr<MobilityModel> > m_mobility; //!< the mobility models to compute the losses with, by PHY index
+};
+
+static bool
+IsMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+}
+
+/**
+ * \param loss the first model of a loss chain
+ * \return whether a model of the chain draws random numbers
+ */
+static bool
+HasRandomLoss (Ptr<PropagationLossModel> loss)
+{
+  for (; loss != 0; loss = loss->GetNext ())
+    {
+      if (DynamicCast<RandomPropagationLossModel> (loss) != 0
+          || DynamicCast<NakagamiPropagationLossModel> (loss) != 0
+          || DynamicCast<JakesPropagationLossModel> (loss) != 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \param loss the first model of a loss chain
+ * \return whether every model of the chain only depends on the distance
+ *         between the two mobility models, as the culling range assumes
+ */
+static bool
+IsDistanceOnlyLoss (Ptr<PropagationLossModel> loss)
+{
+  for (; loss != 0; loss = loss->GetNext ())
+    {
+      if (DynamicCast<FriisPropagationLossModel> (loss) == 0
+          && DynamicCast<LogDistancePropagationLossModel> (loss) == 0
+          && DynamicCast<ThreeLogDistancePropagationLossModel> (loss) == 0
+          && DynamicCast<RangePropagationLossModel> (loss) == 0
+          && DynamicCast<FixedRssLossModel> (loss) == 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \param loss the first model of a loss chain
+ * \return whether every model of the chain is one of the deterministic
+ *         models of the propagation module, which only read the positions
+ *         of the mobility models and change nothing, so that threads may
+ *         compute the losses between copies of the positions.  Models
+ *         deriving from them may do otherwise, and are not taken.
+ */
+static bool
+IsPositionOnlyLoss (Ptr<PropagationLossModel> loss)
+{
+  for (; loss != 0; loss = loss->GetNext ())
+    {
+      const std::type_info &type = typeid (*loss);
+      if (type != typeid (FriisPropagationLossModel)
+          && type != typeid (LogDistancePropagationLossModel)
+          && type != typeid (ThreeLogDistancePropagationLossModel)
+          && type != typeid (RangePropagationLossModel)
+          && type != typeid (FixedRssLossModel)
+          && type != typeid (TwoRayGroundPropagationLossModel))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 TypeId
 YansWifiChannel::GetTypeId (void)
 {
@@ -52,11 +161,49 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("ReceiverCulling", "If true, transmissions are not handed to the PHYs too far away "
+                   "to sense them.  Only applies to loss models depending on the distance alone.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_culling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingMargin", "Margin in dB below the lowest energy detection or CCA threshold "
+                   "of the PHYs at which ReceiverCulling starts.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cullingMarginDb),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("PathCache", "If true, the received power and the delay between two PHYs are computed "
+                   "once for each tx power, as long as neither moves.  The loss and delay models "
+                   "must be deterministic: there is no cache with a random one.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_pathCache),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PathCacheThreads", "The number of threads PrecomputePaths computes the losses on, "
+                   "if threads are enabled and the loss models are known to only read the positions.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&YansWifiChannel::m_pathCacheThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NodeLocalReceive", "If true, the receptions are scheduled as node-local events, "
+                   "each with its own copy of the packet, which a ParallelSimulatorImpl may run "
+                   "concurrently.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_nodeLocalReceive),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_culling (false),
+    m_cullingMarginDb (10.0),
+    m_gridValid (false),
+    m_thresholdDbm (0),
+    m_cellSize (0),
+    m_nTraced (0),
+    m_pathCache (false),
+    m_pathCacheThreads (1),
+    m_randomChecked (false),
+    m_random (false),
+    m_nodeLocalReceive (false)
 {
 }
 
@@ -70,12 +217,25 @@ void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_gridValid = false;
+  m_ranges.clear ();
+  m_paths.clear ();
+  m_randomChecked = false;
+}
+
+void
+YansWifiChannel::NotifyThresholdsChanged (void)
+{
+  m_gridValid = false;
+  m_ranges.clear ();
 }
 
 void
 YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
 {
   m_delay = delay;
+  m_paths.clear ();
+  m_randomChecked = false;
 }
 
 void
@@ -84,9 +244,31 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  //forget the transmissions which have left the air at all their
+  //skipped PHYs, or which they all caught up with
+  while (!m_skipped.empty ()
+         && (m_skipped.front ().end < Simulator::Now () || m_skipped.front ().receivers.empty ()))
+    {
+      m_skipped.pop_front ();
+    }
+  //one copy of the packet, shared by the receivers: a PHY copies it
+  //again only to hand it up
+  Ptr<const Packet> shared = packet->Copy ();
+  uint32_t from = m_pathCache ? GetIndex (sender) : 0;
+  std::vector<uint32_t> skipped;
+  std::vector<Time> skippedDelays;
+  Time maxSkippedDelay;
+  uint32_t n = m_phyList.size ();
+  if (m_culling)
+    {
+      m_candidates.clear ();
+      FindCandidates (senderMobility, GetCullingRange (txPowerDbm));
+      n = m_candidates.size ();
+    }
+  for (uint32_t k = 0; k < n; k++)
     {
+      uint32_t j = m_culling ? m_candidates[k] : k;
+      PhyList::const_iterator i = m_phyList.begin () + j;
       if (sender != (*i))
         {
           //For now don't account for inter channel interference
@@ -94,13 +276,19 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             {
               continue;
             }
-
           Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+          Time delay = GetDelay (from, j, senderMobility, receiverMobility);
+          if ((*i)->IsStateSleep ())
+            {
+              skipped.push_back (j);
+              skippedDelays.push_back (delay);
+              maxSkippedDelay = std::max (maxSkippedDelay, delay);
+              continue;
+            }
+
+          double rxPowerDbm = GetRxPower (txPowerDbm, from, j, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
@@ -112,24 +300,517 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
               dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
             }
 
-          double *atts = new double[3];
-          *atts = rxPowerDbm;
-          *(atts + 1) = packetType;
-          *(atts + 2) = duration.GetNanoSeconds ();
+          RxParameters params;
+          params.rxPowerDbm = rxPowerDbm;
+          params.packetType = packetType;
+          params.duration = duration;
+
+          if (m_nodeLocalReceive)
+            {
+              Simulator::ScheduleNodeLocal (dstNode, delay,
+                                            MakeEvent (&YansWifiChannel::Receive, this,
+                                                       j, packet->Copy (), params, txVector, preamble));
+            }
+          else
+            {
+              Simulator::ScheduleWithContext (dstNode,
+                                              delay, &YansWifiChannel::Receive, this,
+                                              j, shared, params, txVector, preamble);
+            }
+        }
+    }
+  if (!skipped.empty ())
+    {
+      SkippedTx tx;
+      tx.sender = sender;
+      tx.senderIndex = from;
+      tx.packet = shared;
+      tx.txPowerDbm = txPowerDbm;
+      tx.txVector = txVector;
+      tx.preamble = preamble;
+      tx.packetType = packetType;
+      tx.channelNumber = sender->GetChannelNumber ();
+      tx.start = Simulator::Now ();
+      tx.duration = duration;
+      tx.end = tx.start + duration + maxSkippedDelay;
+      m_skipped.push_back (tx);
+      m_skipped.back ().receivers.swap (skipped);
+      m_skipped.back ().delays.swap (skippedDelays);
+    }
+}
+
+void
+YansWifiChannel::CatchUp (Ptr<YansWifiPhy> receiver) const
+{
+  NS_LOG_FUNCTION (this << receiver);
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  uint32_t to = GetIndex (receiver);
+  for (std::deque<SkippedTx>::iterator i = m_skipped.begin (); i != m_skipped.end (); i++)
+    {
+      //only the PHYs skipped by Send catch up, and only once: the others
+      //got the transmission when it was sent
+      std::vector<uint32_t>::iterator skipped = std::lower_bound (i->receivers.begin (), i->receivers.end (), to);
+      if (skipped == i->receivers.end () || *skipped != to)
+        {
+          continue;
+        }
+      std::vector<Time>::iterator delay = i->delays.begin () + (skipped - i->receivers.begin ());
+      Time arrival = i->start + *delay;
+      i->receivers.erase (skipped);
+      i->delays.erase (delay);
+      if (i->channelNumber != receiver->GetChannelNumber ())
+        {
+          continue;
+        }
+      Ptr<MobilityModel> senderMobility = i->sender->GetMobility ()->GetObject<MobilityModel> ();
+      if (arrival + i->duration <= Simulator::Now ())
+        {
+          continue;
+        }
+      double rxPowerDbm = GetRxPower (i->txPowerDbm, i->senderIndex, to, senderMobility, receiverMobility);
+      if (arrival >= Simulator::Now ())
+        {
+          RxParameters params;
+          params.rxPowerDbm = rxPowerDbm;
+          params.packetType = i->packetType;
+          params.duration = i->duration;
+          Simulator::Schedule (arrival - Simulator::Now (), &YansWifiChannel::ReceiveAfterSleep, this,
+                               receiver, i->packet, params, i->txVector, i->preamble);
+        }
+      else
+        {
+          receiver->AddInterference (i->packet->GetSize (), i->txVector, i->preamble,
+                                     arrival + i->duration - Simulator::Now (), rxPowerDbm);
+        }
+    }
+}
+
+double
+YansWifiChannel::GetCullingRange (double txPowerDbm) const
+{
+  if (!m_gridValid)
+    {
+      BuildGrid ();
+    }
+  std::map<double, double>::const_iterator it = m_ranges.find (txPowerDbm);
+  if (it != m_ranges.end ())
+    {
+      return it->second;
+    }
+  if (HasRandomLoss (m_loss))
+    {
+      //probing would draw from the streams of the loss model, for a
+      //range which holds for one draw only
+      NS_LOG_DEBUG ("random loss model, no culling");
+      m_ranges[txPowerDbm] = std::numeric_limits<double>::infinity ();
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (!IsDistanceOnlyLoss (m_loss))
+    {
+      //the probes along the x axis tell nothing of the heights, the
+      //obstacles or the pairs of models the loss may depend on
+      NS_LOG_DEBUG ("loss model not only depending on the distance, no culling");
+      m_ranges[txPowerDbm] = std::numeric_limits<double>::infinity ();
+      return std::numeric_limits<double>::infinity ();
+    }
+  //double the distance until the loss brings the power below the
+  //threshold, then bisect
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  double lo = 0;
+  double hi = 1;
+  double range = std::numeric_limits<double>::infinity ();
+  for (; hi < 1e8; hi *= 2)
+    {
+      b->SetPosition (Vector (hi, 0, 0));
+      if (m_loss->CalcRxPower (txPowerDbm, a, b) < m_thresholdDbm)
+        {
+          for (uint32_t k = 0; k < 30; k++)
+            {
+              double mid = (lo + hi) / 2;
+              b->SetPosition (Vector (mid, 0, 0));
+              if (m_loss->CalcRxPower (txPowerDbm, a, b) < m_thresholdDbm)
+                {
+                  hi = mid;
+                }
+              else
+                {
+                  lo = mid;
+                }
+            }
+          range = hi;
+          break;
+        }
+      lo = hi;
+    }
+  NS_LOG_DEBUG ("culling range for " << txPowerDbm << "dBm: " << range << "m");
+  m_ranges[txPowerDbm] = range;
+  return range;
+}
+
+void
+YansWifiChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility) const
+{
+  m_gridValid = false;
+  if (!m_pathCache)
+    {
+      return;
+    }
+  for (uint32_t j = 0; j < m_nTraced; j++)
+    {
+      if (PeekPointer (m_phyList[j]->GetMobility ()) != PeekPointer (mobility))
+        {
+          continue;
+        }
+      m_mobile[j] = IsMoving (mobility);
+      if (j < m_paths.size ())
+        {
+          m_paths[j].paths.clear ();
+        }
+      for (std::vector<PathRow>::iterator row = m_paths.begin (); row != m_paths.end (); row++)
+        {
+          if (j < row->paths.size ())
+            {
+              row->paths[j] = PathEntry ();
+            }
+        }
+    }
+}
+
+void
+YansWifiChannel::TraceCourseChanges (void) const
+{
+  for (; m_nTraced < m_phyList.size (); m_nTraced++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[m_nTraced]->GetMobility ();
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::NotifyCourseChange, this));
+      m_mobile[m_nTraced] = IsMoving (mobility);
+    }
+}
+
+uint32_t
+YansWifiChannel::GetIndex (Ptr<const YansWifiPhy> phy) const
+{
+  uint32_t index = phy->GetChannelIndex ();
+  NS_ASSERT_MSG (index < m_phyList.size () && m_phyList[index] == phy, "PHY not on the channel");
+  return index;
+}
+
+bool
+YansWifiChannel::IsPathCacheEnabled (void) const
+{
+  if (!m_pathCache)
+    {
+      return false;
+    }
+  if (!m_randomChecked)
+    {
+      m_randomChecked = true;
+      m_random = HasRandomLoss (m_loss) || DynamicCast<RandomPropagationDelayModel> (m_delay) != 0;
+      if (m_random)
+        {
+          //a cached path would repeat the first draw for ever
+          NS_LOG_WARN ("PathCache ignored with a random loss or delay model");
+        }
+    }
+  return !m_random;
+}
+
+YansWifiChannel::PathEntry *
+YansWifiChannel::GetPath (uint32_t from, uint32_t to) const
+{
+  if (!IsPathCacheEnabled ())
+    {
+      return 0;
+    }
+  if (m_nTraced < m_phyList.size ())
+    {
+      TraceCourseChanges ();
+    }
+  if (m_mobile[from] || m_mobile[to])
+    {
+      return 0;
+    }
+  if (from >= m_paths.size ())
+    {
+      PathRow empty;
+      empty.txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+      m_paths.resize (m_phyList.size (), empty);
+    }
+  std::vector<PathEntry> &paths = m_paths[from].paths;
+  if (to >= paths.size ())
+    {
+      paths.resize (m_phyList.size ());
+    }
+  return &paths[to];
+}
+
+Time
+YansWifiChannel::GetDelay (uint32_t from, uint32_t to, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  PathEntry *path = GetPath (from, to);
+  if (path == 0)
+    {
+      return m_delay->GetDelay (a, b);
+    }
+  if (path->delay < 0)
+    {
+      path->delay = m_delay->GetDelay (a, b).GetTimeStep ();
+    }
+  return Time (path->delay);
+}
+
+double
+YansWifiChannel::GetRxPower (double txPowerDbm, uint32_t from, uint32_t to,
+                             Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  PathEntry *path = GetPath (from, to);
+  if (path == 0)
+    {
+      return m_loss->CalcRxPower (txPowerDbm, a, b);
+    }
+  PathRow &row = m_paths[from];
+  if (row.txPowerDbm != txPowerDbm)
+    {
+      //the received powers of the row are for another tx power
+      for (std::vector<PathEntry>::iterator it = row.paths.begin (); it != row.paths.end (); it++)
+        {
+          it->rxPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+        }
+      row.txPowerDbm = txPowerDbm;
+    }
+  if (std::isnan (path->rxPowerDbm))
+    {
+      path->rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, a, b);
+    }
+  return path->rxPowerDbm;
+}
+
+void
+YansWifiChannel::PrecomputePaths (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsPathCacheEnabled ())
+    {
+      return;
+    }
+  TraceCourseChanges ();
+  uint32_t n = m_phyList.size ();
+  PathRow empty;
+  empty.txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+  m_paths.resize (n, empty);
+  for (uint32_t from = 0; from < n; from++)
+    {
+      if (m_mobile[from])
+        {
+          continue;
+        }
+      PathRow &row = m_paths[from];
+      row.paths.resize (n);
+      double txPowerDbm = m_phyList[from]->GetTxPowerEnd () + m_phyList[from]->GetTxGain ();
+      if (row.txPowerDbm != txPowerDbm)
+        {
+          for (std::vector<PathEntry>::iterator it = row.paths.begin (); it != row.paths.end (); it++)
+            {
+              it->rxPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+            }
+          row.txPowerDbm = txPowerDbm;
+        }
+      Ptr<MobilityModel> a = m_phyList[from]->GetMobility ();
+      for (uint32_t to = 0; to < n; to++)
+        {
+          if (to != from && !m_mobile[to])
+            {
+              GetDelay (from, to, a, m_phyList[to]->GetMobility ());
+            }
+        }
+    }
+
+  uint32_t threads = std::max<uint32_t> (1, std::min (m_pathCacheThreads, n));
+  if (threads > 1 && !IsPositionOnlyLoss (m_loss))
+    {
+      //the copies of the positions would not do for a model casting the
+      //mobility models, keyed on them, or changing its state
+      NS_LOG_WARN ("loss model not known to only read the positions, precomputing on one thread");
+      threads = 1;
+    }
+  std::vector<PathSlice> slices;
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      slices.push_back (PathSlice (this, t, threads));
+      slices[t].m_mobility.resize (n);
+      for (uint32_t j = 0; j < n; j++)
+        {
+          Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ();
+          if (threads == 1 || m_mobile[j])
+            {
+              slices[t].m_mobility[j] = mobility;
+              continue;
+            }
+          Ptr<ConstantPositionMobilityModel> copy = CreateObject<ConstantPositionMobilityModel> ();
+          copy->SetPosition (mobility->GetPosition ());
+          slices[t].m_mobility[j] = copy;
+        }
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > workers;
+  for (uint32_t t = 1; t < threads; t++)
+    {
+      workers.push_back (Create<SystemThread> (MakeCallback (&PathSlice::Run, &slices[t])));
+      workers.back ()->Start ();
+    }
+  slices[0].Run ();
+  for (uint32_t t = 0; t < workers.size (); t++)
+    {
+      workers[t]->Join ();
+    }
+#else
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      slices[t].Run ();
+    }
+#endif
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, atts, txVector, preamble);
+void
+YansWifiChannel::PrecomputeLosses (PathSlice *slice) const
+{
+  uint32_t n = m_phyList.size ();
+  for (uint32_t from = slice->m_first; from < n; from += slice->m_step)
+    {
+      if (m_mobile[from])
+        {
+          continue;
+        }
+      PathRow &row = m_paths[from];
+      for (uint32_t to = 0; to < n; to++)
+        {
+          if (to != from && !m_mobile[to] && std::isnan (row.paths[to].rxPowerDbm))
+            {
+              row.paths[to].rxPowerDbm = m_loss->CalcRxPower (row.txPowerDbm, slice->m_mobility[from],
+                                                              slice->m_mobility[to]);
+            }
         }
     }
 }
 
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell ((int64_t) std::floor (position.x / m_cellSize), (int64_t) std::floor (position.y / m_cellSize));
+}
+
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double *atts,
+YansWifiChannel::BuildGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_gridValid = true;
+  m_grid.clear ();
+  m_moving.clear ();
+
+  TraceCourseChanges ();
+
+  //the weakest signal a PHY acts upon, and the strongest sender
+  m_thresholdDbm = std::numeric_limits<double>::infinity ();
+  double maxTxPowerDbm = -std::numeric_limits<double>::infinity ();
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      double threshold = std::min ((*i)->GetEdThreshold (), (*i)->GetCcaMode1Threshold ()) - (*i)->GetRxGain ();
+      m_thresholdDbm = std::min (m_thresholdDbm, threshold - m_cullingMarginDb);
+      maxTxPowerDbm = std::max (maxTxPowerDbm, (*i)->GetTxPowerEnd () + (*i)->GetTxGain ());
+    }
+
+  m_cellSize = 0;
+  if (m_phyList.empty ())
+    {
+      return;
+    }
+  double cellSize = GetCullingRange (maxTxPowerDbm);
+  if (cellSize == std::numeric_limits<double>::infinity () || cellSize <= 0)
+    {
+      return;
+    }
+  m_cellSize = cellSize;
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ();
+      if (IsMoving (mobility))
+        {
+          m_moving.push_back (j);
+        }
+      else
+        {
+          m_grid[GetCell (mobility->GetPosition ())].push_back (j);
+        }
+    }
+}
+
+void
+YansWifiChannel::FindCandidates (Ptr<MobilityModel> sender, double range) const
+{
+  if (!m_gridValid)
+    {
+      BuildGrid ();
+    }
+  if (m_cellSize == 0 || range == std::numeric_limits<double>::infinity ())
+    {
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          m_candidates.push_back (j);
+        }
+      return;
+    }
+  Vector position = sender->GetPosition ();
+  int64_t reach = (int64_t) std::ceil (range / m_cellSize);
+  if ((2 * reach + 1) * (2 * reach + 1) >= (int64_t) m_grid.size ())
+    {
+      for (std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_grid.begin (); it != m_grid.end (); it++)
+        {
+          m_candidates.insert (m_candidates.end (), it->second.begin (), it->second.end ());
+        }
+    }
+  else
+    {
+      Cell center = GetCell (position);
+      for (int64_t x = center.first - reach; x <= center.first + reach; x++)
+        {
+          for (int64_t y = center.second - reach; y <= center.second + reach; y++)
+            {
+              std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_grid.find (Cell (x, y));
+              if (it != m_grid.end ())
+                {
+                  m_candidates.insert (m_candidates.end (), it->second.begin (), it->second.end ());
+                }
+            }
+        }
+    }
+  m_candidates.insert (m_candidates.end (), m_moving.begin (), m_moving.end ());
+
+  //keep the PHYs within range, in PHY list order
+  std::vector<uint32_t>::iterator last = m_candidates.begin ();
+  for (std::vector<uint32_t>::const_iterator it = m_candidates.begin (); it != m_candidates.end (); it++)
+    {
+      if (CalculateDistance (position, m_phyList[*it]->GetMobility ()->GetPosition ()) <= range)
+        {
+          *last++ = *it;
+        }
+    }
+  m_candidates.erase (last, m_candidates.end ());
+  std::sort (m_candidates.begin (), m_candidates.end ());
+}
+
+void
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, RxParameters params,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
-  m_phyList[i]->StartReceivePreambleAndHeader (packet, *atts, txVector, preamble, *(atts + 1), NanoSeconds (*(atts + 2)));
-  delete[] atts;
+  m_phyList[i]->StartReceivePreambleAndHeader (packet, params.rxPowerDbm, txVector, preamble, params.packetType, params.duration);
+}
+
+void
+YansWifiChannel::ReceiveAfterSleep (Ptr<YansWifiPhy> phy, Ptr<const Packet> packet, RxParameters params,
+                                    WifiTxVector txVector, WifiPreamble preamble) const
+{
+  phy->StartReceivePreambleAndHeader (packet, params.rxPowerDbm, txVector, preamble, params.packetType, params.duration);
 }
 
 uint32_t
@@ -147,7 +828,11 @@ YansWifiChannel::GetDevice (uint32_t i) const
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
+  phy->SetChannelIndex (m_phyList.size ());
   m_phyList.push_back (phy);
+  m_mobile.push_back (false);
+  m_gridValid = false;
+  m_ranges.clear ();
 }
 
 int64_t
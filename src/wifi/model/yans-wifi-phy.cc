@@ -189,12 +189,21 @@ YansWifiPhy::GetTypeId (void)
                    MakeUintegerAccessor (&YansWifiPhy::GetChannelWidth,
                                          &YansWifiPhy::SetChannelWidth),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("InterferenceRunningSum",
+                   "Whether the energy received up to now is kept as a running sum, "
+                   "the noise and interference changes passed being dropped while "
+                   "no frame is received.  The results are the same either way.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiPhy::SetInterferenceRunningSum,
+                                        &YansWifiPhy::GetInterferenceRunningSum),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiPhy::YansWifiPhy ()
   : m_initialized (false),
+    m_channelIndex (0),
     m_channelNumber (1),
     m_endRxEvent (),
     m_endPlcpRxEvent (),
@@ -222,6 +231,7 @@ YansWifiPhy::DoDispose (void)
   m_device = 0;
   m_mobility = 0;
   m_state = 0;
+  WifiPhy::DoDispose ();
 }
 
 void
@@ -279,6 +289,13 @@ YansWifiPhy::SetRxNoiseFigure (double noiseFigureDb)
   m_interference.SetNoiseFigure (DbToRatio (noiseFigureDb));
 }
 
+void
+YansWifiPhy::SetInterferenceRunningSum (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_interference.SetRunningSum (enable);
+}
+
 void
 YansWifiPhy::SetTxPowerStart (double start)
 {
@@ -312,6 +329,10 @@ YansWifiPhy::SetRxGain (double gain)
 {
   NS_LOG_FUNCTION (this << gain);
   m_rxGainDb = gain;
+  if (m_channel != 0)
+    {
+      m_channel->NotifyThresholdsChanged ();
+    }
 }
 
 void
@@ -319,6 +340,10 @@ YansWifiPhy::SetEdThreshold (double threshold)
 {
   NS_LOG_FUNCTION (this << threshold);
   m_edThresholdW = DbmToW (threshold);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyThresholdsChanged ();
+    }
 }
 
 void
@@ -326,6 +351,10 @@ YansWifiPhy::SetCcaMode1Threshold (double threshold)
 {
   NS_LOG_FUNCTION (this << threshold);
   m_ccaMode1ThresholdW = DbmToW (threshold);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyThresholdsChanged ();
+    }
 }
 
 void
@@ -352,6 +381,12 @@ YansWifiPhy::GetRxNoiseFigure (void) const
   return RatioToDb (m_interference.GetNoiseFigure ());
 }
 
+bool
+YansWifiPhy::GetInterferenceRunningSum (void) const
+{
+  return m_interference.GetRunningSum ();
+}
+
 double
 YansWifiPhy::GetTxPowerStart (void) const
 {
@@ -432,6 +467,18 @@ YansWifiPhy::SetChannel (Ptr<YansWifiChannel> channel)
   m_channel->Add (this);
 }
 
+void
+YansWifiPhy::SetChannelIndex (uint32_t index)
+{
+  m_channelIndex = index;
+}
+
+uint32_t
+YansWifiPhy::GetChannelIndex (void) const
+{
+  return m_channelIndex;
+}
+
 void
 YansWifiPhy::SetChannelNumber (uint16_t nch)
 {
@@ -450,6 +497,7 @@ YansWifiPhy::SetChannelNumber (uint16_t nch)
       NS_LOG_DEBUG ("drop packet because of channel switching while reception");
       m_endPlcpRxEvent.Cancel ();
       m_endRxEvent.Cancel ();
+      ReleaseRxEvents ();
       goto switchChannel;
       break;
     case YansWifiPhy::TX:
@@ -553,6 +601,12 @@ YansWifiPhy::ResumeFromSleep (void)
     case YansWifiPhy::SLEEP:
       {
         NS_LOG_DEBUG ("resuming from sleep mode");
+        //the channel skipped this PHY while it was sleeping
+        m_plcpSuccess = false;
+        if (m_channel != 0)
+          {
+            m_channel->CatchUp (this);
+          }
         Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
         m_state->SwitchFromSleep (delayUntilCcaEnd);
         break;
@@ -578,7 +632,15 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
+YansWifiPhy::AddInterference (uint32_t size, WifiTxVector txVector, enum WifiPreamble preamble,
+                              Time duration, double rxPowerDbm)
+{
+  NS_LOG_FUNCTION (this << size << txVector.GetMode () << preamble << duration << rxPowerDbm);
+  m_interference.Add (size, txVector, preamble, duration, DbmToW (rxPowerDbm + m_rxGainDb));
+}
+
+void
+YansWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                             double rxPowerDbm,
                                             WifiTxVector txVector,
                                             enum WifiPreamble preamble,
@@ -739,7 +801,17 @@ maybeCcaBusy:
 }
 
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::ReleaseRxEvents (void)
+{
+  //the events hold the packet being received: drop them here rather
+  //than in the next StartReceivePreambleAndHeader, which may run on a
+  //worker thread while other nodes hold copies of the packet
+  m_endPlcpRxEvent = EventId ();
+  m_endRxEvent = EventId ();
+}
+
+void
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble,
                                  uint8_t packetType,
@@ -803,6 +875,7 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
     {
       m_endPlcpRxEvent.Cancel ();
       m_endRxEvent.Cancel ();
+      ReleaseRxEvents ();
       m_interference.NotifyRxEnd ();
     }
   NotifyTxBegin (packet);
@@ -1131,11 +1204,12 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
+  ReleaseRxEvents ();
 
   struct InterferenceHelper::SnrPer snrPer;
   snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
@@ -1170,7 +1244,7 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t
           double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
           double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
           NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, event->GetTxVector (), signalDbm, noiseDbm);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+          m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
             
           //NS_LOG_UNCOND ("YansWifiPhy::EndReceive, SwitchFromRxEndOk, "  << packet);
         }
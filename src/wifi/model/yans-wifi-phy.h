@@ -76,6 +76,18 @@ public:
    * \param channel the YansWifiChannel this YansWifiPhy is to be connected to
    */
   void SetChannel (Ptr<YansWifiChannel> channel);
+  /**
+   * Set the index of this YansWifiPhy in the PHY list of its
+   * YansWifiChannel.  Only the channel calls it, as it adds the PHY.
+   *
+   * \param index the index of this YansWifiPhy in the PHY list
+   */
+  void SetChannelIndex (uint32_t index);
+  /**
+   * \return the index of this YansWifiPhy in the PHY list of its
+   *         YansWifiChannel
+   */
+  uint32_t GetChannelIndex (void) const;
   /**
    * Set the current channel number.
    *
@@ -99,17 +111,31 @@ public:
    */
   double GetChannelFrequencyMhz () const;
 
+  /**
+   * Add to the energy sensed by this PHY the remainder of a frame which
+   * it did not receive, e.g. because it was sleeping when the frame
+   * started.  The frame is never received.
+   *
+   * \param size the size of the frame in bytes
+   * \param txVector the TXVECTOR of the frame
+   * \param preamble the preamble of the frame
+   * \param duration the remaining duration of the frame
+   * \param rxPowerDbm the receive power in dBm
+   */
+  void AddInterference (uint32_t size, WifiTxVector txVector, enum WifiPreamble preamble,
+                        Time duration, double rxPowerDbm);
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, shared with the other receivers:
+   *        it is copied only when handed up
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreambleAndHeader (Ptr<Packet> packet,
+  void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                       double rxPowerDbm,
                                       WifiTxVector txVector,
                                       WifiPreamble preamble,
@@ -124,7 +150,7 @@ public:
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
                            uint8_t packetType,
@@ -136,6 +162,13 @@ public:
    * \param noiseFigureDb noise figure in dB
    */
   void SetRxNoiseFigure (double noiseFigureDb);
+  /**
+   * \param enable whether the InterferenceHelper keeps the energy
+   *        received up to now as a running sum
+   *
+   * \sa InterferenceHelper::SetRunningSum
+   */
+  void SetInterferenceRunningSum (bool enable);
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -213,6 +246,11 @@ public:
    * \return the RX noise figure in dBm
    */
   double GetRxNoiseFigure (void) const;
+  /**
+   * \return whether the InterferenceHelper keeps the energy received up
+   *         to now as a running sum
+   */
+  bool GetInterferenceRunningSum (void) const;
   /**
    * Return the transmission gain (dB).
    *
@@ -529,7 +567,12 @@ void Configure80211ah (void);
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
+  /**
+   * Drop the end of PLCP and end of reception events, once they ran or
+   * were cancelled, and with them the packet they hold.
+   */
+  void ReleaseRxEvents (void);
 
   bool     m_initialized;         //!< Flag for runtime initialization
   double   m_edThresholdW;        //!< Energy detection threshold in watts
@@ -541,6 +584,7 @@ void Configure80211ah (void);
   uint32_t m_nTxPower;            //!< Number of available transmission power levels
 
   Ptr<YansWifiChannel> m_channel;        //!< YansWifiChannel that this YansWifiPhy is connected to
+  uint32_t             m_channelIndex;   //!< Index of this YansWifiPhy in the PHY list of m_channel
   uint16_t             m_channelNumber;  //!< Operating channel number
   Ptr<NetDevice>       m_device;         //!< Pointer to the device
   Ptr<MobilityModel>   m_mobility;       //!< Pointer to the mobility model
@@ -21,6 +21,8 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/dcf-manager.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -693,6 +695,247 @@ DcfManagerTest::DoRun (void)
 }
 
 
+/**
+ * A DcfState which always asks for the medium again, with backoffs taken
+ * in turn from a list.
+ */
+class AccessTimeoutState : public DcfState
+{
+public:
+  AccessTimeoutState (DcfManager *manager, const std::vector<uint32_t> *backoffs);
+  void Request (void);
+
+  std::vector<Time> m_grants;
+  uint32_t m_collisions;
+
+private:
+  void StartNextBackoff (void);
+  virtual void DoNotifyAccessGranted (void);
+  virtual void DoNotifyInternalCollision (void);
+  virtual void DoNotifyCollision (void);
+  virtual void DoNotifyChannelSwitching (void);
+  virtual void DoNotifySleep (void);
+  virtual void DoNotifyWakeUp (void);
+
+  DcfManager *m_manager;
+  const std::vector<uint32_t> *m_backoffs;
+  uint32_t m_next;
+};
+
+AccessTimeoutState::AccessTimeoutState (DcfManager *manager, const std::vector<uint32_t> *backoffs)
+  : m_collisions (0),
+    m_manager (manager),
+    m_backoffs (backoffs),
+    m_next (0)
+{
+}
+
+void
+AccessTimeoutState::Request (void)
+{
+  m_manager->RequestAccess (this);
+}
+
+void
+AccessTimeoutState::StartNextBackoff (void)
+{
+  StartBackoffNow ((*m_backoffs)[m_next++ % m_backoffs->size ()]);
+}
+
+void
+AccessTimeoutState::DoNotifyAccessGranted (void)
+{
+  m_grants.push_back (Simulator::Now ());
+  //ask again after a while, sometimes while the medium is busy
+  uint32_t delay = (*m_backoffs)[m_next % m_backoffs->size ()] * 97;
+  StartNextBackoff ();
+  Simulator::Schedule (MicroSeconds (delay), &AccessTimeoutState::Request, this);
+}
+
+void
+AccessTimeoutState::DoNotifyInternalCollision (void)
+{
+  StartNextBackoff ();
+}
+
+void
+AccessTimeoutState::DoNotifyCollision (void)
+{
+  m_collisions++;
+  StartNextBackoff ();
+}
+
+void
+AccessTimeoutState::DoNotifyChannelSwitching (void)
+{
+}
+
+void
+AccessTimeoutState::DoNotifySleep (void)
+{
+}
+
+void
+AccessTimeoutState::DoNotifyWakeUp (void)
+{
+}
+
+/**
+ * Feeds the same random receptions, CCA busy periods and NAVs to a
+ * DcfManager with and one without LazyAccessTimeout, each with a
+ * DcfState always asking for the medium, and checks that both grant the
+ * access at the same times.  The medium stays idle for an EIFS after a
+ * reception error, where the two differ.
+ */
+class LazyAccessTimeoutTest : public TestCase
+{
+public:
+  LazyAccessTimeoutTest ();
+  virtual void DoRun (void);
+
+private:
+  void RxStart (Time duration);
+  void RxEnd (bool ok);
+  void TxStart (Time duration);
+  void CcaBusyStart (Time duration);
+  void NavStart (Time duration);
+
+  DcfManager *m_managers[2];
+};
+
+LazyAccessTimeoutTest::LazyAccessTimeoutTest ()
+  : TestCase ("A lazy access timeout of DcfManager grants the access at the same times")
+{
+}
+
+void
+LazyAccessTimeoutTest::RxStart (Time duration)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_managers[i]->NotifyRxStartNow (duration);
+    }
+}
+
+void
+LazyAccessTimeoutTest::RxEnd (bool ok)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (ok)
+        {
+          m_managers[i]->NotifyRxEndOkNow ();
+        }
+      else
+        {
+          m_managers[i]->NotifyRxEndErrorNow ();
+        }
+    }
+}
+
+void
+LazyAccessTimeoutTest::TxStart (Time duration)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_managers[i]->NotifyTxStartNow (duration);
+    }
+}
+
+void
+LazyAccessTimeoutTest::CcaBusyStart (Time duration)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_managers[i]->NotifyMaybeCcaBusyStartNow (duration);
+    }
+}
+
+void
+LazyAccessTimeoutTest::NavStart (Time duration)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_managers[i]->NotifyNavStartNow (duration);
+    }
+}
+
+void
+LazyAccessTimeoutTest::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<uint32_t> backoffs;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      backoffs.push_back (rng->GetInteger (0, 15));
+    }
+  AccessTimeoutState *states[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_managers[i] = new DcfManager ();
+      m_managers[i]->SetSlot (MicroSeconds (52));
+      m_managers[i]->SetSifs (MicroSeconds (160));
+      m_managers[i]->SetEifsNoDifs (MicroSeconds (160 + 1000));
+      m_managers[i]->SetLazyAccessTimeout (i == 1);
+      states[i] = new AccessTimeoutState (m_managers[i], &backoffs);
+      states[i]->SetAifsn (2);
+      m_managers[i]->Add (states[i]);
+      Simulator::Schedule (MicroSeconds (1), &AccessTimeoutState::Request, states[i]);
+    }
+
+  //the medium, the same for both managers
+  Time t = MicroSeconds (100);
+  while (t < Seconds (2))
+    {
+      t += MicroSeconds (rng->GetInteger (0, 1500));
+      Time duration = MicroSeconds (rng->GetInteger (100, 3000));
+      uint32_t event = rng->GetInteger (0, 4);
+      if (event <= 1)
+        {
+          Simulator::Schedule (t, &LazyAccessTimeoutTest::RxStart, this, duration);
+          Simulator::Schedule (t + duration, &LazyAccessTimeoutTest::RxEnd, this, event == 0);
+          if (event == 1)
+            {
+              duration += MicroSeconds (160 + 1000);
+            }
+        }
+      else if (event == 2)
+        {
+          //a transmission which aborts a reception started within a SIFS
+          Time delay = MicroSeconds (rng->GetInteger (0, 160));
+          Simulator::Schedule (t, &LazyAccessTimeoutTest::RxStart, this, duration);
+          Simulator::Schedule (t + delay, &LazyAccessTimeoutTest::TxStart, this, duration);
+          duration += delay;
+        }
+      else if (event == 3)
+        {
+          Simulator::Schedule (t, &LazyAccessTimeoutTest::CcaBusyStart, this, duration);
+        }
+      else
+        {
+          Simulator::Schedule (t, &LazyAccessTimeoutTest::NavStart, this, duration);
+        }
+      t += duration;
+    }
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_GT (states[0]->m_grants.size (), 100, "too few grants to compare");
+  NS_TEST_EXPECT_MSG_GT (states[0]->m_collisions, 0, "no request while the medium is busy");
+  NS_TEST_ASSERT_MSG_EQ (states[1]->m_grants.size (), states[0]->m_grants.size (), "grant count");
+  for (uint32_t i = 0; i < states[0]->m_grants.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (states[1]->m_grants[i], states[0]->m_grants[i], "grant " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (states[1]->m_collisions, states[0]->m_collisions, "collisions");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      delete m_managers[i];
+      delete states[i];
+    }
+}
+
 class DcfTestSuite : public TestSuite
 {
 public:
@@ -703,6 +946,7 @@ DcfTestSuite::DcfTestSuite ()
   : TestSuite ("devices-wifi-dcf", UNIT)
 {
   AddTestCase (new DcfManagerTest, TestCase::QUICK);
+  AddTestCase (new LazyAccessTimeoutTest, TestCase::QUICK);
 }
 
 static DcfTestSuite g_dcfTestSuite;
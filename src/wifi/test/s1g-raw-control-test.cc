@@ -0,0 +1,827 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/s1g-raw-control.h"
+#include "ns3/s1g-beacon-tag.h"
+#include "ns3/raw-grouping-strategy.h"
+#include "ns3/raw-access-gate.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/packet.h"
+#include "ns3/object-factory.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * Drives two RAW controllers with the same random association,
+ * disassociation and reception history, one through the station lists
+ * ApWifiMac used to pass every beacon and one through the incremental
+ * notifications, and checks that both send the same RPS every beacon.
+ * With offload stations only, the scheduled stations mostly stay the
+ * same, and the incremental controller patches the RPS of the last
+ * beacon.
+ */
+class S1gRawCtrIncrementalTest : public TestCase
+{
+public:
+  S1gRawCtrIncrementalTest (uint16_t maxAid, uint32_t beacons, bool offloadOnly);
+  virtual void DoRun (void);
+
+private:
+  uint16_t m_maxAid;
+  uint32_t m_beacons;
+  bool m_offloadOnly;
+};
+
+S1gRawCtrIncrementalTest::S1gRawCtrIncrementalTest (uint16_t maxAid, uint32_t beacons, bool offloadOnly)
+  : TestCase ("Incremental RAW grouping gives the same RPS as the full recompute"),
+    m_maxAid (maxAid),
+    m_beacons (beacons),
+    m_offloadOnly (offloadOnly)
+{
+}
+
+void
+S1gRawCtrIncrementalTest::DoRun (void)
+{
+  S1gRawCtr full;
+  S1gRawCtr incremental;
+  full.SetTraceEnabled (false);
+  incremental.SetTraceEnabled (false);
+  incremental.SetIncremental (true);
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  //the lists kept by ApWifiMac for the full recompute
+  std::vector<uint16_t> sensorList;
+  std::vector<uint16_t> offloadList;
+  std::vector<uint16_t> receivedAid;
+
+  for (uint32_t beacon = 1; beacon <= m_beacons; beacon++)
+    {
+      uint32_t events = rng->GetInteger (0, 8);
+      for (uint32_t e = 0; e < events; e++)
+        {
+          uint16_t aid = m_offloadOnly ? 16 * rng->GetInteger (1, m_maxAid / 16) : rng->GetInteger (1, m_maxAid);
+          std::vector<uint16_t>::iterator it = std::find (sensorList.begin (), sensorList.end (), aid);
+          if (it != sensorList.end () && rng->GetValue () < 0.3)
+            {
+              sensorList.erase (it);
+              incremental.NotifyDisassociated (aid);
+            }
+          else if (aid % 16 == 0)
+            {
+              if (std::find (offloadList.begin (), offloadList.end (), aid) == offloadList.end ())
+                {
+                  offloadList.push_back (aid);
+                }
+              incremental.NotifyAssociated (aid, 2);
+            }
+          else if (it == sensorList.end ())
+            {
+              sensorList.push_back (aid);
+              incremental.NotifyAssociated (aid, 1);
+            }
+        }
+
+      //scheduled stations mostly get through, a few others too
+      for (std::vector<uint16_t>::const_iterator it = full.m_aidList.begin (); it != full.m_aidList.end (); it++)
+        {
+          uint32_t frames = rng->GetValue () < 0.7 ? rng->GetInteger (1, 3) : 0;
+          for (uint32_t f = 0; f < frames; f++)
+            {
+              receivedAid.push_back (*it);
+            }
+        }
+      for (std::vector<uint16_t>::const_iterator it = full.m_aidOffloadList.begin (); it != full.m_aidOffloadList.end (); it++)
+        {
+          if (rng->GetValue () < 0.5)
+            {
+              receivedAid.push_back (*it);
+            }
+        }
+      uint32_t unsolicited = rng->GetInteger (0, 3);
+      for (uint32_t u = 0; u < unsolicited; u++)
+        {
+          receivedAid.push_back (rng->GetInteger (1, m_maxAid));
+        }
+      for (std::vector<uint16_t>::const_iterator it = receivedAid.begin (); it != receivedAid.end (); it++)
+        {
+          incremental.NotifyReceived (*it);
+        }
+
+      RPS expected = full.UpdateRAWGroupping (sensorList, offloadList, receivedAid, 102400, "");
+      RPS actual = incremental.UpdateRAWGroupping (102400, "");
+      receivedAid.clear ();
+
+      NS_TEST_ASSERT_MSG_EQ (actual.GetInformationFieldSize (), expected.GetInformationFieldSize (),
+                             "RPS length differs at beacon " << beacon);
+      NS_TEST_ASSERT_MSG_EQ (std::memcmp (actual.GetRawAssignment (), expected.GetRawAssignment (),
+                                          expected.GetInformationFieldSize ()), 0,
+                             "RPS content differs at beacon " << beacon);
+      NS_TEST_ASSERT_MSG_EQ ((incremental.m_aidList == full.m_aidList), true,
+                             "scheduled stations differ at beacon " << beacon);
+    }
+}
+
+/**
+ * Gives the RAW controller more active offload stations than the RAW
+ * Assignment subfields one RPS can carry, and checks that the RPS stays
+ * within them.
+ */
+class S1gRawCtrRpsCapTest : public TestCase
+{
+public:
+  S1gRawCtrRpsCapTest ();
+  virtual void DoRun (void);
+};
+
+S1gRawCtrRpsCapTest::S1gRawCtrRpsCapTest ()
+  : TestCase ("RAW controller fits its RAW assignments in one RPS")
+{
+}
+
+void
+S1gRawCtrRpsCapTest::DoRun (void)
+{
+  S1gRawCtr ctr;
+  ctr.SetTraceEnabled (false);
+  std::vector<uint16_t> sensorList;
+  std::vector<uint16_t> offloadList;
+  for (uint16_t aid = 1; aid <= 60; aid++)
+    {
+      offloadList.push_back (aid);
+    }
+  for (uint32_t beacon = 1; beacon <= 5; beacon++)
+    {
+      RPS rps = ctr.UpdateRAWGroupping (sensorList, offloadList, offloadList, 102400, "");
+      NS_TEST_ASSERT_MSG_GT (rps.GetNRawAssignments (), 1, "no offload station scheduled at beacon " << beacon);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (rps.GetNRawAssignments (), RPS::MAX_RAW_ASSIGNMENTS,
+                                   "too many RAW assignments at beacon " << beacon);
+      NS_TEST_ASSERT_MSG_EQ (rps.GetNRawAssignments (), ctr.m_aidList.size () + ctr.m_aidOffloadList.size (),
+                             "one RAW per scheduled station at beacon " << beacon);
+    }
+}
+
+/**
+ * Checks that the beacon a station gets from the S1gBeaconTag is the one
+ * it would have parsed from the packet, and that a tag referring to a
+ * beacon that has left the table of recent beacons, or to a cleared
+ * table, no longer resolves.
+ */
+class S1gBeaconTagTest : public TestCase
+{
+public:
+  S1gBeaconTagTest ();
+  virtual void DoRun (void);
+};
+
+S1gBeaconTagTest::S1gBeaconTagTest ()
+  : TestCase ("Beacon shared through S1gBeaconTag matches the parsed beacon")
+{
+}
+
+void
+S1gBeaconTagTest::DoRun (void)
+{
+  S1gBeaconHeader beacon;
+  S1gBeaconCompatibility compatibility;
+  compatibility.SetBeaconInterval (102400);
+  beacon.SetBeaconCompatibility (compatibility);
+  RPS rps;
+  for (uint16_t i = 0; i < 3; i++)
+    {
+      RPS::RawAssignment raw;
+      raw.SetRawControl (i == 1 ? 4 : 0);
+      raw.SetSlotCrossBoundary (1);
+      raw.SetSlotFormat (1);
+      raw.SetSlotDurationCount (100 + i);
+      raw.SetSlotNum (2 + i);
+      uint32_t aidStart = 1 + 10 * i;
+      uint32_t aidEnd = 10 + 10 * i;
+      raw.SetRawGroup ((aidEnd << 13) | (aidStart << 2) | i);
+      rps.SetRawAssignment (raw);
+    }
+  beacon.SetRPS (rps);
+  AuthenticationCtrl auth;
+  auth.SetControlType (false);
+  auth.SetThreshold (650);
+  beacon.SetAuthCtrl (auth);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (beacon);
+  S1gBeaconHeader decoded;
+  packet->PeekHeader (decoded);
+  S1gBeaconTable table;
+  S1gBeaconTag tag;
+  tag.SetBeaconInfo (table, Create<S1gBeaconInfo> (decoded));
+  packet->AddPacketTag (tag);
+
+  //what a station receives
+  Ptr<Packet> received = packet->Copy ();
+  S1gBeaconTag receivedTag;
+  NS_TEST_ASSERT_MSG_EQ (received->PeekPacketTag (receivedTag), true, "tag lost in copy");
+  Ptr<const S1gBeaconInfo> shared = receivedTag.GetBeaconInfo ();
+  NS_TEST_ASSERT_MSG_NE (shared, 0, "tag does not resolve");
+  S1gBeaconHeader parsed;
+  received->RemoveHeader (parsed);
+  S1gBeaconInfo expected (parsed);
+
+  NS_TEST_ASSERT_MSG_EQ (shared->GetHeader ().GetBeaconCompatibility ().GetBeaconInterval (), 102400, "beacon interval");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetHeader ().GetAuthCtrl ().GetThreshold (), 650, "authentication threshold");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetRawDurationUs (), expected.GetRawDurationUs (), "total RAW duration");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetRaws ().size (), 3, "number of RAWs");
+  NS_TEST_ASSERT_MSG_EQ (expected.GetRaws ().size (), 3, "number of parsed RAWs");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      const S1gBeaconInfo::Raw & a = shared->GetRaws ()[i];
+      const S1gBeaconInfo::Raw & b = expected.GetRaws ()[i];
+      NS_TEST_ASSERT_MSG_EQ (a.rawType, b.rawType, "RAW type of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.page, i, "page of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.page, b.page, "page of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.rawStartAid, 1 + 10 * i, "start AID of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.rawStartAid, b.rawStartAid, "start AID of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.rawEndAid, b.rawEndAid, "end AID of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.slotDurationCount, b.slotDurationCount, "slot duration of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.slotNum, b.slotNum, "slot number of RAW " << i);
+      NS_TEST_ASSERT_MSG_EQ (a.startUs, b.startUs, "start of RAW " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (shared->GetRaws ()[2].startUs, (500 + 100 * 120) * 2 + (500 + 101 * 120) * 3, "start of the last RAW");
+
+  //enough newer beacons push this one out of the table
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      S1gBeaconTag other;
+      other.SetBeaconInfo (table, Create<S1gBeaconInfo> (decoded));
+    }
+  NS_TEST_ASSERT_MSG_EQ (receivedTag.GetBeaconInfo (), 0, "stale tag still resolves");
+  S1gBeaconTag recent;
+  recent.SetBeaconInfo (table, Create<S1gBeaconInfo> (decoded));
+  NS_TEST_ASSERT_MSG_NE (recent.GetBeaconInfo (), 0, "recent tag does not resolve");
+  table.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (recent.GetBeaconInfo (), 0, "tag resolves once the table is cleared");
+  NS_TEST_ASSERT_MSG_EQ (S1gBeaconTag ().GetBeaconInfo (), 0, "empty tag resolves");
+}
+
+/**
+ * Checks the slot S1gBeaconInfo finds for every AID against a scan of
+ * all the RAW assignments, on random RPS elements with overlapping RAW
+ * groups spread over the four pages.
+ */
+class S1gBeaconInfoSlotTest : public TestCase
+{
+public:
+  S1gBeaconInfoSlotTest ();
+  virtual void DoRun (void);
+};
+
+S1gBeaconInfoSlotTest::S1gBeaconInfoSlotTest ()
+  : TestCase ("RAW slot lookup gives the slot of a scan of the RAW assignments")
+{
+}
+
+void
+S1gBeaconInfoSlotTest::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+
+  for (uint32_t run = 0; run < 50; run++)
+    {
+      uint16_t nRaws = rng->GetInteger (0, 42);
+      std::vector<RPS::RawAssignment> assignments;
+      RPS rps;
+      for (uint16_t i = 0; i < nRaws; i++)
+        {
+          RPS::RawAssignment raw;
+          raw.SetRawControl (rng->GetInteger (0, 7));
+          raw.SetSlotCrossBoundary (1);
+          raw.SetSlotFormat (1);
+          raw.SetSlotDurationCount (rng->GetInteger (0, 2047));
+          raw.SetSlotNum (rng->GetInteger (1, 7));
+          uint32_t page = rng->GetInteger (0, 3);
+          uint32_t aidStart = rng->GetInteger (0, 1023);
+          uint32_t aidEnd = rng->GetInteger (0, 1023);
+          raw.SetRawGroup ((aidEnd << 13) | (aidStart << 2) | page);
+          rps.SetRawAssignment (raw);
+          assignments.push_back (raw);
+        }
+      S1gBeaconHeader beacon;
+      beacon.SetRPS (rps);
+      S1gBeaconInfo info (beacon);
+
+      for (uint16_t aid = 0; aid < 8192; aid++)
+        {
+          //the last RAW including the station gives its slot
+          bool expectedFound = false;
+          uint64_t expectedStart = 0;
+          uint64_t expectedDuration = 0;
+          uint64_t rawStart = 0;
+          for (std::vector<RPS::RawAssignment>::const_iterator it = assignments.begin (); it != assignments.end (); ++it)
+            {
+              uint64_t duration = 500 + it->GetSlotDurationCount () * 120;
+              uint32_t group = it->GetRawGroup ();
+              uint16_t start = (group >> 2) & 0x03ff;
+              uint16_t end = (group >> 13) & 0x03ff;
+              if ((group & 0x03) == ((aid >> 11) & 0x03)
+                  && start <= (aid & 0x03ff) && (aid & 0x03ff) <= end)
+                {
+                  expectedFound = true;
+                  expectedStart = duration * ((aid & 0x03ff) % it->GetSlotNum ()) + rawStart;
+                  expectedDuration = duration;
+                }
+              rawStart += duration * it->GetSlotNum ();
+            }
+
+          S1gBeaconInfo::Slot slot;
+          bool found = info.FindSlot (aid, slot);
+          NS_TEST_ASSERT_MSG_EQ (found, expectedFound, "AID " << aid << " in run " << run);
+          if (found && expectedFound)
+            {
+              NS_TEST_ASSERT_MSG_EQ (slot.startUs, expectedStart, "slot start of AID " << aid << " in run " << run);
+              NS_TEST_ASSERT_MSG_EQ (slot.durationUs, expectedDuration, "slot duration of AID " << aid << " in run " << run);
+            }
+        }
+    }
+}
+
+/**
+ * Checks that the batched estimate of SensorTable gives the same
+ * transmission intervals and next transmission ids as
+ * Sensor::EstimateTransmissionInterval, over random reception histories
+ * covering all of its cases.
+ */
+class SensorEstimateBatchTest : public TestCase
+{
+public:
+  SensorEstimateBatchTest ();
+  virtual void DoRun (void);
+};
+
+SensorEstimateBatchTest::SensorEstimateBatchTest ()
+  : TestCase ("Batched transmission interval estimate matches the per-sensor one")
+{
+}
+
+void
+SensorEstimateBatchTest::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (3);
+
+  const uint16_t nSensors = 300;
+  SensorTable scalar;
+  SensorTable batched;
+  for (uint16_t aid = 1; aid <= nSensors; aid++)
+    {
+      scalar.Add (aid);
+      batched.Add (aid);
+    }
+
+  std::vector<uint16_t> aids;
+  for (uint64_t beacon = 1; beacon <= 400; beacon++)
+    {
+      aids.clear ();
+      for (uint16_t aid = 1; aid <= nSensors; aid++)
+        {
+          if (rng->GetInteger (0, 2) != 0)
+            {
+              continue;
+            }
+          aids.push_back (aid);
+          bool success = rng->GetInteger (0, 3) != 0;
+          uint16_t received = rng->GetInteger (0, 4);
+          SensorTable * tables[] = { &scalar, &batched };
+          for (uint32_t t = 0; t < 2; t++)
+            {
+              Sensor * sensor = tables[t]->Lookup (aid);
+              UpdateInfo & info = sensor->GetUpdateInfo ();
+              info.preTrySuccess = info.CurrentTrySuccess;
+              info.CurrentTrySuccess = success;
+              if (success)
+                {
+                  info.preSuccessId = info.CurrentSuccessId;
+                  info.CurrentSuccessId = beacon;
+                }
+              sensor->SetTransmissionSuccess (success);
+              sensor->SetNumPacketsReceived (received);
+            }
+        }
+
+      for (std::vector<uint16_t>::const_iterator it = aids.begin (); it != aids.end (); it++)
+        {
+          scalar.Lookup (*it)->EstimateTransmissionInterval (beacon, 102400);
+        }
+      batched.EstimateTransmissionIntervals (aids, beacon);
+
+      for (uint16_t aid = 1; aid <= nSensors; aid++)
+        {
+          Sensor * expected = scalar.Lookup (aid);
+          Sensor * actual = batched.Lookup (aid);
+          NS_TEST_ASSERT_MSG_EQ (actual->GetEstimateNextTransmissionId (), expected->GetEstimateNextTransmissionId (),
+                                 "next transmission id of AID " << aid << " at beacon " << beacon);
+          NS_TEST_ASSERT_MSG_EQ (actual->GetTransInOneBeacon (), expected->GetTransInOneBeacon (),
+                                 "transmissions in one beacon of AID " << aid << " at beacon " << beacon);
+          for (uint16_t i = 0; i < SensorTable::TRANS_INTERVAL_LIST_SIZE; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (actual->GetTransInterval (i), expected->GetTransInterval (i),
+                                     "interval " << i << " of AID " << aid << " at beacon " << beacon);
+            }
+        }
+    }
+}
+
+/**
+ * Checks the RAW groups of LoadRawGrouping: every associated station has
+ * a slot, no slot expects more frames than the busiest one the solver
+ * reports, the RAWs fit in the beacon interval, and no split of the
+ * stations in groups of consecutive AIDs fits with a busiest slot
+ * expecting 10% fewer frames.
+ */
+class LoadRawGroupingTest : public TestCase
+{
+public:
+  LoadRawGroupingTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \return whether some split of the stations in at most 42 groups of
+   *         consecutive AIDs, with at most maxSlotLoad expected frames
+   *         per slot, fits in the beacon interval; found by dynamic
+   *         programming over all the splits
+   */
+  bool SplitFits (const std::vector<uint16_t> &aids, const std::vector<double> &loads,
+                  double maxSlotLoad) const;
+  /**
+   * \return the most frames expected in one slot
+   */
+  double CheckRps (const RPS &rps, const std::vector<uint16_t> &aids,
+                   const std::vector<double> &loads, std::string label);
+  void CheckSolution (const std::vector<uint16_t> &aids, const std::vector<double> &loads,
+                      bool optimal, std::string label);
+};
+
+LoadRawGroupingTest::LoadRawGroupingTest ()
+  : TestCase ("RAW groups sized after the load of the stations")
+{
+}
+
+bool
+LoadRawGroupingTest::SplitFits (const std::vector<uint16_t> &aids, const std::vector<double> &loads,
+                                double maxSlotLoad) const
+{
+  //best[g][j]: microseconds needed by the first j stations in g groups
+  std::vector<std::vector<double> > best (43, std::vector<double> (aids.size () + 1, -1));
+  best[0][0] = 0;
+  for (uint32_t g = 0; g < 42; g++)
+    {
+      for (uint32_t i = 0; i < aids.size (); i++)
+        {
+          if (best[g][i] < 0)
+            {
+              continue;
+            }
+          double slot[8][7] = {};
+          double busiest[8] = {};
+          for (uint32_t j = i; j < aids.size () && (aids[j] >> 11) == (aids[i] >> 11); j++)
+            {
+              double groupUs = -1;
+              for (uint16_t s = 1; s <= 7; s++)
+                {
+                  slot[s][(aids[j] & 0x03ff) % s] += loads[j];
+                  busiest[s] = std::max (busiest[s], slot[s][(aids[j] & 0x03ff) % s]);
+                  if (busiest[s] <= maxSlotLoad)
+                    {
+                      double us = s * 2000 * std::max (1.0, busiest[s]);
+                      groupUs = groupUs < 0 ? us : std::min (groupUs, us);
+                    }
+                }
+              if (groupUs < 0)
+                {
+                  break;
+                }
+              double & next = best[g + 1][j + 1];
+              if (next < 0 || best[g][i] + groupUs < next)
+                {
+                  next = best[g][i] + groupUs;
+                }
+            }
+        }
+    }
+  for (uint32_t g = 1; g <= 42; g++)
+    {
+      double availableUs = 102400 - (((g * 6 + 60) * 8 + 14) / 12 * 40 + 560);
+      if (best[g].back () >= 0 && best[g].back () <= availableUs)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+double
+LoadRawGroupingTest::CheckRps (const RPS &rps, const std::vector<uint16_t> &aids,
+                               const std::vector<double> &loads, std::string label)
+{
+  S1gBeaconHeader beacon;
+  beacon.SetRPS (rps);
+  Ptr<S1gBeaconInfo> info = Create<S1gBeaconInfo> (beacon);
+  uint32_t nGroups = info->GetRaws ().size ();
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (nGroups, 42, label << ": number of RAW groups");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (info->GetRawDurationUs (), 102400 - (((nGroups * 6 + 60) * 8 + 14) / 12 * 40 + 560),
+                               label << ": RAWs longer than the beacon interval");
+  std::map<std::pair<uint16_t, uint16_t>, double> slotLoads;
+  double busiest = 0;
+  for (uint32_t i = 0; i < aids.size (); i++)
+    {
+      S1gBeaconInfo::Slot slot;
+      bool found = info->FindSlot (aids[i], slot);
+      NS_TEST_EXPECT_MSG_EQ (found, true, label << ": no slot for AID " << aids[i]);
+      double & load = slotLoads[std::make_pair (slot.rawIndex, slot.slot)];
+      load += loads[i];
+      busiest = std::max (busiest, load);
+    }
+  return busiest;
+}
+
+void
+LoadRawGroupingTest::CheckSolution (const std::vector<uint16_t> &aids, const std::vector<double> &loads,
+                                    bool optimal, std::string label)
+{
+  Ptr<LoadRawGrouping> grouping = CreateObjectWithAttributes<LoadRawGrouping> ("Smoothing", DoubleValue (0));
+  for (uint32_t i = 0; i < aids.size (); i++)
+    {
+      grouping->NotifyAssociated (aids[i], 1);
+      grouping->SetLoad (aids[i], loads[i] / 0.1024);
+    }
+  double reported = 0;
+  const std::vector<LoadRawGrouping::Group> & groups = grouping->Solve (102400);
+  for (uint32_t g = 0; g < groups.size (); g++)
+    {
+      reported = std::max (reported, groups[g].maxSlotLoad);
+    }
+  double busiest = CheckRps (grouping->GetRps (102400), aids, loads, label);
+  NS_TEST_EXPECT_MSG_EQ_TOL (busiest, reported, 1e-9 * reported, label << ": busiest slot");
+  //no slot can expect fewer frames than the busiest station sends
+  if (optimal && 0.9 * busiest >= *std::max_element (loads.begin (), loads.end ()))
+    {
+      NS_TEST_EXPECT_MSG_EQ (SplitFits (aids, loads, 0.9 * busiest), false,
+                             label << ": a split with less contention fits");
+    }
+}
+
+void
+LoadRawGroupingTest::DoRun (void)
+{
+  //one frame per beacon each: a slot for every station
+  std::vector<uint16_t> aids;
+  std::vector<double> loads;
+  for (uint16_t aid = 1; aid <= 8; aid++)
+    {
+      aids.push_back (aid);
+      loads.push_back (1);
+    }
+  CheckSolution (aids, loads, false, "one frame per station");
+  Ptr<LoadRawGrouping> grouping = CreateObjectWithAttributes<LoadRawGrouping> ("Smoothing", DoubleValue (0));
+  for (uint32_t i = 0; i < aids.size (); i++)
+    {
+      grouping->NotifyAssociated (aids[i], 1);
+      grouping->SetLoad (aids[i], 1 / 0.1024);
+    }
+  const std::vector<LoadRawGrouping::Group> & groups = grouping->Solve (102400);
+  for (uint32_t g = 0; g < groups.size (); g++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (groups[g].maxSlotLoad, 1, 1e-9, "station sharing a slot");
+    }
+
+  //random loads over two pages
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+  for (uint32_t run = 0; run < 4; run++)
+    {
+      aids.clear ();
+      loads.clear ();
+      for (uint16_t page = 0; page < 2; page++)
+        {
+          for (uint16_t aid = 1 + rng->GetInteger (0, 4); aid < 1024; aid += 1 + rng->GetInteger (0, 4))
+            {
+              aids.push_back ((page << 11) | aid);
+              loads.push_back (rng->GetValue () < 0.8 ? rng->GetValue (0, 0.04) : rng->GetValue (0, 0.2));
+            }
+        }
+      std::ostringstream label;
+      label << "random loads, run " << run;
+      CheckSolution (aids, loads, true, label.str ());
+    }
+
+  //more frames than one beacon interval carries
+  aids.clear ();
+  loads.clear ();
+  for (uint16_t aid = 1; aid <= 100; aid++)
+    {
+      aids.push_back (aid);
+      loads.push_back (5);
+    }
+  CheckSolution (aids, loads, false, "overload");
+
+  //the loads follow the received frames
+  grouping = CreateObjectWithAttributes<LoadRawGrouping> ("Smoothing", DoubleValue (0.5));
+  grouping->NotifyAssociated (3, 1);
+  grouping->SetLoad (3, 10);
+  for (uint32_t f = 0; f < 4; f++)
+    {
+      grouping->NotifyReceived (3);
+    }
+  grouping->GetRps (102400);
+  NS_TEST_EXPECT_MSG_EQ_TOL (grouping->GetLoad (3), 0.5 * 10 + 0.5 * 4 / 0.1024, 1e-9, "smoothed load");
+  grouping->GetRps (102400);
+  NS_TEST_EXPECT_MSG_EQ_TOL (grouping->GetLoad (3), 0.25 * 10 + 0.25 * 4 / 0.1024, 1e-9, "load without frames");
+}
+
+/**
+ * Checks that a RawAccessGate opens and closes its queues at the
+ * boundaries it schedules, and notifies every queue, in order, from the
+ * single event of each boundary.
+ */
+class RawAccessGateTest : public TestCase
+{
+public:
+  RawAccessGateTest ();
+  virtual void DoRun (void);
+
+private:
+  struct Call
+  {
+    Time at;
+    char kind;     //!< 'w' wake up, 's' RAW start, 'o' outside RAW
+    int32_t queue; //!< -1 for the wake up
+    bool allowed;  //!< whether the gate allowed the queue at the call
+  };
+
+  static void RawStart (RawAccessGateTest *test, int32_t queue);
+  static void OutsideRawStart (RawAccessGateTest *test, int32_t queue);
+  void WakeUp (void);
+  void Record (char kind, int32_t queue);
+  void Beacon (Time slotStart, Time slotDuration, Time rawDuration);
+  void CheckAllowed (bool allowed);
+  void CheckCall (uint32_t i, Time at, char kind, int32_t queue, bool allowed);
+
+  Ptr<RawAccessGate> m_gate;
+  std::vector<Call> m_calls;
+};
+
+RawAccessGateTest::RawAccessGateTest ()
+  : TestCase ("RAW access gate notifies all the queues at each RAW boundary")
+{
+}
+
+void
+RawAccessGateTest::Record (char kind, int32_t queue)
+{
+  Call call;
+  call.at = Simulator::Now ();
+  call.kind = kind;
+  call.queue = queue;
+  call.allowed = queue < 0 || m_gate->IsAllowed (queue);
+  m_calls.push_back (call);
+}
+
+void
+RawAccessGateTest::RawStart (RawAccessGateTest *test, int32_t queue)
+{
+  test->Record ('s', queue);
+}
+
+void
+RawAccessGateTest::OutsideRawStart (RawAccessGateTest *test, int32_t queue)
+{
+  //as the queues do, reopen before restarting the backoff
+  test->m_gate->SetAllowed (queue, true);
+  test->Record ('o', queue);
+}
+
+void
+RawAccessGateTest::WakeUp (void)
+{
+  Record ('w', -1);
+}
+
+void
+RawAccessGateTest::Beacon (Time slotStart, Time slotDuration, Time rawDuration)
+{
+  m_gate->CancelRawEnd ();
+  m_gate->ScheduleRawEnd (rawDuration);
+  m_gate->SetAllAllowed (false);
+  m_gate->ScheduleSlot (slotStart, slotDuration);
+}
+
+void
+RawAccessGateTest::CheckAllowed (bool allowed)
+{
+  for (int32_t queue = 0; queue < 3; queue++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_gate->IsAllowed (queue), allowed, "queue " << queue << " at " << Simulator::Now ());
+    }
+}
+
+void
+RawAccessGateTest::CheckCall (uint32_t i, Time at, char kind, int32_t queue, bool allowed)
+{
+  NS_TEST_ASSERT_MSG_LT (i, m_calls.size (), "missing call " << i);
+  NS_TEST_EXPECT_MSG_EQ (m_calls[i].at, at, "time of call " << i);
+  NS_TEST_EXPECT_MSG_EQ (m_calls[i].kind, kind, "kind of call " << i);
+  NS_TEST_EXPECT_MSG_EQ (m_calls[i].queue, queue, "queue of call " << i);
+  NS_TEST_EXPECT_MSG_EQ (m_calls[i].allowed, allowed, "gate at call " << i);
+}
+
+void
+RawAccessGateTest::DoRun (void)
+{
+  m_gate = Create<RawAccessGate> ();
+  m_gate->SetWakeUpCallback (MakeCallback (&RawAccessGateTest::WakeUp, this));
+  for (int32_t queue = 0; queue < 3; queue++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_gate->AddQueue (MakeBoundCallback (&RawAccessGateTest::RawStart, this, queue),
+                                               MakeBoundCallback (&RawAccessGateTest::OutsideRawStart, this, queue)),
+                             (uint32_t) queue, "index of a new queue");
+    }
+  CheckAllowed (true);
+
+  //a RAW from 1 s to 1.010 s, with the slot of the station from 1.002 s to 1.005 s
+  Simulator::Schedule (Seconds (1), &RawAccessGateTest::Beacon, this,
+                       MilliSeconds (2), MilliSeconds (3), MilliSeconds (10));
+  Simulator::Schedule (MilliSeconds (1001), &RawAccessGateTest::CheckAllowed, this, false);
+  Simulator::Schedule (MilliSeconds (1003), &RawAccessGateTest::CheckAllowed, this, true);
+  Simulator::Schedule (MilliSeconds (1006), &RawAccessGateTest::CheckAllowed, this, false);
+  Simulator::Schedule (MilliSeconds (1011), &RawAccessGateTest::CheckAllowed, this, true);
+  //a beacon before the slot and the end of its RAW replaces them
+  Simulator::Schedule (Seconds (2), &RawAccessGateTest::Beacon, this,
+                       MilliSeconds (2), MilliSeconds (3), MilliSeconds (10));
+  Simulator::Schedule (MilliSeconds (2001), &RawAccessGateTest::Beacon, this,
+                       MilliSeconds (4), MilliSeconds (1), MilliSeconds (20));
+  Simulator::Schedule (MilliSeconds (2012), &RawAccessGateTest::CheckAllowed, this, false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 16, "calls to the queues");
+  for (uint32_t raw = 0; raw < 2; raw++)
+    {
+      Time slot = raw == 0 ? MilliSeconds (1002) : MilliSeconds (2005);
+      Time end = raw == 0 ? MilliSeconds (1010) : MilliSeconds (2021);
+      CheckCall (raw * 8, slot, 'w', -1, true);
+      for (int32_t queue = 0; queue < 3; queue++)
+        {
+          CheckCall (raw * 8 + 1 + queue, slot, 's', queue, true);
+        }
+      CheckCall (raw * 8 + 4, end, 'w', -1, true);
+      for (int32_t queue = 0; queue < 3; queue++)
+        {
+          CheckCall (raw * 8 + 5 + queue, end, 'o', queue, true);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_gate->IsRawEndPending (), false, "RAW end after the simulation");
+  m_gate = 0;
+}
+
+class S1gRawCtrTestSuite : public TestSuite
+{
+public:
+  S1gRawCtrTestSuite ();
+};
+
+S1gRawCtrTestSuite::S1gRawCtrTestSuite ()
+  : TestSuite ("devices-wifi-s1g-raw-control", UNIT)
+{
+  AddTestCase (new S1gRawCtrIncrementalTest (64, 500, false), TestCase::QUICK);
+  AddTestCase (new S1gRawCtrIncrementalTest (2000, 300, false), TestCase::QUICK);
+  AddTestCase (new S1gRawCtrIncrementalTest (640, 300, true), TestCase::QUICK);
+  AddTestCase (new S1gRawCtrRpsCapTest, TestCase::QUICK);
+  AddTestCase (new S1gBeaconTagTest, TestCase::QUICK);
+  AddTestCase (new S1gBeaconInfoSlotTest, TestCase::QUICK);
+  AddTestCase (new SensorEstimateBatchTest, TestCase::QUICK);
+  AddTestCase (new LoadRawGroupingTest, TestCase::QUICK);
+  AddTestCase (new RawAccessGateTest, TestCase::QUICK);
+}
+
+static S1gRawCtrTestSuite g_s1gRawCtrTestSuite;
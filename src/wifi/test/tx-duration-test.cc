@@ -21,9 +21,14 @@
 #include <ns3/object.h>
 #include <ns3/log.h>
 #include <ns3/test.h>
-#include <iostream>
 #include "ns3/interference-helper.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +283,74 @@ TxDurationTest::DoRun (void)
 }
 
 
+/**
+ * Checks that the TxDurationCache of WifiPhy and the PerCache of
+ * YansErrorRateModel give the same durations and chunk success rates as
+ * the computations they skip, and that the PerTableResolution tables stay
+ * close to them.
+ */
+class PhyTablesTest : public TestCase
+{
+public:
+  PhyTablesTest ();
+  virtual void DoRun (void);
+};
+
+PhyTablesTest::PhyTablesTest ()
+  : TestCase ("WifiPhy and YansErrorRateModel caches give the exact results")
+{
+}
+
+void
+PhyTablesTest::DoRun (void)
+{
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetOfdmRate650KbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate1_3MbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate2_6MbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate3_9MbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate5_85MbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate7_8MbpsBW2MHz ());
+  modes.push_back (WifiPhy::GetOfdmRate8_666_7MbpsBW2MHz ());
+  Ptr<YansWifiPhy> exactPhy = CreateObject<YansWifiPhy> ();
+  exactPhy->SetAttribute ("TxDurationCache", BooleanValue (false));
+  Ptr<YansWifiPhy> cachedPhy = CreateObject<YansWifiPhy> ();
+  Ptr<YansErrorRateModel> exactError = CreateObject<YansErrorRateModel> ();
+  exactError->SetAttribute ("PerCache", BooleanValue (false));
+  Ptr<YansErrorRateModel> cachedError = CreateObject<YansErrorRateModel> ();
+  Ptr<YansErrorRateModel> tableError = CreateObject<YansErrorRateModel> ();
+  tableError->SetAttribute ("PerTableResolution", DoubleValue (0.05));
+  enum WifiPreamble preambles[] = { WIFI_PREAMBLE_S1G_SHORT, WIFI_PREAMBLE_S1G_LONG };
+  double frequency = exactPhy->GetFrequency ();
+
+  //twice, for the second pass to hit the caches
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); mode++)
+        {
+          WifiTxVector txVector (*mode, 0, 0, false, 1, 0, false);
+          for (uint32_t p = 0; p < 2; p++)
+            {
+              for (uint32_t size = 14; size < 1600; size += 97)
+                {
+                  NS_TEST_EXPECT_MSG_EQ (cachedPhy->CalculateTxDuration (size, txVector, preambles[p], frequency, 0, 0),
+                                         exactPhy->CalculateTxDuration (size, txVector, preambles[p], frequency, 0, 0),
+                                         "duration of " << size << " bytes at " << *mode);
+                }
+            }
+          for (double db = -5; db < 40; db += 0.37)
+            {
+              double snr = std::pow (10.0, db / 10);
+              double exact = exactError->GetChunkSuccessRate (*mode, snr, 8000);
+              NS_TEST_EXPECT_MSG_EQ (cachedError->GetChunkSuccessRate (*mode, snr, 8000), exact,
+                                     "success rate at " << db << " dB with " << *mode);
+              NS_TEST_EXPECT_MSG_EQ_TOL (tableError->GetChunkSuccessRate (*mode, snr, 8000), exact, 0.01,
+                                         "table success rate at " << db << " dB with " << *mode);
+            }
+        }
+    }
+}
+
 class TxDurationTestSuite : public TestSuite
 {
 public:
@@ -287,6 +360,7 @@ public:
 TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
+  AddTestCase (new PhyTablesTest, TestCase::QUICK);
   AddTestCase (new TxDurationTest, TestCase::QUICK);
 }
 
@@ -41,6 +41,24 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/interference-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/address-hash-table.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mac-low.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include <map>
+#include <limits>
+#include <cmath>
+#include <list>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -76,6 +94,30 @@ AssignWifiRandomStreams (Ptr<WifiMac> mac, int64_t stream)
     }
 }
 
+/**
+ * \param channel the channel of the PHY
+ * \param position the position of the PHY, which stands still
+ * \param receive the callback of the frames received, if any
+ * \return an 802.11a YansWifiPhy on channel
+ */
+static Ptr<YansWifiPhy>
+CreateYansWifiPhy (Ptr<YansWifiChannel> channel, Vector position,
+                   WifiPhy::RxOkCallback receive = WifiPhy::RxOkCallback ())
+{
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (position);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  if (!receive.IsNull ())
+    {
+      phy->SetReceiveOkCallback (receive);
+    }
+  return phy;
+}
+
 
 class WifiTest : public TestCase
 {
@@ -482,6 +524,1011 @@ Bug555TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Checks that a dozing PHY gets nothing from the channel, and that on
+ * wake up it senses the frames still in the air and receives the frames
+ * still propagating.  A PHY which falls asleep right after a frame is
+ * sent already got it, and does not get it again on wake up.  A far PHY
+ * gets the frames still propagating to it long after they left the air
+ * next to the sender.
+ */
+class RawDozeChannelTest : public TestCase
+{
+public:
+  RawDozeChannelTest ();
+  virtual void DoRun (void);
+
+private:
+  void Send (void);
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void ReceiveOther (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void ReceiveFar (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void CheckState (bool ccaBusy, bool idle);
+
+  Ptr<YansWifiPhy> m_tx;    //!< sending PHY
+  Ptr<YansWifiPhy> m_rx;    //!< dozing PHY
+  Ptr<YansWifiPhy> m_other; //!< PHY falling asleep after a frame is sent
+  Ptr<YansWifiPhy> m_far;   //!< PHY 10 ms away
+  uint32_t m_received;      //!< number of frames received by m_rx
+  uint32_t m_receivedOther; //!< number of frames received by m_other
+  uint32_t m_receivedFar;   //!< number of frames received by m_far
+};
+
+RawDozeChannelTest::RawDozeChannelTest ()
+  : TestCase ("Dozing PHY is skipped by the channel and catches up on wake up")
+{
+}
+
+void
+RawDozeChannelTest::Send (void)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  m_tx->SendPacket (Create<Packet> (1000), txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+RawDozeChannelTest::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_received++;
+}
+
+void
+RawDozeChannelTest::ReceiveOther (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_receivedOther++;
+}
+
+void
+RawDozeChannelTest::ReceiveFar (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_receivedFar++;
+}
+
+void
+RawDozeChannelTest::CheckState (bool ccaBusy, bool idle)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_rx->IsStateCcaBusy (), ccaBusy, "CCA busy at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (m_rx->IsStateIdle (), idle, "idle at " << Simulator::Now ());
+}
+
+void
+RawDozeChannelTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<MatrixPropagationLossModel> loss = CreateObject<MatrixPropagationLossModel> ();
+  loss->SetDefaultLoss (50);
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_tx = CreateYansWifiPhy (channel, Vector (0.0, 0.0, 0.0));
+  m_rx = CreateYansWifiPhy (channel, Vector (5.0, 0.0, 0.0));
+  m_other = CreateYansWifiPhy (channel, Vector (3000.0, 0.0, 0.0));
+  m_far = CreateYansWifiPhy (channel, Vector (3e6, 0.0, 0.0));
+  m_rx->SetReceiveOkCallback (MakeCallback (&RawDozeChannelTest::Receive, this));
+  m_other->SetReceiveOkCallback (MakeCallback (&RawDozeChannelTest::ReceiveOther, this));
+  m_far->SetReceiveOkCallback (MakeCallback (&RawDozeChannelTest::ReceiveFar, this));
+  m_received = 0;
+  m_receivedOther = 0;
+  m_receivedFar = 0;
+  //the far PHY sleeps through all but the last frames
+  Simulator::Schedule (Seconds (0.5), &YansWifiPhy::SetSleepMode, m_far);
+
+  //a 1000 byte frame at 6 Mbit/s lasts about 1.4 ms; the PHY wakes up
+  //in the middle of it and senses the rest without receiving it
+  Simulator::Schedule (Seconds (0.5), &YansWifiPhy::SetSleepMode, m_rx);
+  Simulator::Schedule (Seconds (1.0), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (1.0005), &YansWifiPhy::ResumeFromSleep, m_rx);
+  Simulator::Schedule (Seconds (1.0006), &RawDozeChannelTest::CheckState, this, true, false);
+  Simulator::Schedule (Seconds (1.002), &RawDozeChannelTest::CheckState, this, false, true);
+
+  //the PHY wakes up while the frame propagates and receives it
+  Simulator::Schedule (Seconds (2.0), &YansWifiPhy::SetSleepMode, m_rx);
+  Simulator::Schedule (Seconds (3.0), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (3.0), &YansWifiPhy::ResumeFromSleep, m_rx);
+
+  //a frame sent after the PHY went back to sleep is not received
+  Simulator::Schedule (Seconds (4.0), &YansWifiPhy::SetSleepMode, m_rx);
+  Simulator::Schedule (Seconds (5.0), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (6.0), &YansWifiPhy::ResumeFromSleep, m_rx);
+
+  //the other PHY gets the frame as it is sent, then sleeps and wakes up
+  //before it arrives, 10 us later; the dozing PHY has the frame kept
+  //for catching up
+  Simulator::Schedule (Seconds (6.5), &YansWifiPhy::SetSleepMode, m_rx);
+  Simulator::Schedule (Seconds (7.0), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (7.0), &YansWifiPhy::SetSleepMode, m_other);
+  Simulator::Schedule (Seconds (7.000005), &YansWifiPhy::ResumeFromSleep, m_other);
+  Simulator::Schedule (Seconds (8.0), &YansWifiPhy::ResumeFromSleep, m_rx);
+
+  //the far PHY wakes up 5 ms after the frame of 9 s left the air next
+  //to the sender, another frame sent since, and before either reaches it
+  Simulator::Schedule (Seconds (8.5), &YansWifiPhy::SetSleepMode, m_rx);
+  Simulator::Schedule (Seconds (9.0), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (9.004), &RawDozeChannelTest::Send, this);
+  Simulator::Schedule (Seconds (9.0064), &YansWifiPhy::ResumeFromSleep, m_far);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 1, "frames received by the dozing PHY");
+  //the frames of 1, 3 and 5 s, the frame of 7 s once, and the two of 9 s
+  NS_TEST_ASSERT_MSG_EQ (m_receivedOther, 6, "frames received by the other PHY");
+  NS_TEST_ASSERT_MSG_EQ (m_receivedFar, 2, "frames received by the far PHY");
+  m_tx = 0;
+  m_rx = 0;
+  m_other = 0;
+  m_far = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Loss model which counts its calls for every receiver, and leaves the
+ * loss to the next model of the chain.  It derives from the Friis model,
+ * which it adds nothing of, for ReceiverCulling to take the chain as
+ * depending on the distance alone.
+ */
+class CountingLossModel : public FriisPropagationLossModel
+{
+public:
+  std::map<Ptr<MobilityModel>, uint32_t> m_calls; //!< calls by receiver
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    const_cast<CountingLossModel *> (this)->m_calls[b]++;
+    return txPowerDbm;
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+};
+
+/**
+ * Checks the culling range of YansWifiChannel against the log distance
+ * loss, that the PHYs beyond it are never handed a transmission, and that
+ * the grid follows the PHYs which move.  Also checks that the range
+ * follows the thresholds of the PHYs, that a random loss model is
+ * neither probed nor culled, and that a two ray ground loss, which
+ * depends on the heights of the PHYs, is not culled.
+ */
+class ReceiverCullingTest : public TestCase
+{
+public:
+  ReceiverCullingTest ();
+  virtual void DoRun (void);
+
+private:
+  void Send (void);
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void CheckCalls (uint32_t near, uint32_t far);
+  /**
+   * \param culling whether the channel culls the receivers
+   * \return the number of frames received over a two ray ground loss
+   *         by a PHY 100 m away, both 1.5 m above the ground
+   */
+  uint32_t RunTwoRayGround (bool culling);
+
+  Ptr<CountingLossModel> m_loss;
+  Ptr<YansWifiPhy> m_tx;    //!< sending PHY
+  Ptr<YansWifiPhy> m_near;  //!< PHY within range
+  Ptr<YansWifiPhy> m_far;   //!< PHY out of range until it moves
+  uint32_t m_received;      //!< number of frames received by m_near and m_far
+};
+
+ReceiverCullingTest::ReceiverCullingTest ()
+  : TestCase ("YansWifiChannel skips the PHYs beyond the culling range")
+{
+}
+
+void
+ReceiverCullingTest::Send (void)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  m_tx->SendPacket (Create<Packet> (100), txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+ReceiverCullingTest::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_received++;
+}
+
+void
+ReceiverCullingTest::CheckCalls (uint32_t near, uint32_t far)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_loss->m_calls[m_near->GetMobility ()], near, "losses to the near PHY at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (m_loss->m_calls[m_far->GetMobility ()], far, "losses to the far PHY at " << Simulator::Now ());
+}
+
+uint32_t
+ReceiverCullingTest::RunTwoRayGround (bool culling)
+{
+  Ptr<YansWifiChannel> channel = CreateObjectWithAttributes<YansWifiChannel> ("ReceiverCulling", BooleanValue (culling));
+  channel->SetPropagationLossModel (CreateObject<TwoRayGroundPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  WifiPhy::RxOkCallback receive = MakeCallback (&ReceiverCullingTest::Receive, this);
+  m_tx = CreateYansWifiPhy (channel, Vector (0.0, 0.0, 1.5), receive);
+  CreateYansWifiPhy (channel, Vector (100.0, 0.0, 1.5), receive);
+  m_received = 0;
+  if (culling)
+    {
+      //probing along the x axis at z = 0 would cull beyond half a meter
+      NS_TEST_EXPECT_MSG_EQ (channel->GetCullingRange (m_tx->GetTxPowerEnd () + m_tx->GetTxGain ()),
+                             std::numeric_limits<double>::infinity (), "culling range with a two ray ground loss");
+    }
+  Simulator::Schedule (Seconds (1.0), &ReceiverCullingTest::Send, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_tx = 0;
+  return m_received;
+}
+
+void
+ReceiverCullingTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObjectWithAttributes<YansWifiChannel> ("ReceiverCulling", BooleanValue (true));
+  m_loss = CreateObject<CountingLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  m_loss->SetNext (logDistance);
+  channel->SetPropagationLossModel (m_loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  WifiPhy::RxOkCallback receive = MakeCallback (&ReceiverCullingTest::Receive, this);
+  m_tx = CreateYansWifiPhy (channel, Vector (0.0, 0.0, 0.0), receive);
+  m_near = CreateYansWifiPhy (channel, Vector (10.0, 10.0, 0.0), receive);
+  m_far = CreateYansWifiPhy (channel, Vector (0.0, 1e5, 0.0), receive);
+  //enough cells for the grid not to be scanned whole
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      CreateYansWifiPhy (channel, Vector (5e3 * k, -5e3, 0.0), receive);
+    }
+  m_received = 0;
+
+  //log distance loss: 46.6777 dB at 1 m, plus 30 dB per decade
+  double txPowerDbm = m_tx->GetTxPowerEnd () + m_tx->GetTxGain ();
+  double thresholdDbm = std::min (m_tx->GetEdThreshold (), m_tx->GetCcaMode1Threshold ())
+    - m_tx->GetRxGain () - 10;
+  double expected = std::pow (10, (txPowerDbm - 46.6777 - thresholdDbm) / 30);
+  double range = channel->GetCullingRange (txPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ_TOL (range / expected, 1, 1e-6, "culling range");
+  NS_TEST_ASSERT_MSG_LT (range, 1e5, "far PHY out of range");
+  m_loss->m_calls.clear ();
+
+  Simulator::Schedule (Seconds (1.0), &ReceiverCullingTest::Send, this);
+  Simulator::Schedule (Seconds (1.5), &ReceiverCullingTest::CheckCalls, this, 1, 0);
+  //the far PHY comes within range, the grid must follow
+  Simulator::Schedule (Seconds (2.0), &ConstantPositionMobilityModel::SetPosition,
+                       DynamicCast<ConstantPositionMobilityModel> (m_far->GetMobility ()), Vector (-10.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &ReceiverCullingTest::Send, this);
+  Simulator::Schedule (Seconds (3.5), &ReceiverCullingTest::CheckCalls, this, 2, 1);
+  //and leaves it again
+  Simulator::Schedule (Seconds (4.0), &ConstantPositionMobilityModel::SetPosition,
+                       DynamicCast<ConstantPositionMobilityModel> (m_far->GetMobility ()), Vector (range * 1.01, 0.0, 0.0));
+  Simulator::Schedule (Seconds (5.0), &ReceiverCullingTest::Send, this);
+  Simulator::Schedule (Seconds (5.5), &ReceiverCullingTest::CheckCalls, this, 3, 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 4, "frames received");
+
+  //a PHY sensing 30 dB weaker signals takes the range 10 times as far
+  m_near->SetEdThreshold (m_near->GetEdThreshold () - 30);
+  m_near->SetCcaMode1Threshold (m_near->GetCcaMode1Threshold () - 30);
+  NS_TEST_EXPECT_MSG_EQ_TOL (channel->GetCullingRange (txPowerDbm) / (expected * 10), 1, 1e-6,
+                             "culling range after a threshold change");
+
+  //the random losses draw the same numbers with and without culling
+  Ptr<RandomPropagationLossModel> random = CreateObjectWithAttributes<RandomPropagationLossModel>
+      ("Variable", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"));
+  Ptr<RandomPropagationLossModel> reference = CreateObjectWithAttributes<RandomPropagationLossModel>
+      ("Variable", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"));
+  random->AssignStreams (7);
+  reference->AssignStreams (7);
+  logDistance->SetNext (random);
+  NS_TEST_EXPECT_MSG_EQ (channel->GetCullingRange (txPowerDbm + 1), std::numeric_limits<double>::infinity (),
+                         "culling range with a random loss");
+  Ptr<MobilityModel> a = m_tx->GetMobility ();
+  Ptr<MobilityModel> b = m_near->GetMobility ();
+  for (uint32_t k = 0; k < 10; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (random->CalcRxPower (txPowerDbm, a, b), reference->CalcRxPower (txPowerDbm, a, b),
+                             "random loss " << k);
+    }
+  m_loss = 0;
+  m_tx = 0;
+  m_near = 0;
+  m_far = 0;
+
+  NS_TEST_EXPECT_MSG_EQ (RunTwoRayGround (false), 1, "frames received over a two ray ground loss");
+  NS_TEST_EXPECT_MSG_EQ (RunTwoRayGround (true), 1, "frames received over a two ray ground loss with culling");
+}
+
+/**
+ * Checks that YansWifiChannel with PathCache calls the loss model once
+ * per pair of PHYs and tx power, again after a PHY moves, and delivers
+ * the frames with the same powers as without the cache.  Also checks
+ * that PrecomputePaths fills the cache for all the pairs, on one thread
+ * or several, and that a loss chain with a random model is not cached.
+ */
+class PathCacheTest : public TestCase
+{
+public:
+  PathCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param cache whether the channel caches the paths
+   * \param random whether the loss chain holds a random model
+   * \return the SNRs of the frames received
+   */
+  std::vector<double> Run (bool cache, bool random);
+  /**
+   * \param cache whether the channel caches the paths
+   * \param threads the number of threads of PrecomputePaths
+   * \return the SNRs of the frames every PHY sends once, after the
+   *         paths are precomputed and the loss model changed
+   */
+  std::vector<double> RunPrecomputed (bool cache, uint32_t threads);
+  void Send (uint8_t powerLevel);
+  void SendFrom (Ptr<YansWifiPhy> phy);
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void CheckCalls (uint32_t calls);
+
+  Ptr<CountingLossModel> m_loss;
+  Ptr<YansWifiPhy> m_tx;     //!< sending PHY
+  Ptr<YansWifiPhy> m_rx;     //!< receiving PHY, which moves
+  std::vector<double> m_snr; //!< SNRs of the frames received
+};
+
+PathCacheTest::PathCacheTest ()
+  : TestCase ("YansWifiChannel caches the losses of the pairs of PHYs")
+{
+}
+
+void
+PathCacheTest::Send (uint8_t powerLevel)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), powerLevel, 0, false, 1, 0, false);
+  m_tx->SendPacket (Create<Packet> (100), txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+PathCacheTest::SendFrom (Ptr<YansWifiPhy> phy)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  phy->SendPacket (Create<Packet> (100), txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+PathCacheTest::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_snr.push_back (snr);
+}
+
+void
+PathCacheTest::CheckCalls (uint32_t calls)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_loss->m_calls[m_rx->GetMobility ()], calls, "losses to the receiver at " << Simulator::Now ());
+}
+
+std::vector<double>
+PathCacheTest::Run (bool cache, bool random)
+{
+  Ptr<YansWifiChannel> channel = CreateObjectWithAttributes<YansWifiChannel> ("PathCache", BooleanValue (cache));
+  m_loss = CreateObject<CountingLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  if (random)
+    {
+      //a constant draw, for the same powers as without the cache
+      Ptr<RandomPropagationLossModel> randomLoss = CreateObject<RandomPropagationLossModel> ();
+      m_loss->SetNext (randomLoss);
+      randomLoss->SetNext (logDistance);
+    }
+  else
+    {
+      m_loss->SetNext (logDistance);
+    }
+  channel->SetPropagationLossModel (m_loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  WifiPhy::RxOkCallback receive = MakeCallback (&PathCacheTest::Receive, this);
+  m_tx = CreateYansWifiPhy (channel, Vector (0.0, 0.0, 0.0), receive);
+  m_tx->SetTxPowerStart (10);
+  m_tx->SetNTxPower (2);
+  m_rx = CreateYansWifiPhy (channel, Vector (30.0, 0.0, 0.0), receive);
+  m_snr.clear ();
+
+  Simulator::Schedule (Seconds (1.0), &PathCacheTest::Send, this, 1);
+  Simulator::Schedule (Seconds (1.1), &PathCacheTest::Send, this, 1);
+  Simulator::Schedule (Seconds (1.2), &PathCacheTest::Send, this, 1);
+  if (cache)
+    {
+      Simulator::Schedule (Seconds (1.5), &PathCacheTest::CheckCalls, this, random ? 3 : 1);
+    }
+  //another tx power, then back
+  Simulator::Schedule (Seconds (2.0), &PathCacheTest::Send, this, 0);
+  Simulator::Schedule (Seconds (2.1), &PathCacheTest::Send, this, 1);
+  if (cache)
+    {
+      Simulator::Schedule (Seconds (2.5), &PathCacheTest::CheckCalls, this, random ? 5 : 3);
+    }
+  //the receiver moves
+  Simulator::Schedule (Seconds (3.0), &ConstantPositionMobilityModel::SetPosition,
+                       DynamicCast<ConstantPositionMobilityModel> (m_rx->GetMobility ()), Vector (60.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (4.0), &PathCacheTest::Send, this, 1);
+  Simulator::Schedule (Seconds (4.1), &PathCacheTest::Send, this, 1);
+  if (cache)
+    {
+      Simulator::Schedule (Seconds (4.5), &PathCacheTest::CheckCalls, this, random ? 7 : 4);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_loss = 0;
+  m_tx = 0;
+  m_rx = 0;
+  return m_snr;
+}
+
+std::vector<double>
+PathCacheTest::RunPrecomputed (bool cache, uint32_t threads)
+{
+  Ptr<YansWifiChannel> channel = CreateObjectWithAttributes<YansWifiChannel> ("PathCache", BooleanValue (cache),
+                                                                              "PathCacheThreads", UintegerValue (threads));
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t k = 0; k < 6; k++)
+    {
+  WifiPhy::RxOkCallback receive = MakeCallback (&PathCacheTest::Receive, this);
+      phys.push_back (CreateYansWifiPhy (channel, Vector (7.0 * k, (11.0 * k * k) - 40.0 * k, 0.0), receive));
+    }
+  m_snr.clear ();
+  channel->PrecomputePaths ();
+  //a cache filled ahead hides the 10 dB this adds to the losses
+  loss->SetAttribute ("ReferenceLoss", DoubleValue (46.6777 + (cache ? 10 : 0)));
+  for (uint32_t k = 0; k < phys.size (); k++)
+    {
+      Simulator::Schedule (Seconds (1.0 + 0.1 * k), &PathCacheTest::SendFrom, this, phys[k]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_snr;
+}
+
+void
+PathCacheTest::DoRun (void)
+{
+  std::vector<double> expected = Run (false, false);
+  std::vector<double> cached = Run (true, false);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 7, "frames received without the cache");
+  NS_TEST_ASSERT_MSG_EQ (cached.size (), expected.size (), "frames received with the cache");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (cached[i], expected[i], "SNR of frame " << i);
+    }
+  expected = Run (false, true);
+  cached = Run (true, true);
+  NS_TEST_ASSERT_MSG_EQ (cached.size (), expected.size (), "frames received with a random loss");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (cached[i], expected[i], "SNR of frame " << i << " with a random loss");
+    }
+
+  expected = RunPrecomputed (false, 1);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 30, "frames received without the cache");
+  for (uint32_t threads = 1; threads <= 3; threads += 2)
+    {
+      std::vector<double> precomputed = RunPrecomputed (true, threads);
+      NS_TEST_ASSERT_MSG_EQ (precomputed.size (), expected.size (), "frames received after precomputing on "
+                             << threads << " threads");
+      for (uint32_t i = 0; i < expected.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (precomputed[i], expected[i], "SNR of frame " << i << " after precomputing on "
+                                 << threads << " threads");
+        }
+    }
+}
+
+/**
+ * Checks that InterferenceHelper gives the same energy durations, SNRs
+ * and PERs with and without the running sum, over random overlapping
+ * frames, and that the running sum keeps fewer NI changes.
+ */
+class InterferenceRunningSumTest : public TestCase
+{
+public:
+  InterferenceRunningSumTest ();
+  virtual void DoRun (void);
+
+private:
+  void Arrive (void);
+  void Query (void);
+  void CheckHeader (void);
+  void EndRx (void);
+
+  InterferenceHelper m_legacy;   //!< without running sum
+  InterferenceHelper m_running;  //!< with running sum
+  Ptr<InterferenceHelper::Event> m_legacyRx;   //!< frame received by m_legacy
+  Ptr<InterferenceHelper::Event> m_runningRx;  //!< frame received by m_running
+  Ptr<UniformRandomVariable> m_rng;
+  uint32_t m_nArrivals;          //!< frames left to arrive
+  bool m_smaller;                //!< whether m_running ever kept fewer changes
+};
+
+InterferenceRunningSumTest::InterferenceRunningSumTest ()
+  : TestCase ("InterferenceHelper gives the same results with a running sum")
+{
+}
+
+void
+InterferenceRunningSumTest::Arrive (void)
+{
+  WifiTxVector txVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, false);
+  Time duration = MicroSeconds (m_rng->GetInteger (100, 2000));
+  double powerW = std::pow (10, m_rng->GetValue (-12, -8));
+  Ptr<InterferenceHelper::Event> legacy = m_legacy.Add (100, txVector, WIFI_PREAMBLE_LONG, duration, powerW);
+  Ptr<InterferenceHelper::Event> running = m_running.Add (100, txVector, WIFI_PREAMBLE_LONG, duration, powerW);
+  if (m_legacyRx == 0 && m_rng->GetValue () < 0.5)
+    {
+      m_legacyRx = legacy;
+      m_runningRx = running;
+      m_legacy.NotifyRxStart ();
+      m_running.NotifyRxStart ();
+      Simulator::Schedule (MicroSeconds (40), &InterferenceRunningSumTest::CheckHeader, this);
+      Simulator::Schedule (duration, &InterferenceRunningSumTest::EndRx, this);
+    }
+  Query ();
+  if (--m_nArrivals > 0)
+    {
+      //some frames arrive at the same time
+      Time next = m_rng->GetValue () < 0.1 ? Seconds (0) : MicroSeconds (m_rng->GetInteger (1, 400));
+      Simulator::Schedule (next, &InterferenceRunningSumTest::Arrive, this);
+      Simulator::Schedule (MicroSeconds (m_rng->GetInteger (0, 400)), &InterferenceRunningSumTest::Query, this);
+    }
+}
+
+void
+InterferenceRunningSumTest::Query (void)
+{
+  double energyW = std::pow (10, m_rng->GetValue (-12, -8));
+  NS_TEST_EXPECT_MSG_EQ (m_running.GetEnergyDuration (energyW), m_legacy.GetEnergyDuration (energyW),
+                         "energy duration at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_running.GetNNiChanges (), m_legacy.GetNNiChanges (), "NI changes kept");
+  if (m_running.GetNNiChanges () < m_legacy.GetNNiChanges ())
+    {
+      m_smaller = true;
+    }
+}
+
+void
+InterferenceRunningSumTest::CheckHeader (void)
+{
+  InterferenceHelper::SnrPer legacy = m_legacy.CalculatePlcpHeaderSnrPer (m_legacyRx);
+  InterferenceHelper::SnrPer running = m_running.CalculatePlcpHeaderSnrPer (m_runningRx);
+  NS_TEST_EXPECT_MSG_EQ (running.snr, legacy.snr, "header SNR at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (running.per, legacy.per, "header PER at " << Simulator::Now ());
+}
+
+void
+InterferenceRunningSumTest::EndRx (void)
+{
+  InterferenceHelper::SnrPer legacy = m_legacy.CalculatePlcpPayloadSnrPer (m_legacyRx);
+  InterferenceHelper::SnrPer running = m_running.CalculatePlcpPayloadSnrPer (m_runningRx);
+  NS_TEST_EXPECT_MSG_EQ (running.snr, legacy.snr, "payload SNR at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (running.per, legacy.per, "payload PER at " << Simulator::Now ());
+  m_legacy.NotifyRxEnd ();
+  m_running.NotifyRxEnd ();
+  m_legacyRx = 0;
+  m_runningRx = 0;
+  Query ();
+}
+
+void
+InterferenceRunningSumTest::DoRun (void)
+{
+  m_legacy.SetNoiseFigure (5);
+  m_running.SetNoiseFigure (5);
+  m_legacy.SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  m_running.SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  m_running.SetRunningSum (true);
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (3);
+  m_nArrivals = 3000;
+  m_smaller = false;
+  Simulator::Schedule (Seconds (1.0), &InterferenceRunningSumTest::Arrive, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_smaller, true, "NI changes pruned");
+  m_legacy.EraseEvents ();
+  m_running.EraseEvents ();
+}
+
+/**
+ * Drives a WifiMacQueue with random enqueues, pushes to the front,
+ * lookups by TID and receiver, removals and expiries, and checks every
+ * result against a plain list of the packets, as the queue was kept
+ * before its lists by receiver and TID.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual void DoRun (void);
+
+private:
+  struct RefItem
+  {
+    Ptr<const Packet> packet;
+    WifiMacHeader hdr;
+    Time tstamp;
+  };
+  typedef std::list<RefItem> RefQueue;
+
+  void Step (void);
+  void Cleanup (void);
+  RefQueue::iterator Find (uint8_t tid, Mac48Address addr);
+  WifiMacHeader MakeHeader (void);
+
+  Ptr<WifiMacQueue> m_queue;
+  RefQueue m_ref;
+  Ptr<UniformRandomVariable> m_rng;
+  uint32_t m_steps;
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("WifiMacQueue lookups by TID and receiver match a linear scan")
+{
+}
+
+void
+WifiMacQueueIndexTest::Cleanup (void)
+{
+  for (RefQueue::iterator it = m_ref.begin (); it != m_ref.end (); )
+    {
+      if (it->tstamp + m_queue->GetMaxDelay () > Simulator::Now ())
+        {
+          it++;
+        }
+      else
+        {
+          it = m_ref.erase (it);
+        }
+    }
+}
+
+WifiMacQueueIndexTest::RefQueue::iterator
+WifiMacQueueIndexTest::Find (uint8_t tid, Mac48Address addr)
+{
+  for (RefQueue::iterator it = m_ref.begin (); it != m_ref.end (); it++)
+    {
+      if (it->hdr.IsQosData () && it->hdr.GetAddr1 () == addr && it->hdr.GetQosTid () == tid)
+        {
+          return it;
+        }
+    }
+  return m_ref.end ();
+}
+
+WifiMacHeader
+WifiMacQueueIndexTest::MakeHeader (void)
+{
+  WifiMacHeader hdr;
+  if (m_rng->GetValue () < 0.2)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (m_rng->GetInteger (0, 3));
+    }
+  std::ostringstream addr;
+  addr << "00:00:00:00:00:0" << m_rng->GetInteger (1, 8);
+  hdr.SetAddr1 (Mac48Address (addr.str ().c_str ()));
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:ff"));
+  return hdr;
+}
+
+void
+WifiMacQueueIndexTest::Step (void)
+{
+  m_queue->IsEmpty ();
+  Cleanup ();
+  uint32_t op = m_rng->GetInteger (0, 9);
+  uint8_t tid = m_rng->GetInteger (0, 3);
+  std::ostringstream addrString;
+  addrString << "00:00:00:00:00:0" << m_rng->GetInteger (1, 8);
+  Mac48Address addr (addrString.str ().c_str ());
+  WifiMacHeader hdr;
+  Time tstamp;
+  if (op <= 4)
+    {
+      RefItem item;
+      item.packet = Create<Packet> (10);
+      item.hdr = MakeHeader ();
+      item.tstamp = Simulator::Now ();
+      if (m_ref.size () < m_queue->GetMaxSize ())
+        {
+          if (op == 4)
+            {
+              m_ref.push_front (item);
+            }
+          else
+            {
+              m_ref.push_back (item);
+            }
+        }
+      if (op == 4)
+        {
+          m_queue->PushFront (item.packet, item.hdr);
+        }
+      else
+        {
+          m_queue->Enqueue (item.packet, item.hdr);
+        }
+    }
+  else if (op == 5)
+    {
+      RefQueue::iterator it = Find (tid, addr);
+      Ptr<const Packet> packet = m_queue->DequeueByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr);
+      NS_TEST_EXPECT_MSG_EQ (packet, (it == m_ref.end () ? 0 : it->packet), "dequeue by TID and address");
+      if (it != m_ref.end ())
+        {
+          m_ref.erase (it);
+        }
+    }
+  else if (op == 6)
+    {
+      RefQueue::iterator it = Find (tid, addr);
+      Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr, &tstamp);
+      NS_TEST_EXPECT_MSG_EQ (packet, (it == m_ref.end () ? 0 : it->packet), "peek by TID and address");
+      if (it != m_ref.end ())
+        {
+          NS_TEST_EXPECT_MSG_EQ (tstamp, it->tstamp, "timestamp of the peeked packet");
+          //as the A-MSDU aggregation does
+          if (m_rng->GetValue () < 0.5)
+            {
+              NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (packet), true, "remove the peeked packet");
+              m_ref.erase (it);
+            }
+        }
+    }
+  else if (op == 7)
+    {
+      uint32_t n = 0;
+      uint32_t nTid = 0;
+      for (RefQueue::iterator it = m_ref.begin (); it != m_ref.end (); it++)
+        {
+          if (it->hdr.IsQosData () && it->hdr.GetQosTid () == tid)
+            {
+              nTid++;
+              n += (it->hdr.GetAddr1 () == addr);
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, addr), n,
+                             "packets of the TID and address");
+      //the other addresses go through the whole queue
+      NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR2, Mac48Address ("00:00:00:00:00:ff")),
+                             nTid, "packets of the TID and address 2");
+    }
+  else if (op == 8)
+    {
+      Ptr<const Packet> packet = m_queue->Dequeue (&hdr);
+      NS_TEST_EXPECT_MSG_EQ (packet, (m_ref.empty () ? 0 : m_ref.front ().packet), "dequeue");
+      if (!m_ref.empty ())
+        {
+          m_ref.pop_front ();
+        }
+    }
+  else if (!m_ref.empty ())
+    {
+      RefQueue::iterator it = m_ref.begin ();
+      std::advance (it, m_rng->GetInteger (0, m_ref.size () - 1));
+      NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (it->packet), true, "remove");
+      m_ref.erase (it);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), m_ref.size (), "queue size");
+  if (--m_steps > 0)
+    {
+      Simulator::Schedule (MicroSeconds (m_rng->GetInteger (0, 3000)), &WifiMacQueueIndexTest::Step, this);
+    }
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxSize (60);
+  m_queue->SetMaxDelay (MilliSeconds (40));
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (5);
+  m_steps = 20000;
+  Simulator::Schedule (Seconds (1.0), &WifiMacQueueIndexTest::Step, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "flushed");
+}
+
+/**
+ * Checks that AddressHashTable finds every address and TID it was given,
+ * through its growth, and none it was not given.
+ */
+class AddressHashTableTest : public TestCase
+{
+public:
+  AddressHashTableTest ();
+  virtual void DoRun (void);
+};
+
+AddressHashTableTest::AddressHashTableTest ()
+  : TestCase ("AddressHashTable finds the stations by address and TID")
+{
+}
+
+void
+AddressHashTableTest::DoRun (void)
+{
+  AddressHashTable<uint32_t> table;
+  std::vector<uint32_t> values (10000);
+  std::vector<uint64_t> keys;
+  for (uint32_t n = 0; n < values.size (); n++)
+    {
+      //consecutive addresses, as Mac48Address::Allocate gives, and a few TIDs
+      uint8_t buffer[6] = { 0, 0, 0, (uint8_t)(n / 4 >> 16), (uint8_t)(n / 4 >> 8), (uint8_t)(n / 4) };
+      Mac48Address address;
+      address.CopyFrom (buffer);
+      keys.push_back (AddressHashTable<uint32_t>::GetKey (address, n % 4));
+      values[n] = n;
+      NS_TEST_EXPECT_MSG_EQ (table.Find (keys[n]), (uint32_t *) 0, "key " << n << " before its insertion");
+      table.Insert (keys[n], &values[n]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), values.size (), "table size");
+  for (uint32_t n = 0; n < values.size (); n++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (table.Find (keys[n]), &values[n], "key " << n);
+    }
+  NS_TEST_EXPECT_MSG_EQ (table.Find (AddressHashTable<uint32_t>::GetKey (Mac48Address ("00:00:00:00:00:01"), 7)),
+                         (uint32_t *) 0, "TID never inserted");
+  table.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "cleared table size");
+  NS_TEST_EXPECT_MSG_EQ (table.Find (keys[0]), (uint32_t *) 0, "key in the cleared table");
+}
+
+/**
+ * Sends data frames and RTSs to a MacLow, with and without
+ * ControlFrameTemplates, and checks that it answers with the same ACKs
+ * and CTSs, byte for byte and at the same times.
+ */
+class ControlFrameTemplatesTest : public TestCase
+{
+public:
+  ControlFrameTemplatesTest ();
+  virtual void DoRun (void);
+
+private:
+  struct Frame
+  {
+    Time at;
+    std::vector<uint8_t> bytes;
+  };
+
+  /**
+   * \param templates whether the MacLow uses the templates
+   * \return the frames received from the MacLow
+   */
+  std::vector<Frame> Run (bool templates);
+  void Send (enum WifiMacType type, Mac48Address from, uint32_t durationUs);
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void ForwardUp (Ptr<Packet> packet, const WifiMacHeader *hdr);
+
+  Ptr<YansWifiPhy> m_tx;
+  std::vector<Frame> m_frames;
+};
+
+ControlFrameTemplatesTest::ControlFrameTemplatesTest ()
+  : TestCase ("MacLow builds the same ACKs and CTSs from its templates")
+{
+}
+
+void
+ControlFrameTemplatesTest::Send (enum WifiMacType type, Mac48Address from, uint32_t durationUs)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (type);
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  hdr.SetAddr2 (from);
+  hdr.SetAddr3 (from);
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  hdr.SetDuration (MicroSeconds (durationUs));
+  Ptr<Packet> packet = Create<Packet> (type == WIFI_MAC_DATA ? 200 : 0);
+  packet->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  WifiTxVector txVector (WifiPhy::GetOfdmRate24Mbps (), 0, 0, false, 1, 0, false);
+  m_tx->SendPacket (packet, txVector, WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+ControlFrameTemplatesTest::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  Frame frame;
+  frame.at = Simulator::Now ();
+  frame.bytes.resize (packet->GetSize ());
+  packet->CopyData (&frame.bytes[0], frame.bytes.size ());
+  m_frames.push_back (frame);
+}
+
+void
+ControlFrameTemplatesTest::ForwardUp (Ptr<Packet> packet, const WifiMacHeader *hdr)
+{
+}
+
+std::vector<ControlFrameTemplatesTest::Frame>
+ControlFrameTemplatesTest::Run (bool templates)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_tx = CreateYansWifiPhy (channel, Vector (0.0, 0.0, 0.0));
+  m_tx->SetReceiveOkCallback (MakeCallback (&ControlFrameTemplatesTest::Receive, this));
+  Ptr<YansWifiPhy> phy = CreateYansWifiPhy (channel, Vector (10.0, 0.0, 0.0));
+  Ptr<WifiRemoteStationManager> manager = CreateObjectWithAttributes<ConstantRateWifiManager> ("DataMode", StringValue ("OfdmRate24Mbps"));
+  manager->SetupPhy (phy);
+  Ptr<MacLow> low = CreateObjectWithAttributes<MacLow> ("ControlFrameTemplates", BooleanValue (templates));
+  low->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  low->SetSifs (MicroSeconds (16));
+  low->SetSlotTime (MicroSeconds (9));
+  low->SetWifiRemoteStationManager (manager);
+  low->SetRxCallback (MakeCallback (&ControlFrameTemplatesTest::ForwardUp, this));
+  low->SetPhy (phy);
+  m_frames.clear ();
+
+  //ACKs and CTSs to several stations, with several durations
+  Simulator::Schedule (MilliSeconds (10), &ControlFrameTemplatesTest::Send, this,
+                       WIFI_MAC_DATA, Mac48Address ("00:00:00:00:00:02"), 60);
+  Simulator::Schedule (MilliSeconds (20), &ControlFrameTemplatesTest::Send, this,
+                       WIFI_MAC_DATA, Mac48Address ("00:00:00:00:00:03"), 300);
+  Simulator::Schedule (MilliSeconds (30), &ControlFrameTemplatesTest::Send, this,
+                       WIFI_MAC_CTL_RTS, Mac48Address ("00:00:00:00:00:02"), 400);
+  Simulator::Schedule (MilliSeconds (40), &ControlFrameTemplatesTest::Send, this,
+                       WIFI_MAC_CTL_RTS, Mac48Address ("00:00:00:00:01:04"), 1000);
+  Simulator::Schedule (MilliSeconds (50), &ControlFrameTemplatesTest::Send, this,
+                       WIFI_MAC_DATA, Mac48Address ("00:00:00:00:01:04"), 60);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  low->Dispose ();
+  manager->Dispose ();
+  m_tx = 0;
+  return m_frames;
+}
+
+void
+ControlFrameTemplatesTest::DoRun (void)
+{
+  std::vector<Frame> expected = Run (false);
+  std::vector<Frame> frames = Run (true);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 5, "frames answered without the templates");
+  NS_TEST_ASSERT_MSG_EQ (frames.size (), expected.size (), "frames answered with the templates");
+  for (uint32_t i = 0; i < frames.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (frames[i].at, expected[i].at, "reception time of frame " << i);
+      NS_TEST_EXPECT_MSG_EQ ((frames[i].bytes == expected[i].bytes), true, "bytes of frame " << i);
+    }
+  //the second ACK, to 00:00:00:00:00:03, keeps 300 us minus a SIFS and
+  //the ACK, 44 us at 6 Mbps
+  Ptr<Packet> packet = Create<Packet> (&frames[1].bytes[0], frames[1].bytes.size ());
+  WifiMacHeader hdr;
+  packet->RemoveHeader (hdr);
+  NS_TEST_EXPECT_MSG_EQ (hdr.IsAck (), true, "second answer");
+  NS_TEST_EXPECT_MSG_EQ (hdr.GetAddr1 (), Mac48Address ("00:00:00:00:00:03"), "receiver of the second ACK");
+  NS_TEST_EXPECT_MSG_EQ (hdr.GetDuration (), MicroSeconds (300 - 16 - 44), "duration of the second ACK");
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -495,6 +1542,13 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
+  AddTestCase (new RawDozeChannelTest, TestCase::QUICK);
+  AddTestCase (new ReceiverCullingTest, TestCase::QUICK);
+  AddTestCase (new PathCacheTest, TestCase::QUICK);
+  AddTestCase (new InterferenceRunningSumTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
+  AddTestCase (new AddressHashTableTest, TestCase::QUICK);
+  AddTestCase (new ControlFrameTemplatesTest, TestCase::QUICK);
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
 }
 